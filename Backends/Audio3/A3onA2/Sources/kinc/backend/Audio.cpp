@@ -1,41 +1,403 @@
 #include <Kore/Audio2/Audio.h>
 #include <Kore/Audio3/Audio.h>
+#include <Kore/Memory.h>
+
+#include <kinc/audio2/audio.h>
+#include <kinc/log.h>
+#include <kinc/profiler.h>
+#include <kinc/simd/float32x4.h>
+#include <kinc/system.h>
+#include <kinc/threads/mutex.h>
+
+#include <math.h>
+#include <string.h>
 
 using namespace Kore;
 
+// Every channel is mixed in blocks: its samples are resampled for the Doppler-effect, low-pass filtered and then panned into a stereo-accumulator,
+// using equal-power panning or a convolution with head-related impulse-responses. Gains are ramped across every block to avoid clicks. Distance
+// attenuation is evaluated once per block and voices which end up inaudible only advance their buffers.
+// The channel-callbacks are called with the mixer's mutex unlocked so they can take their time and call back into Audio3. Every block first
+// works out how many samples each voice will consume, then calls the callbacks and then locks the mutex again for the actual mixing. The
+// callbacks are serialized against destroyChannel by a second mutex so no callback runs after destroyChannel has returned.
+
 namespace {
-	const int channelCount = 64;
+	const int channelCount = 256;
+	// mono float-samples per channel, has to hold at least blockFrames * maxPitch + 2 samples
+	const int bufferSamples = 4096;
+	// frames which are mixed at once
+	const int blockFrames = 256;
+	const float minPitch = 0.25f;
+	const float maxPitch = 4.0f;
+	const int maxHRTFLength = 512;
+	const float pi = 3.14159265358979f;
+
+	struct Voice {
+		float fraction;
+		// fixed while the samples for a block are requested and mixed
+		float pitch;
+		float gains[2];
+		float filter;
+		int direction;
+		bool started;
+		float *history;
+	};
+
 	Audio3::Channel channels[channelCount];
+	Voice voices[channelCount];
+	kinc_mutex_t mutex;
+	kinc_mutex_t callbackMutex;
+	// samples which the callbacks have to provide for the current block
+	int missingSamples[channelCount];
+
+	float listenerPosition[3];
+	float listenerRight[3];
+	float listenerUp[3];
+	float listenerForward[3];
+	float listenerVelocity[3];
+	float speedOfSound = 343.0f;
+	float dopplerFactor = 1.0f;
+	float cullThreshold = 0.0001f;
+	Audio3::Panning panning = Audio3::PanningEqualPower;
+
+	// reversed and zero-padded to a multiple of four, left and right for every direction
+	float *hrtf = nullptr;
+	int hrtfDirections = 0;
+	int hrtfLength = 0;
+
+	Audio3::Statistics stats;
+
+	float mono[blockFrames];
+	float convolved[2][blockFrames];
+	float extended[maxHRTFLength + blockFrames];
+	float accumulator[2][blockFrames];
+
+	float dot(const float *a, const float *b) {
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	void normalize(float *v) {
+		float length = sqrtf(dot(v, v));
+		if (length > 0.0f) {
+			v[0] /= length;
+			v[1] /= length;
+			v[2] /= length;
+		}
+	}
 
-	void callback(int samples) {
+	void cross(const float *a, const float *b, float *result) {
+		result[0] = a[1] * b[2] - a[2] * b[1];
+		result[1] = a[2] * b[0] - a[0] * b[2];
+		result[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	int available(const Audio3::Channel &channel) {
+		int bytes = channel.buffer.writeLocation - channel.buffer.readLocation;
+		if (bytes < 0) bytes += channel.buffer.dataSize;
+		return bytes / 4;
+	}
+
+	// samples which a block of the given length consumes, including the one that is interpolated towards
+	int requiredSamples(const Voice &voice, int frames) {
+		return (int)(voice.fraction + voice.pitch * frames) + 2;
+	}
+
+	// makes sure that the channel's buffer holds at least the given number of samples, filling up with silence what the callback did not
+	// provide, for example for channels which were created after the samples were requested
+	void request(Audio3::Channel &channel, int samples) {
+		int missing = samples - available(channel);
+		for (int i = 0; i < missing; ++i) {
+			*(float *)&channel.buffer.data[channel.buffer.writeLocation] = 0.0f;
+			channel.buffer.writeLocation += 4;
+			if (channel.buffer.writeLocation >= channel.buffer.dataSize) channel.buffer.writeLocation = 0;
+		}
+	}
+
+	// calls the callbacks for the samples which were counted in missingSamples, has to be called without holding the mutex
+	void callCallbacks() {
+		kinc_mutex_lock(&callbackMutex);
 		for (int i = 0; i < channelCount; ++i) {
-			channels[i].callback(samples);
+			if (missingSamples[i] <= 0) {
+				continue;
+			}
+			kinc_mutex_lock(&mutex);
+			Audio3::Channel *channel = channels[i].active ? &channels[i] : nullptr;
+			Audio3::ChannelCallback channelCallback = channels[i].channelCallback;
+			Audio3::AudioCallback callback = channels[i].callback;
+			kinc_mutex_unlock(&mutex);
+			if (channel == nullptr) {
+				continue;
+			}
+			if (channelCallback != nullptr) {
+				channelCallback(channel, missingSamples[i]);
+			}
+			else if (callback != nullptr) {
+				callback(missingSamples[i]);
+			}
 		}
-		for (int i = 0; i < samples; ++i) {
-			float value = 0;
+		kinc_mutex_unlock(&callbackMutex);
+	}
+
+	float sampleAt(const Audio3::Channel &channel, int index) {
+		int location = channel.buffer.readLocation + index * 4;
+		if (location >= channel.buffer.dataSize) location -= channel.buffer.dataSize;
+		return *(float *)&channel.buffer.data[location];
+	}
+
+	void consume(Audio3::Channel &channel, int samples) {
+		channel.buffer.readLocation = (channel.buffer.readLocation + samples * 4) % channel.buffer.dataSize;
+	}
+
+	void skip(Audio3::Channel &channel, Voice &voice, float pitch, int frames) {
+		request(channel, requiredSamples(voice, frames));
+		float position = voice.fraction + pitch * frames;
+		int consumed = (int)position;
+		consume(channel, consumed);
+		voice.fraction = position - consumed;
+	}
+
+	void resample(Audio3::Channel &channel, Voice &voice, float pitch, int frames) {
+		request(channel, requiredSamples(voice, frames));
+		if (pitch == 1.0f && voice.fraction == 0.0f) {
+			int contiguous = (channel.buffer.dataSize - channel.buffer.readLocation) / 4;
+			int first = frames < contiguous ? frames : contiguous;
+			memcpy(mono, &channel.buffer.data[channel.buffer.readLocation], first * 4);
+			memcpy(&mono[first], channel.buffer.data, (frames - first) * 4);
+			consume(channel, frames);
+			return;
+		}
+		float position = voice.fraction;
+		for (int i = 0; i < frames; ++i) {
+			int index = (int)position;
+			float a = position - index;
+			float s0 = sampleAt(channel, index);
+			float s1 = sampleAt(channel, index + 1);
+			mono[i] = s0 + (s1 - s0) * a;
+			position += pitch;
+		}
+		int consumed = (int)position;
+		consume(channel, consumed);
+		voice.fraction = position - consumed;
+	}
+
+	void lowPass(Voice &voice, float cutoff, float samplesPerSecond, int frames) {
+		float a = 1.0f - expf(-2.0f * pi * cutoff / samplesPerSecond);
+		float y = voice.filter;
+		for (int i = 0; i < frames; ++i) {
+			y += a * (mono[i] - y);
+			mono[i] = y;
+		}
+		voice.filter = y;
+	}
+
+	// target += source * gain, with gain ramping linearly from one value to the other
+	void accumulate(float *target, const float *source, float from, float to, int frames) {
+		float step = (to - from) / frames;
+		kinc_float32x4_t gain = kinc_float32x4_load(from, from + step, from + 2 * step, from + 3 * step);
+		kinc_float32x4_t gainStep = kinc_float32x4_load_all(4 * step);
+		int i = 0;
+		for (; i + 4 <= frames; i += 4) {
+			kinc_float32x4_t value = kinc_float32x4_mul(kinc_float32x4_load_unaligned(&source[i]), gain);
+			kinc_float32x4_store_unaligned(&target[i], kinc_float32x4_add(kinc_float32x4_load_unaligned(&target[i]), value));
+			gain = kinc_float32x4_add(gain, gainStep);
+		}
+		for (; i < frames; ++i) {
+			target[i] += source[i] * (from + step * i);
+		}
+	}
+
+	// convolves the samples in extended, which start with the voice's history
+	void convolve(const float *impulse, float *target, int frames) {
+		for (int n = 0; n < frames; ++n) {
+			kinc_float32x4_t sum = kinc_float32x4_load_all(0.0f);
+			for (int j = 0; j < hrtfLength; j += 4) {
+				sum = kinc_float32x4_add(sum, kinc_float32x4_mul(kinc_float32x4_load_unaligned(&impulse[j]), kinc_float32x4_load_unaligned(&extended[n + j])));
+			}
+			target[n] = kinc_float32x4_get(sum, 0) + kinc_float32x4_get(sum, 1) + kinc_float32x4_get(sum, 2) + kinc_float32x4_get(sum, 3);
+		}
+	}
+
+	float distanceGain(const Audio3::Channel &channel, float distance) {
+		float reference = channel.referenceDistance > 0.0f ? channel.referenceDistance : 0.0001f;
+		float maximum = channel.maxDistance > reference ? channel.maxDistance : reference;
+		float d = distance < reference ? reference : (distance > maximum ? maximum : distance);
+		switch (channel.distanceModel) {
+		case Audio3::DistanceInverse:
+			return reference / (reference + channel.rolloff * (d - reference));
+		case Audio3::DistanceLinear: {
+			if (maximum <= reference) return 1.0f;
+			float gain = 1.0f - channel.rolloff * (d - reference) / (maximum - reference);
+			return gain < 0.0f ? 0.0f : gain;
+		}
+		case Audio3::DistanceExponential:
+			return powf(d / reference, -channel.rolloff);
+		default:
+			return 1.0f;
+		}
+	}
+
+	float dopplerPitch(const Audio3::Channel &channel) {
+		float offset[3] = {channel.origin.x() - listenerPosition[0], channel.origin.y() - listenerPosition[1], channel.origin.z() - listenerPosition[2]};
+		float distance = sqrtf(dot(offset, offset));
+		float pitch = 1.0f;
+		if (channel.doppler && dopplerFactor > 0.0f && distance > 0.0f) {
+			float direction[3] = {offset[0] / distance, offset[1] / distance, offset[2] / distance};
+			float velocity[3] = {channel.velocity.x(), channel.velocity.y(), channel.velocity.z()};
+			// speeds towards the other one
+			float listenerSpeed = dot(listenerVelocity, direction) * dopplerFactor;
+			float sourceSpeed = -dot(velocity, direction) * dopplerFactor;
+			float denominator = speedOfSound - sourceSpeed;
+			pitch = denominator > 0.0f ? (speedOfSound + listenerSpeed) / denominator : maxPitch;
+			pitch = pitch < minPitch ? minPitch : (pitch > maxPitch ? maxPitch : pitch);
+		}
+		return pitch;
+	}
+
+	void mixVoice(Audio3::Channel &channel, Voice &voice, float samplesPerSecond, int frames, bool &audible) {
+		float offset[3] = {channel.origin.x() - listenerPosition[0], channel.origin.y() - listenerPosition[1], channel.origin.z() - listenerPosition[2]};
+		float distance = sqrtf(dot(offset, offset));
+		float gain = channel.volume * distanceGain(channel, distance);
+		float pitch = voice.pitch;
+
+		if (gain < cullThreshold) {
+			skip(channel, voice, pitch, frames);
+			voice.started = false;
+			audible = false;
+			return;
+		}
+		audible = true;
+
+		resample(channel, voice, pitch, frames);
+		if (channel.lowPass > 0.0f && channel.lowPass < samplesPerSecond * 0.5f) {
+			lowPass(voice, channel.lowPass, samplesPerSecond, frames);
+		}
+
+		float x = dot(offset, listenerRight);
+		float z = dot(offset, listenerForward);
+
+		if (panning == Audio3::PanningHRTF && hrtf != nullptr) {
+			float azimuth = atan2f(x, z);
+			int direction = (int)floorf(azimuth / (2.0f * pi) * hrtfDirections + 0.5f) % hrtfDirections;
+			if (direction < 0) direction += hrtfDirections;
+			if (!voice.started) {
+				memset(voice.history, 0, maxHRTFLength * sizeof(float));
+				voice.gains[0] = 0.0f;
+				voice.direction = direction;
+			}
+			memcpy(extended, voice.history, (hrtfLength - 1) * sizeof(float));
+			memcpy(&extended[hrtfLength - 1], mono, frames * sizeof(float));
+			for (int ear = 0; ear < 2; ++ear) {
+				convolve(&hrtf[(direction * 2 + ear) * hrtfLength], convolved[ear], frames);
+				accumulate(accumulator[ear], convolved[ear], direction == voice.direction ? voice.gains[0] : 0.0f, gain, frames);
+				if (direction != voice.direction) {
+					// crossfades to the new direction
+					convolve(&hrtf[(voice.direction * 2 + ear) * hrtfLength], convolved[ear], frames);
+					accumulate(accumulator[ear], convolved[ear], voice.gains[0], 0.0f, frames);
+				}
+			}
+			memcpy(voice.history, &extended[frames], (hrtfLength - 1) * sizeof(float));
+			voice.direction = direction;
+			voice.gains[0] = gain;
+		}
+		else {
+			float lateral = distance > 0.0f ? x / distance : 0.0f;
+			float angle = (lateral + 1.0f) * pi * 0.25f;
+			float gains[2] = {cosf(angle) * gain, sinf(angle) * gain};
+			if (!voice.started) {
+				voice.gains[0] = voice.gains[1] = 0.0f;
+			}
+			for (int ear = 0; ear < 2; ++ear) {
+				accumulate(accumulator[ear], mono, voice.gains[ear], gains[ear], frames);
+				voice.gains[ear] = gains[ear];
+			}
+		}
+		voice.started = true;
+	}
+
+	void mix(kinc_a2_block_t *block, void *userdata) {
+		KINC_PROFILER_BEGIN("Audio3 mix");
+		kinc_ticks_t start = kinc_timestamp();
+		int mixed = 0;
+		int culled = 0;
+
+		double seconds = 0.0;
+		for (int offset = 0; offset < block->frames; offset += blockFrames) {
+			int frames = block->frames - offset < blockFrames ? block->frames - offset : blockFrames;
+
+			kinc_mutex_lock(&mutex);
 			for (int i = 0; i < channelCount; ++i) {
-				value += *(float *)&channels[i].buffer.data[Audio2::buffer.readLocation];
-				channels[i].buffer.readLocation += 4;
-				if (channels[i].buffer.readLocation >= channels[i].buffer.dataSize) channels[i].buffer.readLocation = 0;
+				missingSamples[i] = 0;
+				if (channels[i].active) {
+					voices[i].pitch = dopplerPitch(channels[i]);
+					missingSamples[i] = requiredSamples(voices[i], frames) - available(channels[i]);
+				}
 			}
+			kinc_mutex_unlock(&mutex);
+
+			// the callbacks are not included in the statistics
+			seconds += (kinc_timestamp() - start) / kinc_frequency();
+			callCallbacks();
+			start = kinc_timestamp();
 
-			*(float *)&Audio2::buffer.data[Audio2::buffer.writeLocation] = value;
-			Audio2::buffer.writeLocation += 4;
-			if (Audio2::buffer.writeLocation >= Audio2::buffer.dataSize) Audio2::buffer.writeLocation = 0;
+			kinc_mutex_lock(&mutex);
+			memset(accumulator, 0, sizeof(accumulator));
+			for (int i = 0; i < channelCount; ++i) {
+				if (!channels[i].active) {
+					continue;
+				}
+				bool audible;
+				mixVoice(channels[i], voices[i], (float)block->samples_per_second, frames, audible);
+				if (offset == 0) {
+					audible ? ++mixed : ++culled;
+				}
+			}
+			for (int i = 0; i < frames; ++i) {
+				for (int c = 0; c < block->channels; ++c) {
+					float value = block->channels == 1 ? (accumulator[0][i] + accumulator[1][i]) * 0.5f : (c < 2 ? accumulator[c][i] : 0.0f);
+					if (block->planar) {
+						block->data[c][offset + i] = value;
+					}
+					else {
+						block->data[0][(offset + i) * block->channels + c] = value;
+					}
+				}
+			}
+			kinc_mutex_unlock(&mutex);
+		}
+		seconds += (kinc_timestamp() - start) / kinc_frequency();
+
+		kinc_mutex_lock(&mutex);
+		stats.voices = mixed;
+		stats.culled = culled;
+		stats.frames = block->frames;
+		stats.seconds = seconds;
+		kinc_mutex_unlock(&mutex);
+
+		KINC_PROFILER_COUNTER("Audio3 voices", mixed);
+		if (seconds > 0.0) {
+			KINC_PROFILER_COUNTER("Audio3 voices per ms", mixed / (seconds * 1000.0));
 		}
+		KINC_PROFILER_END();
 	}
 }
 
 void Audio3::init() {
+	kinc_mutex_init(&mutex);
+	kinc_mutex_init(&callbackMutex);
 	for (int i = 0; i < channelCount; ++i) {
 		channels[i].active = false;
 		channels[i].buffer.readLocation = 0;
 		channels[i].buffer.writeLocation = 0;
-		channels[i].buffer.dataSize = 128 * 1024;
-		channels[i].buffer.data = new u8[channels[i].buffer.dataSize];
+		channels[i].buffer.dataSize = bufferSamples * 4;
+		channels[i].buffer.data = createArray<u8>(channels[i].buffer.dataSize, KINC_MEMORY_TAG_AUDIO);
+		channels[i].buffer.format.channels = 1;
+		channels[i].buffer.format.bitsPerSample = 32;
+		voices[i].history = nullptr;
 	}
+	setListener(vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+	kinc_a2_set_block_format(2, 0, false);
 	Audio2::init();
-	Audio2::audioCallback = callback;
+	kinc_a2_set_block_callback(mix, nullptr);
 }
 
 void Audio3::update() {
@@ -47,14 +409,129 @@ void Audio3::shutdown() {
 }
 
 Audio3::Channel *Audio3::createChannel(vec3 origin, AudioCallback callback) {
+	Channel *channel = createChannel(origin, (ChannelCallback) nullptr, nullptr);
+	if (channel != nullptr) {
+		channel->callback = callback;
+	}
+	return channel;
+}
+
+Audio3::Channel *Audio3::createChannel(vec3 origin, ChannelCallback callback, void *userdata) {
+	Channel *channel = nullptr;
+	kinc_mutex_lock(&mutex);
 	for (int i = 0; i < channelCount; ++i) {
 		if (!channels[i].active) {
-			return &channels[i];
+			channel = &channels[i];
+			channel->origin = origin;
+			channel->callback = nullptr;
+			channel->channelCallback = callback;
+			channel->userdata = userdata;
+			channel->velocity = vec3(0.0f, 0.0f, 0.0f);
+			channel->volume = 1.0f;
+			channel->distanceModel = DistanceInverse;
+			channel->referenceDistance = 1.0f;
+			channel->maxDistance = 1000000.0f;
+			channel->rolloff = 1.0f;
+			channel->lowPass = 0.0f;
+			channel->doppler = true;
+			channel->buffer.readLocation = 0;
+			channel->buffer.writeLocation = 0;
+			channel->buffer.format.samplesPerSecond = kinc_a2_samples_per_second;
+			voices[i].fraction = 0.0f;
+			voices[i].pitch = 1.0f;
+			voices[i].filter = 0.0f;
+			voices[i].started = false;
+			channel->active = true;
+			break;
 		}
 	}
-	return nullptr;
+	kinc_mutex_unlock(&mutex);
+	return channel;
 }
 
 void Audio3::destroyChannel(Channel *channel) {
+	kinc_mutex_lock(&callbackMutex);
+	kinc_mutex_lock(&mutex);
 	channel->active = false;
+	kinc_mutex_unlock(&mutex);
+	kinc_mutex_unlock(&callbackMutex);
+}
+
+void Audio3::setListener(vec3 position, vec3 forward, vec3 up, vec3 velocity) {
+	float f[3] = {forward.x(), forward.y(), forward.z()};
+	float u[3] = {up.x(), up.y(), up.z()};
+	float r[3];
+	normalize(f);
+	cross(f, u, r);
+	normalize(r);
+	cross(r, f, u);
+	kinc_mutex_lock(&mutex);
+	for (int i = 0; i < 3; ++i) {
+		listenerPosition[i] = position[i];
+		listenerForward[i] = f[i];
+		listenerRight[i] = r[i];
+		listenerUp[i] = u[i];
+		listenerVelocity[i] = velocity[i];
+	}
+	kinc_mutex_unlock(&mutex);
+}
+
+void Audio3::setSpeedOfSound(float unitsPerSecond) {
+	speedOfSound = unitsPerSecond;
+}
+
+void Audio3::setDopplerFactor(float factor) {
+	dopplerFactor = factor;
+}
+
+void Audio3::setPanning(Panning newPanning) {
+	kinc_mutex_lock(&mutex);
+	panning = newPanning;
+	for (int i = 0; i < channelCount; ++i) {
+		voices[i].started = false;
+	}
+	kinc_mutex_unlock(&mutex);
+}
+
+void Audio3::setHRTF(const float *left, const float *right, int directions, int length) {
+	if (left == nullptr || right == nullptr || directions <= 0 || length <= 0) {
+		kinc_log(KINC_LOG_LEVEL_ERROR, "Ignoring an HRTF with %i directions and %i samples.", directions, length);
+		return;
+	}
+	if (length > maxHRTFLength) length = maxHRTFLength;
+	int padded = (length + 3) & ~3;
+	float *data = createArray<float>(directions * 2 * padded, KINC_MEMORY_TAG_AUDIO);
+	for (int d = 0; d < directions; ++d) {
+		for (int ear = 0; ear < 2; ++ear) {
+			const float *impulse = (ear == 0 ? left : right) + d * length;
+			float *target = &data[(d * 2 + ear) * padded];
+			for (int j = 0; j < padded; ++j) {
+				int k = padded - 1 - j;
+				target[j] = k < length ? impulse[k] : 0.0f;
+			}
+		}
+	}
+	kinc_mutex_lock(&mutex);
+	destroyArray(hrtf);
+	hrtf = data;
+	hrtfDirections = directions;
+	hrtfLength = padded;
+	for (int i = 0; i < channelCount; ++i) {
+		if (voices[i].history == nullptr) {
+			voices[i].history = createArray<float>(maxHRTFLength, KINC_MEMORY_TAG_AUDIO);
+		}
+		voices[i].started = false;
+	}
+	kinc_mutex_unlock(&mutex);
+}
+
+void Audio3::setCullThreshold(float volume) {
+	cullThreshold = volume;
+}
+
+Audio3::Statistics Audio3::statistics() {
+	kinc_mutex_lock(&mutex);
+	Statistics copy = stats;
+	kinc_mutex_unlock(&mutex);
+	return copy;
 }
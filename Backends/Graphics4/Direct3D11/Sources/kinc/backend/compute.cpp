@@ -4,6 +4,7 @@
 #include <kinc/graphics4/texture.h>
 #include <kinc/log.h>
 #include <kinc/math/core.h>
+#include <kinc/memory.h>
 
 #include <kinc/backend/SystemMicrosoft.h>
 
@@ -173,7 +174,7 @@ void kinc_compute_shader_init(kinc_compute_shader_t *shader, void *_data, int le
 	}
 
 	shader->impl.length = (int)(length - index);
-	shader->impl.data = (uint8_t *)malloc(shader->impl.length);
+	shader->impl.data = (uint8_t *)kinc_memory_allocate(shader->impl.length, KINC_MEMORY_TAG_GRAPHICS);
 	assert(shader->impl.data != NULL);
 	memcpy(shader->impl.data, &data[index], shader->impl.length);
 
@@ -4,6 +4,7 @@
 #include <kinc/graphics4/shader.h>
 #include <kinc/graphics4/vertexbuffer.h>
 #include <kinc/log.h>
+#include <kinc/system.h>
 
 #include <kinc/backend/SystemMicrosoft.h>
 
@@ -425,6 +426,7 @@ namespace {
 }
 
 void kinc_g4_pipeline_compile(kinc_g4_pipeline *state) {
+	double start = kinc_time();
 	if (state->vertex_shader->impl.constantsSize > 0)
 		kinc_microsoft_affirm(device->CreateBuffer(&CD3D11_BUFFER_DESC(getMultipleOf16(state->vertex_shader->impl.constantsSize), D3D11_BIND_CONSTANT_BUFFER),
 		                                           nullptr, &state->impl.vertexConstantBuffer));
@@ -515,6 +517,55 @@ void kinc_g4_pipeline_compile(kinc_g4_pipeline *state) {
 				vertexDesc[i].Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 				++i;
 				break;
+			case KINC_G4_VERTEX_DATA_HALF2:
+				setVertexDesc(vertexDesc[i],
+				              getAttributeLocation(state->vertex_shader->impl.attributes, state->input_layout[stream]->elements[index].name, used), index,
+				              stream, state->input_layout[stream]->instanced);
+				vertexDesc[i].Format = DXGI_FORMAT_R16G16_FLOAT;
+				++i;
+				break;
+			case KINC_G4_VERTEX_DATA_HALF4:
+				setVertexDesc(vertexDesc[i],
+				              getAttributeLocation(state->vertex_shader->impl.attributes, state->input_layout[stream]->elements[index].name, used), index,
+				              stream, state->input_layout[stream]->instanced);
+				vertexDesc[i].Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+				++i;
+				break;
+			case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+				setVertexDesc(vertexDesc[i],
+				              getAttributeLocation(state->vertex_shader->impl.attributes, state->input_layout[stream]->elements[index].name, used), index,
+				              stream, state->input_layout[stream]->instanced);
+				vertexDesc[i].Format = DXGI_FORMAT_R8G8B8A8_SNORM;
+				++i;
+				break;
+			case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+				setVertexDesc(vertexDesc[i],
+				              getAttributeLocation(state->vertex_shader->impl.attributes, state->input_layout[stream]->elements[index].name, used), index,
+				              stream, state->input_layout[stream]->instanced);
+				vertexDesc[i].Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+				++i;
+				break;
+			case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+				setVertexDesc(vertexDesc[i],
+				              getAttributeLocation(state->vertex_shader->impl.attributes, state->input_layout[stream]->elements[index].name, used), index,
+				              stream, state->input_layout[stream]->instanced);
+				vertexDesc[i].Format = DXGI_FORMAT_R10G10B10A2_UNORM;
+				++i;
+				break;
+			case KINC_G4_VERTEX_DATA_SHORT2:
+				setVertexDesc(vertexDesc[i],
+				              getAttributeLocation(state->vertex_shader->impl.attributes, state->input_layout[stream]->elements[index].name, used), index,
+				              stream, state->input_layout[stream]->instanced);
+				vertexDesc[i].Format = DXGI_FORMAT_R16G16_SINT;
+				++i;
+				break;
+			case KINC_G4_VERTEX_DATA_SHORT4:
+				setVertexDesc(vertexDesc[i],
+				              getAttributeLocation(state->vertex_shader->impl.attributes, state->input_layout[stream]->elements[index].name, used), index,
+				              stream, state->input_layout[stream]->instanced);
+				vertexDesc[i].Format = DXGI_FORMAT_R16G16B16A16_SINT;
+				++i;
+				break;
 			case KINC_G4_VERTEX_DATA_FLOAT4X4:
 				char name[101];
 				strcpy(name, state->input_layout[stream]->elements[index].name);
@@ -608,4 +659,7 @@ void kinc_g4_pipeline_compile(kinc_g4_pipeline *state) {
 
 		device->CreateBlendState(&blendDesc, &state->impl.blendState);
 	}
+
+	// Direct3D 11 already returns the same state-objects for identical descriptions
+	kinc_g4_internal_pipeline_count_compilation(kinc_time() - start, false, false);
 }
@@ -2,6 +2,7 @@
 
 #include <Kore/Math/Core.h>
 #include <kinc/backend/SystemMicrosoft.h>
+#include <kinc/memory.h>
 
 #include "Direct3D11.h"
 
@@ -27,7 +28,7 @@ void kinc_g4_shader_destroy(kinc_g4_shader_t *shader) {
 			((ID3D11DomainShader *)shader->impl.shader)->Release();
 			break;
 		}
-		free(shader->impl.data);
+		kinc_memory_free(shader->impl.data);
 	}
 }
 
@@ -85,7 +86,7 @@ void kinc_g4_shader_init(kinc_g4_shader_t *shader, void *_data, size_t length, k
 	}
 
 	shader->impl.length = (int)(length - index);
-	shader->impl.data = (uint8_t *)malloc(shader->impl.length);
+	shader->impl.data = (uint8_t *)kinc_memory_allocate(shader->impl.length, KINC_MEMORY_TAG_GRAPHICS);
 	assert(shader->impl.data != NULL);
 	memcpy(shader->impl.data, &data[index], shader->impl.length);
 
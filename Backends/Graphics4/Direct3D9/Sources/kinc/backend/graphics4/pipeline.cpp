@@ -139,6 +139,40 @@ void kinc_g4_pipeline_compile(kinc_g4_pipeline_t *state) {
 				elements[i].Type = D3DDECLTYPE_D3DCOLOR;
 				stride += 4;
 				break;
+			case KINC_G4_VERTEX_DATA_HALF2:
+				elements[i].Type = D3DDECLTYPE_FLOAT16_2;
+				stride += 2 * 2;
+				break;
+			case KINC_G4_VERTEX_DATA_HALF4:
+				elements[i].Type = D3DDECLTYPE_FLOAT16_4;
+				stride += 2 * 4;
+				break;
+			case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+				// Direct3D 9 has no signed normalized bytes
+				kinc_log(KINC_LOG_LEVEL_WARNING, "BYTE4_NORM is not supported in Direct3D 9, %s is read as BYTE4_UNORM.",
+				         state->input_layout[stream]->elements[index].name);
+				elements[i].Type = D3DDECLTYPE_UBYTE4N;
+				stride += 4;
+				break;
+			case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+				elements[i].Type = D3DDECLTYPE_UBYTE4N;
+				stride += 4;
+				break;
+			case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+				// UDEC3 is not normalized and drops the 2 bit component
+				kinc_log(KINC_LOG_LEVEL_WARNING, "UINT10_10_10_2 is not normalized in Direct3D 9, %s is read as UDEC3.",
+				         state->input_layout[stream]->elements[index].name);
+				elements[i].Type = D3DDECLTYPE_UDEC3;
+				stride += 4;
+				break;
+			case KINC_G4_VERTEX_DATA_SHORT2:
+				elements[i].Type = D3DDECLTYPE_SHORT2;
+				stride += 2 * 2;
+				break;
+			case KINC_G4_VERTEX_DATA_SHORT4:
+				elements[i].Type = D3DDECLTYPE_SHORT4;
+				stride += 2 * 4;
+				break;
 			case KINC_G4_VERTEX_DATA_FLOAT4X4:
 				for (int i2 = 0; i2 < 4; ++i2) {
 					elements[i].Stream = stream;
@@ -37,6 +37,17 @@ void kinc_g4_vertex_buffer_init(kinc_g4_vertex_buffer_t *buffer, int count, kinc
 		case KINC_G4_VERTEX_DATA_FLOAT4X4:
 			buffer->impl.myStride += 4 * 4 * 4;
 			break;
+		case KINC_G4_VERTEX_DATA_HALF2:
+		case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+		case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+		case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+		case KINC_G4_VERTEX_DATA_SHORT2:
+			buffer->impl.myStride += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_HALF4:
+		case KINC_G4_VERTEX_DATA_SHORT4:
+			buffer->impl.myStride += 4 * 2;
+			break;
 		}
 	}
 
@@ -18,6 +18,7 @@
 #include <kinc/io/filereader.h>
 #include <kinc/math/core.h>
 #include <kinc/math/matrix.h>
+#include <kinc/profiler.h>
 #include <kinc/system.h>
 
 kinc_g5_command_list_t commandList;
@@ -69,10 +70,15 @@ static void startDraw() {
 	kinc_g5_command_list_set_fragment_constant_buffer(&commandList, &fragmentConstantBuffer, constantBufferIndex * constantBufferSize, constantBufferSize);
 }
 
+static int drawCalls = 0;
+
 static void endDraw() {
+	++drawCalls;
 	++constantBufferIndex;
 	if (constantBufferIndex >= constantBufferMultiply || waitAfterNextDraw) {
+		KINC_PROFILER_BEGIN("G5 submit");
 		kinc_g5_command_list_execute_and_wait(&commandList);
+		KINC_PROFILER_END();
 		constantBufferIndex = 0;
 		waitAfterNextDraw = false;
 	}
@@ -191,10 +197,12 @@ void kinc_g4_end(int window) {
 	kinc_g5_constant_buffer_unlock(&fragmentConstantBuffer);
 
 	kinc_g5_command_list_render_target_to_framebuffer_barrier(&commandList, &framebuffers[currentBuffer]);
+	KINC_PROFILER_BEGIN("G5 submit");
 	kinc_g5_command_list_end(&commandList);
 	// delete commandList;
 	// commandList = nullptr;
 	kinc_g5_end(window);
+	KINC_PROFILER_END();
 
 #ifndef KORE_VULKAN
 	kinc_g5_command_list_begin(&commandList);
@@ -206,7 +214,12 @@ void kinc_g4_end(int window) {
 }*/
 
 bool kinc_g4_swap_buffers() {
-	return kinc_g5_swap_buffers();
+	KINC_PROFILER_COUNTER("Draw calls", drawCalls);
+	drawCalls = 0;
+	KINC_PROFILER_BEGIN("Swap buffers");
+	bool result = kinc_g5_swap_buffers();
+	KINC_PROFILER_END();
+	return result;
 }
 
 void kinc_g4_flush() {
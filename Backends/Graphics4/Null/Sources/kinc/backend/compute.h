@@ -0,0 +1,13 @@
+#pragma once
+
+typedef struct {
+	int nothing;
+} kinc_compute_constant_location_impl_t;
+
+typedef struct {
+	int unit;
+} kinc_compute_texture_unit_impl_t;
+
+typedef struct {
+	int nothing;
+} kinc_compute_shader_impl_t;
@@ -0,0 +1,163 @@
+#include <kinc/graphics4/graphics.h>
+#include <kinc/graphics4/indexbuffer.h>
+#include <kinc/graphics4/pipeline.h>
+#include <kinc/graphics4/rendertarget.h>
+#include <kinc/graphics4/texture.h>
+#include <kinc/graphics4/texturearray.h>
+#include <kinc/graphics4/vertexbuffer.h>
+#include <kinc/profiler.h>
+#include <kinc/window.h>
+
+// Accepts everything and draws nothing so that applications run unchanged on machines without a GPU.
+
+static int draw_calls = 0;
+
+void kinc_internal_resize(int window, int width, int height) {}
+
+void kinc_internal_change_framebuffer(int window, kinc_framebuffer_options_t *frame) {}
+
+bool kinc_window_vsynced(int window) {
+	return false;
+}
+
+void kinc_g4_init(int window, int depth_buffer_bits, int stencil_buffer_bits, bool vsync) {}
+
+void kinc_g4_destroy(int window) {}
+
+void kinc_g4_flush(void) {}
+
+void kinc_g4_begin(int window) {}
+
+void kinc_g4_end(int window) {}
+
+bool kinc_g4_swap_buffers(void) {
+	KINC_PROFILER_COUNTER("Draw calls", draw_calls);
+	draw_calls = 0;
+	return true;
+}
+
+void kinc_g4_clear(unsigned flags, unsigned color, float depth, int stencil) {}
+
+void kinc_g4_viewport(int x, int y, int width, int height) {}
+
+void kinc_g4_scissor(int x, int y, int width, int height) {}
+
+void kinc_g4_disable_scissor(void) {}
+
+void kinc_g4_draw_indexed_vertices(void) {
+	++draw_calls;
+}
+
+void kinc_g4_draw_indexed_vertices_from_to(int start, int count) {
+	++draw_calls;
+}
+
+void kinc_g4_draw_indexed_vertices_from_to_from(int start, int count, int vertex_offset) {
+	++draw_calls;
+}
+
+void kinc_g4_draw_indexed_vertices_instanced(int instanceCount) {
+	++draw_calls;
+}
+
+void kinc_g4_draw_indexed_vertices_instanced_from_to(int instanceCount, int start, int count) {
+	++draw_calls;
+}
+
+void kinc_g4_set_texture_addressing(kinc_g4_texture_unit_t unit, kinc_g4_texture_direction_t dir, kinc_g4_texture_addressing_t addressing) {}
+
+void kinc_g4_set_texture3d_addressing(kinc_g4_texture_unit_t unit, kinc_g4_texture_direction_t dir, kinc_g4_texture_addressing_t addressing) {}
+
+void kinc_g4_set_pipeline(kinc_g4_pipeline_t *pipeline) {}
+
+void kinc_g4_set_stencil_reference_value(int value) {}
+
+void kinc_g4_set_texture_operation(kinc_g4_texture_operation_t operation, kinc_g4_texture_argument_t arg1, kinc_g4_texture_argument_t arg2) {}
+
+void kinc_g4_set_int(kinc_g4_constant_location_t location, int value) {}
+
+void kinc_g4_set_int2(kinc_g4_constant_location_t location, int value1, int value2) {}
+
+void kinc_g4_set_int3(kinc_g4_constant_location_t location, int value1, int value2, int value3) {}
+
+void kinc_g4_set_int4(kinc_g4_constant_location_t location, int value1, int value2, int value3, int value4) {}
+
+void kinc_g4_set_ints(kinc_g4_constant_location_t location, int *values, int count) {}
+
+void kinc_g4_set_float(kinc_g4_constant_location_t location, float value) {}
+
+void kinc_g4_set_float2(kinc_g4_constant_location_t location, float value1, float value2) {}
+
+void kinc_g4_set_float3(kinc_g4_constant_location_t location, float value1, float value2, float value3) {}
+
+void kinc_g4_set_float4(kinc_g4_constant_location_t location, float value1, float value2, float value3, float value4) {}
+
+void kinc_g4_set_floats(kinc_g4_constant_location_t location, float *values, int count) {}
+
+void kinc_g4_set_bool(kinc_g4_constant_location_t location, bool value) {}
+
+void kinc_g4_set_matrix3(kinc_g4_constant_location_t location, kinc_matrix3x3_t *value) {}
+
+void kinc_g4_set_matrix4(kinc_g4_constant_location_t location, kinc_matrix4x4_t *value) {}
+
+void kinc_g4_set_texture_magnification_filter(kinc_g4_texture_unit_t unit, kinc_g4_texture_filter_t filter) {}
+
+void kinc_g4_set_texture3d_magnification_filter(kinc_g4_texture_unit_t texunit, kinc_g4_texture_filter_t filter) {}
+
+void kinc_g4_set_texture_minification_filter(kinc_g4_texture_unit_t unit, kinc_g4_texture_filter_t filter) {}
+
+void kinc_g4_set_texture3d_minification_filter(kinc_g4_texture_unit_t texunit, kinc_g4_texture_filter_t filter) {}
+
+void kinc_g4_set_texture_mipmap_filter(kinc_g4_texture_unit_t unit, kinc_g4_mipmap_filter_t filter) {}
+
+void kinc_g4_set_texture3d_mipmap_filter(kinc_g4_texture_unit_t texunit, kinc_g4_mipmap_filter_t filter) {}
+
+void kinc_g4_set_texture_compare_mode(kinc_g4_texture_unit_t unit, bool enabled) {}
+
+void kinc_g4_set_cubemap_compare_mode(kinc_g4_texture_unit_t unit, bool enabled) {}
+
+int kinc_g4_max_bound_textures(void) {
+	return 16;
+}
+
+bool kinc_g4_render_targets_inverted_y(void) {
+	return false;
+}
+
+bool kinc_g4_non_pow2_textures_supported(void) {
+	return true;
+}
+
+void kinc_g4_restore_render_target(void) {}
+
+void kinc_g4_set_render_targets(kinc_g4_render_target_t **targets, int count) {}
+
+void kinc_g4_set_render_target_face(kinc_g4_render_target_t *texture, int face) {}
+
+void kinc_g4_set_texture(kinc_g4_texture_unit_t unit, kinc_g4_texture_t *texture) {}
+
+void kinc_g4_set_image_texture(kinc_g4_texture_unit_t unit, kinc_g4_texture_t *texture) {}
+
+bool kinc_g4_init_occlusion_query(unsigned *occlusionQuery) {
+	return false;
+}
+
+void kinc_g4_delete_occlusion_query(unsigned occlusionQuery) {}
+
+void kinc_g4_start_occlusion_query(unsigned occlusionQuery) {}
+
+void kinc_g4_end_occlusion_query(unsigned occlusionQuery) {}
+
+bool kinc_g4_are_query_results_available(unsigned occlusionQuery) {
+	return true;
+}
+
+void kinc_g4_get_query_results(unsigned occlusionQuery, unsigned *pixelCount) {
+	*pixelCount = 0;
+}
+
+void kinc_g4_set_texture_array(kinc_g4_texture_unit_t unit, kinc_g4_texture_array_t *array) {}
+
+void kinc_g4_set_index_buffer(kinc_g4_index_buffer_t *buffer) {}
+
+void kinc_g4_set_vertex_buffers(kinc_g4_vertex_buffer_t **buffers, int count) {}
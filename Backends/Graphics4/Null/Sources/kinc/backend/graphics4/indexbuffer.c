@@ -0,0 +1,24 @@
+#include <kinc/graphics4/indexbuffer.h>
+#include <kinc/memory.h>
+
+#include <stdlib.h>
+
+void kinc_g4_index_buffer_init(kinc_g4_index_buffer_t *buffer, int count, kinc_g4_index_buffer_format_t format, kinc_g4_usage_t usage) {
+	buffer->impl.count = count;
+	buffer->impl.data = (int *)kinc_memory_allocate(count * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+}
+
+void kinc_g4_index_buffer_destroy(kinc_g4_index_buffer_t *buffer) {
+	kinc_memory_free(buffer->impl.data);
+	buffer->impl.data = NULL;
+}
+
+int *kinc_g4_index_buffer_lock(kinc_g4_index_buffer_t *buffer) {
+	return buffer->impl.data;
+}
+
+void kinc_g4_index_buffer_unlock(kinc_g4_index_buffer_t *buffer) {}
+
+int kinc_g4_index_buffer_count(kinc_g4_index_buffer_t *buffer) {
+	return buffer->impl.count;
+}
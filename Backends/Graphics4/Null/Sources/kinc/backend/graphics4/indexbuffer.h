@@ -0,0 +1,14 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	int *data;
+	int count;
+} kinc_g4_index_buffer_impl_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,24 @@
+#include <kinc/graphics4/pipeline.h>
+
+#include <string.h>
+
+void kinc_g4_pipeline_init(kinc_g4_pipeline_t *pipeline) {
+	memset(pipeline, 0, sizeof(kinc_g4_pipeline_t));
+	kinc_g4_internal_pipeline_set_defaults(pipeline);
+}
+
+void kinc_g4_pipeline_destroy(kinc_g4_pipeline_t *pipeline) {}
+
+void kinc_g4_pipeline_compile(kinc_g4_pipeline_t *pipeline) {}
+
+kinc_g4_constant_location_t kinc_g4_pipeline_get_constant_location(kinc_g4_pipeline_t *pipeline, const char *name) {
+	kinc_g4_constant_location_t location;
+	location.impl.nothing = 0;
+	return location;
+}
+
+kinc_g4_texture_unit_t kinc_g4_pipeline_get_texture_unit(kinc_g4_pipeline_t *pipeline, const char *name) {
+	kinc_g4_texture_unit_t unit;
+	unit.impl.unit = 0;
+	return unit;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	int nothing;
+} kinc_g4_pipeline_impl_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+#include <kinc/graphics4/rendertarget.h>
+
+#include <string.h>
+
+static int pixel_size(kinc_g4_render_target_format_t format) {
+	switch (format) {
+	case KINC_G4_RENDER_TARGET_FORMAT_128BIT_FLOAT:
+		return 16;
+	case KINC_G4_RENDER_TARGET_FORMAT_64BIT_FLOAT:
+		return 8;
+	case KINC_G4_RENDER_TARGET_FORMAT_8BIT_RED:
+		return 1;
+	case KINC_G4_RENDER_TARGET_FORMAT_16BIT_DEPTH:
+	case KINC_G4_RENDER_TARGET_FORMAT_16BIT_RED_FLOAT:
+		return 2;
+	case KINC_G4_RENDER_TARGET_FORMAT_32BIT_RED_FLOAT:
+	case KINC_G4_RENDER_TARGET_FORMAT_32BIT:
+	default:
+		return 4;
+	}
+}
+
+void kinc_g4_render_target_init(kinc_g4_render_target_t *renderTarget, int width, int height, int depthBufferBits, bool antialiasing,
+                                kinc_g4_render_target_format_t format, int stencilBufferBits, int contextId) {
+	renderTarget->width = width;
+	renderTarget->height = height;
+	renderTarget->texWidth = width;
+	renderTarget->texHeight = height;
+	renderTarget->contextId = contextId;
+	renderTarget->isCubeMap = false;
+	renderTarget->isDepthAttachment = false;
+	renderTarget->impl.format = (int)format;
+}
+
+void kinc_g4_render_target_init_cube(kinc_g4_render_target_t *renderTarget, int cubeMapSize, int depthBufferBits, bool antialiasing,
+                                     kinc_g4_render_target_format_t format, int stencilBufferBits, int contextId) {
+	kinc_g4_render_target_init(renderTarget, cubeMapSize, cubeMapSize, depthBufferBits, antialiasing, format, stencilBufferBits, contextId);
+	renderTarget->isCubeMap = true;
+}
+
+void kinc_g4_render_target_destroy(kinc_g4_render_target_t *renderTarget) {}
+
+void kinc_g4_render_target_use_color_as_texture(kinc_g4_render_target_t *renderTarget, kinc_g4_texture_unit_t unit) {}
+
+void kinc_g4_render_target_use_depth_as_texture(kinc_g4_render_target_t *renderTarget, kinc_g4_texture_unit_t unit) {}
+
+void kinc_g4_render_target_set_depth_stencil_from(kinc_g4_render_target_t *renderTarget, kinc_g4_render_target_t *source) {}
+
+void kinc_g4_render_target_get_pixels(kinc_g4_render_target_t *renderTarget, uint8_t *data) {
+	memset(data, 0, (size_t)renderTarget->texWidth * renderTarget->texHeight * pixel_size((kinc_g4_render_target_format_t)renderTarget->impl.format));
+}
+
+void kinc_g4_render_target_generate_mipmaps(kinc_g4_render_target_t *renderTarget, int levels) {}
@@ -0,0 +1,7 @@
+#include <kinc/graphics4/shader.h>
+
+void kinc_g4_shader_init(kinc_g4_shader_t *shader, void *data, size_t length, kinc_g4_shader_type_t type) {}
+
+void kinc_g4_shader_init_from_source(kinc_g4_shader_t *shader, const char *source, kinc_g4_shader_type_t type) {}
+
+void kinc_g4_shader_destroy(kinc_g4_shader_t *shader) {}
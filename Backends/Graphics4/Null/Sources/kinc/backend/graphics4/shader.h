@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	int nothing;
+} kinc_g4_shader_impl_t;
+
+typedef struct {
+	int nothing;
+} kinc_g4_constant_location_impl_t;
+
+typedef struct {
+	int unit;
+} kinc_g4_texture_unit_impl_t;
+
+#ifdef __cplusplus
+}
+#endif
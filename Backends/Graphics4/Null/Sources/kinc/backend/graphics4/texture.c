@@ -0,0 +1,68 @@
+#include <kinc/graphics4/texture.h>
+#include <kinc/image.h>
+#include <kinc/memory.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+static void allocate(kinc_g4_texture_t *texture, int width, int height, int depth, kinc_image_format_t format) {
+	texture->tex_width = width;
+	texture->tex_height = height;
+	texture->tex_depth = depth;
+	texture->format = format;
+	texture->impl.data = (uint8_t *)kinc_memory_allocate_zeroed((size_t)width * height * depth * kinc_image_format_sizeof(format), KINC_MEMORY_TAG_GRAPHICS);
+}
+
+void kinc_g4_texture_init(kinc_g4_texture_t *texture, int width, int height, kinc_image_format_t format) {
+	allocate(texture, width, height, 1, format);
+}
+
+void kinc_g4_texture_init3d(kinc_g4_texture_t *texture, int width, int height, int depth, kinc_image_format_t format) {
+	allocate(texture, width, height, depth, format);
+}
+
+void kinc_g4_texture_init_from_image(kinc_g4_texture_t *texture, kinc_image_t *image) {
+	allocate(texture, image->width, image->height, 1, image->format);
+	if (image->compression == KINC_IMAGE_COMPRESSION_NONE && image->data != NULL) {
+		memcpy(texture->impl.data, image->data, (size_t)image->width * image->height * kinc_image_format_sizeof(image->format));
+	}
+}
+
+void kinc_g4_texture_init_from_image3d(kinc_g4_texture_t *texture, kinc_image_t *image) {
+	allocate(texture, image->width, image->height, image->depth, image->format);
+	if (image->compression == KINC_IMAGE_COMPRESSION_NONE && image->data != NULL) {
+		memcpy(texture->impl.data, image->data, (size_t)image->width * image->height * image->depth * kinc_image_format_sizeof(image->format));
+	}
+}
+
+void kinc_g4_texture_init_from_id(kinc_g4_texture_t *texture, unsigned texid) {
+	allocate(texture, 1, 1, 1, KINC_IMAGE_FORMAT_RGBA32);
+}
+
+void kinc_g4_texture_destroy(kinc_g4_texture_t *texture) {
+	kinc_memory_free(texture->impl.data);
+	texture->impl.data = NULL;
+}
+
+unsigned char *kinc_g4_texture_lock(kinc_g4_texture_t *texture) {
+	return texture->impl.data;
+}
+
+void kinc_g4_texture_unlock(kinc_g4_texture_t *texture) {}
+
+void kinc_g4_texture_clear(kinc_g4_texture_t *texture, int x, int y, int z, int width, int height, int depth, unsigned color) {}
+
+void kinc_g4_texture_generate_mipmaps(kinc_g4_texture_t *texture, int levels) {}
+
+void kinc_g4_texture_set_mipmap(kinc_g4_texture_t *texture, kinc_image_t *mipmap, int level) {}
+
+int kinc_g4_texture_stride(kinc_g4_texture_t *texture) {
+	return texture->tex_width * kinc_image_format_sizeof(texture->format);
+}
+
+void kinc_g4_texture_upload(kinc_g4_texture_t *texture, uint8_t *data, int stride) {
+	int row = kinc_g4_texture_stride(texture);
+	for (int y = 0; y < texture->tex_height; ++y) {
+		memcpy(&texture->impl.data[y * row], &data[y * stride], row);
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	uint8_t *data;
+} kinc_g4_texture_impl_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,7 @@
+#include <kinc/graphics4/texturearray.h>
+
+void kinc_g4_texture_array_init(kinc_g4_texture_array_t *array, kinc_image_t *images, int count) {
+	array->impl.count = count;
+}
+
+void kinc_g4_texture_array_destroy(kinc_g4_texture_array_t *array) {}
@@ -0,0 +1,13 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	int count;
+} kinc_g4_texture_array_impl_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,73 @@
+#include <kinc/graphics4/vertexbuffer.h>
+#include <kinc/memory.h>
+
+#include <stdlib.h>
+
+static int element_size(kinc_g4_vertex_data_t data) {
+	switch (data) {
+	case KINC_G4_VERTEX_DATA_COLOR:
+	case KINC_G4_VERTEX_DATA_FLOAT1:
+	case KINC_G4_VERTEX_DATA_HALF2:
+	case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+	case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+	case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+	case KINC_G4_VERTEX_DATA_SHORT2:
+		return 4;
+	case KINC_G4_VERTEX_DATA_FLOAT2:
+		return 2 * 4;
+	case KINC_G4_VERTEX_DATA_FLOAT3:
+		return 3 * 4;
+	case KINC_G4_VERTEX_DATA_FLOAT4:
+		return 4 * 4;
+	case KINC_G4_VERTEX_DATA_FLOAT4X4:
+		return 4 * 4 * 4;
+	case KINC_G4_VERTEX_DATA_SHORT2_NORM:
+		return 2 * 2;
+	case KINC_G4_VERTEX_DATA_SHORT4_NORM:
+	case KINC_G4_VERTEX_DATA_HALF4:
+	case KINC_G4_VERTEX_DATA_SHORT4:
+		return 4 * 2;
+	case KINC_G4_VERTEX_DATA_NONE:
+	default:
+		return 0;
+	}
+}
+
+void kinc_g4_vertex_buffer_init(kinc_g4_vertex_buffer_t *buffer, int count, kinc_g4_vertex_structure_t *structure, kinc_g4_usage_t usage,
+                                int instance_data_step_rate) {
+	buffer->impl.count = count;
+	buffer->impl.stride = 0;
+	for (int i = 0; i < structure->size; ++i) {
+		buffer->impl.stride += element_size(structure->elements[i].data);
+	}
+	buffer->impl.data = (float *)kinc_memory_allocate(count * buffer->impl.stride, KINC_MEMORY_TAG_GRAPHICS);
+}
+
+void kinc_g4_vertex_buffer_destroy(kinc_g4_vertex_buffer_t *buffer) {
+	kinc_memory_free(buffer->impl.data);
+	buffer->impl.data = NULL;
+}
+
+float *kinc_g4_vertex_buffer_lock_all(kinc_g4_vertex_buffer_t *buffer) {
+	return buffer->impl.data;
+}
+
+float *kinc_g4_vertex_buffer_lock(kinc_g4_vertex_buffer_t *buffer, int start, int count) {
+	return (float *)((uint8_t *)buffer->impl.data + start * buffer->impl.stride);
+}
+
+void kinc_g4_vertex_buffer_unlock_all(kinc_g4_vertex_buffer_t *buffer) {}
+
+void kinc_g4_vertex_buffer_unlock(kinc_g4_vertex_buffer_t *buffer, int count) {}
+
+int kinc_g4_vertex_buffer_count(kinc_g4_vertex_buffer_t *buffer) {
+	return buffer->impl.count;
+}
+
+int kinc_g4_vertex_buffer_stride(kinc_g4_vertex_buffer_t *buffer) {
+	return buffer->impl.stride;
+}
+
+int kinc_internal_g4_vertex_buffer_set(kinc_g4_vertex_buffer_t *buffer, int offset) {
+	return 0;
+}
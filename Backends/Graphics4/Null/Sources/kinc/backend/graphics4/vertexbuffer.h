@@ -0,0 +1,15 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	float *data;
+	int count;
+	int stride;
+} kinc_g4_vertex_buffer_impl_t;
+
+#ifdef __cplusplus
+}
+#endif
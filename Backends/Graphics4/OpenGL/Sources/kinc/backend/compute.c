@@ -1,4 +1,5 @@
 #include <kinc/backend/graphics4/ogl.h>
+#include <kinc/backend/graphics4/state.h>
 
 #include <kinc/compute/compute.h>
 #include <kinc/graphics4/graphics.h>
@@ -7,6 +8,7 @@
 #include <kinc/image.h>
 #include <kinc/log.h>
 #include <kinc/math/core.h>
+#include <kinc/memory.h>
 
 #include <stdio.h>
 #include <string.h>
@@ -131,7 +133,7 @@ static void setMinMipFilters(GLenum target, int unit) {
 void kinc_compute_shader_init(kinc_compute_shader_t *shader, void *source, int length) {
 	shader->impl._length = length;
 	shader->impl.textureCount = 0;
-	shader->impl._source = (char *)malloc(sizeof(char) * (length + 1));
+	shader->impl._source = (char *)kinc_memory_allocate(sizeof(char) * (length + 1), KINC_MEMORY_TAG_GRAPHICS);
 	for (int i = 0; i < length; ++i) {
 		shader->impl._source[i] = ((char *)source)[i];
 	}
@@ -148,10 +150,10 @@ void kinc_compute_shader_init(kinc_compute_shader_t *shader, void *source, int l
 	if (result != GL_TRUE) {
 		int length;
 		glGetShaderiv(shader->impl._id, GL_INFO_LOG_LENGTH, &length);
-		char *errormessage = (char *)malloc(sizeof(char) * length);
+		char *errormessage = (char *)kinc_memory_allocate(sizeof(char) * length, KINC_MEMORY_TAG_GRAPHICS);
 		glGetShaderInfoLog(shader->impl._id, length, NULL, errormessage);
 		kinc_log(KINC_LOG_LEVEL_ERROR, "GLSL compiler error: %s\n", errormessage);
-		free(errormessage);
+		kinc_memory_free(errormessage);
 	}
 
 	shader->impl._programid = glCreateProgram();
@@ -162,26 +164,27 @@ void kinc_compute_shader_init(kinc_compute_shader_t *shader, void *source, int l
 	if (result != GL_TRUE) {
 		int length;
 		glGetProgramiv(shader->impl._programid, GL_INFO_LOG_LENGTH, &length);
-		char *errormessage = (char *)malloc(sizeof(char) * length);
+		char *errormessage = (char *)kinc_memory_allocate(sizeof(char) * length, KINC_MEMORY_TAG_GRAPHICS);
 		glGetProgramInfoLog(shader->impl._programid, length, NULL, errormessage);
 		kinc_log(KINC_LOG_LEVEL_ERROR, "GLSL linker error: %s\n", errormessage);
-		free(errormessage);
+		kinc_memory_free(errormessage);
 	}
 #endif
 
 	// TODO: Get rid of allocations
-	shader->impl.textures = (char **)malloc(sizeof(char *) * 16);
+	shader->impl.textures = (char **)kinc_memory_allocate(sizeof(char *) * 16, KINC_MEMORY_TAG_GRAPHICS);
 	for (int i = 0; i < 16; ++i) {
-		shader->impl.textures[i] = (char *)malloc(sizeof(char) * 128);
+		shader->impl.textures[i] = (char *)kinc_memory_allocate(sizeof(char) * 128, KINC_MEMORY_TAG_GRAPHICS);
 		shader->impl.textures[i][0] = 0;
 	}
-	shader->impl.textureValues = (int *)malloc(sizeof(int) * 16);
+	shader->impl.textureValues = (int *)kinc_memory_allocate(sizeof(int) * 16, KINC_MEMORY_TAG_GRAPHICS);
 }
 
 void kinc_compute_shader_destroy(kinc_compute_shader_t *shader) {
-	free(shader->impl._source);
+	kinc_memory_free(shader->impl._source);
 	shader->impl._source = NULL;
 #ifdef HAS_COMPUTE
+	kinc_g4_internal_gl_forget_program(shader->impl._programid);
 	glDeleteProgram(shader->impl._programid);
 	glDeleteShader(shader->impl._id);
 #endif
@@ -426,8 +429,7 @@ void kinc_compute_set_texture3d_mipmap_filter(kinc_compute_texture_unit_t unit,
 
 void kinc_compute_set_shader(kinc_compute_shader_t *shader) {
 #ifdef HAS_COMPUTE
-	glUseProgram(shader->impl._programid);
-	glCheckErrors();
+	kinc_g4_internal_gl_use_program(shader->impl._programid);
 #endif
 }
 
@@ -12,10 +12,12 @@
 #include <kinc/error.h>
 #include <kinc/log.h>
 #include <kinc/math/core.h>
+#include <kinc/profiler.h>
 #include <kinc/system.h>
 #include <kinc/window.h>
 
 #include "OpenGLWindow.h"
+#include "state.h"
 
 #ifdef KORE_WINDOWS
 #include <kinc/backend/Windows.h>
@@ -66,6 +68,14 @@ extern "C" bool Kinc_Internal_SupportsConservativeRaster;
 bool Kinc_Internal_SupportsConservativeRaster = false;
 extern "C" bool Kinc_Internal_SupportsDepthTexture;
 bool Kinc_Internal_SupportsDepthTexture = true;
+extern "C" bool Kinc_Internal_SupportsVertexArrayObjects;
+bool Kinc_Internal_SupportsVertexArrayObjects = false;
+extern "C" unsigned Kinc_Internal_DefaultVertexArray;
+unsigned Kinc_Internal_DefaultVertexArray = 0;
+extern "C" bool Kinc_Internal_SupportsBufferStorage;
+bool Kinc_Internal_SupportsBufferStorage = false;
+extern "C" bool Kinc_Internal_SupportsBufferMapping;
+bool Kinc_Internal_SupportsBufferMapping = false;
 
 #if defined(KORE_OPENGL_ES) && defined(KORE_ANDROID) && KORE_ANDROID_API >= 18
 extern "C" void *glesVertexAttribDivisor;
@@ -119,12 +129,16 @@ extern "C" void kinc_internal_change_framebuffer(int window, kinc_framebuffer_op
 #endif
 }
 
+extern "C" void Kinc_G4_Internal_SetVertexArrayContext(int context, unsigned defaultVertexArray);
+extern "C" void Kinc_G4_Internal_ForgetVertexArrayContext(int context);
+
 void kinc_g4_destroy(int window) {
 #ifdef KORE_WINDOWS
 	if (Kinc_Internal_windows[window].glContext) {
 		assert(wglMakeCurrent(nullptr, nullptr));
 		assert(wglDeleteContext(Kinc_Internal_windows[window].glContext));
 		Kinc_Internal_windows[window].glContext = nullptr;
+		Kinc_G4_Internal_ForgetVertexArrayContext(window);
 	}
 
 	HWND windowHandle = kinc_windows_window_handle(window);
@@ -159,6 +173,7 @@ void kinc_g4_init(int windowId, int depthBufferBits, int stencilBufferBits, bool
 #endif
 
 	initGLState(windowId);
+	kinc_g4_internal_gl_state_reset();
 
 #ifdef KORE_WINDOWS
 	if (windowId == 0) {
@@ -194,6 +209,9 @@ void kinc_g4_init(int windowId, int depthBufferBits, int stencilBufferBits, bool
 		if (extension != nullptr && strcmp(extension, "GL_NV_conservative_raster") == 0) {
 			Kinc_Internal_SupportsConservativeRaster = true;
 		}
+		if (extension != nullptr && strcmp(extension, "GL_ARB_buffer_storage") == 0) {
+			Kinc_Internal_SupportsBufferStorage = true;
+		}
 	}
 	maxColorAttachments = 8;
 #endif
@@ -223,15 +241,18 @@ void kinc_g4_init(int windowId, int depthBufferBits, int stencilBufferBits, bool
 		minor = 0;
 	}
 	int gl_version = major * 100 + minor * 10;
+	Kinc_Internal_SupportsBufferMapping = gl_version >= 310;
+	if (gl_version >= 440) {
+		Kinc_Internal_SupportsBufferStorage = true;
+	}
 #endif
 
 #if defined(KORE_LINUX) || defined(KORE_MACOS)
 	if (gl_version >= 300) {
-		unsigned vertexArray;
-		glGenVertexArrays(1, &vertexArray);
-		glCheckErrors();
-		glBindVertexArray(vertexArray);
+		glGenVertexArrays(1, &Kinc_Internal_DefaultVertexArray);
 		glCheckErrors();
+		kinc_g4_internal_gl_bind_vertex_array(Kinc_Internal_DefaultVertexArray);
+		Kinc_Internal_SupportsVertexArrayObjects = true;
 	}
 #endif
 }
@@ -340,11 +361,17 @@ void kinc_g4_set_matrix3(kinc_g4_constant_location_t location, kinc_matrix3x3_t
 
 extern "C" kinc_g4_index_buffer_t *Kinc_Internal_CurrentIndexBuffer;
 
+extern "C" void Kinc_G4_Internal_ApplyVertexBuffers(void);
+
+static int drawCalls = 0;
+
 void kinc_g4_draw_indexed_vertices() {
 	kinc_g4_draw_indexed_vertices_from_to(0, kinc_g4_index_buffer_count(Kinc_Internal_CurrentIndexBuffer));
 }
 
 void kinc_g4_draw_indexed_vertices_from_to(int start, int count) {
+	++drawCalls;
+	Kinc_G4_Internal_ApplyVertexBuffers();
 #ifdef KORE_OPENGL_ES
 	if (Kinc_Internal_CurrentIndexBuffer->impl.shortData != NULL) {
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, (void *)(start * sizeof(uint16_t)));
@@ -366,6 +393,8 @@ void kinc_g4_draw_indexed_vertices_from_to(int start, int count) {
 }
 
 void kinc_g4_draw_indexed_vertices_from_to_from(int start, int count, int vertex_offset) {
+	++drawCalls;
+	Kinc_G4_Internal_ApplyVertexBuffers();
 #ifdef KORE_OPENGL_ES
 	if (Kinc_Internal_CurrentIndexBuffer->impl.shortData != NULL) {
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, (void *)(start * sizeof(uint16_t)));
@@ -391,6 +420,8 @@ void kinc_g4_draw_indexed_vertices_instanced(int instanceCount) {
 }
 
 void kinc_g4_draw_indexed_vertices_instanced_from_to(int instanceCount, int start, int count) {
+	++drawCalls;
+	Kinc_G4_Internal_ApplyVertexBuffers();
 #if defined(KORE_OPENGL_ES) && defined(KORE_ANDROID) && KORE_ANDROID_API >= 18
 	((void (*)(GLenum, GLsizei, GLenum, void *, GLsizei))glesDrawElementsInstanced)(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void *)(start * sizeof(uint32_t)),
 	                                                                                instanceCount);
@@ -423,16 +454,21 @@ void swapBuffersiOS();
 #endif
 
 bool kinc_g4_swap_buffers() {
+	KINC_PROFILER_COUNTER("Draw calls", drawCalls);
+	drawCalls = 0;
+	KINC_PROFILER_BEGIN("Swap buffers");
 #ifdef KORE_WINDOWS
 	for (int i = 9; i >= 0; --i) {
 		if (Kinc_Internal_windows[i].deviceContext != nullptr) {
 			wglMakeCurrent(Kinc_Internal_windows[i].deviceContext, Kinc_Internal_windows[i].glContext);
+			Kinc_G4_Internal_SetVertexArrayContext(i, i == 0 ? 0 : Kinc_Internal_windows[i].vertexArray);
 			if (i != 0) {
 				Kinc_Internal_blitWindowContent(i);
 			}
 			::SwapBuffers(Kinc_Internal_windows[i].deviceContext);
 		}
 	}
+	kinc_g4_internal_gl_state_reset();
 #elif defined(KORE_ANDROID)
 	androidSwapBuffers();
 #elif defined(KORE_LINUX)
@@ -442,6 +478,7 @@ bool kinc_g4_swap_buffers() {
 #elif defined(KORE_IOS)
 	swapBuffersiOS();
 #endif
+	KINC_PROFILER_END();
 	return true;
 }
 
@@ -474,7 +511,7 @@ static bool scissor_on = false;
 
 void kinc_g4_scissor(int x, int y, int width, int height) {
 	scissor_on = true;
-	glEnable(GL_SCISSOR_TEST);
+	kinc_g4_internal_gl_enable(GL_SCISSOR_TEST, true);
 	if (renderToBackbuffer) {
 		glScissor(x, _renderTargetHeight - y - height, width, height);
 	}
@@ -485,7 +522,7 @@ void kinc_g4_scissor(int x, int y, int width, int height) {
 
 void kinc_g4_disable_scissor() {
 	scissor_on = false;
-	glDisable(GL_SCISSOR_TEST);
+	kinc_g4_internal_gl_enable(GL_SCISSOR_TEST, false);
 }
 
 void kinc_g4_end(int windowId) {
@@ -494,15 +531,13 @@ void kinc_g4_end(int windowId) {
 }
 
 void kinc_g4_clear(unsigned flags, unsigned color, float depth, int stencil) {
-	glColorMask(true, true, true, true);
-	glCheckErrors();
+	kinc_g4_internal_gl_color_mask(-1, true, true, true, true);
 	glClearColor(((color & 0x00ff0000) >> 16) / 255.0f, ((color & 0x0000ff00) >> 8) / 255.0f, (color & 0x000000ff) / 255.0f,
 	             ((color & 0xff000000) >> 24) / 255.0f);
 	glCheckErrors();
 	if (flags & KINC_G4_CLEAR_DEPTH) {
-		glEnable(GL_DEPTH_TEST);
-		glDepthMask(GL_TRUE);
-		glCheckErrors();
+		kinc_g4_internal_gl_enable(GL_DEPTH_TEST, true);
+		kinc_g4_internal_gl_depth_mask(true);
 	}
 #ifdef KORE_OPENGL_ES
 	glClearDepthf(depth);
@@ -510,22 +545,21 @@ void kinc_g4_clear(unsigned flags, unsigned color, float depth, int stencil) {
 	glClearDepth(depth);
 #endif
 	glCheckErrors();
-	glStencilMask(0xff);
-	glCheckErrors();
+	kinc_g4_internal_gl_stencil_mask(0xff);
 	glClearStencil(stencil);
 	glCheckErrors();
 	GLbitfield oglflags = ((flags & KINC_G4_CLEAR_COLOR) ? GL_COLOR_BUFFER_BIT : 0) | ((flags & KINC_G4_CLEAR_DEPTH) ? GL_DEPTH_BUFFER_BIT : 0) |
 	                      ((flags & KINC_G4_CLEAR_STENCIL) ? GL_STENCIL_BUFFER_BIT : 0);
 
 	if (scissor_on) {
-		glDisable(GL_SCISSOR_TEST);
+		kinc_g4_internal_gl_enable(GL_SCISSOR_TEST, false);
 	}
 
 	glClear(oglflags);
 	glCheckErrors();
 
 	if (scissor_on) {
-		glEnable(GL_SCISSOR_TEST);
+		kinc_g4_internal_gl_enable(GL_SCISSOR_TEST, true);
 	}
 
 	if (lastPipeline != nullptr) {
@@ -533,11 +567,10 @@ void kinc_g4_clear(unsigned flags, unsigned color, float depth, int stencil) {
 	}
 }
 
+extern "C" void Kinc_G4_Internal_SetVertexBuffers(kinc_g4_vertex_buffer_t **buffers, int count);
+
 void kinc_g4_set_vertex_buffers(kinc_g4_vertex_buffer_t **vertexBuffers, int count) {
-	int offset = 0;
-	for (int i = 0; i < count; ++i) {
-		offset += kinc_internal_g4_vertex_buffer_set(vertexBuffers[i], offset);
-	}
+	Kinc_G4_Internal_SetVertexBuffers(vertexBuffers, count);
 }
 
 void kinc_g4_set_index_buffer(kinc_g4_index_buffer_t *indexBuffer) {
@@ -844,6 +877,7 @@ void kinc_g4_delete_occlusion_query(unsigned occlusionQuery) {
 #endif
 
 void kinc_g4_render_occlusion_query(unsigned occlusionQuery, int triangles) {
+	Kinc_G4_Internal_ApplyVertexBuffers();
 	glBeginQuery(SAMPLES_PASSED, occlusionQuery);
 	glDrawArrays(GL_TRIANGLES, 0, triangles);
 	glCheckErrors();
@@ -872,7 +906,7 @@ void kinc_g4_set_pipeline(kinc_g4_pipeline_t *pipeline) {
 }
 
 void kinc_g4_set_stencil_reference_value(int value) {
-	glStencilFunc(Kinc_G4_Internal_StencilFunc(lastPipeline->stencil_mode), value, lastPipeline->stencil_read_mask);
+	kinc_g4_internal_gl_stencil_func(Kinc_G4_Internal_StencilFunc(lastPipeline->stencil_mode), value, lastPipeline->stencil_read_mask);
 }
 
 extern "C" void Kinc_G4_Internal_TextureArraySet(kinc_g4_texture_array *array, kinc_g4_texture_unit_t unit);
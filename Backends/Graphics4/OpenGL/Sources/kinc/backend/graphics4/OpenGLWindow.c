@@ -14,6 +14,7 @@
 #endif
 
 #include "ogl.h"
+#include "state.h"
 
 #ifdef KORE_WINDOWS
 #include <GL/wglew.h>
@@ -185,6 +186,8 @@ void Kinc_Internal_initWindowsGLContext(int window, int depthBufferBits, int ste
 #endif
 
 void Kinc_Internal_blitWindowContent(int window) {
+	// each window has its own context
+	kinc_g4_internal_gl_state_reset();
 	glBindFramebuffer(GL_FRAMEBUFFER, Kinc_Internal_windows[window].framebuffer);
 	kinc_g4_clear(KINC_G4_CLEAR_COLOR, 0xff00ffff, 0.0f, 0);
 	kinc_g4_set_pipeline(&windowPipeline);
@@ -206,6 +209,7 @@ void Kinc_Internal_blitWindowContent(int window) {
 	glBindVertexArray(Kinc_Internal_windows[0].vertexArray);
 #endif
 	glCheckErrors();
+	kinc_g4_internal_gl_state_reset();
 }
 
 void Kinc_Internal_setWindowRenderTarget(int window) {
@@ -1,6 +1,7 @@
 #include "ogl.h"
 
 #include <kinc/compute/compute.h>
+#include <kinc/memory.h>
 
 #if defined(KORE_WINDOWS) || (defined(KORE_LINUX) && defined(GL_VERSION_4_3)) || (defined(KORE_ANDROID) && defined(GL_ES_VERSION_3_1))
 #define HAS_COMPUTE
@@ -40,6 +41,27 @@ void kinc_shader_storage_buffer_init(kinc_shader_storage_buffer_t *buffer, int i
 	case KINC_G4_VERTEX_DATA_SHORT4_NORM:
 		buffer->impl.myStride += 2 * 4;
 		break;
+	case KINC_G4_VERTEX_DATA_HALF2:
+		buffer->impl.myStride += 2 * 2;
+		break;
+	case KINC_G4_VERTEX_DATA_HALF4:
+		buffer->impl.myStride += 4 * 2;
+		break;
+	case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+		buffer->impl.myStride += 4;
+		break;
+	case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+		buffer->impl.myStride += 4;
+		break;
+	case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+		buffer->impl.myStride += 4;
+		break;
+	case KINC_G4_VERTEX_DATA_SHORT2:
+		buffer->impl.myStride += 2 * 2;
+		break;
+	case KINC_G4_VERTEX_DATA_SHORT4:
+		buffer->impl.myStride += 4 * 2;
+		break;
 	case KINC_G4_VERTEX_DATA_NONE:
 		break;
 	}
@@ -47,12 +69,12 @@ void kinc_shader_storage_buffer_init(kinc_shader_storage_buffer_t *buffer, int i
 	glGenBuffers(1, &buffer->impl.bufferId);
 	glCheckErrors();
 #endif
-	buffer->impl.data = (int*)malloc(sizeof(int) * indexCount);
+	buffer->impl.data = (int*)kinc_memory_allocate(sizeof(int) * indexCount, KINC_MEMORY_TAG_GRAPHICS);
 }
 
 void kinc_shader_storage_buffer_destroy(kinc_shader_storage_buffer_t *buffer) {
 	unset(buffer);
-	free(buffer->impl.data);
+	kinc_memory_free(buffer->impl.data);
 }
 
 int *kinc_shader_storage_buffer_lock(kinc_shader_storage_buffer_t *buffer) {
@@ -1,22 +1,32 @@
 #include "ogl.h"
+#include "state.h"
 
 #include <kinc/graphics4/indexbuffer.h>
+#include <kinc/memory.h>
 
 #include <stdlib.h>
 
 kinc_g4_index_buffer_t *Kinc_Internal_CurrentIndexBuffer = NULL;
 
+extern bool Kinc_Internal_SupportsBufferMapping;
+
 void kinc_g4_index_buffer_init(kinc_g4_index_buffer_t *buffer, int count, kinc_g4_index_buffer_format_t format, kinc_g4_usage_t usage) {
 	buffer->impl.myCount = count;
 	glGenBuffers(1, &buffer->impl.bufferId);
 	glCheckErrors();
-	buffer->impl.data = (int *)malloc(count * sizeof(int));
 	if (format == KINC_G4_INDEX_BUFFER_FORMAT_16BIT) {
-		buffer->impl.shortData = (uint16_t *)malloc(count * sizeof(uint16_t));
+		buffer->impl.shortData = (uint16_t *)kinc_memory_allocate(count * sizeof(uint16_t), KINC_MEMORY_TAG_GRAPHICS);
 	}
 	else
 		buffer->impl.shortData = NULL;
 
+	// dynamic 32 bit indices are written straight into an orphaned and mapped buffer
+	buffer->impl.mapped = false;
+#ifndef KORE_OPENGL_ES
+	buffer->impl.mapped = usage == KINC_G4_USAGE_DYNAMIC && buffer->impl.shortData == NULL && Kinc_Internal_SupportsBufferMapping;
+#endif
+	buffer->impl.data = buffer->impl.mapped ? NULL : (int *)kinc_memory_allocate(count * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+
 	switch (usage) {
 	case KINC_G4_USAGE_STATIC:
 		buffer->impl.usage = GL_STATIC_DRAW;
@@ -38,25 +48,45 @@ void Kinc_Internal_IndexBufferUnset(kinc_g4_index_buffer_t *buffer) {
 
 void kinc_g4_index_buffer_destroy(kinc_g4_index_buffer_t *buffer) {
 	Kinc_Internal_IndexBufferUnset(buffer);
+	kinc_g4_internal_gl_forget_buffer(buffer->impl.bufferId);
 	glDeleteBuffers(1, &buffer->impl.bufferId);
-	free(buffer->impl.data);
+	kinc_memory_free(buffer->impl.data);
 	if (buffer->impl.shortData != NULL) {
-		free(buffer->impl.shortData);
+		kinc_memory_free(buffer->impl.shortData);
 	}
 }
 
 int *kinc_g4_index_buffer_lock(kinc_g4_index_buffer_t *buffer) {
+#ifndef KORE_OPENGL_ES
+	if (buffer->impl.mapped) {
+		// bound to the copy target so the element binding of the current vertex array stays untouched
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->impl.bufferId);
+		glBufferData(GL_COPY_WRITE_BUFFER, buffer->impl.myCount * 4, NULL, GL_STREAM_DRAW);
+		glCheckErrors();
+		buffer->impl.data = (int *)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, buffer->impl.myCount * 4,
+		                                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		glCheckErrors();
+	}
+#endif
 	return buffer->impl.data;
 }
 
 void kinc_g4_index_buffer_unlock(kinc_g4_index_buffer_t *buffer) {
+#ifndef KORE_OPENGL_ES
+	if (buffer->impl.mapped) {
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->impl.bufferId);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glCheckErrors();
+		buffer->impl.data = NULL;
+		return;
+	}
+#endif
 	if (buffer->impl.shortData != NULL) {
 		for (int i = 0; i < buffer->impl.myCount; ++i) {
 			buffer->impl.shortData[i] = (uint16_t)buffer->impl.data[i];
 		}
 	}
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->impl.bufferId);
-	glCheckErrors();
+	kinc_g4_internal_gl_bind_element_array_buffer(buffer->impl.bufferId);
 	if (buffer->impl.shortData != NULL) {
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, buffer->impl.myCount * 2, buffer->impl.shortData, buffer->impl.usage);
 		glCheckErrors();
@@ -65,14 +95,12 @@ void kinc_g4_index_buffer_unlock(kinc_g4_index_buffer_t *buffer) {
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, buffer->impl.myCount * 4, buffer->impl.data, buffer->impl.usage);
 		glCheckErrors();
 	}
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glCheckErrors();
+	kinc_g4_internal_gl_bind_element_array_buffer(0);
 }
 
 void kinc_internal_g4_index_buffer_set(kinc_g4_index_buffer_t *buffer) {
 	Kinc_Internal_CurrentIndexBuffer = buffer;
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->impl.bufferId);
-	glCheckErrors();
+	kinc_g4_internal_gl_bind_element_array_buffer(buffer->impl.bufferId);
 }
 
 int kinc_g4_index_buffer_count(kinc_g4_index_buffer_t *buffer) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -12,6 +13,7 @@ typedef struct {
 	int myCount;
 	unsigned usage;
 	unsigned bufferId;
+	bool mapped;
 } kinc_g4_index_buffer_impl_t;
 
 #ifdef __cplusplus
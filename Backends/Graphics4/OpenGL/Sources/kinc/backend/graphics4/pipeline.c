@@ -4,10 +4,16 @@
 #include <kinc/graphics4/pipeline.h>
 #include <kinc/graphics4/shader.h>
 #include <kinc/graphics4/vertexstructure.h>
+#include <kinc/io/filereader.h>
+#include <kinc/io/filewriter.h>
 #include <kinc/log.h>
+#include <kinc/memory.h>
+#include <kinc/system.h>
 
 #include <kinc/backend/graphics4/OpenGL.h>
 
+#include "state.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,6 +23,25 @@ bool Kinc_Internal_ProgramUsesTessellation = false;
 #endif
 extern bool Kinc_Internal_SupportsConservativeRaster;
 
+#if defined(GL_PROGRAM_BINARY_LENGTH) && !defined(KORE_HTML5)
+#define KINC_INTERNAL_PROGRAM_BINARIES
+#endif
+
+struct kinc_g4_internal_gl_program {
+	// the shader-sources, the input-layout and the rest of the pipeline-state, compared completely because hashes can collide
+	uint8_t *key;
+	size_t key_size;
+	uint64_t hash;
+	unsigned id;
+	int references;
+	// the pipeline whose texture-units are currently assigned to the sampler-uniforms
+	kinc_g4_pipeline_t *texture_owner;
+};
+
+static struct kinc_g4_internal_gl_program **programs = NULL;
+static int program_count = 0;
+static int program_capacity = 0;
+
 static GLenum convertStencilAction(kinc_g4_stencil_action_t action) {
 	switch (action) {
 	default:
@@ -72,25 +97,52 @@ void kinc_g4_pipeline_init(kinc_g4_pipeline_t *state) {
 	kinc_g4_internal_pipeline_set_defaults(state);
 
 	state->impl.textureCount = 0;
+	state->impl.uploadedTextureCount = 0;
 	// TODO: Get rid of allocations
-	state->impl.textures = (char **)malloc(sizeof(char *) * 16);
+	state->impl.textures = (char **)kinc_memory_allocate(sizeof(char *) * 16, KINC_MEMORY_TAG_GRAPHICS);
 	for (int i = 0; i < 16; ++i) {
-		state->impl.textures[i] = (char *)malloc(sizeof(char) * 128);
+		state->impl.textures[i] = (char *)kinc_memory_allocate(sizeof(char) * 128, KINC_MEMORY_TAG_GRAPHICS);
 		state->impl.textures[i][0] = 0;
 	}
-	state->impl.textureValues = (int *)malloc(sizeof(int) * 16);
+	state->impl.textureValues = (int *)kinc_memory_allocate(sizeof(int) * 16, KINC_MEMORY_TAG_GRAPHICS);
 
-	state->impl.programId = glCreateProgram();
-	glCheckErrors();
+	// programs are created or found in the program-cache when the pipeline is compiled
+	state->impl.programId = 0;
+	state->impl.program = NULL;
+}
+
+static void releaseProgram(struct kinc_g4_internal_gl_program *program) {
+	--program->references;
+	if (program->references > 0) {
+		return;
+	}
+	kinc_g4_internal_gl_forget_program(program->id);
+	glDeleteProgram(program->id);
+	kinc_memory_free(program->key);
+	for (int i = 0; i < program_count; ++i) {
+		if (programs[i] == program) {
+			programs[i] = programs[program_count - 1];
+			--program_count;
+			break;
+		}
+	}
+	kinc_memory_free(program);
 }
 
 void kinc_g4_pipeline_destroy(kinc_g4_pipeline_t *state) {
 	for (int i = 0; i < 16; ++i) {
-		free(state->impl.textures[i]);
+		kinc_memory_free(state->impl.textures[i]);
+	}
+	kinc_memory_free(state->impl.textures);
+	kinc_memory_free(state->impl.textureValues);
+	if (state->impl.program != NULL) {
+		if (state->impl.program->texture_owner == state) {
+			state->impl.program->texture_owner = NULL;
+		}
+		releaseProgram(state->impl.program);
+		state->impl.program = NULL;
+		state->impl.programId = 0;
 	}
-	free(state->impl.textures);
-	free(state->impl.textureValues);
-	glDeleteProgram(state->impl.programId);
 }
 
 static int toGlShader(kinc_g4_shader_type_t type) {
@@ -122,41 +174,58 @@ static void compileShader(unsigned *id, const char *source, size_t length, kinc_
 	if (result != GL_TRUE) {
 		int length;
 		glGetShaderiv(*id, GL_INFO_LOG_LENGTH, &length);
-		char *errormessage = (char *)malloc(length);
+		char *errormessage = (char *)kinc_memory_allocate(length, KINC_MEMORY_TAG_GRAPHICS);
 		glGetShaderInfoLog(*id, length, NULL, errormessage);
 		kinc_log(KINC_LOG_LEVEL_ERROR, "GLSL compiler error: %s", errormessage);
-		free(errormessage);
+		kinc_memory_free(errormessage);
 	}
 }
 
-void kinc_g4_pipeline_compile(kinc_g4_pipeline_t *state) {
-	compileShader(&state->vertex_shader->impl._glid, state->vertex_shader->impl.source, state->vertex_shader->impl.length, KINC_G4_SHADER_TYPE_VERTEX);
-	compileShader(&state->fragment_shader->impl._glid, state->fragment_shader->impl.source, state->fragment_shader->impl.length, KINC_G4_SHADER_TYPE_FRAGMENT);
+#ifdef KINC_INTERNAL_PROGRAM_BINARIES
+static bool programBinariesSupported(void) {
+	static int formats = -1;
+	if (formats < 0) {
+		formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		// not supported by older contexts
+		while (glGetError() != GL_NO_ERROR) {}
+	}
+	return formats > 0;
+}
+#endif
+
+static void compileShaderOnce(kinc_g4_shader_t *shader, kinc_g4_shader_type_t type) {
+	// shaders are shared by pipelines and only compiled for the first one
+	if (shader->impl._glid == 0) {
+		compileShader(&shader->impl._glid, shader->impl.source, shader->impl.length, type);
+	}
+}
+
+static bool linkProgram(kinc_g4_pipeline_t *state, unsigned programId) {
+	compileShaderOnce(state->vertex_shader, KINC_G4_SHADER_TYPE_VERTEX);
+	compileShaderOnce(state->fragment_shader, KINC_G4_SHADER_TYPE_FRAGMENT);
 #ifndef OPENGLES
 	if (state->geometry_shader != NULL) {
-		compileShader(&state->geometry_shader->impl._glid, state->geometry_shader->impl.source, state->geometry_shader->impl.length,
-		              KINC_G4_SHADER_TYPE_GEOMETRY);
+		compileShaderOnce(state->geometry_shader, KINC_G4_SHADER_TYPE_GEOMETRY);
 	}
 	if (state->tessellation_control_shader != NULL) {
-		compileShader(&state->tessellation_control_shader->impl._glid, state->tessellation_control_shader->impl.source,
-		              state->tessellation_control_shader->impl.length, KINC_G4_SHADER_TYPE_TESSELLATION_CONTROL);
+		compileShaderOnce(state->tessellation_control_shader, KINC_G4_SHADER_TYPE_TESSELLATION_CONTROL);
 	}
 	if (state->tessellation_evaluation_shader != NULL) {
-		compileShader(&state->tessellation_evaluation_shader->impl._glid, state->tessellation_evaluation_shader->impl.source,
-		              state->tessellation_evaluation_shader->impl.length, KINC_G4_SHADER_TYPE_TESSELLATION_EVALUATION);
+		compileShaderOnce(state->tessellation_evaluation_shader, KINC_G4_SHADER_TYPE_TESSELLATION_EVALUATION);
 	}
 #endif
-	glAttachShader(state->impl.programId, state->vertex_shader->impl._glid);
-	glAttachShader(state->impl.programId, state->fragment_shader->impl._glid);
+	glAttachShader(programId, state->vertex_shader->impl._glid);
+	glAttachShader(programId, state->fragment_shader->impl._glid);
 #ifndef OPENGLES
 	if (state->geometry_shader != NULL) {
-		glAttachShader(state->impl.programId, state->geometry_shader->impl._glid);
+		glAttachShader(programId, state->geometry_shader->impl._glid);
 	}
 	if (state->tessellation_control_shader != NULL) {
-		glAttachShader(state->impl.programId, state->tessellation_control_shader->impl._glid);
+		glAttachShader(programId, state->tessellation_control_shader->impl._glid);
 	}
 	if (state->tessellation_evaluation_shader != NULL) {
-		glAttachShader(state->impl.programId, state->tessellation_evaluation_shader->impl._glid);
+		glAttachShader(programId, state->tessellation_evaluation_shader->impl._glid);
 	}
 #endif
 	glCheckErrors();
@@ -165,7 +234,7 @@ void kinc_g4_pipeline_compile(kinc_g4_pipeline_t *state) {
 	for (int i1 = 0; state->input_layout[i1] != NULL; ++i1) {
 		for (int i2 = 0; i2 < state->input_layout[i1]->size; ++i2) {
 			kinc_g4_vertex_element_t element = state->input_layout[i1]->elements[i2];
-			glBindAttribLocation(state->impl.programId, index, element.name);
+			glBindAttribLocation(programId, index, element.name);
 			glCheckErrors();
 			if (element.data == KINC_G4_VERTEX_DATA_FLOAT4X4) {
 				index += 4;
@@ -176,18 +245,256 @@ void kinc_g4_pipeline_compile(kinc_g4_pipeline_t *state) {
 		}
 	}
 
-	glLinkProgram(state->impl.programId);
+#ifdef KINC_INTERNAL_PROGRAM_BINARIES
+	if (programBinariesSupported()) {
+		glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+#endif
+	glLinkProgram(programId);
 
 	int result;
-	glGetProgramiv(state->impl.programId, GL_LINK_STATUS, &result);
+	glGetProgramiv(programId, GL_LINK_STATUS, &result);
 	if (result != GL_TRUE) {
 		int length;
-		glGetProgramiv(state->impl.programId, GL_INFO_LOG_LENGTH, &length);
-		char *errormessage = (char *)malloc(length);
-		glGetProgramInfoLog(state->impl.programId, length, NULL, errormessage);
+		glGetProgramiv(programId, GL_INFO_LOG_LENGTH, &length);
+		char *errormessage = (char *)kinc_memory_allocate(length, KINC_MEMORY_TAG_GRAPHICS);
+		glGetProgramInfoLog(programId, length, NULL, errormessage);
 		kinc_log(KINC_LOG_LEVEL_ERROR, "GLSL linker error: %s", errormessage);
-		free(errormessage);
+		kinc_memory_free(errormessage);
+		return false;
+	}
+	return true;
+}
+
+typedef struct program_key {
+	uint8_t *data;
+	size_t size;
+	size_t capacity;
+	// the part of the key which goes into linking, which identifies program-binaries
+	size_t link_size;
+} program_key_t;
+
+static void appendKey(program_key_t *key, const void *data, size_t size) {
+	if (key->size + size > key->capacity) {
+		key->capacity = (key->size + size) * 2;
+		key->data = (uint8_t *)kinc_memory_reallocate(key->data, key->capacity, KINC_MEMORY_TAG_GRAPHICS);
+	}
+	memcpy(&key->data[key->size], data, size);
+	key->size += size;
+}
+
+static void appendKeyInt(program_key_t *key, int value) {
+	appendKey(key, &value, sizeof(value));
+}
+
+static void appendShader(program_key_t *key, kinc_g4_shader_t *shader) {
+	if (shader == NULL) {
+		appendKeyInt(key, -1);
+		return;
+	}
+	appendKeyInt(key, (int)shader->impl.length);
+	appendKey(key, shader->impl.source, shader->impl.length);
+}
+
+// shaders are identified by their sources because a destroyed shader's address can be reused by a different one, and the program is shared
+// only by pipelines whose complete state is equal - the values of uniforms belong to the program so any differing pipeline needs its own
+static void programKey(kinc_g4_pipeline_t *state, program_key_t *key) {
+	memset(key, 0, sizeof(*key));
+	appendShader(key, state->vertex_shader);
+	appendShader(key, state->fragment_shader);
+	appendShader(key, state->geometry_shader);
+	appendShader(key, state->tessellation_control_shader);
+	appendShader(key, state->tessellation_evaluation_shader);
+	for (int i = 0; i < 16 && state->input_layout[i] != NULL; ++i) {
+		kinc_g4_vertex_structure_t *structure = state->input_layout[i];
+		appendKeyInt(key, structure->size);
+		appendKeyInt(key, structure->instanced ? 1 : 0);
+		for (int j = 0; j < structure->size; ++j) {
+			const char *name = structure->elements[j].name;
+			// including the terminator so neighbouring names can not merge
+			appendKey(key, name, strlen(name) + 1);
+			appendKeyInt(key, structure->elements[j].data);
+		}
+	}
+	appendKeyInt(key, -1);
+	key->link_size = key->size;
+
+	int values[KINC_G4_INTERNAL_PIPELINE_STATE_SIZE];
+	int count = kinc_g4_internal_pipeline_state(state, values);
+	appendKey(key, values, count * sizeof(int));
+}
+
+#ifdef KINC_INTERNAL_PROGRAM_BINARIES
+
+#define PROGRAM_BINARY_MAGIC 0x5047474b // KGGP
+
+typedef struct program_binary_header {
+	uint32_t magic;
+	// binaries only work with the driver that created them
+	uint32_t driver;
+	uint32_t format;
+	// followed by the key the program was linked for and then the binary
+	uint32_t key_length;
+	uint32_t length;
+} program_binary_header_t;
+
+static uint32_t driverHash(void) {
+	static uint32_t driver = 0;
+	if (driver == 0) {
+		const GLubyte *strings[3] = {glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION)};
+		uint64_t hash = 0;
+		for (int i = 0; i < 3; ++i) {
+			if (strings[i] != NULL) {
+				hash = kinc_g4_internal_hash(strings[i], strlen((const char *)strings[i]), hash);
+			}
+		}
+		driver = (uint32_t)(hash ^ (hash >> 32)) | 1;
+	}
+	return driver;
+}
+
+static void programBinaryName(uint64_t key, char *name) {
+	sprintf(name, "kinc_program_%08x%08x.bin", (uint32_t)(key >> 32), (uint32_t)key);
+}
+
+static bool loadProgramBinary(unsigned *programId, const uint8_t *key, size_t key_length, uint64_t hash) {
+	if (!programBinariesSupported()) {
+		return false;
+	}
+	char name[64];
+	programBinaryName(hash, name);
+	kinc_file_reader_t reader;
+	if (!kinc_file_reader_open(&reader, name, KINC_FILE_TYPE_SAVE)) {
+		return false;
+	}
+	program_binary_header_t header;
+	bool loaded = false;
+	if (kinc_file_reader_read(&reader, &header, sizeof(header)) == sizeof(header) && header.magic == PROGRAM_BINARY_MAGIC &&
+	    header.driver == driverHash() && header.key_length == key_length &&
+	    header.key_length + header.length == kinc_file_reader_size(&reader) - sizeof(header)) {
+		uint8_t *data = (uint8_t *)kinc_memory_allocate(header.key_length + header.length, KINC_MEMORY_TAG_GRAPHICS);
+		// a different program whose key has the same hash must not be loaded
+		if (kinc_file_reader_read(&reader, data, header.key_length + header.length) == (int)(header.key_length + header.length) &&
+		    memcmp(data, key, key_length) == 0) {
+			glProgramBinary(*programId, header.format, &data[header.key_length], header.length);
+			int result = GL_FALSE;
+			glGetProgramiv(*programId, GL_LINK_STATUS, &result);
+			// drivers reject binaries after updates even when the version-string did not change
+			while (glGetError() != GL_NO_ERROR) {}
+			loaded = result == GL_TRUE;
+			if (!loaded) {
+				// a program which failed to load a binary is not reliably linkable
+				glDeleteProgram(*programId);
+				*programId = glCreateProgram();
+			}
+		}
+		kinc_memory_free(data);
+	}
+	kinc_file_reader_close(&reader);
+	return loaded;
+}
+
+static void saveProgramBinary(unsigned programId, const uint8_t *key, size_t key_length, uint64_t hash) {
+	if (!programBinariesSupported()) {
+		return;
+	}
+	int length = 0;
+	glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+	program_binary_header_t header;
+	header.magic = PROGRAM_BINARY_MAGIC;
+	header.driver = driverHash();
+	header.key_length = (uint32_t)key_length;
+	header.length = 0;
+	void *data = kinc_memory_allocate(length, KINC_MEMORY_TAG_GRAPHICS);
+	GLenum format = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(programId, length, &written, &format, data);
+	header.format = format;
+	header.length = written;
+	glCheckErrors();
+
+	if (written > 0) {
+		char name[64];
+		programBinaryName(hash, name);
+		kinc_file_writer_t writer;
+		if (kinc_file_writer_open(&writer, name)) {
+			kinc_file_writer_write(&writer, &header, sizeof(header));
+			kinc_file_writer_write(&writer, (void *)key, (int)key_length);
+			kinc_file_writer_write(&writer, data, written);
+			kinc_file_writer_close(&writer);
+		}
 	}
+	kinc_memory_free(data);
+}
+
+#endif
+
+static struct kinc_g4_internal_gl_program *findProgram(const program_key_t *key, uint64_t hash) {
+	for (int i = 0; i < program_count; ++i) {
+		if (programs[i]->hash == hash && programs[i]->key_size == key->size && memcmp(programs[i]->key, key->data, key->size) == 0) {
+			return programs[i];
+		}
+	}
+	return NULL;
+}
+
+// takes over the memory of the key
+static struct kinc_g4_internal_gl_program *addProgram(program_key_t *key, uint64_t hash) {
+	if (program_count == program_capacity) {
+		program_capacity = program_capacity == 0 ? 32 : program_capacity * 2;
+		programs = (struct kinc_g4_internal_gl_program **)kinc_memory_reallocate(programs, program_capacity * sizeof(struct kinc_g4_internal_gl_program *),
+		                                                                          KINC_MEMORY_TAG_GRAPHICS);
+	}
+	struct kinc_g4_internal_gl_program *program =
+	    (struct kinc_g4_internal_gl_program *)kinc_memory_allocate(sizeof(struct kinc_g4_internal_gl_program), KINC_MEMORY_TAG_GRAPHICS);
+	program->key = key->data;
+	program->key_size = key->size;
+	program->hash = hash;
+	key->data = NULL;
+	program->id = glCreateProgram();
+	glCheckErrors();
+	program->references = 1;
+	program->texture_owner = NULL;
+	programs[program_count++] = program;
+	return program;
+}
+
+void kinc_g4_pipeline_compile(kinc_g4_pipeline_t *state) {
+	double start = kinc_time();
+	program_key_t key;
+	programKey(state, &key);
+	uint64_t hash = kinc_g4_internal_hash(key.data, key.size, 0);
+	bool binary_load = false;
+
+	struct kinc_g4_internal_gl_program *program = findProgram(&key, hash);
+	bool cache_hit = program != NULL;
+	if (cache_hit) {
+		++program->references;
+		kinc_memory_free(key.data);
+	}
+	else {
+#ifdef KINC_INTERNAL_PROGRAM_BINARIES
+		size_t link_size = key.link_size;
+		uint64_t link_hash = kinc_g4_internal_hash(key.data, link_size, 0);
+		program = addProgram(&key, hash);
+		binary_load = loadProgramBinary(&program->id, program->key, link_size, link_hash);
+		if (!binary_load) {
+			if (linkProgram(state, program->id)) {
+				saveProgramBinary(program->id, program->key, link_size, link_hash);
+			}
+		}
+#else
+		program = addProgram(&key, hash);
+		linkProgram(state, program->id);
+#endif
+	}
+
+	state->impl.program = program;
+	state->impl.programId = program->id;
+	state->impl.uploadedTextureCount = 0;
 
 #ifndef KORE_OPENGL_ES
 #ifndef KORE_LINUX
@@ -197,87 +504,55 @@ void kinc_g4_pipeline_compile(kinc_g4_pipeline_t *state) {
 	}
 #endif
 #endif
+
+	kinc_g4_internal_pipeline_count_compilation(kinc_time() - start, cache_hit, binary_load);
 }
 
 void kinc_g4_internal_set_pipeline(kinc_g4_pipeline_t *pipeline) {
 #ifndef KORE_OPENGL_ES
 	Kinc_Internal_ProgramUsesTessellation = pipeline->tessellation_control_shader != NULL;
 #endif
-	glUseProgram(pipeline->impl.programId);
-	glCheckErrors();
-	for (int index = 0; index < pipeline->impl.textureCount; ++index) {
+	kinc_g4_internal_gl_use_program(pipeline->impl.programId);
+	// another pipeline which shares the program may have assigned its texture-units in a different order
+	if (pipeline->impl.program != NULL && pipeline->impl.program->texture_owner != pipeline) {
+		pipeline->impl.program->texture_owner = pipeline;
+		pipeline->impl.uploadedTextureCount = 0;
+	}
+	// sampler uniforms are program state and only have to be uploaded once
+	for (int index = pipeline->impl.uploadedTextureCount; index < pipeline->impl.textureCount; ++index) {
 		glUniform1i(pipeline->impl.textureValues[index], index);
 		glCheckErrors();
 	}
+	pipeline->impl.uploadedTextureCount = pipeline->impl.textureCount;
 
 	if (pipeline->stencil_mode == KINC_G4_COMPARE_ALWAYS && pipeline->stencil_both_pass == KINC_G4_STENCIL_KEEP &&
 	    pipeline->stencil_depth_fail == KINC_G4_STENCIL_KEEP && pipeline->stencil_fail == KINC_G4_STENCIL_KEEP) {
-		glDisable(GL_STENCIL_TEST);
+		kinc_g4_internal_gl_enable(GL_STENCIL_TEST, false);
 	}
 	else {
-		glEnable(GL_STENCIL_TEST);
+		kinc_g4_internal_gl_enable(GL_STENCIL_TEST, true);
 		int stencilFunc = Kinc_G4_Internal_StencilFunc(pipeline->stencil_mode);
-		glStencilMask(pipeline->stencil_write_mask);
-		glStencilOp(convertStencilAction(pipeline->stencil_fail), convertStencilAction(pipeline->stencil_depth_fail),
-		            convertStencilAction(pipeline->stencil_both_pass));
-		glStencilFunc(stencilFunc, pipeline->stencil_reference_value, pipeline->stencil_read_mask);
+		kinc_g4_internal_gl_stencil_mask(pipeline->stencil_write_mask);
+		kinc_g4_internal_gl_stencil_op(convertStencilAction(pipeline->stencil_fail), convertStencilAction(pipeline->stencil_depth_fail),
+		                               convertStencilAction(pipeline->stencil_both_pass));
+		kinc_g4_internal_gl_stencil_func(stencilFunc, pipeline->stencil_reference_value, pipeline->stencil_read_mask);
 	}
 
 #ifdef KORE_OPENGL_ES
-	glColorMask(pipeline->color_write_mask_red[0], pipeline->color_write_mask_green[0], pipeline->color_write_mask_blue[0],
-	            pipeline->color_write_mask_alpha[0]);
+	kinc_g4_internal_gl_color_mask(-1, pipeline->color_write_mask_red[0], pipeline->color_write_mask_green[0], pipeline->color_write_mask_blue[0],
+	                               pipeline->color_write_mask_alpha[0]);
 #else
 	for (int i = 0; i < 8; ++i)
-		glColorMaski(i, pipeline->color_write_mask_red[i], pipeline->color_write_mask_green[i], pipeline->color_write_mask_blue[i],
-		             pipeline->color_write_mask_alpha[i]);
+		kinc_g4_internal_gl_color_mask(i, pipeline->color_write_mask_red[i], pipeline->color_write_mask_green[i], pipeline->color_write_mask_blue[i],
+		                               pipeline->color_write_mask_alpha[i]);
 #endif
 
 	if (Kinc_Internal_SupportsConservativeRaster) {
-		if (pipeline->conservative_rasterization) {
-			glEnable(0x9346); // GL_CONSERVATIVE_RASTERIZATION_NV
-		}
-		else {
-			glDisable(0x9346);
-		}
-	}
-
-	glCheckErrors();
-
-	/*switch (state) {
-	case Normalize:
-	device->SetRenderState(D3DRS_NORMALIZENORMALS, on ? TRUE : FALSE);
-	break;
-	case BackfaceCulling:
-	if (on) device->SetRenderState(D3DRS_CULLMODE, D3DCULL_CCW);
-	else device->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-	break;
-	case FogState:
-	device->SetRenderState(D3DRS_FOGENABLE, on ? TRUE : FALSE);
-	break;
-	case ScissorTestState:
-	device->SetRenderState(D3DRS_SCISSORTESTENABLE, on ? TRUE : FALSE);
-	break;
-	case AlphaTestState:
-	device->SetRenderState(D3DRS_ALPHATESTENABLE, on ? TRUE : FALSE);
-	device->SetRenderState(D3DRS_ALPHAFUNC, D3DCMP_GREATEREQUAL);
-	break;
-	default:
-	throw Exception();
-	}*/
-
-	if (pipeline->depth_write) {
-		glDepthMask(GL_TRUE);
-	}
-	else {
-		glDepthMask(GL_FALSE);
+		kinc_g4_internal_gl_enable(0x9346, pipeline->conservative_rasterization); // GL_CONSERVATIVE_RASTERIZATION_NV
 	}
 
-	if (pipeline->depth_mode != KINC_G4_COMPARE_ALWAYS) {
-		glEnable(GL_DEPTH_TEST);
-	}
-	else {
-		glDisable(GL_DEPTH_TEST);
-	}
+	kinc_g4_internal_gl_depth_mask(pipeline->depth_write);
+	kinc_g4_internal_gl_enable(GL_DEPTH_TEST, pipeline->depth_mode != KINC_G4_COMPARE_ALWAYS);
 
 	GLenum func = GL_ALWAYS;
 	switch (pipeline->depth_mode) {
@@ -307,68 +582,28 @@ void kinc_g4_internal_set_pipeline(kinc_g4_pipeline_t *pipeline) {
 		func = GL_GEQUAL;
 		break;
 	}
-	glDepthFunc(func);
-	glCheckErrors();
+	kinc_g4_internal_gl_depth_func(func);
 
 	switch (pipeline->cull_mode) {
 	case KINC_G4_CULL_CLOCKWISE:
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
-		glCheckErrors();
+		kinc_g4_internal_gl_enable(GL_CULL_FACE, true);
+		kinc_g4_internal_gl_cull_face(GL_BACK);
 		break;
 	case KINC_G4_CULL_COUNTER_CLOCKWISE:
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_FRONT);
-		glCheckErrors();
+		kinc_g4_internal_gl_enable(GL_CULL_FACE, true);
+		kinc_g4_internal_gl_cull_face(GL_FRONT);
 		break;
 	case KINC_G4_CULL_NOTHING:
-		glDisable(GL_CULL_FACE);
-		glCheckErrors();
+		kinc_g4_internal_gl_enable(GL_CULL_FACE, false);
 		break;
 	default:
 		break;
 	}
 
-	/*switch (state) {
-	case DepthTestCompare:
-	switch (v) {
-	// TODO: Cmp-Konstanten systemabhaengig abgleichen
-	default:
-	case ZCmp_Always      : v = D3DCMP_ALWAYS; break;
-	case ZCmp_Never       : v = D3DCMP_NEVER; break;
-	case ZCmp_Equal       : v = D3DCMP_EQUAL; break;
-	case ZCmp_NotEqual    : v = D3DCMP_NOTEQUAL; break;
-	case ZCmp_Less        : v = D3DCMP_LESS; break;
-	case ZCmp_LessEqual   : v = D3DCMP_LESSEQUAL; break;
-	case ZCmp_Greater     : v = D3DCMP_GREATER; break;
-	case ZCmp_GreaterEqual: v = D3DCMP_GREATEREQUAL; break;
-	}
-	device->SetRenderState(D3DRS_ZFUNC, v);
-	break;
-	case FogTypeState:
-	switch (v) {
-	case LinearFog:
-	device->SetRenderState(D3DRS_FOGVERTEXMODE, D3DFOG_LINEAR);
-	}
-	break;
-	case AlphaReferenceState:
-	device->SetRenderState(D3DRS_ALPHAREF, (DWORD)v);
-	break;
-	default:
-	throw Exception();
-	}*/
-
-	if (pipeline->blend_source != KINC_G4_BLEND_ONE || pipeline->blend_destination != KINC_G4_BLEND_ZERO || pipeline->alpha_blend_source != KINC_G4_BLEND_ONE ||
-	    pipeline->alpha_blend_destination != KINC_G4_BLEND_ZERO) {
-		glEnable(GL_BLEND);
-	}
-	else {
-		glDisable(GL_BLEND);
-	}
-
-	// glBlendFunc(convert(pipeline->blendSource), convert(pipeline->blendDestination));
-	glBlendFuncSeparate(convertBlendingOperation(pipeline->blend_source), convertBlendingOperation(pipeline->blend_destination),
-	                    convertBlendingOperation(pipeline->alpha_blend_source), convertBlendingOperation(pipeline->alpha_blend_destination));
+	kinc_g4_internal_gl_enable(GL_BLEND, pipeline->blend_source != KINC_G4_BLEND_ONE || pipeline->blend_destination != KINC_G4_BLEND_ZERO ||
+	                                         pipeline->alpha_blend_source != KINC_G4_BLEND_ONE || pipeline->alpha_blend_destination != KINC_G4_BLEND_ZERO);
+	kinc_g4_internal_gl_blend_func(convertBlendingOperation(pipeline->blend_source), convertBlendingOperation(pipeline->blend_destination),
+	                               convertBlendingOperation(pipeline->alpha_blend_source), convertBlendingOperation(pipeline->alpha_blend_destination));
 }
 
 kinc_g4_constant_location_t kinc_g4_pipeline_get_constant_location(kinc_g4_pipeline_t *state, const char *name) {
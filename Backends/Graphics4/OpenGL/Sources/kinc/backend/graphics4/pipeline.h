@@ -4,11 +4,16 @@
 extern "C" {
 #endif
 
+struct kinc_g4_internal_gl_program;
+
 typedef struct {
 	unsigned programId;
+	// shared by all pipelines whose complete state is equal
+	struct kinc_g4_internal_gl_program *program;
 	char **textures;
 	int *textureValues;
 	int textureCount;
+	int uploadedTextureCount;
 } kinc_g4_pipeline_impl_t;
 
 #ifdef __cplusplus
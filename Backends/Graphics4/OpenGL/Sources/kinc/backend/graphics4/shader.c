@@ -1,6 +1,7 @@
 #include "ogl.h"
 
 #include <kinc/graphics4/shader.h>
+#include <kinc/memory.h>
 
 #include <stdlib.h>
 #include <string.h>
@@ -9,7 +10,7 @@ void kinc_g4_shader_init(kinc_g4_shader_t *shader, void *data, size_t length, ki
 	shader->impl.length = length;
 	shader->impl._glid = 0;
 	shader->impl.fromSource = false;
-	char* source = (char*)malloc(length + 1);
+	char* source = (char*)kinc_memory_allocate(length + 1, KINC_MEMORY_TAG_GRAPHICS);
 	memcpy(source, data, length);
 	source[length] = 0;
 	shader->impl.source = source;
@@ -24,7 +25,7 @@ void kinc_g4_shader_init_from_source(kinc_g4_shader_t *shader, const char *sourc
 
 void kinc_g4_shader_destroy(kinc_g4_shader_t *shader) {
 	if (!shader->impl.fromSource) {
-		free((void*)shader->impl.source);
+		kinc_memory_free((void*)shader->impl.source);
 	}
 	shader->impl.source = NULL;
 	if (shader->impl._glid != 0) {
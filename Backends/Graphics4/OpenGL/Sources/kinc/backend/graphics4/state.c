@@ -0,0 +1,277 @@
+#include "state.h"
+
+#include <stdint.h>
+
+#if defined(KORE_OPENGL_ES) && defined(KORE_ANDROID) && KORE_ANDROID_API >= 18
+extern void *glesVertexAttribDivisor;
+#endif
+
+#define UNKNOWN -1
+#define MAX_ATTRIBUTES 16
+#define MAX_COLOR_TARGETS 8
+
+enum { CAP_DEPTH_TEST, CAP_STENCIL_TEST, CAP_CULL_FACE, CAP_BLEND, CAP_SCISSOR_TEST, CAP_CONSERVATIVE_RASTER, CAP_COUNT };
+
+static struct {
+	int capabilities[CAP_COUNT];
+	int64_t program;
+	int depth_mask;
+	int64_t depth_func;
+	int64_t cull_face;
+	int64_t blend[4];
+	int64_t stencil_mask;
+	int64_t stencil_op[3];
+	int64_t stencil_func[3];
+	int color_masks[MAX_COLOR_TARGETS];
+	int64_t array_buffer;
+	int64_t element_array_buffer;
+	int64_t vertex_array;
+	int attributes[MAX_ATTRIBUTES];
+	int divisors[MAX_ATTRIBUTES];
+} state;
+
+static void reset_vertex_array_state(void) {
+	state.element_array_buffer = UNKNOWN;
+	for (int i = 0; i < MAX_ATTRIBUTES; ++i) {
+		state.attributes[i] = UNKNOWN;
+		state.divisors[i] = UNKNOWN;
+	}
+}
+
+void kinc_g4_internal_gl_state_reset(void) {
+	for (int i = 0; i < CAP_COUNT; ++i) {
+		state.capabilities[i] = UNKNOWN;
+	}
+	state.program = UNKNOWN;
+	state.depth_mask = UNKNOWN;
+	state.depth_func = UNKNOWN;
+	state.cull_face = UNKNOWN;
+	for (int i = 0; i < 4; ++i) {
+		state.blend[i] = UNKNOWN;
+	}
+	state.stencil_mask = UNKNOWN;
+	for (int i = 0; i < 3; ++i) {
+		state.stencil_op[i] = UNKNOWN;
+		state.stencil_func[i] = UNKNOWN;
+	}
+	for (int i = 0; i < MAX_COLOR_TARGETS; ++i) {
+		state.color_masks[i] = UNKNOWN;
+	}
+	state.array_buffer = UNKNOWN;
+	state.vertex_array = UNKNOWN;
+	reset_vertex_array_state();
+}
+
+static int capability_index(GLenum capability) {
+	switch (capability) {
+	case GL_DEPTH_TEST:
+		return CAP_DEPTH_TEST;
+	case GL_STENCIL_TEST:
+		return CAP_STENCIL_TEST;
+	case GL_CULL_FACE:
+		return CAP_CULL_FACE;
+	case GL_BLEND:
+		return CAP_BLEND;
+	case GL_SCISSOR_TEST:
+		return CAP_SCISSOR_TEST;
+	case 0x9346: // GL_CONSERVATIVE_RASTERIZATION_NV
+		return CAP_CONSERVATIVE_RASTER;
+	default:
+		return -1;
+	}
+}
+
+void kinc_g4_internal_gl_enable(GLenum capability, bool enabled) {
+	int index = capability_index(capability);
+	if (index >= 0) {
+		if (state.capabilities[index] == (int)enabled) {
+			return;
+		}
+		state.capabilities[index] = enabled;
+	}
+	if (enabled) {
+		glEnable(capability);
+	}
+	else {
+		glDisable(capability);
+	}
+	glCheckErrors();
+}
+
+void kinc_g4_internal_gl_use_program(unsigned program) {
+	if (state.program != program) {
+		state.program = program;
+		glUseProgram(program);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_depth_mask(bool write) {
+	if (state.depth_mask != (int)write) {
+		state.depth_mask = write;
+		glDepthMask(write ? GL_TRUE : GL_FALSE);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_depth_func(GLenum func) {
+	if (state.depth_func != func) {
+		state.depth_func = func;
+		glDepthFunc(func);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_cull_face(GLenum mode) {
+	if (state.cull_face != mode) {
+		state.cull_face = mode;
+		glCullFace(mode);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_blend_func(GLenum source, GLenum destination, GLenum alpha_source, GLenum alpha_destination) {
+	if (state.blend[0] != source || state.blend[1] != destination || state.blend[2] != alpha_source || state.blend[3] != alpha_destination) {
+		state.blend[0] = source;
+		state.blend[1] = destination;
+		state.blend[2] = alpha_source;
+		state.blend[3] = alpha_destination;
+		glBlendFuncSeparate(source, destination, alpha_source, alpha_destination);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_stencil_mask(unsigned mask) {
+	if (state.stencil_mask != mask) {
+		state.stencil_mask = mask;
+		glStencilMask(mask);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_stencil_op(GLenum fail, GLenum depth_fail, GLenum both_pass) {
+	if (state.stencil_op[0] != fail || state.stencil_op[1] != depth_fail || state.stencil_op[2] != both_pass) {
+		state.stencil_op[0] = fail;
+		state.stencil_op[1] = depth_fail;
+		state.stencil_op[2] = both_pass;
+		glStencilOp(fail, depth_fail, both_pass);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_stencil_func(GLenum func, int reference, unsigned read_mask) {
+	if (state.stencil_func[0] != func || state.stencil_func[1] != reference || state.stencil_func[2] != read_mask) {
+		state.stencil_func[0] = func;
+		state.stencil_func[1] = reference;
+		state.stencil_func[2] = read_mask;
+		glStencilFunc(func, reference, read_mask);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_color_mask(int target, bool red, bool green, bool blue, bool alpha) {
+	int mask = (red ? 1 : 0) | (green ? 2 : 0) | (blue ? 4 : 0) | (alpha ? 8 : 0);
+#ifdef KORE_OPENGL_ES
+	// a single mask covers all targets
+	target = -1;
+#endif
+	if (target < 0) {
+		bool changed = false;
+		for (int i = 0; i < MAX_COLOR_TARGETS; ++i) {
+			if (state.color_masks[i] != mask) {
+				state.color_masks[i] = mask;
+				changed = true;
+			}
+		}
+		if (changed) {
+			glColorMask(red, green, blue, alpha);
+			glCheckErrors();
+		}
+	}
+#ifndef KORE_OPENGL_ES
+	else if (state.color_masks[target] != mask) {
+		state.color_masks[target] = mask;
+		glColorMaski(target, red, green, blue, alpha);
+		glCheckErrors();
+	}
+#endif
+}
+
+void kinc_g4_internal_gl_bind_array_buffer(unsigned buffer) {
+	if (state.array_buffer != buffer) {
+		state.array_buffer = buffer;
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_bind_element_array_buffer(unsigned buffer) {
+	if (state.element_array_buffer != buffer) {
+		state.element_array_buffer = buffer;
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+		glCheckErrors();
+	}
+}
+
+void kinc_g4_internal_gl_forget_program(unsigned program) {
+	if (state.program == program) {
+		state.program = UNKNOWN;
+	}
+}
+
+void kinc_g4_internal_gl_forget_buffer(unsigned buffer) {
+	if (state.array_buffer == buffer) {
+		state.array_buffer = UNKNOWN;
+	}
+	if (state.element_array_buffer == buffer) {
+		state.element_array_buffer = UNKNOWN;
+	}
+}
+
+void kinc_g4_internal_gl_forget_vertex_array(unsigned vertex_array) {
+	if (state.vertex_array == vertex_array) {
+		state.vertex_array = UNKNOWN;
+		reset_vertex_array_state();
+	}
+}
+
+void kinc_g4_internal_gl_bind_vertex_array(unsigned vertex_array) {
+#if !defined(KORE_OPENGL_ES)
+	if (state.vertex_array != vertex_array) {
+		state.vertex_array = vertex_array;
+		glBindVertexArray(vertex_array);
+		glCheckErrors();
+		// element buffer binding and attribute arrays are vertex array state
+		reset_vertex_array_state();
+	}
+#endif
+}
+
+void kinc_g4_internal_gl_vertex_attrib_array(int index, bool enabled) {
+	if (state.attributes[index] == (int)enabled) {
+		return;
+	}
+	state.attributes[index] = enabled;
+	if (enabled) {
+		glEnableVertexAttribArray(index);
+	}
+	else {
+		glDisableVertexAttribArray(index);
+	}
+	glCheckErrors();
+}
+
+void kinc_g4_internal_gl_vertex_attrib_divisor(int index, int divisor) {
+	if (state.divisors[index] == divisor) {
+		return;
+	}
+	state.divisors[index] = divisor;
+#ifndef KORE_OPENGL_ES
+	glVertexAttribDivisor(index, divisor);
+	glCheckErrors();
+#endif
+#if (defined(KORE_OPENGL_ES) && defined(KORE_ANDROID) && KORE_ANDROID_API >= 18)
+	((void (*)(GLuint, GLuint))glesVertexAttribDivisor)(index, divisor);
+	glCheckErrors();
+#endif
+}
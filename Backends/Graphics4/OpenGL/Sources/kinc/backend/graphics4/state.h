@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ogl.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shadow copy of the GL state that is touched per draw-call. Every setter compares against
+// the cached value and only calls into GL when something actually changes.
+// kinc_g4_internal_gl_state_reset has to be called whenever GL state was modified behind the
+// back of these functions (for example after switching contexts).
+
+void kinc_g4_internal_gl_state_reset(void);
+
+void kinc_g4_internal_gl_enable(GLenum capability, bool enabled);
+void kinc_g4_internal_gl_use_program(unsigned program);
+void kinc_g4_internal_gl_depth_mask(bool write);
+void kinc_g4_internal_gl_depth_func(GLenum func);
+void kinc_g4_internal_gl_cull_face(GLenum mode);
+void kinc_g4_internal_gl_blend_func(GLenum source, GLenum destination, GLenum alpha_source, GLenum alpha_destination);
+void kinc_g4_internal_gl_stencil_mask(unsigned mask);
+void kinc_g4_internal_gl_stencil_op(GLenum fail, GLenum depth_fail, GLenum both_pass);
+void kinc_g4_internal_gl_stencil_func(GLenum func, int reference, unsigned read_mask);
+// A negative target sets the mask of all color targets at once.
+void kinc_g4_internal_gl_color_mask(int target, bool red, bool green, bool blue, bool alpha);
+
+void kinc_g4_internal_gl_bind_array_buffer(unsigned buffer);
+void kinc_g4_internal_gl_bind_element_array_buffer(unsigned buffer);
+void kinc_g4_internal_gl_bind_vertex_array(unsigned vertex_array);
+void kinc_g4_internal_gl_vertex_attrib_array(int index, bool enabled);
+void kinc_g4_internal_gl_vertex_attrib_divisor(int index, int divisor);
+
+// Deleted objects release their bindings and their names can be handed out again.
+void kinc_g4_internal_gl_forget_program(unsigned program);
+void kinc_g4_internal_gl_forget_buffer(unsigned buffer);
+void kinc_g4_internal_gl_forget_vertex_array(unsigned vertex_array);
+
+#ifdef __cplusplus
+}
+#endif
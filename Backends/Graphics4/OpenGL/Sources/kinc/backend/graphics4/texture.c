@@ -6,6 +6,7 @@
 #include <kinc/math/core.h>
 #include <kinc/image.h>
 #include <kinc/log.h>
+#include <kinc/memory.h>
 
 #include "OpenGL.h"
 
@@ -278,7 +279,7 @@ void kinc_g4_texture_init_from_image(kinc_g4_texture_t *texture, kinc_image_t *i
 	switch (image->compression) {
 	case KINC_IMAGE_COMPRESSION_NONE:
 		if (toPow2) {
-			conversionBuffer = (uint8_t*)malloc(texture->tex_width * texture->tex_height * kinc_image_format_sizeof(image->format));
+			conversionBuffer = (uint8_t*)kinc_memory_allocate(texture->tex_width * texture->tex_height * kinc_image_format_sizeof(image->format), KINC_MEMORY_TAG_GRAPHICS);
 			convertImageToPow2(image->format, (uint8_t *)image->data, image->width, image->height, conversionBuffer,
 			                   texture->tex_width, texture->tex_height);
 		}
@@ -348,7 +349,7 @@ void kinc_g4_texture_init_from_image(kinc_g4_texture_t *texture, kinc_image_t *i
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 	if (toPow2) {
-		free(conversionBuffer);
+		kinc_memory_free(conversionBuffer);
 		conversionBuffer = NULL;
 	}
 
@@ -537,7 +538,7 @@ static uint8_t *lock_cache = NULL;
 
 unsigned char *kinc_g4_texture_lock(kinc_g4_texture_t *texture) {
 	if (lock_cache == NULL) {
-		lock_cache = (uint8_t*)malloc(4096 * 4096 * 4);
+		lock_cache = (uint8_t*)kinc_memory_allocate(4096 * 4096 * 4, KINC_MEMORY_TAG_GRAPHICS);
 	}
 	return lock_cache; //**(texture->image.data ? texture->image.data : (uint8_t *)texture->image.hdrData);
 }
@@ -1,12 +1,15 @@
 #include "ogl.h"
+#include "state.h"
 #include <kinc/backend/graphics4/shader.h>
 #include <kinc/backend/graphics4/vertexbuffer.h>
 
 #include <kinc/graphics4/indexbuffer.h>
 #include <kinc/graphics4/vertexbuffer.h>
+#include <kinc/memory.h>
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 extern kinc_g4_index_buffer_t *Kinc_Internal_CurrentIndexBuffer;
 static kinc_g4_vertex_buffer_t *currentVertexBuffer = NULL;
@@ -15,6 +18,21 @@ static kinc_g4_vertex_buffer_t *currentVertexBuffer = NULL;
 void *glesVertexAttribDivisor;
 #endif
 
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif
+
+#ifndef GL_UNSIGNED_INT_2_10_10_10_REV
+#define GL_UNSIGNED_INT_2_10_10_10_REV 0x8368
+#endif
+
+#if !defined(KORE_OPENGL_ES) && defined(GL_MAP_PERSISTENT_BIT)
+#define HAS_BUFFER_STORAGE
+#endif
+
+extern bool Kinc_Internal_SupportsBufferStorage;
+extern bool Kinc_Internal_SupportsBufferMapping;
+
 void kinc_g4_vertex_buffer_init(kinc_g4_vertex_buffer_t *buffer, int vertexCount, kinc_g4_vertex_structure_t *structure, kinc_g4_usage_t usage,
                                 int instanceDataStepRate) {
 	buffer->impl.myCount = vertexCount;
@@ -50,6 +68,27 @@ void kinc_g4_vertex_buffer_init(kinc_g4_vertex_buffer_t *buffer, int vertexCount
 		case KINC_G4_VERTEX_DATA_SHORT4_NORM:
 			buffer->impl.myStride += 4 * 2;
 			break;
+		case KINC_G4_VERTEX_DATA_HALF2:
+			buffer->impl.myStride += 2 * 2;
+			break;
+		case KINC_G4_VERTEX_DATA_HALF4:
+			buffer->impl.myStride += 4 * 2;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+			buffer->impl.myStride += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+			buffer->impl.myStride += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+			buffer->impl.myStride += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT2:
+			buffer->impl.myStride += 2 * 2;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT4:
+			buffer->impl.myStride += 4 * 2;
+			break;
 		case KINC_G4_VERTEX_DATA_NONE:
 			break;
 		}
@@ -70,56 +109,188 @@ void kinc_g4_vertex_buffer_init(kinc_g4_vertex_buffer_t *buffer, int vertexCount
 		break;
 	}
 
+	buffer->impl.streaming = KINC_INTERNAL_G4_STREAMING_NONE;
+	buffer->impl.mapped = NULL;
+	buffer->impl.segment = 0;
+	for (int i = 0; i < KINC_INTERNAL_G4_STREAMING_SEGMENTS; ++i) {
+		buffer->impl.fences[i] = NULL;
+	}
+	buffer->impl.data = NULL;
+
 	glGenBuffers(1, &buffer->impl.bufferId);
 	glCheckErrors();
-	glBindBuffer(GL_ARRAY_BUFFER, buffer->impl.bufferId);
-	glCheckErrors();
+	kinc_g4_internal_gl_bind_array_buffer(buffer->impl.bufferId);
+
+	// Dynamic buffers are written straight into GPU-visible memory, preferably via a persistently
+	// mapped ring of segments so data that is still in flight is never overwritten.
+	if (usage == KINC_G4_USAGE_DYNAMIC) {
+#ifdef HAS_BUFFER_STORAGE
+		if (Kinc_Internal_SupportsBufferStorage) {
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			GLsizeiptr size = (GLsizeiptr)buffer->impl.myStride * buffer->impl.myCount * KINC_INTERNAL_G4_STREAMING_SEGMENTS;
+			glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+			glCheckErrors();
+			buffer->impl.mapped = (uint8_t *)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+			glCheckErrors();
+			if (buffer->impl.mapped != NULL) {
+				buffer->impl.streaming = KINC_INTERNAL_G4_STREAMING_PERSISTENT;
+				return;
+			}
+			// buffer storage is immutable, start over with a fresh buffer
+			kinc_g4_internal_gl_forget_buffer(buffer->impl.bufferId);
+			glDeleteBuffers(1, &buffer->impl.bufferId);
+			glGenBuffers(1, &buffer->impl.bufferId);
+			glCheckErrors();
+			kinc_g4_internal_gl_bind_array_buffer(buffer->impl.bufferId);
+		}
+#endif
+#ifndef KORE_OPENGL_ES
+		if (Kinc_Internal_SupportsBufferMapping) {
+			buffer->impl.streaming = KINC_INTERNAL_G4_STREAMING_ORPHAN;
+			gl_usage = GL_STREAM_DRAW;
+		}
+#endif
+	}
+
 	glBufferData(GL_ARRAY_BUFFER, buffer->impl.myStride * buffer->impl.myCount, NULL, gl_usage);
 	glCheckErrors();
-	buffer->impl.data = (float *)malloc(vertexCount * buffer->impl.myStride);
+	if (buffer->impl.streaming == KINC_INTERNAL_G4_STREAMING_NONE) {
+		buffer->impl.data = (float *)kinc_memory_allocate(vertexCount * buffer->impl.myStride, KINC_MEMORY_TAG_GRAPHICS);
+	}
 }
 
 void Kinc_Internal_G4_VertexBuffer_Unset(kinc_g4_vertex_buffer_t *buffer);
 
+static void forget_vertex_arrays(unsigned bufferId);
+static void forgetVertexBuffer(kinc_g4_vertex_buffer_t *buffer);
+
 void kinc_g4_vertex_buffer_destroy(kinc_g4_vertex_buffer_t *buffer) {
 	Kinc_Internal_G4_VertexBuffer_Unset(buffer);
+	forgetVertexBuffer(buffer);
+	forget_vertex_arrays(buffer->impl.bufferId);
+#ifdef HAS_BUFFER_STORAGE
+	if (buffer->impl.streaming == KINC_INTERNAL_G4_STREAMING_PERSISTENT) {
+		kinc_g4_internal_gl_bind_array_buffer(buffer->impl.bufferId);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glCheckErrors();
+		for (int i = 0; i < KINC_INTERNAL_G4_STREAMING_SEGMENTS; ++i) {
+			if (buffer->impl.fences[i] != NULL) {
+				glDeleteSync((GLsync)buffer->impl.fences[i]);
+			}
+		}
+	}
+#endif
+	kinc_g4_internal_gl_forget_buffer(buffer->impl.bufferId);
 	glDeleteBuffers(1, &buffer->impl.bufferId);
-	free(buffer->impl.data);
+	kinc_memory_free(buffer->impl.data);
+}
+
+#ifdef HAS_BUFFER_STORAGE
+// Fences the segment that was used until now and waits for the GPU to release the next one.
+static void nextSegment(kinc_g4_vertex_buffer_t *buffer) {
+	if (buffer->impl.fences[buffer->impl.segment] != NULL) {
+		glDeleteSync((GLsync)buffer->impl.fences[buffer->impl.segment]);
+	}
+	buffer->impl.fences[buffer->impl.segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glCheckErrors();
+
+	buffer->impl.segment = (buffer->impl.segment + 1) % KINC_INTERNAL_G4_STREAMING_SEGMENTS;
+
+	GLsync fence = (GLsync)buffer->impl.fences[buffer->impl.segment];
+	if (fence != NULL) {
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		while (result == GL_TIMEOUT_EXPIRED) {
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		}
+		glDeleteSync(fence);
+		buffer->impl.fences[buffer->impl.segment] = NULL;
+	}
+}
+#endif
+
+static GLintptr bufferOffset(kinc_g4_vertex_buffer_t *buffer) {
+	if (buffer->impl.streaming == KINC_INTERNAL_G4_STREAMING_PERSISTENT) {
+		return (GLintptr)buffer->impl.segment * buffer->impl.myCount * buffer->impl.myStride;
+	}
+	return 0;
 }
 
 float *kinc_g4_vertex_buffer_lock_all(kinc_g4_vertex_buffer_t *buffer) {
-	buffer->impl.sectionStart = 0;
-	buffer->impl.sectionSize = buffer->impl.myCount * buffer->impl.myStride;
-	return buffer->impl.data;
+	return kinc_g4_vertex_buffer_lock(buffer, 0, buffer->impl.myCount);
 }
 
+// For dynamic buffers a lock which starts at the first vertex begins a new batch of data. Locks
+// further into the buffer append to the current batch and must not overwrite vertices that
+// were already submitted for drawing.
 float *kinc_g4_vertex_buffer_lock(kinc_g4_vertex_buffer_t *buffer, int start, int count) {
 	buffer->impl.sectionStart = start * buffer->impl.myStride;
 	buffer->impl.sectionSize = count * buffer->impl.myStride;
-	uint8_t *u8data = (uint8_t *)buffer->impl.data;
-	return (float *)&u8data[buffer->impl.sectionStart];
+	switch (buffer->impl.streaming) {
+	case KINC_INTERNAL_G4_STREAMING_PERSISTENT:
+#ifdef HAS_BUFFER_STORAGE
+		if (start == 0) {
+			nextSegment(buffer);
+		}
+#endif
+		return (float *)&buffer->impl.mapped[bufferOffset(buffer) + buffer->impl.sectionStart];
+	case KINC_INTERNAL_G4_STREAMING_ORPHAN: {
+#ifndef KORE_OPENGL_ES
+		kinc_g4_internal_gl_bind_array_buffer(buffer->impl.bufferId);
+		GLbitfield access = GL_MAP_WRITE_BIT;
+		if (start == 0) {
+			glBufferData(GL_ARRAY_BUFFER, buffer->impl.myStride * buffer->impl.myCount, NULL, GL_STREAM_DRAW);
+			glCheckErrors();
+			access |= GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+		}
+		else {
+			// appended vertices never overlap data which was already submitted
+			access |= GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+		}
+		buffer->impl.mapped = (uint8_t *)glMapBufferRange(GL_ARRAY_BUFFER, buffer->impl.sectionStart, buffer->impl.sectionSize, access);
+		glCheckErrors();
+		return (float *)buffer->impl.mapped;
+#endif
+	}
+	case KINC_INTERNAL_G4_STREAMING_NONE:
+	default: {
+		uint8_t *u8data = (uint8_t *)buffer->impl.data;
+		return (float *)&u8data[buffer->impl.sectionStart];
+	}
+	}
 }
 
-void kinc_g4_vertex_buffer_unlock_all(kinc_g4_vertex_buffer_t *buffer) {
-	glBindBuffer(GL_ARRAY_BUFFER, buffer->impl.bufferId);
-	glCheckErrors();
-	uint8_t *u8data = (uint8_t *)buffer->impl.data;
-	glBufferSubData(GL_ARRAY_BUFFER, buffer->impl.sectionStart, buffer->impl.sectionSize, u8data + buffer->impl.sectionStart);
-	glCheckErrors();
+static void unlock(kinc_g4_vertex_buffer_t *buffer, int size) {
+	switch (buffer->impl.streaming) {
+	case KINC_INTERNAL_G4_STREAMING_PERSISTENT:
+		// coherent mapping, nothing to upload
+		break;
+	case KINC_INTERNAL_G4_STREAMING_ORPHAN:
+#ifndef KORE_OPENGL_ES
+		kinc_g4_internal_gl_bind_array_buffer(buffer->impl.bufferId);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glCheckErrors();
+		buffer->impl.mapped = NULL;
+#endif
+		break;
+	case KINC_INTERNAL_G4_STREAMING_NONE: {
+		kinc_g4_internal_gl_bind_array_buffer(buffer->impl.bufferId);
+		uint8_t *u8data = (uint8_t *)buffer->impl.data;
+		glBufferSubData(GL_ARRAY_BUFFER, buffer->impl.sectionStart, size, u8data + buffer->impl.sectionStart);
+		glCheckErrors();
+		break;
+	}
+	}
 #ifndef NDEBUG
 	buffer->impl.initialized = true;
 #endif
 }
 
+void kinc_g4_vertex_buffer_unlock_all(kinc_g4_vertex_buffer_t *buffer) {
+	unlock(buffer, buffer->impl.sectionSize);
+}
+
 void kinc_g4_vertex_buffer_unlock(kinc_g4_vertex_buffer_t *buffer, int count) {
-	glBindBuffer(GL_ARRAY_BUFFER, buffer->impl.bufferId);
-	glCheckErrors();
-	uint8_t *u8data = (uint8_t *)buffer->impl.data;
-	glBufferSubData(GL_ARRAY_BUFFER, buffer->impl.sectionStart, count * buffer->impl.myStride, u8data + buffer->impl.sectionStart);
-	glCheckErrors();
-#ifndef NDEBUG
-	buffer->impl.initialized = true;
-#endif
+	unlock(buffer, count * buffer->impl.myStride);
 }
 
 int Kinc_G4_Internal_SetVertexAttributes(kinc_g4_vertex_buffer_t *buffer, int offset);
@@ -151,20 +322,42 @@ int kinc_g4_vertex_buffer_stride(kinc_g4_vertex_buffer_t *buffer) {
 static bool attribDivisorUsed = false;
 #endif
 
-int Kinc_G4_Internal_SetVertexAttributes(kinc_g4_vertex_buffer_t *buffer, int offset) {
-	glBindBuffer(GL_ARRAY_BUFFER, buffer->impl.bufferId);
+static void setAttribute(kinc_g4_vertex_buffer_t *buffer, int index, int size, GLenum type, bool normalized, bool integer, GLintptr offset) {
+	kinc_g4_internal_gl_vertex_attrib_array(index, true);
+#if !defined(KORE_OPENGL_ES) || defined(GL_ES_VERSION_3_0)
+	if (integer) {
+		glVertexAttribIPointer(index, size, type, buffer->impl.myStride, (void *)offset);
+	}
+	else
+#endif
+	{
+		glVertexAttribPointer(index, size, type, normalized, buffer->impl.myStride, (void *)offset);
+	}
 	glCheckErrors();
+#if !defined(KORE_OPENGL_ES) || (defined(KORE_OPENGL_ES) && defined(KORE_ANDROID) && KORE_ANDROID_API >= 18)
+	if (attribDivisorUsed || buffer->impl.instanceDataStepRate != 0) {
+		attribDivisorUsed = true;
+		kinc_g4_internal_gl_vertex_attrib_divisor(index, buffer->impl.instanceDataStepRate);
+	}
+#endif
+}
 
-	int internaloffset = 0;
+int Kinc_G4_Internal_SetVertexAttributes(kinc_g4_vertex_buffer_t *buffer, int offset) {
+	kinc_g4_internal_gl_bind_array_buffer(buffer->impl.bufferId);
+
+	GLintptr internaloffset = bufferOffset(buffer);
 	int actualIndex = 0;
 	for (int index = 0; index < buffer->impl.structure.size; ++index) {
 		kinc_g4_vertex_element_t element = buffer->impl.structure.elements[index];
 		int size = 0;
 		GLenum type = GL_FLOAT;
+		bool normalized = false;
+		bool integer = false;
 		switch (element.data) {
 		case KINC_G4_VERTEX_DATA_COLOR:
 			size = 4;
 			type = GL_UNSIGNED_BYTE;
+			normalized = true;
 			break;
 		case KINC_G4_VERTEX_DATA_FLOAT1:
 			size = 1;
@@ -184,10 +377,45 @@ int Kinc_G4_Internal_SetVertexAttributes(kinc_g4_vertex_buffer_t *buffer, int of
 		case KINC_G4_VERTEX_DATA_SHORT2_NORM:
 			size = 2;
 			type = GL_SHORT;
+			normalized = true;
 			break;
 		case KINC_G4_VERTEX_DATA_SHORT4_NORM:
 			size = 4;
 			type = GL_SHORT;
+			normalized = true;
+			break;
+		case KINC_G4_VERTEX_DATA_HALF2:
+			size = 2;
+			type = GL_HALF_FLOAT;
+			break;
+		case KINC_G4_VERTEX_DATA_HALF4:
+			size = 4;
+			type = GL_HALF_FLOAT;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+			size = 4;
+			type = GL_BYTE;
+			normalized = true;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+			size = 4;
+			type = GL_UNSIGNED_BYTE;
+			normalized = true;
+			break;
+		case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+			size = 4;
+			type = GL_UNSIGNED_INT_2_10_10_10_REV;
+			normalized = true;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT2:
+			size = 2;
+			type = GL_SHORT;
+			integer = true;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT4:
+			size = 4;
+			type = GL_SHORT;
+			integer = true;
 			break;
 		case KINC_G4_VERTEX_DATA_NONE:
 			break;
@@ -196,48 +424,14 @@ int Kinc_G4_Internal_SetVertexAttributes(kinc_g4_vertex_buffer_t *buffer, int of
 			int subsize = size;
 			int addonOffset = 0;
 			while (subsize > 0) {
-				glEnableVertexAttribArray(offset + actualIndex);
-				glCheckErrors();
-				glVertexAttribPointer(offset + actualIndex, 4, type, false, buffer->impl.myStride, (void *)(int64_t)(internaloffset + addonOffset));
-				glCheckErrors();
-#ifndef KORE_OPENGL_ES
-				if (attribDivisorUsed || buffer->impl.instanceDataStepRate != 0) {
-					attribDivisorUsed = true;
-					glVertexAttribDivisor(offset + actualIndex, buffer->impl.instanceDataStepRate);
-					glCheckErrors();
-				}
-#endif
-#if (defined(KORE_OPENGL_ES) && defined(KORE_ANDROID) && KORE_ANDROID_API >= 18)
-				if (attribDivisorUsed || buffer->impl.instanceDataStepRate != 0) {
-					attribDivisorUsed = true;
-					((void (*)(GLuint, GLuint))glesVertexAttribDivisor)(offset + actualIndex, buffer->impl.instanceDataStepRate);
-					glCheckErrors();
-				}
-#endif
+				setAttribute(buffer, offset + actualIndex, 4, type, false, false, internaloffset + addonOffset);
 				subsize -= 4;
 				addonOffset += 4 * 4;
 				++actualIndex;
 			}
 		}
 		else {
-			glEnableVertexAttribArray(offset + actualIndex);
-			glCheckErrors();
-			glVertexAttribPointer(offset + actualIndex, size, type, type == GL_FLOAT ? false : true, buffer->impl.myStride, (void *)(int64_t)internaloffset);
-			glCheckErrors();
-#ifndef KORE_OPENGL_ES
-			if (attribDivisorUsed || buffer->impl.instanceDataStepRate != 0) {
-				attribDivisorUsed = true;
-				glVertexAttribDivisor(offset + actualIndex, buffer->impl.instanceDataStepRate);
-				glCheckErrors();
-			}
-#endif
-#if (defined(KORE_OPENGL_ES) && defined(KORE_ANDROID) && KORE_ANDROID_API >= 18)
-			if (attribDivisorUsed || buffer->impl.instanceDataStepRate != 0) {
-				attribDivisorUsed = true;
-				((void (*)(GLuint, GLuint))glesVertexAttribDivisor)(offset + actualIndex, buffer->impl.instanceDataStepRate);
-				glCheckErrors();
-			}
-#endif
+			setAttribute(buffer, offset + actualIndex, size, type, normalized, integer, internaloffset);
 			++actualIndex;
 		}
 		switch (element.data) {
@@ -265,14 +459,262 @@ int Kinc_G4_Internal_SetVertexAttributes(kinc_g4_vertex_buffer_t *buffer, int of
 		case KINC_G4_VERTEX_DATA_SHORT4_NORM:
 			internaloffset += 2 * 4;
 			break;
+		case KINC_G4_VERTEX_DATA_HALF2:
+			internaloffset += 2 * 2;
+			break;
+		case KINC_G4_VERTEX_DATA_HALF4:
+			internaloffset += 4 * 2;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+			internaloffset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+			internaloffset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+			internaloffset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT2:
+			internaloffset += 2 * 2;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT4:
+			internaloffset += 4 * 2;
+			break;
 		case KINC_G4_VERTEX_DATA_NONE:
 			break;
 		}
 	}
 	int count = 16 - offset;
 	for (int index = actualIndex; index < count; ++index) {
-		glDisableVertexAttribArray(offset + index);
-		glCheckErrors();
+		kinc_g4_internal_gl_vertex_attrib_array(offset + index, false);
 	}
 	return actualIndex;
 }
+
+// Vertex array objects are cached per combination of vertex buffers and their current streaming
+// segments. Attribute locations are bound in input-layout order in kinc_g4_pipeline_compile so the
+// buffers alone define the layout. Vertex array objects are not shared between contexts so every
+// entry also remembers the context it was created in - only Windows uses more than one.
+
+#ifndef KORE_OPENGL_ES
+extern bool Kinc_Internal_SupportsVertexArrayObjects;
+extern unsigned Kinc_Internal_DefaultVertexArray;
+
+static int vertexArrayContext = 0;
+static unsigned contextDefaultVertexArray = 0;
+
+#define VERTEX_ARRAY_CACHE_SIZE 64
+#define MAX_CACHED_VERTEX_BUFFERS 4
+
+typedef struct {
+	unsigned vertexArray;
+	int context;
+	// -1 when one of the buffers was destroyed while a different context was current,
+	// the vertex array is deleted the next time its context is current
+	int count;
+	unsigned buffers[MAX_CACHED_VERTEX_BUFFERS];
+	GLintptr offsets[MAX_CACHED_VERTEX_BUFFERS];
+	uint32_t lastUse;
+} VertexArrayCacheEntry;
+
+static VertexArrayCacheEntry vertexArrayCache[VERTEX_ARRAY_CACHE_SIZE];
+static uint32_t vertexArrayUses = 0;
+static VertexArrayCacheEntry *lastVertexArray = NULL;
+
+static bool matches(VertexArrayCacheEntry *entry, kinc_g4_vertex_buffer_t **buffers, int count) {
+	if (entry->vertexArray == 0 || entry->context != vertexArrayContext || entry->count != count) {
+		return false;
+	}
+	for (int i = 0; i < count; ++i) {
+		if (entry->buffers[i] != buffers[i]->impl.bufferId || entry->offsets[i] != bufferOffset(buffers[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void deleteVertexArray(VertexArrayCacheEntry *entry) {
+	kinc_g4_internal_gl_forget_vertex_array(entry->vertexArray);
+	glDeleteVertexArrays(1, &entry->vertexArray);
+	glCheckErrors();
+	if (lastVertexArray == entry) {
+		lastVertexArray = NULL;
+	}
+	memset(entry, 0, sizeof(*entry));
+}
+
+// vertex arrays of other contexts can not be deleted now, they are only free when they are empty
+static bool replaceable(VertexArrayCacheEntry *entry) {
+	return entry->vertexArray == 0 || entry->context == vertexArrayContext;
+}
+
+// returns NULL when the cache is filled with vertex arrays of other contexts
+static VertexArrayCacheEntry *findVertexArray(kinc_g4_vertex_buffer_t **buffers, int count) {
+	if (lastVertexArray != NULL && matches(lastVertexArray, buffers, count)) {
+		return lastVertexArray;
+	}
+
+	VertexArrayCacheEntry *victim = NULL;
+	for (int i = 0; i < VERTEX_ARRAY_CACHE_SIZE; ++i) {
+		VertexArrayCacheEntry *entry = &vertexArrayCache[i];
+		if (matches(entry, buffers, count)) {
+			entry->lastUse = ++vertexArrayUses;
+			lastVertexArray = entry;
+			return entry;
+		}
+		if (replaceable(entry) && (victim == NULL || (victim->vertexArray != 0 && (entry->vertexArray == 0 || entry->lastUse < victim->lastUse)))) {
+			victim = entry;
+		}
+	}
+	if (victim == NULL) {
+		return NULL;
+	}
+
+	if (victim->vertexArray != 0) {
+		deleteVertexArray(victim);
+	}
+	glGenVertexArrays(1, &victim->vertexArray);
+	glCheckErrors();
+	kinc_g4_internal_gl_bind_vertex_array(victim->vertexArray);
+	int offset = 0;
+	for (int i = 0; i < count; ++i) {
+		offset += Kinc_G4_Internal_SetVertexAttributes(buffers[i], offset);
+		victim->buffers[i] = buffers[i]->impl.bufferId;
+		victim->offsets[i] = bufferOffset(buffers[i]);
+	}
+	victim->context = vertexArrayContext;
+	victim->count = count;
+	victim->lastUse = ++vertexArrayUses;
+	lastVertexArray = victim;
+	return victim;
+}
+#endif
+
+static void forget_vertex_arrays(unsigned bufferId) {
+#ifndef KORE_OPENGL_ES
+	for (int i = 0; i < VERTEX_ARRAY_CACHE_SIZE; ++i) {
+		VertexArrayCacheEntry *entry = &vertexArrayCache[i];
+		if (entry->vertexArray == 0) {
+			continue;
+		}
+		for (int j = 0; j < entry->count; ++j) {
+			if (entry->buffers[j] == bufferId) {
+				if (entry->context == vertexArrayContext) {
+					deleteVertexArray(entry);
+				}
+				else {
+					entry->count = -1;
+				}
+				break;
+			}
+		}
+	}
+#endif
+}
+
+// Vertex buffers are bound right before drawing because locking a persistently mapped buffer can
+// move it to another segment after it was set.
+
+#define MAX_VERTEX_BUFFERS 16
+
+static kinc_g4_vertex_buffer_t *vertexBuffers[MAX_VERTEX_BUFFERS];
+static GLintptr vertexBufferOffsets[MAX_VERTEX_BUFFERS];
+static int vertexBufferCount = 0;
+static bool vertexBuffersDirty = false;
+
+void Kinc_G4_Internal_SetVertexBuffers(kinc_g4_vertex_buffer_t **buffers, int count) {
+	assert(count <= MAX_VERTEX_BUFFERS);
+	for (int i = 0; i < count; ++i) {
+		vertexBuffers[i] = buffers[i];
+	}
+	vertexBufferCount = count;
+	vertexBuffersDirty = true;
+}
+
+static void forgetVertexBuffer(kinc_g4_vertex_buffer_t *buffer) {
+	for (int i = 0; i < vertexBufferCount; ++i) {
+		if (vertexBuffers[i] == buffer) {
+			vertexBufferCount = 0;
+			vertexBuffersDirty = true;
+			return;
+		}
+	}
+}
+
+// Has to be called after a different context was made current. defaultVertexArray is bound when
+// more vertex buffers are set than the cache handles, 0 stands for Kinc_Internal_DefaultVertexArray.
+void Kinc_G4_Internal_SetVertexArrayContext(int context, unsigned defaultVertexArray) {
+#ifndef KORE_OPENGL_ES
+	contextDefaultVertexArray = defaultVertexArray;
+	if (context == vertexArrayContext) {
+		return;
+	}
+	vertexArrayContext = context;
+	lastVertexArray = NULL;
+	for (int i = 0; i < VERTEX_ARRAY_CACHE_SIZE; ++i) {
+		VertexArrayCacheEntry *entry = &vertexArrayCache[i];
+		if (entry->vertexArray != 0 && entry->context == context && entry->count < 0) {
+			deleteVertexArray(entry);
+		}
+	}
+	vertexBuffersDirty = true;
+#endif
+}
+
+// The vertex arrays of a context which was deleted are gone with it.
+void Kinc_G4_Internal_ForgetVertexArrayContext(int context) {
+#ifndef KORE_OPENGL_ES
+	for (int i = 0; i < VERTEX_ARRAY_CACHE_SIZE; ++i) {
+		VertexArrayCacheEntry *entry = &vertexArrayCache[i];
+		if (entry->vertexArray != 0 && entry->context == context) {
+			if (lastVertexArray == entry) {
+				lastVertexArray = NULL;
+			}
+			memset(entry, 0, sizeof(*entry));
+		}
+	}
+#endif
+}
+
+static void setVertexBuffers(kinc_g4_vertex_buffer_t **buffers, int count) {
+#ifndef KORE_OPENGL_ES
+	if (Kinc_Internal_SupportsVertexArrayObjects) {
+		VertexArrayCacheEntry *entry = count <= MAX_CACHED_VERTEX_BUFFERS ? findVertexArray(buffers, count) : NULL;
+		if (entry != NULL) {
+			// the per-buffer part of kinc_internal_g4_vertex_buffer_set, the attributes are part of the vertex array
+			for (int i = 0; i < count; ++i) {
+				assert(buffers[i]->impl.initialized); // Vertex Buffer is used before lock/unlock was called
+			}
+			kinc_g4_internal_gl_bind_vertex_array(entry->vertexArray);
+			if (Kinc_Internal_CurrentIndexBuffer != NULL) {
+				kinc_internal_g4_index_buffer_set(Kinc_Internal_CurrentIndexBuffer);
+			}
+			return;
+		}
+		kinc_g4_internal_gl_bind_vertex_array(contextDefaultVertexArray != 0 ? contextDefaultVertexArray : Kinc_Internal_DefaultVertexArray);
+	}
+#endif
+	int offset = 0;
+	for (int i = 0; i < count; ++i) {
+		offset += kinc_internal_g4_vertex_buffer_set(buffers[i], offset);
+	}
+}
+
+void Kinc_G4_Internal_ApplyVertexBuffers(void) {
+	if (!vertexBuffersDirty) {
+		for (int i = 0; i < vertexBufferCount; ++i) {
+			if (bufferOffset(vertexBuffers[i]) != vertexBufferOffsets[i]) {
+				vertexBuffersDirty = true;
+				break;
+			}
+		}
+		if (!vertexBuffersDirty) {
+			return;
+		}
+	}
+	setVertexBuffers(vertexBuffers, vertexBufferCount);
+	for (int i = 0; i < vertexBufferCount; ++i) {
+		vertexBufferOffsets[i] = bufferOffset(vertexBuffers[i]);
+	}
+	vertexBuffersDirty = false;
+}
@@ -3,11 +3,20 @@
 #include <kinc/graphics4/vertexstructure.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define KINC_INTERNAL_G4_STREAMING_SEGMENTS 3
+
+typedef enum {
+	KINC_INTERNAL_G4_STREAMING_NONE,      // CPU-side copy uploaded via glBufferSubData
+	KINC_INTERNAL_G4_STREAMING_ORPHAN,    // buffer is orphaned and mapped on lock
+	KINC_INTERNAL_G4_STREAMING_PERSISTENT // persistently mapped ring of segments
+} kinc_internal_g4_streaming_t;
+
 typedef struct {
 	float *data;
 	int myCount;
@@ -19,6 +28,10 @@ typedef struct {
 	kinc_g4_vertex_structure_t structure;
 	//#endif
 	int instanceDataStepRate;
+	kinc_internal_g4_streaming_t streaming;
+	uint8_t *mapped;
+	int segment;
+	void *fences[KINC_INTERNAL_G4_STREAMING_SEGMENTS];
 #ifndef NDEBUG
 	bool initialized;
 #endif
@@ -30,18 +30,22 @@ void kinc_g5_constant_buffer_lock_all(kinc_g5_constant_buffer_t *buffer) {
 void kinc_g5_constant_buffer_lock(kinc_g5_constant_buffer_t *buffer, int start, int count) {
 	buffer->impl.lastStart = start;
 	buffer->impl.lastCount = count;
+	kinc_g5_internal_constant_buffer_reset_dirty(buffer);
+	// the CPU does not read from the buffer
 	D3D12_RANGE range;
-	range.Begin = start;
-	range.End = range.Begin + count;
+	range.Begin = 0;
+	range.End = 0;
 	uint8_t *p;
 	buffer->impl.constant_buffer->Map(0, &range, (void **)&p);
 	buffer->data = &p[start];
 }
 
 void kinc_g5_constant_buffer_unlock(kinc_g5_constant_buffer_t *buffer) {
+	int start, end;
+	kinc_g5_internal_constant_buffer_get_dirty_range(buffer, buffer->impl.lastCount, &start, &end);
 	D3D12_RANGE range;
-	range.Begin = buffer->impl.lastStart;
-	range.End = range.Begin + buffer->impl.lastCount;
+	range.Begin = buffer->impl.lastStart + start;
+	range.End = end > start ? buffer->impl.lastStart + end : range.Begin;
 	buffer->impl.constant_buffer->Unmap(0, &range);
 	buffer->data = nullptr;
 }
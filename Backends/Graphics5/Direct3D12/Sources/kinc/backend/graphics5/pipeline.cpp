@@ -314,6 +314,27 @@ void kinc_g5_pipeline_compile(kinc_g5_pipeline_t *pipe) {
 			case KINC_G4_VERTEX_DATA_SHORT4_NORM:
 				vertexDesc[curAttr].Format = DXGI_FORMAT_R16G16B16A16_SNORM;
 				break;
+			case KINC_G4_VERTEX_DATA_HALF2:
+				vertexDesc[curAttr].Format = DXGI_FORMAT_R16G16_FLOAT;
+				break;
+			case KINC_G4_VERTEX_DATA_HALF4:
+				vertexDesc[curAttr].Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+				break;
+			case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+				vertexDesc[curAttr].Format = DXGI_FORMAT_R8G8B8A8_SNORM;
+				break;
+			case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+				vertexDesc[curAttr].Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+				break;
+			case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+				vertexDesc[curAttr].Format = DXGI_FORMAT_R10G10B10A2_UNORM;
+				break;
+			case KINC_G4_VERTEX_DATA_SHORT2:
+				vertexDesc[curAttr].Format = DXGI_FORMAT_R16G16_SINT;
+				break;
+			case KINC_G4_VERTEX_DATA_SHORT4:
+				vertexDesc[curAttr].Format = DXGI_FORMAT_R16G16B16A16_SINT;
+				break;
 			}
 			curAttr++;
 		}
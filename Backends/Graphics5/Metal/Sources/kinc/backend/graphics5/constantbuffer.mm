@@ -22,12 +22,23 @@ void kinc_g5_constant_buffer_lock_all(kinc_g5_constant_buffer_t *buffer) {
 void kinc_g5_constant_buffer_lock(kinc_g5_constant_buffer_t *buffer, int start, int count) {
 	buffer->impl.lastStart = start;
 	buffer->impl.lastCount = count;
+	kinc_g5_internal_constant_buffer_reset_dirty(buffer);
 	uint8_t *data = (uint8_t*)[buffer->impl._buffer contents];
 	buffer->data = &data[start];
 }
 
 void kinc_g5_constant_buffer_unlock(kinc_g5_constant_buffer_t *buffer) {
-
+#ifdef KORE_MACOS
+	// managed buffers keep a copy in video-memory which has to be told about what changed
+	id<MTLBuffer> metalBuffer = buffer->impl._buffer;
+	if (metalBuffer.storageMode == MTLStorageModeManaged) {
+		int start, end;
+		kinc_g5_internal_constant_buffer_get_dirty_range(buffer, buffer->impl.lastCount, &start, &end);
+		if (end > start) {
+			[metalBuffer didModifyRange:NSMakeRange(buffer->impl.lastStart + start, end - start)];
+		}
+	}
+#endif
 	buffer->data = nullptr;
 }
 
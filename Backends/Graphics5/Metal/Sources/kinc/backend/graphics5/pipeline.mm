@@ -181,6 +181,48 @@ void kinc_g5_pipeline_compile(kinc_g5_pipeline_t *pipeline) {
 			}
 			offset += 4 * sizeof(short);
 			break;
+		case KINC_G4_VERTEX_DATA_HALF2:
+			if (index >= 0) {
+				vertexDescriptor.attributes[index].format = MTLVertexFormatHalf2;
+			}
+			offset += 2 * sizeof(short);
+			break;
+		case KINC_G4_VERTEX_DATA_HALF4:
+			if (index >= 0) {
+				vertexDescriptor.attributes[index].format = MTLVertexFormatHalf4;
+			}
+			offset += 4 * sizeof(short);
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+			if (index >= 0) {
+				vertexDescriptor.attributes[index].format = MTLVertexFormatChar4Normalized;
+			}
+			offset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+			if (index >= 0) {
+				vertexDescriptor.attributes[index].format = MTLVertexFormatUChar4Normalized;
+			}
+			offset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+			if (index >= 0) {
+				vertexDescriptor.attributes[index].format = MTLVertexFormatUInt1010102Normalized;
+			}
+			offset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT2:
+			if (index >= 0) {
+				vertexDescriptor.attributes[index].format = MTLVertexFormatShort2;
+			}
+			offset += 2 * sizeof(short);
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT4:
+			if (index >= 0) {
+				vertexDescriptor.attributes[index].format = MTLVertexFormatShort4;
+			}
+			offset += 4 * sizeof(short);
+			break;
 		default:
 			break;
 		}
@@ -4,6 +4,7 @@
 #include <kinc/graphics5/graphics.h>
 #include <kinc/graphics5/texture.h>
 #include <kinc/log.h>
+#include <kinc/memory.h>
 
 #import <Metal/Metal.h>
 
@@ -91,7 +92,7 @@ void kinc_g5_texture_init(kinc_g5_texture_t *texture, int width, int height, kin
 	texture->texWidth = width;
 	texture->texHeight = height;
 	texture->format = format;
-	texture->impl.data = malloc(width * height * (format == KINC_IMAGE_FORMAT_GREY8 ? 1 : 4));
+	texture->impl.data = kinc_memory_allocate(width * height * (format == KINC_IMAGE_FORMAT_GREY8 ? 1 : 4), KINC_MEMORY_TAG_GRAPHICS);
 	create(texture, width, height, format, true);
 }
 
@@ -114,7 +115,7 @@ void kinc_g5_texture_init_non_sampled_access(kinc_g5_texture_t *texture, int wid
 void kinc_g5_texture_destroy(kinc_g5_texture_t *texture) {
 	texture->impl._tex = nil;
 	if (texture->impl.data != NULL) {
-		free(texture->impl.data);
+		kinc_memory_free(texture->impl.data);
 		texture->impl.data = NULL;
 	}
 }
@@ -32,7 +32,10 @@ namespace {
 		mem_alloc.allocationSize = mem_reqs.size;
 		mem_alloc.memoryTypeIndex = 0;
 
-		bool pass = memory_type_from_properties(mem_reqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &mem_alloc.memoryTypeIndex);
+		// host-coherent memory does not need to be flushed so writes do not have to be tracked per lock, there is always at least one
+		// host-visible memory-type which is also host-coherent
+		bool pass = memory_type_from_properties(mem_reqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		                                        &mem_alloc.memoryTypeIndex);
 		assert(pass);
 
 		err = vkAllocateMemory(device, &mem_alloc, NULL, &mem);
@@ -61,26 +64,29 @@ void kinc_g5_constant_buffer_init(kinc_g5_constant_buffer_t *buffer, int size) {
 		Kore::Vulkan::fragmentUniformBuffer = &buffer->impl.buf;
 	}
 
-	void* p;
-	VkResult err = vkMapMemory(device, buffer->impl.mem, 0, buffer->impl.mem_alloc.allocationSize, 0, (void **)&p);
+	VkResult err = vkMapMemory(device, buffer->impl.mem, 0, buffer->impl.mem_alloc.allocationSize, 0, (void **)&buffer->impl.mapped);
 	assert(!err);
-	memset(p, 0, buffer->impl.mem_alloc.allocationSize);
-	vkUnmapMemory(device, buffer->impl.mem);
+	memset(buffer->impl.mapped, 0, buffer->impl.mem_alloc.allocationSize);
 }
 
-void kinc_g5_constant_buffer_destroy(kinc_g5_constant_buffer_t *buffer) {}
+void kinc_g5_constant_buffer_destroy(kinc_g5_constant_buffer_t *buffer) {
+	vkUnmapMemory(device, buffer->impl.mem);
+	buffer->impl.mapped = nullptr;
+}
 
 void kinc_g5_constant_buffer_lock_all(kinc_g5_constant_buffer_t *buffer) {
 	kinc_g5_constant_buffer_lock(buffer, 0, kinc_g5_constant_buffer_size(buffer));
 }
 
 void kinc_g5_constant_buffer_lock(kinc_g5_constant_buffer_t *buffer, int start, int count) {
-	VkResult err = vkMapMemory(device, buffer->impl.mem, start, count, 0, (void **)&buffer->data);
-	assert(!err);
+	buffer->impl.lastStart = start;
+	buffer->impl.lastCount = count;
+	kinc_g5_internal_constant_buffer_reset_dirty(buffer);
+	buffer->data = &buffer->impl.mapped[start];
 }
 
 void kinc_g5_constant_buffer_unlock(kinc_g5_constant_buffer_t *buffer) {
-	vkUnmapMemory(device, buffer->impl.mem);
+	// writes to host-coherent memory are visible to the next submit without mapping or flushing
 	buffer->data = nullptr;
 }
 
@@ -7,6 +7,8 @@ typedef struct {
 	VkDescriptorBufferInfo buffer_info;
 	VkMemoryAllocateInfo mem_alloc;
 	VkDeviceMemory mem;
+	// host-coherent and mapped for the whole lifetime of the buffer
+	uint8_t *mapped;
 	int lastStart;
 	int lastCount;
 	int mySize;
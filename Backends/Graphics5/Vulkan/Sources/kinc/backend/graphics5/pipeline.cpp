@@ -418,6 +418,62 @@ void kinc_g5_pipeline_compile(kinc_g5_pipeline_t *pipeline) {
 				offset += 4 * 2;
 				stride += 4 * 2;
 				break;
+			case KINC_G4_VERTEX_DATA_HALF2:
+				vi_attrs[attr].binding = binding;
+				vi_attrs[attr].location = find_number(pipeline->impl.vertexLocations, element.name);
+				vi_attrs[attr].format = VK_FORMAT_R16G16_SFLOAT;
+				vi_attrs[attr].offset = offset;
+				offset += 2 * 2;
+				stride += 2 * 2;
+				break;
+			case KINC_G4_VERTEX_DATA_HALF4:
+				vi_attrs[attr].binding = binding;
+				vi_attrs[attr].location = find_number(pipeline->impl.vertexLocations, element.name);
+				vi_attrs[attr].format = VK_FORMAT_R16G16B16A16_SFLOAT;
+				vi_attrs[attr].offset = offset;
+				offset += 4 * 2;
+				stride += 4 * 2;
+				break;
+			case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+				vi_attrs[attr].binding = binding;
+				vi_attrs[attr].location = find_number(pipeline->impl.vertexLocations, element.name);
+				vi_attrs[attr].format = VK_FORMAT_R8G8B8A8_SNORM;
+				vi_attrs[attr].offset = offset;
+				offset += 4;
+				stride += 4;
+				break;
+			case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+				vi_attrs[attr].binding = binding;
+				vi_attrs[attr].location = find_number(pipeline->impl.vertexLocations, element.name);
+				vi_attrs[attr].format = VK_FORMAT_R8G8B8A8_UNORM;
+				vi_attrs[attr].offset = offset;
+				offset += 4;
+				stride += 4;
+				break;
+			case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+				vi_attrs[attr].binding = binding;
+				vi_attrs[attr].location = find_number(pipeline->impl.vertexLocations, element.name);
+				vi_attrs[attr].format = VK_FORMAT_A2B10G10R10_UNORM_PACK32;
+				vi_attrs[attr].offset = offset;
+				offset += 4;
+				stride += 4;
+				break;
+			case KINC_G4_VERTEX_DATA_SHORT2:
+				vi_attrs[attr].binding = binding;
+				vi_attrs[attr].location = find_number(pipeline->impl.vertexLocations, element.name);
+				vi_attrs[attr].format = VK_FORMAT_R16G16_SINT;
+				vi_attrs[attr].offset = offset;
+				offset += 2 * 2;
+				stride += 2 * 2;
+				break;
+			case KINC_G4_VERTEX_DATA_SHORT4:
+				vi_attrs[attr].binding = binding;
+				vi_attrs[attr].location = find_number(pipeline->impl.vertexLocations, element.name);
+				vi_attrs[attr].format = VK_FORMAT_R16G16B16A16_SINT;
+				vi_attrs[attr].offset = offset;
+				offset += 4 * 2;
+				stride += 4 * 2;
+				break;
 			}
 		attr++;
 		}
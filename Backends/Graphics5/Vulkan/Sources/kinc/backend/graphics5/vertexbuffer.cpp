@@ -49,6 +49,27 @@ void kinc_g5_vertex_buffer_init(kinc_g5_vertex_buffer_t *buffer, int vertexCount
 		case KINC_G4_VERTEX_DATA_SHORT4_NORM:
 			buffer->impl.myStride += 4 * 2;
 			break;
+		case KINC_G4_VERTEX_DATA_HALF2:
+			buffer->impl.myStride += 2 * 2;
+			break;
+		case KINC_G4_VERTEX_DATA_HALF4:
+			buffer->impl.myStride += 4 * 2;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+			buffer->impl.myStride += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+			buffer->impl.myStride += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+			buffer->impl.myStride += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT2:
+			buffer->impl.myStride += 2 * 2;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT4:
+			buffer->impl.myStride += 4 * 2;
+			break;
 		}
 	}
 	buffer->impl.structure = *structure;
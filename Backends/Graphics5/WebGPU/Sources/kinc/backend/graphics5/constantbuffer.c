@@ -19,7 +19,9 @@ void kinc_g5_constant_buffer_lock_all(kinc_g5_constant_buffer_t *buffer) {
 	kinc_g5_constant_buffer_lock(buffer, 0, kinc_g5_constant_buffer_size(buffer));
 }
 
-void kinc_g5_constant_buffer_lock(kinc_g5_constant_buffer_t *buffer, int start, int count) {}
+void kinc_g5_constant_buffer_lock(kinc_g5_constant_buffer_t *buffer, int start, int count) {
+	kinc_g5_internal_constant_buffer_reset_dirty(buffer);
+}
 
 void kinc_g5_constant_buffer_unlock(kinc_g5_constant_buffer_t *buffer) {
 	
@@ -73,6 +73,35 @@ void kinc_g5_pipeline_compile(kinc_g5_pipeline_t *pipe) {
 			vaDesc[i].format = WGPUVertexFormat_Snorm16x4;
 			offset += 8;
 			break;
+		case KINC_G4_VERTEX_DATA_HALF2:
+			vaDesc[i].format = WGPUVertexFormat_Float16x2;
+			offset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_HALF4:
+			vaDesc[i].format = WGPUVertexFormat_Float16x4;
+			offset += 8;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_NORM:
+			vaDesc[i].format = WGPUVertexFormat_Snorm8x4;
+			offset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_BYTE4_UNORM:
+			vaDesc[i].format = WGPUVertexFormat_Unorm8x4;
+			offset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_UINT10_10_10_2:
+			// WebGPU has no packed 10 bit vertex-format, the word has to be unpacked in the shader
+			vaDesc[i].format = WGPUVertexFormat_Uint32;
+			offset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT2:
+			vaDesc[i].format = WGPUVertexFormat_Sint16x2;
+			offset += 4;
+			break;
+		case KINC_G4_VERTEX_DATA_SHORT4:
+			vaDesc[i].format = WGPUVertexFormat_Sint16x4;
+			offset += 8;
+			break;
 		}
 	}
 
@@ -4,6 +4,8 @@
 
 #define KINC_ATOMIC_COMPARE_EXCHANGE_POINTER(pointer, oldValue, newValue)
 
+#define KINC_ATOMIC_COMPARE_EXCHANGE_64(pointer, oldValue, newValue)
+
 #define KINC_ATOMIC_INCREMENT(pointer)
 
 #define KINC_ATOMIC_DECREMENT(pointer)
@@ -3,7 +3,7 @@
 #include <string.h>
 
 void kinc_thread_local_init(kinc_thread_local_t *local) {
-	
+	local->impl.data = NULL;
 }
 
 void kinc_thread_local_destroy(kinc_thread_local_t *local) {
@@ -11,9 +11,9 @@ void kinc_thread_local_destroy(kinc_thread_local_t *local) {
 }
 
 void* kinc_thread_local_get(kinc_thread_local_t *local) {
-	return NULL;
+	return local->impl.data;
 }
 
 void kinc_thread_local_set(kinc_thread_local_t *local, void* data) {
-	
+	local->impl.data = data;
 }
@@ -5,7 +5,7 @@ extern "C" {
 #endif
 
 typedef struct {
-	int nothing;
+	void *data;
 } kinc_thread_local_impl_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <kinc/global.h>
+
+/*! \file headless.h
+    \brief Controls the headless system backend which runs without a display, a GPU or sound hardware - for servers, bots and benchmarks.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// <summary>
+/// Switches to a fixed time step. Every frame then advances kinc_timestamp and kinc_time by exactly the given amount and frames run back to back
+/// as fast as possible, which makes simulations reproducible and independent of the machine's speed. Audio is mixed on the main thread with the
+/// matching number of samples per frame. kinc_set_target_frame_rate has no effect in this mode.
+/// </summary>
+/// <param name="seconds">The duration of one frame or 0 to go back to real time</param>
+KINC_FUNC void kinc_headless_set_fixed_step(double seconds);
+
+/// <summary>
+/// Returns the fixed time step or 0 when running in real time.
+/// </summary>
+KINC_FUNC double kinc_headless_fixed_step(void);
+
+/// <summary>
+/// Stops the kinc_start-loop after the given number of frames, counted from the call.
+/// </summary>
+/// <param name="frames">The number of frames or 0 to run until kinc_stop is called</param>
+KINC_FUNC void kinc_headless_set_frame_limit(int frames);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,45 @@
+#include <kinc/input/gamepad.h>
+#include <kinc/input/mouse.h>
+
+// There are no input devices, input can still be injected using the kinc_internal_*_trigger-functions.
+
+static int mouse_x = 0;
+static int mouse_y = 0;
+
+void kinc_internal_mouse_lock(int window) {}
+
+void kinc_internal_mouse_unlock(void) {}
+
+bool kinc_mouse_can_lock(void) {
+	return false;
+}
+
+void kinc_mouse_show(void) {}
+
+void kinc_mouse_hide(void) {}
+
+void kinc_mouse_set_cursor(int cursor) {}
+
+void kinc_mouse_set_position(int window, int x, int y) {
+	mouse_x = x;
+	mouse_y = y;
+}
+
+void kinc_mouse_get_position(int window, int *x, int *y) {
+	*x = mouse_x;
+	*y = mouse_y;
+}
+
+const char *kinc_gamepad_vendor(int gamepad) {
+	return "None";
+}
+
+const char *kinc_gamepad_product_name(int gamepad) {
+	return "None";
+}
+
+bool kinc_gamepad_connected(int gamepad) {
+	return false;
+}
+
+void kinc_gamepad_rumble(int gamepad, float left, float right) {}
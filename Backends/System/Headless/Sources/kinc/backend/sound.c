@@ -0,0 +1,107 @@
+#include "headless.h"
+
+#include <kinc/audio2/audio.h>
+#include <kinc/memory.h>
+#include <kinc/system.h>
+#include <kinc/threads/mutex.h>
+#include <kinc/threads/thread.h>
+
+#include <stdlib.h>
+
+// A sound device which consumes samples at the output rate and throws them away. The callback still runs exactly like it does on real hardware
+// so mixing costs show up in profiles.
+
+#define CHUNK_FRAMES 512
+
+static void (*a2_callback)(kinc_a2_buffer_t *buffer, int samples) = NULL;
+static void (*a2_sample_rate_callback)(void) = NULL;
+static kinc_a2_buffer_t a2_buffer;
+
+static kinc_mutex_t mutex;
+static kinc_thread_t thread;
+static volatile bool running = false;
+static double pending_frames = 0.0;
+
+static void mix(void) {
+	int frames = (int)pending_frames;
+	pending_frames -= frames;
+	while (frames > 0) {
+		int count = frames < CHUNK_FRAMES ? frames : CHUNK_FRAMES;
+		if (a2_callback != NULL) {
+			a2_callback(&a2_buffer, count * 2);
+			a2_buffer.read_location = a2_buffer.write_location;
+		}
+		frames -= count;
+	}
+}
+
+static void run(void *param) {
+	kinc_ticks_t last = kinc_timestamp();
+	bool fixed = false;
+	while (running) {
+		kinc_thread_sleep(CHUNK_FRAMES * 1000 / kinc_a2_samples_per_second / 2);
+		kinc_mutex_lock(&mutex);
+		kinc_ticks_t now = kinc_timestamp();
+		// in fixed-step mode the main thread mixes, afterwards start counting anew because virtual time jumps
+		if (kinc_headless_fixed_step() > 0.0) {
+			fixed = true;
+		}
+		else if (fixed) {
+			fixed = false;
+		}
+		else {
+			pending_frames += (now - last) / kinc_frequency() * kinc_a2_samples_per_second;
+			mix();
+		}
+		last = now;
+		kinc_mutex_unlock(&mutex);
+	}
+}
+
+void kinc_internal_headless_audio_advance(double seconds) {
+	if (!running) {
+		return;
+	}
+	kinc_mutex_lock(&mutex);
+	pending_frames += seconds * kinc_a2_samples_per_second;
+	mix();
+	kinc_mutex_unlock(&mutex);
+}
+
+void kinc_a2_init(void) {
+	if (running) {
+		return;
+	}
+	a2_buffer.format.channels = 2;
+	a2_buffer.format.samples_per_second = kinc_a2_samples_per_second;
+	a2_buffer.format.bits_per_sample = 32;
+	a2_buffer.read_location = 0;
+	a2_buffer.write_location = 0;
+	a2_buffer.data_size = 128 * 1024;
+	a2_buffer.data = (uint8_t *)kinc_memory_allocate(a2_buffer.data_size, KINC_MEMORY_TAG_AUDIO);
+
+	kinc_mutex_init(&mutex);
+	running = true;
+	kinc_thread_init(&thread, run, NULL);
+}
+
+void kinc_a2_update(void) {}
+
+void kinc_a2_shutdown(void) {
+	if (!running) {
+		return;
+	}
+	running = false;
+	kinc_thread_wait_and_destroy(&thread);
+	kinc_mutex_destroy(&mutex);
+	kinc_memory_free(a2_buffer.data);
+	a2_buffer.data = NULL;
+}
+
+void kinc_internal_a2_set_callback(void (*kinc_a2_audio_callback)(kinc_a2_buffer_t *buffer, int samples)) {
+	a2_callback = kinc_a2_audio_callback;
+}
+
+void kinc_a2_set_sample_rate_callback(void (*kinc_a2_sample_rate_callback)(void)) {
+	a2_sample_rate_callback = kinc_a2_sample_rate_callback;
+}
@@ -0,0 +1,199 @@
+#include "headless.h"
+
+#include <kinc/display.h>
+#include <kinc/graphics4/graphics.h>
+#include <kinc/system.h>
+#include <kinc/window.h>
+
+#include <pwd.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+void kinc_internal_headless_audio_advance(double seconds);
+
+static double fixed_step = 0.0;
+static kinc_ticks_t fixed_start = 0;
+static int64_t fixed_frames = 0;
+static volatile kinc_ticks_t virtual_time = 0;
+
+static int frame_limit = 0;
+static int frame_count = 0;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+double kinc_frequency(void) {
+	return 1000000000.0;
+}
+
+static kinc_ticks_t monotonic_nanoseconds(void) {
+	struct timespec now;
+#ifdef CLOCK_MONOTONIC_RAW
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+	return (kinc_ticks_t)now.tv_sec * 1000000000 + (kinc_ticks_t)now.tv_nsec;
+}
+
+static kinc_ticks_t start = 0;
+
+static kinc_ticks_t real_timestamp(void) {
+	kinc_ticks_t now = monotonic_nanoseconds();
+	if (start == 0) {
+		start = now - 1;
+	}
+	return now - start;
+}
+
+kinc_ticks_t kinc_timestamp(void) {
+	if (fixed_step > 0.0) {
+		return virtual_time;
+	}
+	return real_timestamp();
+}
+
+void kinc_headless_set_fixed_step(double seconds) {
+	kinc_ticks_t now = kinc_timestamp();
+	if (seconds > 0.0) {
+		fixed_start = now;
+		fixed_frames = 0;
+		virtual_time = now;
+	}
+	else if (fixed_step > 0.0) {
+		// continue real time from where virtual time stopped
+		start = monotonic_nanoseconds() - now;
+	}
+	fixed_step = seconds > 0.0 ? seconds : 0.0;
+}
+
+double kinc_headless_fixed_step(void) {
+	return fixed_step;
+}
+
+void kinc_headless_set_frame_limit(int frames) {
+	frame_limit = frames;
+	frame_count = 0;
+}
+
+static void request_stop(int signal) {
+	stop_requested = 1;
+}
+
+bool kinc_internal_handle_messages(void) {
+	if (stop_requested) {
+		kinc_stop();
+	}
+	if (frame_limit > 0 && ++frame_count >= frame_limit) {
+		kinc_stop();
+	}
+	if (fixed_step > 0.0) {
+		// derived from the frame count so that rounding errors do not add up
+		++fixed_frames;
+		virtual_time = fixed_start + (kinc_ticks_t)(fixed_frames * fixed_step * kinc_frequency() + 0.5);
+		kinc_internal_headless_audio_advance(fixed_step);
+	}
+	return true;
+}
+
+const char *kinc_system_id(void) {
+	return "Headless";
+}
+
+void kinc_set_keep_screen_on(bool on) {}
+
+void kinc_keyboard_show(void) {}
+
+void kinc_keyboard_hide(void) {}
+
+bool kinc_keyboard_active(void) {
+	return false;
+}
+
+void kinc_load_url(const char *url) {}
+
+void kinc_vibrate(int milliseconds) {}
+
+const char *kinc_language(void) {
+	return "en";
+}
+
+static char save[2000];
+static bool save_initialized = false;
+
+const char *kinc_internal_save_path(void) {
+	if (!save_initialized) {
+		const char *homedir;
+		if ((homedir = getenv("HOME")) == NULL) {
+			homedir = getpwuid(getuid())->pw_dir;
+		}
+
+		strcpy(save, homedir);
+		strcat(save, "/.");
+		strcat(save, kinc_application_name());
+		strcat(save, "/");
+
+		mkdir(save, 0700);
+
+		save_initialized = true;
+	}
+	return save;
+}
+
+static const char *video_formats[] = {NULL};
+
+const char **kinc_video_formats(void) {
+	return video_formats;
+}
+
+void kinc_login(void) {}
+
+void kinc_unlock_achievement(int id) {}
+
+static char clipboard[4096];
+
+void kinc_copy_to_clipboard(const char *text) {
+	strncpy(clipboard, text, sizeof(clipboard) - 1);
+}
+
+int kinc_init(const char *name, int width, int height, kinc_window_options_t *win, kinc_framebuffer_options_t *frame) {
+	kinc_timestamp();
+	kinc_display_init();
+
+	// servers are usually stopped using signals, let them shut down like a closed window would
+	signal(SIGINT, request_stop);
+	signal(SIGTERM, request_stop);
+
+	kinc_set_application_name(name);
+	kinc_window_options_t default_win;
+	if (win == NULL) {
+		kinc_window_options_set_defaults(&default_win);
+		win = &default_win;
+	}
+	kinc_framebuffer_options_t default_frame;
+	if (frame == NULL) {
+		kinc_framebuffer_options_set_defaults(&default_frame);
+		frame = &default_frame;
+	}
+	win->width = width;
+	win->height = height;
+	if (win->title == NULL) {
+		win->title = name;
+	}
+	int window = kinc_window_create(win, frame);
+	kinc_g4_init(window, frame->depth_bits, frame->stencil_bits, frame->vertical_sync);
+	return window;
+}
+
+void kinc_internal_shutdown(void) {
+	kinc_internal_shutdown_callback();
+}
+
+#ifndef KINC_NO_MAIN
+int main(int argc, char **argv) {
+	return kickstart(argc, argv);
+}
+#endif
@@ -0,0 +1,139 @@
+#include <kinc/display.h>
+#include <kinc/window.h>
+
+#include <stddef.h>
+
+// Windows only exist as sizes so that code which queries them keeps working.
+
+#define MAXIMUM_WINDOWS 16
+
+typedef struct {
+	int x;
+	int y;
+	int width;
+	int height;
+	kinc_window_mode_t mode;
+	void (*resize_callback)(int x, int y, void *data);
+	void *resize_callback_data;
+} headless_window;
+
+static headless_window windows[MAXIMUM_WINDOWS];
+static int window_count = 0;
+
+int kinc_window_create(kinc_window_options_t *win, kinc_framebuffer_options_t *frame) {
+	if (window_count == MAXIMUM_WINDOWS) {
+		return -1;
+	}
+	headless_window *window = &windows[window_count];
+	window->x = win->x < 0 ? 0 : win->x;
+	window->y = win->y < 0 ? 0 : win->y;
+	window->width = win->width;
+	window->height = win->height;
+	window->mode = win->mode;
+	window->resize_callback = NULL;
+	window->resize_callback_data = NULL;
+	return window_count++;
+}
+
+void kinc_window_destroy(int window_index) {}
+
+int kinc_count_windows(void) {
+	return window_count;
+}
+
+void kinc_window_resize(int window_index, int width, int height) {
+	headless_window *window = &windows[window_index];
+	window->width = width;
+	window->height = height;
+	if (window->resize_callback != NULL) {
+		window->resize_callback(width, height, window->resize_callback_data);
+	}
+}
+
+void kinc_window_move(int window_index, int x, int y) {
+	windows[window_index].x = x;
+	windows[window_index].y = y;
+}
+
+void kinc_window_change_mode(int window_index, kinc_window_mode_t mode) {
+	windows[window_index].mode = mode;
+}
+
+void kinc_window_change_features(int window_index, int features) {}
+
+void kinc_window_change_framebuffer(int window_index, kinc_framebuffer_options_t *frame) {}
+
+int kinc_window_x(int window_index) {
+	return windows[window_index].x;
+}
+
+int kinc_window_y(int window_index) {
+	return windows[window_index].y;
+}
+
+int kinc_window_width(int window_index) {
+	return windows[window_index].width;
+}
+
+int kinc_window_height(int window_index) {
+	return windows[window_index].height;
+}
+
+int kinc_window_display(int window_index) {
+	return 0;
+}
+
+kinc_window_mode_t kinc_window_get_mode(int window_index) {
+	return windows[window_index].mode;
+}
+
+void kinc_window_show(int window_index) {}
+
+void kinc_window_hide(int window_index) {}
+
+void kinc_window_set_title(int window_index, const char *title) {}
+
+void kinc_window_set_resize_callback(int window_index, void (*callback)(int x, int y, void *data), void *data) {
+	windows[window_index].resize_callback = callback;
+	windows[window_index].resize_callback_data = data;
+}
+
+void kinc_window_set_ppi_changed_callback(int window_index, void (*callback)(int ppi, void *data), void *data) {}
+
+void kinc_display_init(void) {}
+
+int kinc_primary_display(void) {
+	return 0;
+}
+
+int kinc_count_displays(void) {
+	return 1;
+}
+
+bool kinc_display_available(int display_index) {
+	return display_index == 0;
+}
+
+const char *kinc_display_name(int display_index) {
+	return "Headless";
+}
+
+kinc_display_mode_t kinc_display_current_mode(int display_index) {
+	kinc_display_mode_t mode;
+	mode.x = 0;
+	mode.y = 0;
+	mode.width = 1920;
+	mode.height = 1080;
+	mode.pixels_per_inch = 96;
+	mode.frequency = 60;
+	mode.bits_per_pixel = 32;
+	return mode;
+}
+
+int kinc_display_count_available_modes(int display_index) {
+	return 1;
+}
+
+kinc_display_mode_t kinc_display_available_mode(int display_index, int mode_index) {
+	return kinc_display_current_mode(display_index);
+}
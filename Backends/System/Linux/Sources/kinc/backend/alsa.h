@@ -0,0 +1,60 @@
+#pragma once
+
+#include <kinc/global.h>
+
+/*! \file alsa.h
+    \brief Configures the ALSA-output which is used by Audio2 on Linux. Smaller and fewer periods lower the latency but need a faster audio-thread to
+   avoid underruns.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct kinc_alsa_options {
+	// the ALSA-device, "default" by default
+	const char *device;
+	// frames per period or 0 to derive it from latency and periods
+	int period_frames;
+	int periods;
+	// the targeted size of the output-buffer in seconds, only used when period_frames is 0
+	double latency;
+	// writes directly into the device's buffer using SND_PCM_ACCESS_MMAP_INTERLEAVED, falls back to regular writes when unsupported
+	bool mmap;
+	// runs the audio-thread with SCHED_FIFO, which requires CAP_SYS_NICE or an rtprio-limit
+	bool realtime;
+} kinc_alsa_options_t;
+
+/// <summary>
+/// Sets options to their defaults, which keep the output-buffer at 1/8 of a second like in previous versions.
+/// </summary>
+KINC_FUNC void kinc_alsa_options_set_defaults(kinc_alsa_options_t *options);
+
+/// <summary>
+/// Sets the options which are used by the next call to kinc_a2_init. The device name is copied.
+/// </summary>
+KINC_FUNC void kinc_alsa_configure(const kinc_alsa_options_t *options);
+
+/// <summary>
+/// Returns the output-latency which was measured last - the time it takes until a sample which is mixed now is played - in seconds.
+/// </summary>
+KINC_FUNC double kinc_alsa_latency(void);
+
+/// <summary>
+/// Returns the period-size which the device actually uses.
+/// </summary>
+KINC_FUNC int kinc_alsa_period_frames(void);
+
+/// <summary>
+/// Returns the buffer-size which the device actually uses.
+/// </summary>
+KINC_FUNC int kinc_alsa_buffer_frames(void);
+
+/// <summary>
+/// Returns the number of buffer-underruns since kinc_a2_init.
+/// </summary>
+KINC_FUNC int kinc_alsa_underruns(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,240 +1,515 @@
 #include "gamepad.h"
 
 #include <kinc/input/gamepad.h>
-
+#include <kinc/input/queue.h>
+#include <kinc/log.h>
+#include <kinc/system.h>
+#include <kinc/threads/atomic.h>
+#include <kinc/threads/mutex.h>
+#include <kinc/threads/thread.h>
+
+#include <errno.h>
 #include <fcntl.h>
 #include <libudev.h>
-#include <linux/joystick.h>
+#include <linux/input.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
+#include <time.h>
 #include <unistd.h>
 
 using namespace Kore;
 
-namespace {
+// older kernel-headers only have the timeval
+#ifndef input_event_sec
+#define input_event_sec time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
 
-	struct HIDGamepad {
-		HIDGamepad();
-		~HIDGamepad();
-		void init(int index);
-		void update();
+// Gamepads are read from their evdev nodes (/dev/input/event*) on a dedicated thread which sleeps in epoll_wait, so input does not wait for the next
+// frame. While the queued input-mode is active the thread passes events on directly (the queue is thread-safe and timestamps them on arrival),
+// otherwise they are handed to the main thread through a lock-free single-producer/single-consumer ring and dispatched in updateHIDGamepads.
+// Either way they keep the time the kernel recorded for them, see kinc_gamepad_event_timestamp.
+// Axes and buttons are numbered like the legacy joystick-driver (/dev/input/js*) numbers them, so existing mappings keep working.
 
-		int idx;
-		char gamepad_dev_name[256];
-		char name[384];
-		int file_descriptor;
-		bool connected;
-		js_event gamepadEvent;
+namespace {
+	const int gamepadCount = 12;
+	const uint32_t udevTag = 0xfffffffe;
+	const uint32_t wakeTag = 0xffffffff;
 
-		void open();
-		void close();
-		void processEvent(js_event e);
-	};
+	// has to be a power of two
+	const int ringSize = 1024;
 
-	HIDGamepad::HIDGamepad() {}
+	const int maxAxes = ABS_CNT;
+	const int maxButtons = KEY_MAX - BTN_MISC + 1;
 
-	void HIDGamepad::init(int index) {
-		file_descriptor = -1;
-		connected = false;
-		gamepad_dev_name[0] = 0;
-		if (index >= 0 && index < 12) {
-			idx = index;
-			snprintf(gamepad_dev_name, sizeof(gamepad_dev_name), "/dev/input/js%d", idx);
-			open();
-		}
+	bool testBit(const unsigned long *bits, int bit) {
+		return (bits[bit / (8 * sizeof(unsigned long))] >> (bit % (8 * sizeof(unsigned long)))) & 1;
 	}
 
-	HIDGamepad::~HIDGamepad() {
-		close();
+	// evdev-nodes and eventfds only transfer complete records, anything shorter is an error
+	bool writeRecord(int fd, const void *record, size_t size) {
+		for (;;) {
+			ssize_t written = write(fd, record, size);
+			if (written == (ssize_t)size) {
+				return true;
+			}
+			if (written < 0 && errno == EINTR) {
+				continue;
+			}
+			if (written >= 0) {
+				errno = EIO;
+			}
+			return false;
+		}
 	}
 
-	void HIDGamepad::open() {
-		file_descriptor = ::open(gamepad_dev_name, O_RDONLY | O_NONBLOCK);
-		if (file_descriptor < 0) {
-			connected = false;
-		}
-		else {
-			connected = true;
+	struct RingEvent {
+		kinc_ticks_t timestamp;
+		int gamepad;
+		int index;
+		float value;
+		bool axis;
+	};
 
-			char buf[128];
-			if (ioctl(file_descriptor, JSIOCGNAME(sizeof(buf)), buf) < 0) strncpy(buf, "Unknown", sizeof(buf));
-			snprintf(name, sizeof(name), "%s%s%s%s", buf, " (", gamepad_dev_name, ")");
+	RingEvent ring[ringSize];
+	volatile int32_t ringWrite = 0;
+	volatile int32_t ringRead = 0;
+	volatile int32_t ringDropped = 0;
+
+	// evdev-timestamps use CLOCK_MONOTONIC (see EvdevGamepad::open) while kinc_timestamp uses CLOCK_MONOTONIC_RAW, so only the age of the
+	// event is carried over
+	kinc_ticks_t toTimestamp(const input_event &e) {
+		kinc_ticks_t current = kinc_timestamp();
+		timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		int64_t age = ((int64_t)now.tv_sec - (int64_t)e.input_event_sec) * 1000000000 + ((int64_t)now.tv_nsec - (int64_t)e.input_event_usec * 1000);
+		if (age <= 0 || (kinc_ticks_t)age >= current) {
+			return current;
 		}
+		return current - (kinc_ticks_t)age;
 	}
 
-	void HIDGamepad::close() {
-		if (connected) {
-			::close(file_descriptor);
-			file_descriptor = -1;
-			connected = false;
+	void pushEvent(int gamepad, bool axis, int index, float value, kinc_ticks_t timestamp) {
+		// the queue can be switched off at any time, events which miss it go through the ring and reach the callbacks on the main thread
+		kinc_input_event_t queued;
+		if (axis) {
+			queued.type = KINC_INPUT_EVENT_GAMEPAD_AXIS;
+			queued.data.gamepad_axis.gamepad = gamepad;
+			queued.data.gamepad_axis.axis = index;
+			queued.data.gamepad_axis.value = value;
 		}
-	}
-
-	void HIDGamepad::update() {
-		if (connected) {
-			while (read(file_descriptor, &gamepadEvent, sizeof(gamepadEvent)) > 0) {
-				processEvent(gamepadEvent);
-			}
+		else {
+			queued.type = KINC_INPUT_EVENT_GAMEPAD_BUTTON;
+			queued.data.gamepad_button.gamepad = gamepad;
+			queued.data.gamepad_button.button = index;
+			queued.data.gamepad_button.value = value;
+		}
+		if (kinc_internal_input_queue_try_push_at(&queued, timestamp)) {
+			return;
 		}
+		int32_t position = ringWrite;
+		if ((uint32_t)position - (uint32_t)ringRead >= (uint32_t)ringSize) {
+			KINC_ATOMIC_INCREMENT(&ringDropped);
+			return;
+		}
+		RingEvent *event = &ring[(uint32_t)position & (ringSize - 1)];
+		event->timestamp = timestamp;
+		event->gamepad = gamepad;
+		event->axis = axis;
+		event->index = index;
+		event->value = value;
+		// full barrier, publishes the entry
+		KINC_ATOMIC_COMPARE_EXCHANGE(&ringWrite, position, (int32_t)((uint32_t)position + 1));
 	}
 
-	void HIDGamepad::processEvent(js_event e) {
-		switch (e.type) {
-		case JS_EVENT_BUTTON:
-			kinc_internal_gamepad_trigger_button(idx, e.number, e.value);
-			break;
-		case JS_EVENT_AXIS: {
-            float value = e.number % 2 == 0 ? e.value : -e.value;
-            kinc_internal_gamepad_trigger_axis(idx, e.number, value / 32767.0f);
-            break;
-        }
-		default:
-			break;
+	void drainEvents() {
+		int32_t dropped = ringDropped;
+		if (dropped != 0 && KINC_ATOMIC_COMPARE_EXCHANGE(&ringDropped, dropped, 0)) {
+			kinc_log(KINC_LOG_LEVEL_WARNING, "Dropped %i gamepad-events because the ring-buffer was full.", (int)dropped);
+		}
+		for (;;) {
+			int32_t position = ringRead;
+			if (position == ringWrite) {
+				break;
+			}
+			RingEvent event = ring[(uint32_t)position & (ringSize - 1)];
+			KINC_ATOMIC_COMPARE_EXCHANGE(&ringRead, position, (int32_t)((uint32_t)position + 1));
+			if (event.axis) {
+				kinc_internal_gamepad_trigger_axis_at(event.gamepad, event.index, event.value, event.timestamp);
+			}
+			else {
+				kinc_internal_gamepad_trigger_button_at(event.gamepad, event.index, event.value, event.timestamp);
+			}
 		}
 	}
 
+	struct EvdevGamepad {
+		void open(const char *devnode, int epollFD);
+		void close(int epollFD);
+		void read();
+		void sync();
+		void rumble(float left, float right);
 
-	struct HIDGamepadUdevHelper {
-
-	private:
-
-		struct udev* udevPtr;
-		struct udev_monitor* udevMonitorPtr;
-		int udevMonitorFD;
-
-		void openOrCloseGamepad(struct udev_device* dev);
-		void processDevice(struct udev_device* dev);
-
-	public:
-
-		void init();
-		void update();
-		void close();
+		int idx;
+		char devnode[64];
+		char name[384];
+		int file_descriptor;
+		volatile bool connected;
+		int16_t effect;
+		int16_t axisIndex[maxAxes];
+		int16_t buttonIndex[maxButtons];
+		input_absinfo absinfo[maxAxes];
 
+		void processAxis(int code, int value, kinc_ticks_t timestamp);
 	};
 
-	void HIDGamepadUdevHelper::processDevice(struct udev_device* dev) {
-
-	    if (dev) {
-
-		    if (udev_device_get_devnode(dev))
-		        HIDGamepadUdevHelper::openOrCloseGamepad(dev);
-
-		    udev_device_unref(dev);
-
+	void EvdevGamepad::open(const char *node, int epollFD) {
+		file_descriptor = ::open(node, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+		if (file_descriptor < 0 && (errno == EACCES || errno == EPERM)) {
+			// no write access, still fine for everything but rumble
+			file_descriptor = ::open(node, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+		}
+		if (file_descriptor < 0) {
+			return;
 		}
 
-	}
-
-	void HIDGamepadUdevHelper::init() {
-
-	    struct udev* udevPtrNew = udev_new();
-
-	    //enumerate
-	    struct udev_enumerate* enumerate = udev_enumerate_new(udevPtrNew);
-
-	    udev_enumerate_add_match_subsystem(enumerate, "input");
-	    udev_enumerate_scan_devices(enumerate);
-
-	    struct udev_list_entry* devices = udev_enumerate_get_list_entry(enumerate);
-	    struct udev_list_entry* entry;
-
-	    udev_list_entry_foreach(entry, devices) {
-	        const char* path = udev_list_entry_get_name(entry);
-	        struct udev_device* dev = udev_device_new_from_syspath(udevPtrNew, path);
-	        processDevice(dev);
-	    }
-
-	    udev_enumerate_unref(enumerate);
-
-	    //setup mon
-	    udevMonitorPtr = udev_monitor_new_from_netlink(udevPtrNew, "udev");
+		unsigned long absBits[ABS_CNT / (8 * sizeof(unsigned long)) + 1];
+		unsigned long keyBits[KEY_CNT / (8 * sizeof(unsigned long)) + 1];
+		memset(absBits, 0, sizeof(absBits));
+		memset(keyBits, 0, sizeof(keyBits));
+		ioctl(file_descriptor, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+		ioctl(file_descriptor, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits);
+		int clock = CLOCK_MONOTONIC;
+		ioctl(file_descriptor, EVIOCSCLOCKID, &clock);
+
+		int axes = 0;
+		for (int code = 0; code < maxAxes; ++code) {
+			axisIndex[code] = -1;
+			if (testBit(absBits, code) && ioctl(file_descriptor, EVIOCGABS(code), &absinfo[code]) >= 0) {
+				axisIndex[code] = axes++;
+			}
+		}
 
-	    udev_monitor_filter_add_match_subsystem_devtype(udevMonitorPtr, "input", NULL);
-	    udev_monitor_enable_receiving(udevMonitorPtr);
+		// joystick-buttons first, then the remaining misc-buttons, like the joystick-driver
+		int buttons = 0;
+		for (int code = BTN_MISC; code <= KEY_MAX; ++code) {
+			buttonIndex[code - BTN_MISC] = -1;
+		}
+		for (int code = BTN_JOYSTICK; code <= KEY_MAX; ++code) {
+			if (testBit(keyBits, code)) buttonIndex[code - BTN_MISC] = buttons++;
+		}
+		for (int code = BTN_MISC; code < BTN_JOYSTICK; ++code) {
+			if (testBit(keyBits, code)) buttonIndex[code - BTN_MISC] = buttons++;
+		}
 
-	    udevMonitorFD = udev_monitor_get_fd(udevMonitorPtr);
+		char buf[128];
+		if (ioctl(file_descriptor, EVIOCGNAME(sizeof(buf)), buf) < 0) strncpy(buf, "Unknown", sizeof(buf));
+		buf[sizeof(buf) - 1] = 0;
+		strncpy(devnode, node, sizeof(devnode) - 1);
+		devnode[sizeof(devnode) - 1] = 0;
+		snprintf(name, sizeof(name), "%s%s%s%s", buf, " (", devnode, ")");
+		effect = -1;
 
-		udevPtr = udevPtrNew;
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u32 = idx;
+		epoll_ctl(epollFD, EPOLL_CTL_ADD, file_descriptor, &event);
 
+		connected = true;
 	}
 
-	void HIDGamepadUdevHelper::update() {
-
-	    fd_set fds;
-	    FD_ZERO(&fds);
-	    FD_SET(udevMonitorFD, &fds);
-
-	    if (FD_ISSET(udevMonitorFD, &fds)) {
-	        struct udev_device* dev = udev_monitor_receive_device(udevMonitorPtr);
-	        processDevice(dev);
-	    }
+	void EvdevGamepad::close(int epollFD) {
+		if (file_descriptor >= 0) {
+			connected = false;
+			epoll_ctl(epollFD, EPOLL_CTL_DEL, file_descriptor, NULL);
+			::close(file_descriptor);
+			file_descriptor = -1;
+			devnode[0] = 0;
+		}
+	}
 
+	void EvdevGamepad::processAxis(int code, int value, kinc_ticks_t timestamp) {
+		int index = axisIndex[code];
+		if (index < 0) {
+			return;
+		}
+		const input_absinfo &info = absinfo[code];
+		float normalized = 0.0f;
+		if (info.maximum > info.minimum) {
+			normalized = (value - info.minimum) * 2.0f / (info.maximum - info.minimum) - 1.0f;
+		}
+		pushEvent(idx, true, index, index % 2 == 0 ? normalized : -normalized, timestamp);
 	}
 
-	void HIDGamepadUdevHelper::close() {
+	void EvdevGamepad::read() {
+		input_event events[64];
+		for (;;) {
+			ssize_t size = ::read(file_descriptor, events, sizeof(events));
+			if (size < 0 && errno == EINTR) {
+				continue;
+			}
+			if (size <= 0) {
+				// EAGAIN when everything was read, other errors are followed by EPOLLERR or the udev remove-event
+				break;
+			}
+			int count = (int)(size / sizeof(input_event));
+			for (int i = 0; i < count; ++i) {
+				const input_event &e = events[i];
+				switch (e.type) {
+				case EV_KEY:
+					// ignore autorepeat
+					if (e.code >= BTN_MISC && e.code <= KEY_MAX && e.value != 2 && buttonIndex[e.code - BTN_MISC] >= 0) {
+						pushEvent(idx, false, buttonIndex[e.code - BTN_MISC], (float)e.value, toTimestamp(e));
+					}
+					break;
+				case EV_ABS:
+					if (e.code < maxAxes) processAxis(e.code, e.value, toTimestamp(e));
+					break;
+				case EV_SYN:
+					if (e.code == SYN_DROPPED) sync();
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	}
 
-	    udev_unref(udevPtr);
+	// the kernel ran out of buffer space, refetch the complete state
+	void EvdevGamepad::sync() {
+		kinc_ticks_t timestamp = kinc_timestamp();
+		input_event drop[64];
+		while (::read(file_descriptor, drop, sizeof(drop)) > 0) {
+		}
+		for (int code = 0; code < maxAxes; ++code) {
+			if (axisIndex[code] >= 0 && ioctl(file_descriptor, EVIOCGABS(code), &absinfo[code]) >= 0) {
+				processAxis(code, absinfo[code].value, timestamp);
+			}
+		}
+		unsigned long keyState[KEY_CNT / (8 * sizeof(unsigned long)) + 1];
+		memset(keyState, 0, sizeof(keyState));
+		ioctl(file_descriptor, EVIOCGKEY(sizeof(keyState)), keyState);
+		for (int code = BTN_MISC; code <= KEY_MAX; ++code) {
+			if (buttonIndex[code - BTN_MISC] >= 0) {
+				pushEvent(idx, false, buttonIndex[code - BTN_MISC], testBit(keyState, code) ? 1.0f : 0.0f, timestamp);
+			}
+		}
+	}
 
+	void EvdevGamepad::rumble(float left, float right) {
+		if (!connected) {
+			return;
+		}
+		input_event play;
+		memset(&play, 0, sizeof(play));
+		play.type = EV_FF;
+		if (left <= 0.0f && right <= 0.0f) {
+			if (effect >= 0) {
+				play.code = effect;
+				play.value = 0;
+				if (!writeRecord(file_descriptor, &play, sizeof(play))) {
+					kinc_log(KINC_LOG_LEVEL_WARNING, "Could not stop rumbling of %s: %s", name, strerror(errno));
+				}
+			}
+			return;
+		}
+		ff_effect rumbleEffect;
+		memset(&rumbleEffect, 0, sizeof(rumbleEffect));
+		rumbleEffect.type = FF_RUMBLE;
+		rumbleEffect.id = effect;
+		rumbleEffect.u.rumble.strong_magnitude = (uint16_t)((left > 1.0f ? 1.0f : left) * 0xffff);
+		rumbleEffect.u.rumble.weak_magnitude = (uint16_t)((right > 1.0f ? 1.0f : right) * 0xffff);
+		// a length of zero plays until the effect is stopped, like on the other platforms
+		rumbleEffect.replay.length = 0;
+		if (ioctl(file_descriptor, EVIOCSFF, &rumbleEffect) < 0) {
+			// not opened for writing or no force-feedback support
+			return;
+		}
+		effect = rumbleEffect.id;
+		play.code = effect;
+		play.value = 1;
+		if (!writeRecord(file_descriptor, &play, sizeof(play))) {
+			kinc_log(KINC_LOG_LEVEL_WARNING, "Could not start rumbling of %s: %s", name, strerror(errno));
+		}
 	}
 
-	HIDGamepadUdevHelper udev_helper;
+	EvdevGamepad gamepads[gamepadCount];
 
-	const int gamepadCount = 12;
-	HIDGamepad gamepads[gamepadCount];
+	struct udev *udevPtr = NULL;
+	struct udev_monitor *udevMonitorPtr = NULL;
+	int epollFD = -1;
+	int wakeFD = -1;
+	kinc_thread_t thread;
+	kinc_mutex_t mutex;
+	volatile bool running = false;
 
-	void HIDGamepadUdevHelper::openOrCloseGamepad(struct udev_device* dev) {
+	bool isGamepad(struct udev_device *dev) {
+		const char *devnode = udev_device_get_devnode(dev);
+		if (devnode == NULL || strncmp(devnode, "/dev/input/event", 16) != 0) {
+			return false;
+		}
+		const char *joystick = udev_device_get_property_value(dev, "ID_INPUT_JOYSTICK");
+		return joystick != NULL && strcmp(joystick, "1") == 0;
+	}
 
-		const char* action = udev_device_get_action(dev);
+	void openOrCloseGamepad(struct udev_device *dev) {
+		const char *devnode = udev_device_get_devnode(dev);
+		if (devnode == NULL || strncmp(devnode, "/dev/input/event", 16) != 0) {
+			return;
+		}
+		const char *action = udev_device_get_action(dev);
 		if (!action) action = "add";
 
-		const char* joystickDevnodeName = strstr(udev_device_get_devnode(dev), "js");
-
-		if (joystickDevnodeName) {
-
-
-		    int joystickDevnodeIndex;
-		    sscanf(joystickDevnodeName, "js%d", &joystickDevnodeIndex);
-
-		    if (!strcmp(action, "add"))
-	            gamepads[joystickDevnodeIndex].open();
-
-			if (!strcmp(action, "remove"))
-			    gamepads[joystickDevnodeIndex].close();
-
-	    }
+		kinc_mutex_lock(&mutex);
+		if (!strcmp(action, "remove")) {
+			for (int i = 0; i < gamepadCount; ++i) {
+				if (gamepads[i].file_descriptor >= 0 && strcmp(gamepads[i].devnode, devnode) == 0) {
+					gamepads[i].close(epollFD);
+				}
+			}
+		}
+		else if (!strcmp(action, "add") && isGamepad(dev)) {
+			bool known = false;
+			for (int i = 0; i < gamepadCount; ++i) {
+				if (gamepads[i].file_descriptor >= 0 && strcmp(gamepads[i].devnode, devnode) == 0) {
+					known = true;
+				}
+			}
+			for (int i = 0; !known && i < gamepadCount; ++i) {
+				if (gamepads[i].file_descriptor < 0) {
+					gamepads[i].open(devnode, epollFD);
+					break;
+				}
+			}
+		}
+		kinc_mutex_unlock(&mutex);
+	}
 
+	void processDevice(struct udev_device *dev) {
+		if (dev) {
+			openOrCloseGamepad(dev);
+			udev_device_unref(dev);
+		}
 	}
 
+	void readerThread(void *) {
+		epoll_event events[gamepadCount + 2];
+		while (running) {
+			int count = epoll_wait(epollFD, events, gamepadCount + 2, -1);
+			for (int i = 0; i < count; ++i) {
+				uint32_t tag = events[i].data.u32;
+				if (tag == wakeTag) {
+					uint64_t value;
+					// only resets the counter, EAGAIN means another wakeup already did that
+					if (::read(wakeFD, &value, sizeof(value)) < 0 && errno != EAGAIN && errno != EINTR) {
+						kinc_log(KINC_LOG_LEVEL_WARNING, "Could not read the gamepad wakeup-event: %s", strerror(errno));
+					}
+				}
+				else if (tag == udevTag) {
+					processDevice(udev_monitor_receive_device(udevMonitorPtr));
+				}
+				else if (tag < (uint32_t)gamepadCount) {
+					if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+						// udev sends the remove-event as well, but that can come late
+						kinc_mutex_lock(&mutex);
+						gamepads[tag].close(epollFD);
+						kinc_mutex_unlock(&mutex);
+					}
+					else if (gamepads[tag].connected) {
+						gamepads[tag].read();
+					}
+				}
+			}
+		}
+	}
 }
 
-
-
 void Kore::initHIDGamepads() {
+	kinc_mutex_init(&mutex);
 	for (int i = 0; i < gamepadCount; ++i) {
-		gamepads[i].init(i);
+		gamepads[i].idx = i;
+		gamepads[i].file_descriptor = -1;
+		gamepads[i].connected = false;
+		gamepads[i].devnode[0] = 0;
+		gamepads[i].name[0] = 0;
+	}
+
+	epollFD = epoll_create1(EPOLL_CLOEXEC);
+	wakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u32 = wakeTag;
+	epoll_ctl(epollFD, EPOLL_CTL_ADD, wakeFD, &event);
+
+	udevPtr = udev_new();
+	if (udevPtr != NULL) {
+		// set up the monitor first so no device which is plugged in during the enumeration is missed
+		udevMonitorPtr = udev_monitor_new_from_netlink(udevPtr, "udev");
+		if (udevMonitorPtr != NULL) {
+			udev_monitor_filter_add_match_subsystem_devtype(udevMonitorPtr, "input", NULL);
+			udev_monitor_enable_receiving(udevMonitorPtr);
+			event.events = EPOLLIN;
+			event.data.u32 = udevTag;
+			epoll_ctl(epollFD, EPOLL_CTL_ADD, udev_monitor_get_fd(udevMonitorPtr), &event);
+		}
+
+		struct udev_enumerate *enumerate = udev_enumerate_new(udevPtr);
+		udev_enumerate_add_match_subsystem(enumerate, "input");
+		udev_enumerate_scan_devices(enumerate);
+		struct udev_list_entry *entry;
+		udev_list_entry_foreach(entry, udev_enumerate_get_list_entry(enumerate)) {
+			processDevice(udev_device_new_from_syspath(udevPtr, udev_list_entry_get_name(entry)));
+		}
+		udev_enumerate_unref(enumerate);
 	}
-	udev_helper.init();
+
+	running = true;
+	kinc_thread_init(&thread, readerThread, NULL);
 }
 
 void Kore::updateHIDGamepads() {
-	udev_helper.update();
-	for (int i = 0; i < gamepadCount; ++i) {
-		gamepads[i].update();
-	}
+	drainEvents();
 }
 
 void Kore::closeHIDGamepads() {
-	udev_helper.close();
+	if (!running) {
+		return;
+	}
+	running = false;
+	uint64_t value = 1;
+	// EAGAIN means the counter is saturated, which wakes the thread just the same
+	if (!writeRecord(wakeFD, &value, sizeof(value)) && errno != EAGAIN) {
+		kinc_log(KINC_LOG_LEVEL_ERROR, "Could not wake the gamepad thread: %s", strerror(errno));
+		return;
+	}
+	kinc_thread_wait_and_destroy(&thread);
+
+	for (int i = 0; i < gamepadCount; ++i) {
+		gamepads[i].close(epollFD);
+	}
+	if (udevMonitorPtr != NULL) {
+		udev_monitor_unref(udevMonitorPtr);
+		udevMonitorPtr = NULL;
+	}
+	if (udevPtr != NULL) {
+		udev_unref(udevPtr);
+		udevPtr = NULL;
+	}
+	::close(wakeFD);
+	::close(epollFD);
+	kinc_mutex_destroy(&mutex);
 }
 
 const char *kinc_gamepad_vendor(int gamepad) {
-    return "Linux gamepad";
+	return "Linux gamepad";
 }
 
 const char *kinc_gamepad_product_name(int gamepad) {
-    return gamepads[gamepad].name;
+	return gamepads[gamepad].name;
 }
 
 bool kinc_gamepad_connected(int gamepad) {
@@ -242,5 +517,10 @@ bool kinc_gamepad_connected(int gamepad) {
 }
 
 void kinc_gamepad_rumble(int gamepad, float left, float right) {
-	
-}
\ No newline at end of file
+	if (gamepad < 0 || gamepad >= gamepadCount) {
+		return;
+	}
+	kinc_mutex_lock(&mutex);
+	gamepads[gamepad].rumble(left, right);
+	kinc_mutex_unlock(&mutex);
+}
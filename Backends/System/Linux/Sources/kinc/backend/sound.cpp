@@ -1,53 +1,143 @@
+#include "alsa.h"
+
 #include <kinc/audio2/audio.h>
+#include <kinc/memory.h>
+#include <kinc/simd/float32x4.h>
+#include <kinc/simd/int32x4.h>
 
 #include <alsa/asoundlib.h>
 #include <errno.h>
 #include <poll.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // apt-get install libasound2-dev
 
 namespace {
     void (*a2_callback)(kinc_a2_buffer_t *buffer, int samples) = nullptr;
+	void (*a2_sample_rate_callback)() = nullptr;
     kinc_a2_buffer_t a2_buffer;
 
 	pthread_t threadid;
-	bool audioRunning = false;
+	volatile bool audioRunning = false;
 	snd_pcm_t* playback_handle;
-	short buf[4096 * 4];
 
-	void copySample(void* buffer) {
-		float value = *(float*)&a2_buffer.data[a2_buffer.read_location];
-        a2_buffer.read_location += 4;
-		if (a2_buffer.read_location >= a2_buffer.data_size) a2_buffer.read_location = 0;
-		if (value != 0) {
-			int a = 3;
-			++a;
+	// frames per call of the audio-callback
+	const int chunkFrames = 4096;
+	int16_t buf[chunkFrames * KINC_A2_MAX_CHANNELS];
+	float floatBuf[chunkFrames * KINC_A2_MAX_CHANNELS];
+
+	char device[128] = "default";
+	kinc_alsa_options_t options = {device, 0, 4, 0.125, false, false};
+	bool mmapAccess = false;
+	unsigned int rate = 44100;
+	unsigned int channels = 2;
+	snd_pcm_uframes_t periodFrames = 0;
+	snd_pcm_uframes_t bufferFrames = 0;
+	volatile double latency = 0.0;
+	volatile int underruns = 0;
+
+	// converts whole blocks, the samples are clamped because mixing can overshoot
+	void convertSamples(int16_t* out, const float* in, int count) {
+		kinc_float32x4_t minimum = kinc_float32x4_load_all(-1.0f);
+		kinc_float32x4_t maximum = kinc_float32x4_load_all(1.0f);
+		kinc_float32x4_t scale = kinc_float32x4_load_all(32767.0f);
+		int32_t values[8];
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			kinc_float32x4_t a = kinc_float32x4_load_unaligned(&in[i]);
+			kinc_float32x4_t b = kinc_float32x4_load_unaligned(&in[i + 4]);
+			a = kinc_float32x4_mul(kinc_float32x4_min(kinc_float32x4_max(a, minimum), maximum), scale);
+			b = kinc_float32x4_mul(kinc_float32x4_min(kinc_float32x4_max(b, minimum), maximum), scale);
+			kinc_int32x4_store_unaligned(&values[0], kinc_int32x4_from_float32x4(a));
+			kinc_int32x4_store_unaligned(&values[4], kinc_int32x4_from_float32x4(b));
+			for (int j = 0; j < 8; ++j) {
+				out[i + j] = (int16_t)values[j];
+			}
+		}
+		for (; i < count; ++i) {
+			float value = in[i] < -1.0f ? -1.0f : (in[i] > 1.0f ? 1.0f : in[i]);
+			out[i] = (int16_t)(value < 0.0f ? value * 32767.0f - 0.5f : value * 32767.0f + 0.5f);
+		}
+	}
+
+	// mixes frames into out, which is interleaved with the device's channel-count
+	void mix(int16_t* out, int frames) {
+		if (a2_callback == nullptr) {
+			memset(out, 0, frames * channels * 2);
+			return;
+		}
+		a2_callback(&a2_buffer, frames * 2);
+		if (channels == 2) {
+			int samples = frames * 2;
+			while (samples > 0) {
+				int contiguous = (a2_buffer.data_size - a2_buffer.read_location) / 4;
+				int count = samples < contiguous ? samples : contiguous;
+				convertSamples(out, (float*)&a2_buffer.data[a2_buffer.read_location], count);
+				out += count;
+				samples -= count;
+				a2_buffer.read_location += count * 4;
+				if (a2_buffer.read_location >= a2_buffer.data_size) a2_buffer.read_location = 0;
+			}
+			return;
+		}
+		// the ring-buffer is always stereo
+		for (int i = 0; i < frames; ++i) {
+			float left = *(float*)&a2_buffer.data[a2_buffer.read_location];
+			float right = *(float*)&a2_buffer.data[(a2_buffer.read_location + 4) % a2_buffer.data_size];
+			a2_buffer.read_location = (a2_buffer.read_location + 8) % a2_buffer.data_size;
+			float* frame = &floatBuf[i * channels];
+			if (channels == 1) {
+				frame[0] = (left + right) * 0.5f;
+			}
+			else {
+				frame[0] = left;
+				frame[1] = right;
+				for (unsigned c = 2; c < channels; ++c) frame[c] = 0.0f;
+			}
 		}
-		*(int16_t*)buffer = static_cast<int16_t>(value * 32767);
+		convertSamples(out, floatBuf, frames * channels);
 	}
 
 	int playback_callback(snd_pcm_sframes_t nframes) {
-		int err = 0;
-		if (a2_callback != nullptr) {
-			a2_callback(&a2_buffer, nframes * 2);
-			int ni = 0;
-			while (ni < nframes) {
-				int i = 0;
-				for (; ni < nframes && i < 4096 * 2; ++i, ++ni) {
-					copySample(&buf[i * 2]);
-					copySample(&buf[i * 2 + 1]);
+		int delivered = 0;
+		while (delivered < nframes) {
+			int frames = nframes - delivered < chunkFrames ? (int)(nframes - delivered) : chunkFrames;
+			if (mmapAccess) {
+				const snd_pcm_channel_area_t* areas;
+				snd_pcm_uframes_t offset;
+				snd_pcm_uframes_t available = frames;
+				int err;
+				if ((err = snd_pcm_mmap_begin(playback_handle, &areas, &offset, &available)) < 0) {
+					return err;
+				}
+				if (available == 0) {
+					break;
 				}
-				int err2;
-				if ((err2 = snd_pcm_writei(playback_handle, buf, i)) < 0) {
-					fprintf(stderr, "write failed (%s)\n", snd_strerror(err2));
+				int16_t* out = (int16_t*)((uint8_t*)areas[0].addr + areas[0].first / 8 + offset * (areas[0].step / 8));
+				mix(out, (int)available);
+				snd_pcm_sframes_t committed = snd_pcm_mmap_commit(playback_handle, offset, available);
+				if (committed < 0) {
+					return (int)committed;
 				}
-				err += err2;
+				delivered += (int)committed;
 			}
+			else {
+				mix(buf, frames);
+				snd_pcm_sframes_t written = snd_pcm_writei(playback_handle, buf, frames);
+				if (written < 0) {
+					return (int)written;
+				}
+				delivered += (int)written;
+			}
+		}
+		if (snd_pcm_state(playback_handle) == SND_PCM_STATE_PREPARED) {
+			snd_pcm_start(playback_handle);
 		}
-		return err;
+		return delivered;
 	}
 
 	bool tryToRecover( snd_pcm_t* handle, int errorCode ) {
@@ -59,13 +149,15 @@ namespace {
 			case ESTRPIPE:
 			#endif
 			{
+				if (errorCode == -EPIPE) {
+					++underruns;
+				}
 				int recovered = snd_pcm_recover(playback_handle, errorCode, 1);
 
 				if (recovered != 0) {
 					fprintf(stderr, "unable to recover from ALSA error code=%i\n", errorCode);
 					return false;
 				} else {
-					fprintf(stdout, "recovered from ALSA error code=%i\n", errorCode);
 					return true;
 				}
 			}
@@ -75,66 +167,130 @@ namespace {
 		}
 	}
 
-	void* doAudio(void* arg) {
+	bool setHardwareParameters(snd_pcm_access_t access) {
 		snd_pcm_hw_params_t* hw_params;
-		snd_pcm_sw_params_t* sw_params;
-		snd_pcm_sframes_t frames_to_deliver;
 		int err;
 
-		if ((err = snd_pcm_open(&playback_handle, "default", SND_PCM_STREAM_PLAYBACK, 0)) < 0) {
-			fprintf(stderr, "cannot open audio device default (%s)\n", snd_strerror(err));
-			return nullptr;
-		}
-
 		if ((err = snd_pcm_hw_params_malloc(&hw_params)) < 0) {
 			fprintf(stderr, "cannot allocate hardware parameter structure (%s)\n", snd_strerror(err));
-			return nullptr;
+			return false;
 		}
 
 		if ((err = snd_pcm_hw_params_any(playback_handle, hw_params)) < 0) {
 			fprintf(stderr, "cannot initialize hardware parameter structure (%s)\n", snd_strerror(err));
-			return nullptr;
+			snd_pcm_hw_params_free(hw_params);
+			return false;
 		}
 
-		if ((err = snd_pcm_hw_params_set_access(playback_handle, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED)) < 0) {
-			fprintf(stderr, "cannot set access type (%s)\n", snd_strerror(err));
-			return nullptr;
+		if ((err = snd_pcm_hw_params_set_access(playback_handle, hw_params, access)) < 0) {
+			if (access == SND_PCM_ACCESS_RW_INTERLEAVED) {
+				fprintf(stderr, "cannot set access type (%s)\n", snd_strerror(err));
+			}
+			snd_pcm_hw_params_free(hw_params);
+			return false;
 		}
 
 		if ((err = snd_pcm_hw_params_set_format(playback_handle, hw_params, SND_PCM_FORMAT_S16_LE)) < 0) {
 			fprintf(stderr, "cannot set sample format (%s)\n", snd_strerror(err));
-			return nullptr;
+			snd_pcm_hw_params_free(hw_params);
+			return false;
 		}
 
-		unsigned int rate = 44100;
+		rate = kinc_internal_a2_requested_samples_per_second > 0 ? kinc_internal_a2_requested_samples_per_second : 44100;
 		int dir = 0;
 		if ((err = snd_pcm_hw_params_set_rate_near(playback_handle, hw_params, &rate, &dir)) < 0) {
 			fprintf(stderr, "cannot set sample rate (%s)\n", snd_strerror(err));
-			return nullptr;
+			snd_pcm_hw_params_free(hw_params);
+			return false;
 		}
 
-		if ((err = snd_pcm_hw_params_set_channels(playback_handle, hw_params, 2)) < 0) {
+		// 3, 5 and 7 channels have no common ALSA-layout and are played using the next bigger one
+		channels = kinc_internal_a2_requested_channels;
+		if (channels == 3 || channels == 5 || channels == 7) ++channels;
+		if ((err = snd_pcm_hw_params_set_channels_near(playback_handle, hw_params, &channels)) < 0) {
 			fprintf(stderr, "cannot set channel count (%s)\n", snd_strerror(err));
-			return nullptr;
+			snd_pcm_hw_params_free(hw_params);
+			return false;
+		}
+		if (channels > KINC_A2_MAX_CHANNELS) {
+			fprintf(stderr, "unsupported channel count %u\n", channels);
+			snd_pcm_hw_params_free(hw_params);
+			return false;
 		}
 
-		snd_pcm_uframes_t bufferSize = rate / 8;
-		if (((err = snd_pcm_hw_params_set_buffer_size(playback_handle, hw_params, bufferSize)) < 0 &&
-		     (snd_pcm_hw_params_set_buffer_size_near(playback_handle, hw_params, &bufferSize)) < 0)) {
-			fprintf(stderr, "cannot set buffer size (%s)\n", snd_strerror(err));
-			return nullptr;
+		unsigned int periods = options.periods < 2 ? 2 : options.periods;
+		periodFrames = options.period_frames > 0 ? options.period_frames : (snd_pcm_uframes_t)(options.latency * rate / periods);
+		if (periodFrames < 16) periodFrames = 16;
+		if (periodFrames > chunkFrames) periodFrames = chunkFrames;
+		dir = 0;
+		if ((err = snd_pcm_hw_params_set_period_size_near(playback_handle, hw_params, &periodFrames, &dir)) < 0) {
+			fprintf(stderr, "cannot set period size (%s)\n", snd_strerror(err));
+			snd_pcm_hw_params_free(hw_params);
+			return false;
+		}
+		dir = 0;
+		if ((err = snd_pcm_hw_params_set_periods_near(playback_handle, hw_params, &periods, &dir)) < 0) {
+			bufferFrames = periodFrames * periods;
+			if ((err = snd_pcm_hw_params_set_buffer_size_near(playback_handle, hw_params, &bufferFrames)) < 0) {
+				fprintf(stderr, "cannot set buffer size (%s)\n", snd_strerror(err));
+				snd_pcm_hw_params_free(hw_params);
+				return false;
+			}
 		}
 
 		if ((err = snd_pcm_hw_params(playback_handle, hw_params)) < 0) {
 			fprintf(stderr, "cannot set parameters (%s)\n", snd_strerror(err));
-			return nullptr;
+			snd_pcm_hw_params_free(hw_params);
+			return false;
 		}
 
+		snd_pcm_hw_params_get_period_size(hw_params, &periodFrames, &dir);
+		snd_pcm_hw_params_get_buffer_size(hw_params, &bufferFrames);
 		snd_pcm_hw_params_free(hw_params);
+		return true;
+	}
+
+	void setRealtimePriority() {
+		sched_param param;
+		param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+		int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+		if (err != 0) {
+			fprintf(stderr, "cannot use realtime scheduling for audio (%s)\n", strerror(err));
+		}
+	}
 
-		/* tell ALSA to wake us up whenever 4096 or more frames
-		   of playback data can be delivered. Also, tell
-		   ALSA that we'll start the device ourselves.
+	void* doAudio(void* arg) {
+		snd_pcm_sw_params_t* sw_params;
+		snd_pcm_sframes_t frames_to_deliver;
+		int err;
+
+		if (options.realtime) {
+			setRealtimePriority();
+		}
+
+		if ((err = snd_pcm_open(&playback_handle, options.device, SND_PCM_STREAM_PLAYBACK, 0)) < 0) {
+			fprintf(stderr, "cannot open audio device %s (%s)\n", options.device, snd_strerror(err));
+			return nullptr;
+		}
+
+		mmapAccess = options.mmap && setHardwareParameters(SND_PCM_ACCESS_MMAP_INTERLEAVED);
+		if (!mmapAccess && !setHardwareParameters(SND_PCM_ACCESS_RW_INTERLEAVED)) {
+			snd_pcm_close(playback_handle);
+			return nullptr;
+		}
+
+		if ((int)rate != kinc_a2_samples_per_second) {
+			kinc_a2_samples_per_second = rate;
+			if (a2_sample_rate_callback != nullptr) {
+				a2_sample_rate_callback();
+			}
+		}
+		a2_buffer.format.samples_per_second = rate;
+		kinc_internal_a2_set_device_channels(channels);
+
+		/* tell ALSA to wake us up whenever a period can be
+		   delivered and to start the device once the buffer
+		   has been filled.
 		*/
 
 		if ((err = snd_pcm_sw_params_malloc(&sw_params)) < 0) {
@@ -145,11 +301,11 @@ namespace {
 			fprintf(stderr, "cannot initialize software parameters structure (%s)\n", snd_strerror(err));
 			return nullptr;
 		}
-		if ((err = snd_pcm_sw_params_set_avail_min(playback_handle, sw_params, 4096)) < 0) {
+		if ((err = snd_pcm_sw_params_set_avail_min(playback_handle, sw_params, periodFrames)) < 0) {
 			fprintf(stderr, "cannot set minimum available count (%s)\n", snd_strerror(err));
 			return nullptr;
 		}
-		if ((err = snd_pcm_sw_params_set_start_threshold(playback_handle, sw_params, 0U)) < 0) {
+		if ((err = snd_pcm_sw_params_set_start_threshold(playback_handle, sw_params, bufferFrames)) < 0) {
 			fprintf(stderr, "cannot set start mode (%s)\n", snd_strerror(err));
 			return nullptr;
 		}
@@ -157,10 +313,7 @@ namespace {
 			fprintf(stderr, "cannot set software parameters (%s)\n", snd_strerror(err));
 			return nullptr;
 		}
-
-		/* the interface will interrupt the kernel every 4096 frames, and ALSA
-		   will wake up this program very soon after that.
-		*/
+		snd_pcm_sw_params_free(sw_params);
 
 		if ((err = snd_pcm_prepare(playback_handle)) < 0) {
 			fprintf(stderr, "cannot prepare audio interface for use (%s)\n", snd_strerror(err));
@@ -174,41 +327,77 @@ namespace {
 			*/
 
 			if ((err = snd_pcm_wait(playback_handle, 1000)) < 0) {
-				fprintf(stderr, "poll failed (%s)\n", strerror(errno));
-				break;
+				if (!tryToRecover(playback_handle, err)) {
+					break;
+				}
+				continue;
 			}
 
 			/* find out how much space is available for playback data */
 
 			if ((frames_to_deliver = snd_pcm_avail_update(playback_handle)) < 0) {
-				if (!tryToRecover(playback_handle, frames_to_deliver)) {
-					// break;
-				}
-			} else {
-				// frames_to_deliver = frames_to_deliver > 4096 ? 4096 : frames_to_deliver;
-
-				/* deliver the data */
-
+				tryToRecover(playback_handle, frames_to_deliver);
+			} else if (frames_to_deliver > 0) {
 				int delivered = playback_callback(frames_to_deliver);
+				if (delivered < 0) {
+					tryToRecover(playback_handle, delivered);
+				}
 
-				if (delivered != frames_to_deliver) {
-					fprintf(stderr, "playback callback failed (delivered %i / %ld frames)\n", delivered, frames_to_deliver);
-					// break;
+				snd_pcm_sframes_t delay;
+				if (snd_pcm_delay(playback_handle, &delay) == 0) {
+					latency = (double)delay / rate;
 				}
 			}
 		}
 
+		snd_pcm_drop(playback_handle);
 		snd_pcm_close(playback_handle);
 		return nullptr;
 	}
 }
 
+void kinc_alsa_options_set_defaults(kinc_alsa_options_t *options) {
+	options->device = "default";
+	options->period_frames = 0;
+	options->periods = 4;
+	options->latency = 0.125;
+	options->mmap = false;
+	options->realtime = false;
+}
+
+void kinc_alsa_configure(const kinc_alsa_options_t *newOptions) {
+	options = *newOptions;
+	snprintf(device, sizeof(device), "%s", newOptions->device != nullptr ? newOptions->device : "default");
+	options.device = device;
+}
+
+double kinc_alsa_latency() {
+	return latency;
+}
+
+int kinc_alsa_period_frames() {
+	return (int)periodFrames;
+}
+
+int kinc_alsa_buffer_frames() {
+	return (int)bufferFrames;
+}
+
+int kinc_alsa_underruns() {
+	return underruns;
+}
+
 void kinc_a2_init() {
 	a2_buffer.read_location = 0;
 	a2_buffer.write_location = 0;
 	a2_buffer.data_size = 128 * 1024;
-	a2_buffer.data = new uint8_t[a2_buffer.data_size];
+	a2_buffer.data = (uint8_t *)kinc_memory_allocate(a2_buffer.data_size, KINC_MEMORY_TAG_AUDIO);
+	a2_buffer.format.channels = 2;
+	a2_buffer.format.bits_per_sample = 32;
+	a2_buffer.format.samples_per_second = kinc_a2_samples_per_second;
 
+	latency = 0.0;
+	underruns = 0;
 	audioRunning = true;
 	pthread_create(&threadid, nullptr, &doAudio, nullptr);
 }
@@ -216,9 +405,18 @@ void kinc_a2_init() {
 void kinc_a2_update() {}
 
 void kinc_a2_shutdown() {
-	audioRunning = false;
+	if (audioRunning) {
+		audioRunning = false;
+		pthread_join(threadid, nullptr);
+		kinc_memory_free(a2_buffer.data);
+		a2_buffer.data = nullptr;
+	}
 }
 
-void kinc_a2_set_callback(void(*kinc_a2_audio_callback)(kinc_a2_buffer_t *buffer, int samples)) {
+void kinc_internal_a2_set_callback(void(*kinc_a2_audio_callback)(kinc_a2_buffer_t *buffer, int samples)) {
     a2_callback = kinc_a2_audio_callback;
 }
+
+void kinc_a2_set_sample_rate_callback(void (*kinc_a2_sample_rate_callback)()) {
+	a2_sample_rate_callback = kinc_a2_sample_rate_callback;
+}
@@ -1003,28 +1003,37 @@ const char* kinc_internal_save_path() {
 }
 
 namespace {
-	const char* videoFormats[] = {"ogv", nullptr};
+	// the only format kinc_video_init can decode
+	const char* videoFormats[] = {"y4m", nullptr};
 }
 
 const char** kinc_video_formats() {
 	return ::videoFormats;
 }
 
-#include <sys/time.h>
 #include <time.h>
 
 double kinc_frequency(void) {
-	return 1000000.0;
+	return 1000000000.0;
 }
 
-static timeval start;
+// CLOCK_MONOTONIC_RAW is not slewed by NTP so frame times stay stable.
+// The kernel reports it through the vDSO, reading it does not enter the kernel.
+static kinc_ticks_t monotonic_nanoseconds(void) {
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+	return static_cast<kinc_ticks_t>(now.tv_sec) * 1000000000 + static_cast<kinc_ticks_t>(now.tv_nsec);
+}
+
+static kinc_ticks_t start = 0;
 
 kinc_ticks_t kinc_timestamp(void) {
-	timeval now;
-	gettimeofday(&now, NULL);
-	now.tv_sec -= start.tv_sec;
-	now.tv_usec -= start.tv_usec;
-	return static_cast<kinc_ticks_t>(now.tv_sec) * 1000000 + static_cast<kinc_ticks_t>(now.tv_usec);
+	kinc_ticks_t now = monotonic_nanoseconds();
+	// set on first use so that timestamps taken before kinc_init do not jump
+	if (start == 0) {
+		start = now - 1;
+	}
+	return now - start;
 }
 
 void kinc_login() {
@@ -1038,7 +1047,7 @@ void kinc_unlock_achievement(int id) {
 int kinc_init(const char* name, int width, int height, kinc_window_options_t *win, kinc_framebuffer_options_t *frame) {
 	Kore::initHIDGamepads();
 
-	gettimeofday(&start, NULL);
+	kinc_timestamp();
 	kinc_display_init();
 
 	kinc_set_application_name(name);
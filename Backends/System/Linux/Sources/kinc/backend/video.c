@@ -1,55 +1,501 @@
 #include <kinc/video.h>
 
-void kinc_video_init(kinc_video_t *video, const char *filename) {}
+#include <kinc/audio1/audio.h>
+#include <kinc/audio2/audio.h>
+#include <kinc/log.h>
+#include <kinc/memory.h>
+#include <kinc/threads/atomic.h>
+#include <kinc/simd/float32x4.h>
+#include <kinc/simd/int32x4.h>
 
-void kinc_video_destroy(kinc_video_t *video) {}
+#define STB_VORBIS_HEADER_ONLY
+#include <kinc/audio1/stb_vorbis.c>
 
-void kinc_video_play(kinc_video_t *video) {}
+#include <stdlib.h>
+#include <string.h>
 
-void kinc_video_pause(kinc_video_t *video) {}
+// Videos are YUV4MPEG2-streams (.y4m) with 4:2:0 chroma-subsampling. They are decoded on a background-thread into a small ring of YUV-frames
+// which are converted to RGBA and uploaded on the main-thread once a new frame becomes visible.
 
-void kinc_video_stop(kinc_video_t *video) {}
+#define SOUND_BUFFER_SIZE (1024 * 128)
+// source-frames which are decoded at once
+#define AUDIO_CHUNK 1024
+
+void kinc_internal_video_sound_stream_init(kinc_internal_video_sound_stream_t *stream, int channel_count, int frequency) {
+	stream->buffer = (float *)kinc_memory_allocate(SOUND_BUFFER_SIZE * sizeof(float), KINC_MEMORY_TAG_AUDIO);
+	stream->bufferSize = SOUND_BUFFER_SIZE;
+	stream->read = 0;
+	stream->written = 0;
+	stream->channels = channel_count;
+	stream->frequency = frequency;
+	stream->fraction = 0.0;
+	stream->last[0] = stream->last[1] = 0.0f;
+	stream->finished = false;
+}
+
+void kinc_internal_video_sound_stream_destroy(kinc_internal_video_sound_stream_t *stream) {
+	kinc_memory_free(stream->buffer);
+	stream->buffer = NULL;
+}
+
+static int sound_stream_space(kinc_internal_video_sound_stream_t *stream) {
+	return stream->bufferSize - (int)((uint32_t)stream->written - (uint32_t)stream->read);
+}
+
+// Takes interleaved samples at the stream's frequency and stores them as stereo at the output's sample-rate.
+// Only called by the decoder which makes sure that enough space is left.
+void kinc_internal_video_sound_stream_insert_data(kinc_internal_video_sound_stream_t *stream, float *data, int sample_count) {
+	double step = stream->frequency / (double)kinc_a2_samples_per_second;
+	int32_t position = stream->written;
+	uint32_t mask = (uint32_t)stream->bufferSize - 1;
+	for (int i = 0; i + stream->channels <= sample_count; i += stream->channels) {
+		float left = data[i];
+		float right = stream->channels > 1 ? data[i + 1] : left;
+		while (stream->fraction < 1.0) {
+			float a = (float)stream->fraction;
+			stream->buffer[(uint32_t)position & mask] = stream->last[0] + (left - stream->last[0]) * a;
+			position = (int32_t)((uint32_t)position + 1);
+			stream->buffer[(uint32_t)position & mask] = stream->last[1] + (right - stream->last[1]) * a;
+			position = (int32_t)((uint32_t)position + 1);
+			stream->fraction += step;
+		}
+		stream->fraction -= 1.0;
+		stream->last[0] = left;
+		stream->last[1] = right;
+	}
+	KINC_ATOMIC_COMPARE_EXCHANGE(&stream->written, stream->written, position);
+}
+
+float kinc_internal_video_sound_stream_next_sample(kinc_internal_video_sound_stream_t *stream) {
+	int32_t position = stream->read;
+	if (position == stream->written) {
+		// the decoder fell behind, the read-counter is the video's clock so it stops until samples arrive
+		return 0.0f;
+	}
+	float value = stream->buffer[(uint32_t)position & ((uint32_t)stream->bufferSize - 1)];
+	KINC_ATOMIC_COMPARE_EXCHANGE(&stream->read, position, (int32_t)((uint32_t)position + 1));
+	return value;
+}
+
+bool kinc_internal_video_sound_stream_ended(kinc_internal_video_sound_stream_t *stream) {
+	return stream->finished && stream->read == stream->written;
+}
+
+static bool parse_header(kinc_video_t *video) {
+	char header[256];
+	int length = 0;
+	for (;;) {
+		if (length == sizeof(header) - 1 || kinc_file_reader_read(&video->impl.reader, &header[length], 1) != 1) {
+			return false;
+		}
+		if (header[length] == '\n') {
+			break;
+		}
+		++length;
+	}
+	header[length] = 0;
+	if (strncmp(header, "YUV4MPEG2 ", 10) != 0) {
+		return false;
+	}
+
+	video->impl.width = 0;
+	video->impl.height = 0;
+	video->impl.frames_per_second = 25.0;
+	for (char *token = strtok(&header[10], " "); token != NULL; token = strtok(NULL, " ")) {
+		switch (token[0]) {
+		case 'W':
+			video->impl.width = atoi(&token[1]);
+			break;
+		case 'H':
+			video->impl.height = atoi(&token[1]);
+			break;
+		case 'F': {
+			int numerator = atoi(&token[1]);
+			char *colon = strchr(token, ':');
+			int denominator = colon != NULL ? atoi(&colon[1]) : 1;
+			if (numerator > 0 && denominator > 0) {
+				video->impl.frames_per_second = numerator / (double)denominator;
+			}
+			break;
+		}
+		case 'C':
+			if (strncmp(&token[1], "420", 3) != 0) {
+				kinc_log(KINC_LOG_LEVEL_ERROR, "Unsupported chroma-subsampling %s, only 4:2:0 is supported.", &token[1]);
+				return false;
+			}
+			break;
+		}
+	}
+	if (video->impl.width <= 0 || video->impl.height <= 0) {
+		return false;
+	}
+
+	int chroma_width = (video->impl.width + 1) / 2;
+	int chroma_height = (video->impl.height + 1) / 2;
+	video->impl.frame_size = video->impl.width * video->impl.height + 2 * chroma_width * chroma_height;
+	video->impl.header_size = length + 1;
+	// frames are assumed to have no parameters which makes them 6 bytes larger than their data
+	size_t data_size = kinc_file_reader_size(&video->impl.reader) - video->impl.header_size;
+	video->impl.frame_count = (int)(data_size / (video->impl.frame_size + 6));
+	return true;
+}
+
+static bool read_frame(kinc_video_t *video, kinc_internal_video_frame_t *frame, int index) {
+	char tag[5];
+	if (kinc_file_reader_read(&video->impl.reader, tag, 5) != 5 || memcmp(tag, "FRAME", 5) != 0) {
+		return false;
+	}
+	char c;
+	do {
+		if (kinc_file_reader_read(&video->impl.reader, &c, 1) != 1) {
+			return false;
+		}
+	} while (c != '\n');
+	if (kinc_file_reader_read(&video->impl.reader, frame->data, video->impl.frame_size) != video->impl.frame_size) {
+		return false;
+	}
+	frame->time = index / video->impl.frames_per_second;
+	return true;
+}
+
+static void open_audio(kinc_video_t *video, const char *filename) {
+	video->impl.has_audio = false;
+#ifdef KORE_A1
+	char audio_name[1001];
+	strncpy(audio_name, filename, sizeof(audio_name) - 5);
+	audio_name[sizeof(audio_name) - 5] = 0;
+	char *extension = strrchr(audio_name, '.');
+	if (extension == NULL || strchr(extension, '/') != NULL) {
+		extension = &audio_name[strlen(audio_name)];
+	}
+	strcpy(extension, ".ogg");
+
+	kinc_file_reader_t file;
+	if (!kinc_file_reader_open(&file, audio_name, KINC_FILE_TYPE_ASSET)) {
+		return;
+	}
+	int size = (int)kinc_file_reader_size(&file);
+	video->impl.audio_data = (uint8_t *)kinc_memory_allocate(size, KINC_MEMORY_TAG_AUDIO);
+	kinc_file_reader_read(&file, video->impl.audio_data, size);
+	kinc_file_reader_close(&file);
+
+	int error = 0;
+	stb_vorbis *vorbis = stb_vorbis_open_memory(video->impl.audio_data, size, &error, NULL);
+	if (vorbis == NULL) {
+		kinc_log(KINC_LOG_LEVEL_WARNING, "Could not decode the audio of %s.", filename);
+		kinc_memory_free(video->impl.audio_data);
+		video->impl.audio_data = NULL;
+		return;
+	}
+	stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+	video->impl.vorbis = vorbis;
+	video->impl.has_audio = true;
+	// everything beyond stereo is dropped
+	kinc_internal_video_sound_stream_init(&video->impl.sound, info.channels > 1 ? 2 : 1, info.sample_rate);
+#endif
+}
+
+// returns false when there was nothing to do
+static bool decode_audio(kinc_video_t *video) {
+	kinc_internal_video_sound_stream_t *sound = &video->impl.sound;
+	if (!video->impl.has_audio || sound->finished) {
+		return false;
+	}
+	// the stereo-samples which a chunk can become after resampling
+	int needed = (int)((double)AUDIO_CHUNK * kinc_a2_samples_per_second / sound->frequency + 2) * 2;
+	if (sound_stream_space(sound) < needed) {
+		return false;
+	}
+	float samples[AUDIO_CHUNK * 2];
+	int frames = stb_vorbis_get_samples_float_interleaved((stb_vorbis *)video->impl.vorbis, sound->channels, samples, AUDIO_CHUNK * sound->channels);
+	if (frames == 0) {
+		sound->finished = true;
+	}
+	else {
+		kinc_internal_video_sound_stream_insert_data(sound, samples, frames * sound->channels);
+	}
+	return true;
+}
+
+static void decode(void *param) {
+	kinc_video_t *video = (kinc_video_t *)param;
+	while (!video->impl.quit) {
+		bool worked = decode_audio(video);
+
+		kinc_mutex_lock(&video->impl.mutex);
+		int index = video->impl.decoded;
+		bool space = !video->impl.end_of_stream && video->impl.decoded - video->impl.released < KINC_INTERNAL_VIDEO_FRAMES;
+		kinc_mutex_unlock(&video->impl.mutex);
+
+		if (space) {
+			// the slot is not visible to the main-thread before the counter is incremented
+			bool decoded = read_frame(video, &video->impl.frames[index % KINC_INTERNAL_VIDEO_FRAMES], index);
+			kinc_mutex_lock(&video->impl.mutex);
+			if (decoded) {
+				++video->impl.decoded;
+			}
+			else {
+				video->impl.end_of_stream = true;
+			}
+			kinc_mutex_unlock(&video->impl.mutex);
+			worked = true;
+		}
+
+		if (!worked) {
+			// woken up when the main-thread releases a frame, audio is polled
+			kinc_event_try_to_wait(&video->impl.wake, 0.01);
+		}
+	}
+}
+
+static void stop_decoding(kinc_video_t *video) {
+	if (video->impl.thread_running) {
+		video->impl.quit = true;
+		kinc_event_signal(&video->impl.wake);
+		kinc_thread_wait_and_destroy(&video->impl.thread);
+		video->impl.thread_running = false;
+	}
+}
+
+static void start_decoding(kinc_video_t *video) {
+	kinc_file_reader_seek(&video->impl.reader, video->impl.header_size);
+	video->impl.decoded = 0;
+	video->impl.released = 0;
+	video->impl.end_of_stream = false;
+	video->impl.uploaded = -1;
+	video->impl.position = 0.0;
+	video->impl.finished = false;
+	if (video->impl.has_audio) {
+		stb_vorbis_seek_start((stb_vorbis *)video->impl.vorbis);
+		int channels = video->impl.sound.channels;
+		int frequency = video->impl.sound.frequency;
+		kinc_internal_video_sound_stream_destroy(&video->impl.sound);
+		kinc_internal_video_sound_stream_init(&video->impl.sound, channels, frequency);
+	}
+	video->impl.quit = false;
+	video->impl.thread_running = true;
+	kinc_thread_init(&video->impl.thread, decode, video);
+}
+
+void kinc_video_init(kinc_video_t *video, const char *filename) {
+	memset(&video->impl, 0, sizeof(video->impl));
+	if (!kinc_file_reader_open(&video->impl.reader, filename, KINC_FILE_TYPE_ASSET)) {
+		kinc_log(KINC_LOG_LEVEL_ERROR, "Could not open video %s.", filename);
+		return;
+	}
+	if (!parse_header(video)) {
+		kinc_log(KINC_LOG_LEVEL_ERROR, "%s is not a YUV4MPEG2-video.", filename);
+		kinc_file_reader_close(&video->impl.reader);
+		video->impl.width = video->impl.height = 0;
+		return;
+	}
+	video->impl.opened = true;
+
+	for (int i = 0; i < KINC_INTERNAL_VIDEO_FRAMES; ++i) {
+		video->impl.frames[i].data = (uint8_t *)kinc_memory_allocate(video->impl.frame_size, KINC_MEMORY_TAG_GRAPHICS);
+	}
+	kinc_g4_texture_init(&video->impl.image, video->impl.width, video->impl.height, KINC_IMAGE_FORMAT_RGBA32);
+	kinc_mutex_init(&video->impl.mutex);
+	kinc_event_init(&video->impl.wake, true);
+
+	open_audio(video, filename);
+	start_decoding(video);
+}
+
+void kinc_video_destroy(kinc_video_t *video) {
+	if (!video->impl.opened) {
+		return;
+	}
+	kinc_video_pause(video);
+	stop_decoding(video);
+	if (video->impl.has_audio) {
+		stb_vorbis_close((stb_vorbis *)video->impl.vorbis);
+		kinc_memory_free(video->impl.audio_data);
+		kinc_internal_video_sound_stream_destroy(&video->impl.sound);
+	}
+	for (int i = 0; i < KINC_INTERNAL_VIDEO_FRAMES; ++i) {
+		kinc_memory_free(video->impl.frames[i].data);
+	}
+	kinc_g4_texture_destroy(&video->impl.image);
+	kinc_event_destroy(&video->impl.wake);
+	kinc_mutex_destroy(&video->impl.mutex);
+	kinc_file_reader_close(&video->impl.reader);
+	video->impl.opened = false;
+}
+
+void kinc_video_play(kinc_video_t *video) {
+	if (!video->impl.opened || video->impl.playing) {
+		return;
+	}
+	if (video->impl.finished) {
+		stop_decoding(video);
+		start_decoding(video);
+	}
+	video->impl.playing = true;
+	video->impl.last_time = -1.0;
+#ifdef KORE_A1
+	if (video->impl.has_audio) {
+		kinc_internal_play_video_sound_stream(&video->impl.sound);
+	}
+#endif
+}
+
+void kinc_video_pause(kinc_video_t *video) {
+	if (!video->impl.playing) {
+		return;
+	}
+	video->impl.playing = false;
+#ifdef KORE_A1
+	if (video->impl.has_audio) {
+		kinc_internal_stop_video_sound_stream(&video->impl.sound);
+	}
+#endif
+}
+
+void kinc_video_stop(kinc_video_t *video) {
+	if (!video->impl.opened) {
+		return;
+	}
+	kinc_video_pause(video);
+	stop_decoding(video);
+	start_decoding(video);
+}
 
 int kinc_video_width(kinc_video_t *video) {
-	return 256;
+	return video->impl.width;
 }
 
 int kinc_video_height(kinc_video_t *video) {
-	return 256;
+	return video->impl.height;
+}
+
+// BT.601 with limited range, four pixels at a time
+static void convert_row(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t *out, int width) {
+	const kinc_float32x4_t luma_offset = kinc_float32x4_load_all(-16.0f);
+	const kinc_float32x4_t chroma_offset = kinc_float32x4_load_all(-128.0f);
+	const kinc_float32x4_t luma_scale = kinc_float32x4_load_all(1.164f);
+	const kinc_float32x4_t v_to_r = kinc_float32x4_load_all(1.596f);
+	const kinc_float32x4_t u_to_g = kinc_float32x4_load_all(-0.392f);
+	const kinc_float32x4_t v_to_g = kinc_float32x4_load_all(-0.813f);
+	const kinc_float32x4_t u_to_b = kinc_float32x4_load_all(2.017f);
+	const kinc_float32x4_t zero = kinc_float32x4_load_all(0.0f);
+	const kinc_float32x4_t max = kinc_float32x4_load_all(255.0f);
+	const kinc_int32x4_t alpha = kinc_int32x4_load_all((int32_t)0xff000000);
+
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		kinc_float32x4_t luma = kinc_float32x4_load(y[x], y[x + 1], y[x + 2], y[x + 3]);
+		kinc_float32x4_t cb = kinc_float32x4_load(u[x / 2], u[x / 2], u[x / 2 + 1], u[x / 2 + 1]);
+		kinc_float32x4_t cr = kinc_float32x4_load(v[x / 2], v[x / 2], v[x / 2 + 1], v[x / 2 + 1]);
+		luma = kinc_float32x4_mul(kinc_float32x4_add(luma, luma_offset), luma_scale);
+		cb = kinc_float32x4_add(cb, chroma_offset);
+		cr = kinc_float32x4_add(cr, chroma_offset);
+
+		kinc_float32x4_t r = kinc_float32x4_add(luma, kinc_float32x4_mul(cr, v_to_r));
+		kinc_float32x4_t g = kinc_float32x4_add(luma, kinc_float32x4_add(kinc_float32x4_mul(cb, u_to_g), kinc_float32x4_mul(cr, v_to_g)));
+		kinc_float32x4_t b = kinc_float32x4_add(luma, kinc_float32x4_mul(cb, u_to_b));
+
+		kinc_int32x4_t ri = kinc_int32x4_from_float32x4(kinc_float32x4_min(kinc_float32x4_max(r, zero), max));
+		kinc_int32x4_t gi = kinc_int32x4_from_float32x4(kinc_float32x4_min(kinc_float32x4_max(g, zero), max));
+		kinc_int32x4_t bi = kinc_int32x4_from_float32x4(kinc_float32x4_min(kinc_float32x4_max(b, zero), max));
+		kinc_int32x4_t rgba = kinc_int32x4_or(kinc_int32x4_or(ri, kinc_int32x4_shift_left(gi, 8)), kinc_int32x4_or(kinc_int32x4_shift_left(bi, 16), alpha));
+		kinc_int32x4_store_unaligned((int32_t *)&out[x], rgba);
+	}
+	for (; x < width; ++x) {
+		float luma = (y[x] - 16.0f) * 1.164f;
+		float cb = u[x / 2] - 128.0f;
+		float cr = v[x / 2] - 128.0f;
+		float rgb[3] = {luma + 1.596f * cr, luma - 0.392f * cb - 0.813f * cr, luma + 2.017f * cb};
+		uint32_t pixel = 0xff000000;
+		for (int c = 0; c < 3; ++c) {
+			float value = rgb[c] < 0.0f ? 0.0f : (rgb[c] > 255.0f ? 255.0f : rgb[c]);
+			pixel |= (uint32_t)(value + 0.5f) << (c * 8);
+		}
+		out[x] = pixel;
+	}
+}
+
+static void upload(kinc_video_t *video, kinc_internal_video_frame_t *frame) {
+	int width = video->impl.width;
+	int height = video->impl.height;
+	int chroma_width = (width + 1) / 2;
+	int chroma_height = (height + 1) / 2;
+	uint8_t *u_plane = &frame->data[width * height];
+	uint8_t *v_plane = &u_plane[chroma_width * chroma_height];
+	// converted straight into the texture's memory
+	uint8_t *pixels = kinc_g4_texture_lock(&video->impl.image);
+	int stride = kinc_g4_texture_stride(&video->impl.image);
+	for (int y = 0; y < height; ++y) {
+		convert_row(&frame->data[y * width], &u_plane[(y / 2) * chroma_width], &v_plane[(y / 2) * chroma_width], (uint32_t *)&pixels[y * stride], width);
+	}
+	kinc_g4_texture_unlock(&video->impl.image);
 }
 
 kinc_g4_texture_t *kinc_video_current_image(kinc_video_t *video) {
-	return NULL;
+	if (!video->impl.opened) {
+		return NULL;
+	}
+	return &video->impl.image;
 }
 
 double kinc_video_duration(kinc_video_t *video) {
-	return 0.0;
+	if (!video->impl.opened) {
+		return 0.0;
+	}
+	return video->impl.frame_count / video->impl.frames_per_second;
 }
 
 double kinc_video_position(kinc_video_t *video) {
-	return 0.0;
+	return video->impl.position;
 }
 
 bool kinc_video_finished(kinc_video_t *video) {
-	return false;
+	return video->impl.finished;
 }
 
 bool kinc_video_paused(kinc_video_t *video) {
-	return false;
+	return !video->impl.playing;
 }
 
-void kinc_video_update(kinc_video_t *video, double time) {}
+void kinc_video_update(kinc_video_t *video, double time) {
+	if (!video->impl.opened) {
+		return;
+	}
+	if (video->impl.playing) {
+		if (video->impl.has_audio && !kinc_internal_video_sound_stream_ended(&video->impl.sound)) {
+			// audio is the clock while it lasts so the frames follow the samples which were actually played
+			video->impl.position = ((uint32_t)video->impl.sound.read / 2) / (double)kinc_a2_samples_per_second;
+		}
+		else if (video->impl.last_time >= 0.0) {
+			video->impl.position += time - video->impl.last_time;
+		}
+		video->impl.last_time = time;
+	}
 
-void kinc_internal_video_sound_stream_init(kinc_internal_video_sound_stream_t *stream, int channel_count, int frequency) {}
+	kinc_mutex_lock(&video->impl.mutex);
+	// drop frames which are superseded by a later one which is already due
+	bool released = false;
+	while (video->impl.decoded - video->impl.released >= 2 &&
+	       video->impl.frames[(video->impl.released + 1) % KINC_INTERNAL_VIDEO_FRAMES].time <= video->impl.position) {
+		++video->impl.released;
+		released = true;
+	}
+	int current = video->impl.decoded > video->impl.released ? video->impl.released : -1;
+	bool ended = video->impl.end_of_stream && video->impl.decoded - video->impl.released <= 1;
+	kinc_mutex_unlock(&video->impl.mutex);
 
-void kinc_internal_video_sound_stream_destroy(kinc_internal_video_sound_stream_t *stream) {}
+	if (released) {
+		kinc_event_signal(&video->impl.wake);
+	}
 
-void kinc_internal_video_sound_stream_insert_data(kinc_internal_video_sound_stream_t *stream, float *data, int sample_count) {}
+	if (current >= 0 && current != video->impl.uploaded) {
+		upload(video, &video->impl.frames[current % KINC_INTERNAL_VIDEO_FRAMES]);
+		video->impl.uploaded = current;
+	}
 
-float kinc_internal_video_sound_stream_next_sample(kinc_internal_video_sound_stream_t *stream) {
-	return 0.0f;
-}
-
-bool kinc_internal_video_sound_stream_ended(kinc_internal_video_sound_stream_t *stream) {
-	return true;
+	if (ended && video->impl.playing && video->impl.position >= kinc_video_duration(video) &&
+	    (!video->impl.has_audio || kinc_internal_video_sound_stream_ended(&video->impl.sound))) {
+		kinc_video_pause(video);
+		video->impl.finished = true;
+	}
 }
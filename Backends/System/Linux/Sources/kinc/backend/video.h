@@ -1,17 +1,79 @@
 #pragma once
 
+#include <kinc/graphics4/texture.h>
+#include <kinc/io/filereader.h>
+#include <kinc/threads/event.h>
+#include <kinc/threads/mutex.h>
+#include <kinc/threads/thread.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-typedef struct {
-	int nothing;
-} kinc_video_impl_t;
+// decoded frames which are buffered ahead of the one which is shown
+#define KINC_INTERNAL_VIDEO_FRAMES 4
 
 typedef struct kinc_internal_video_sound_stream {
-	int nothing;
+	// interleaved stereo at the output's sample-rate
+	float *buffer;
+	int bufferSize;
+	volatile int32_t read;
+	volatile int32_t written;
+	int channels;
+	int frequency;
+	// resampling-state of insert_data
+	double fraction;
+	float last[2];
+	// set by the decoder once all samples are inserted
+	volatile bool finished;
 } kinc_internal_video_sound_stream_t;
 
+typedef struct kinc_internal_video_frame {
+	// the Y-plane followed by the U- and V-planes at half the resolution
+	uint8_t *data;
+	double time;
+} kinc_internal_video_frame_t;
+
+typedef struct {
+	kinc_file_reader_t reader;
+	bool opened;
+	int width;
+	int height;
+	double frames_per_second;
+	int frame_count;
+	int header_size;
+	int frame_size;
+
+	kinc_internal_video_frame_t frames[KINC_INTERNAL_VIDEO_FRAMES];
+	// counters of frames which were decoded and which were released by the main-thread, guarded by the mutex
+	int decoded;
+	int released;
+	bool end_of_stream;
+	kinc_mutex_t mutex;
+	kinc_event_t wake;
+	kinc_thread_t thread;
+	bool thread_running;
+	volatile bool quit;
+
+	// a sidecar Ogg Vorbis file with the same name provides the audio
+	bool has_audio;
+	uint8_t *audio_data;
+	void *vorbis;
+	kinc_internal_video_sound_stream_t sound;
+
+	kinc_g4_texture_t image;
+	// the decode-counter of the frame which was uploaded last
+	int uploaded;
+
+	double position;
+	double last_time;
+	bool playing;
+	bool finished;
+} kinc_video_impl_t;
+
 void kinc_internal_video_sound_stream_init(kinc_internal_video_sound_stream_t *stream, int channel_count, int frequency);
 
 void kinc_internal_video_sound_stream_destroy(kinc_internal_video_sound_stream_t *stream);
@@ -6,6 +6,8 @@
 
 #define KINC_ATOMIC_COMPARE_EXCHANGE_POINTER(pointer, oldValue, newValue) (_InterlockedCompareExchangePointer(pointer, newValue, oldValue) == oldValue)
 
+#define KINC_ATOMIC_COMPARE_EXCHANGE_64(pointer, oldValue, newValue) (_InterlockedCompareExchange64((volatile __int64 *)pointer, newValue, oldValue) == oldValue)
+
 #define KINC_ATOMIC_INCREMENT(pointer) (_InterlockedIncrement((volatile long *)pointer) - 1)
 
 #define KINC_ATOMIC_DECREMENT(pointer) (_InterlockedDecrement((volatile long *)pointer) + 1)
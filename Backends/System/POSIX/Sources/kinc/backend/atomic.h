@@ -8,6 +8,8 @@
 
 #define KINC_ATOMIC_COMPARE_EXCHANGE_POINTER(pointer, oldValue, newValue) OSAtomicCompareAndSwapPtrBarrier(oldValue, newValue, pointer)
 
+#define KINC_ATOMIC_COMPARE_EXCHANGE_64(pointer, oldValue, newValue) OSAtomicCompareAndSwap64Barrier(oldValue, newValue, pointer)
+
 #define KINC_ATOMIC_INCREMENT(pointer) (OSAtomicIncrement32Barrier(pointer) - 1)
 
 #define KINC_ATOMIC_DECREMENT(pointer) (OSAtomicDecrement32Barrier(ioWhere) + 1)
@@ -20,6 +22,8 @@
 
 #define KINC_ATOMIC_COMPARE_EXCHANGE_POINTER(pointer, oldValue, newValue) (__sync_bool_compare_and_swap(pointer, oldValue, newValue))
 
+#define KINC_ATOMIC_COMPARE_EXCHANGE_64(pointer, oldValue, newValue) (__sync_bool_compare_and_swap(pointer, oldValue, newValue))
+
 #define KINC_ATOMIC_INCREMENT(pointer) (__sync_fetch_and_add(pointer, 1))
 
 #define KINC_ATOMIC_DECREMENT(pointer) (__sync_fetch_and_sub(pointer, 1))
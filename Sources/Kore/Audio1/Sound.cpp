@@ -4,9 +4,11 @@
 #include <Kore/Audio2/Audio.h>
 #include <Kore/Error.h>
 #include <Kore/IO/FileReader.h>
+#include <Kore/Memory.h>
 #include <kinc/audio1/stb_vorbis.c>
 
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 
 using namespace Kore;
@@ -52,7 +54,7 @@ namespace {
 		}
 		else if (strcmp(fourcc, "data") == 0) {
 			wave.dataSize = chunksize;
-			wave.data = new u8[chunksize];
+			wave.data = createArray<u8>(chunksize, KINC_MEMORY_TAG_AUDIO);
 			affirm(wave.data != nullptr);
 			memcpy(wave.data, data, chunksize);
 			data += chunksize;
@@ -107,6 +109,8 @@ Sound::Sound(Reader &file, const char *filename) : left(0), right(0), size(0), l
 void Sound::load(Reader &file, const char *filename) {
 	size_t filenameLength = strlen(filename);
 	u8 *data = nullptr;
+	// stb_vorbis allocates with malloc
+	bool vorbisData = false;
 
 	if (strncmp(&filename[filenameLength - 4], ".ogg", 4) == 0) {
 		u8 *filedata = (u8 *)file.readAll();
@@ -114,6 +118,7 @@ void Sound::load(Reader &file, const char *filename) {
 		size = samples * 2 * format.channels;
 		format.bitsPerSample = 16;
 		length = samples / (float)format.samplesPerSecond;
+		vorbisData = true;
 	}
 	else if (strncmp(&filename[filenameLength - 4], ".wav", 4) == 0) {
 		WaveData wave = {0};
@@ -143,14 +148,14 @@ void Sound::load(Reader &file, const char *filename) {
 
 	if (format.channels == 1) {
 		if (format.bitsPerSample == 8) {
-			left = new s16[size];
-			right = new s16[size];
+			left = createArray<s16>(size, KINC_MEMORY_TAG_AUDIO);
+			right = createArray<s16>(size, KINC_MEMORY_TAG_AUDIO);
 			splitMono8(data, size, left, right);
 		}
 		else if (format.bitsPerSample == 16) {
 			size /= 2;
-			left = new s16[size];
-			right = new s16[size];
+			left = createArray<s16>(size, KINC_MEMORY_TAG_AUDIO);
+			right = createArray<s16>(size, KINC_MEMORY_TAG_AUDIO);
 			splitMono16((s16 *)data, size, left, right);
 		}
 		else {
@@ -161,14 +166,14 @@ void Sound::load(Reader &file, const char *filename) {
 		// Left and right channel are in s16 audio stream, alternating.
 		if (format.bitsPerSample == 8) {
 			size /= 2;
-			left = new s16[size];
-			right = new s16[size];
+			left = createArray<s16>(size, KINC_MEMORY_TAG_AUDIO);
+			right = createArray<s16>(size, KINC_MEMORY_TAG_AUDIO);
 			splitStereo8(data, size, left, right);
 		}
 		else if (format.bitsPerSample == 16) {
 			size /= 4;
-			left = new s16[size];
-			right = new s16[size];
+			left = createArray<s16>(size, KINC_MEMORY_TAG_AUDIO);
+			right = createArray<s16>(size, KINC_MEMORY_TAG_AUDIO);
 			splitStereo16((s16 *)data, size, left, right);
 		}
 		else {
@@ -176,12 +181,17 @@ void Sound::load(Reader &file, const char *filename) {
 		}
 	}
 	sampleRatePos = 44100 / (float)format.samplesPerSecond;
-	delete[] data;
+	if (vorbisData) {
+		free(data);
+	}
+	else {
+		destroyArray(data);
+	}
 }
 
 Sound::~Sound() {
-	delete[] left;
-	delete[] right;
+	destroyArray(left);
+	destroyArray(right);
 	left = nullptr;
 	right = nullptr;
 }
@@ -2,6 +2,7 @@
 
 #define STB_VORBIS_HEADER_ONLY
 #include <Kore/IO/FileReader.h>
+#include <Kore/Memory.h>
 #include <kinc/audio1/stb_vorbis.c>
 #include <string.h>
 
@@ -9,7 +10,7 @@ using namespace Kore;
 
 SoundStream::SoundStream(const char *filename, bool looping) : myLooping(looping), myVolume(1), decoded(false), rateDecodedHack(false), end(false) {
 	FileReader file(filename);
-	buffer = new u8[file.size()];
+	buffer = createArray<u8>(file.size(), KINC_MEMORY_TAG_AUDIO);
 	u8 *filecontent = (u8 *)file.readAll();
 	memcpy(buffer, filecontent, file.size());
 	vorbis = stb_vorbis_open_memory(buffer, file.size(), nullptr, nullptr);
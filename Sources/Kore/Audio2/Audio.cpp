@@ -1,5 +1,6 @@
 #include "Audio.h"
 
+#include <Kore/Memory.h>
 #include <kinc/audio2/audio.h>
 
 #include <stdio.h>
@@ -51,7 +52,7 @@ void Audio2::init() {
 	buffer.readLocation = 0;
 	buffer.writeLocation = 0;
 	buffer.dataSize = 128 * 1024;
-	buffer.data = new u8[buffer.dataSize];
+	buffer.data = createArray<u8>(buffer.dataSize, KINC_MEMORY_TAG_AUDIO);
 	Audio2::samplesPerSecond = kinc_a2_samples_per_second;
 	kinc_a2_set_callback(audio);
 #if defined(KORE_IOS) || defined(KORE_MACOS)
@@ -65,4 +66,6 @@ void Audio2::update() {
 
 void Audio2::shutdown() {
 	kinc_a2_shutdown();
+	destroyArray(buffer.data);
+	buffer.data = nullptr;
 }
@@ -20,20 +20,68 @@ namespace Kore {
 			int writeLocation;
 		};
 
+		struct Channel;
+
+		// has to write the given number of mono float-samples into the channel's buffer, called from the audio-thread without holding Audio3's lock
 		typedef void (*AudioCallback)(int samples);
+		typedef void (*ChannelCallback)(Channel *channel, int samples);
+
+		enum DistanceModel { DistanceNone, DistanceInverse, DistanceLinear, DistanceExponential };
+
+		enum Panning { PanningEqualPower, PanningHRTF };
 
 		struct Channel {
 			vec3 origin;
 			AudioCallback callback;
 			Buffer buffer;
 			bool active;
+
+			ChannelCallback channelCallback;
+			void *userdata;
+			// in units per second, only used for the Doppler-effect
+			vec3 velocity;
+			float volume;
+			DistanceModel distanceModel;
+			// the distance up to which the volume is not attenuated
+			float referenceDistance;
+			// the distance beyond which the volume is not attenuated any further (and reaches zero for DistanceLinear)
+			float maxDistance;
+			float rolloff;
+			// cutoff-frequency of a low-pass filter in Hz or 0 to disable it
+			float lowPass;
+			bool doppler;
+		};
+
+		struct Statistics {
+			// voices which were mixed in the last block
+			int voices;
+			// voices which were skipped because they were inaudible
+			int culled;
+			// time it took to mix the last block, not counting the callbacks
+			double seconds;
+			int frames;
 		};
 
 		void init();
 		void update();
 		void shutdown();
 
+		// the channel is set up with an inverse distance model, a reference distance of 1, no low-pass and Doppler enabled
 		Channel *createChannel(vec3 origin, AudioCallback callback);
+		Channel *createChannel(vec3 origin, ChannelCallback callback, void *userdata);
 		void destroyChannel(Channel *channel);
+
+		void setListener(vec3 position, vec3 forward, vec3 up, vec3 velocity = vec3(0, 0, 0));
+		// 343 by default, which fits a scene which is measured in meters
+		void setSpeedOfSound(float unitsPerSecond);
+		void setDopplerFactor(float factor);
+		void setPanning(Panning panning);
+		// Sets head-related impulse-responses which are used by PanningHRTF. They are given for directions on the horizontal plane, evenly spaced and
+		// ordered clockwise starting in front of the listener, one after another. The data is copied, empty sets are logged and ignored.
+		void setHRTF(const float *left, const float *right, int directions, int length);
+		// Voices which are quieter than the threshold are not mixed but their callbacks are still called to keep them in sync, 1/10000 by default.
+		void setCullThreshold(float volume);
+
+		Statistics statistics();
 	}
 }
@@ -4,6 +4,7 @@
 #include <Kore/Graphics4/PipelineState.h>
 #include <Kore/Graphics4/Shader.h>
 #include <Kore/IO/FileReader.h>
+#include <Kore/Memory.h>
 #include <limits>
 
 using namespace Kore;
@@ -53,12 +54,12 @@ void Graphics1::init(int width, int height) {
 	h = height;
 	FileReader vs("g1.vert");
 	FileReader fs("g1.frag");
-	vertexShader = new Graphics4::Shader(vs.readAll(), vs.size(), Graphics4::VertexShader);
-	fragmentShader = new Graphics4::Shader(fs.readAll(), fs.size(), Graphics4::FragmentShader);
+	vertexShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, vs.readAll(), vs.size(), Graphics4::VertexShader);
+	fragmentShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, fs.readAll(), fs.size(), Graphics4::FragmentShader);
 	Graphics4::VertexStructure structure;
 	structure.add("pos", Graphics4::Float3VertexData);
 	structure.add("tex", Graphics4::Float2VertexData);
-	pipeline = new Graphics4::PipelineState;
+	pipeline = createObject<Graphics4::PipelineState>(KINC_MEMORY_TAG_GRAPHICS);
 	pipeline->inputLayout[0] = &structure;
 	pipeline->inputLayout[1] = nullptr;
 	pipeline->vertexShader = vertexShader;
@@ -67,7 +68,7 @@ void Graphics1::init(int width, int height) {
 
 	tex = pipeline->getTextureUnit("tex");
 
-	texture = new Graphics4::Texture(width, height, Image::RGBA32, false);
+	texture = createObject<Graphics4::Texture>(KINC_MEMORY_TAG_GRAPHICS, width, height, Image::RGBA32, false);
 	image = (int *)texture->lock();
 	for (int y = 0; y < texture->texHeight; ++y) {
 		for (int x = 0; x < texture->texWidth; ++x) {
@@ -80,7 +81,7 @@ void Graphics1::init(int width, int height) {
 	float xAspect = (float)texture->width / texture->texWidth;
 	float yAspect = (float)texture->height / texture->texHeight;
 
-	vb = new Graphics4::VertexBuffer(4, structure, Kore::Graphics4::StaticUsage, 0);
+	vb = createObject<Graphics4::VertexBuffer>(KINC_MEMORY_TAG_GRAPHICS, 4, structure, Kore::Graphics4::StaticUsage, 0);
 	float *v = vb->lock();
 	{
 		int i = 0;
@@ -107,7 +108,7 @@ void Graphics1::init(int width, int height) {
 	}
 	vb->unlock();
 
-	ib = new Graphics4::IndexBuffer(6);
+	ib = createObject<Graphics4::IndexBuffer>(KINC_MEMORY_TAG_GRAPHICS, 6);
 	int *ii = ib->lock();
 	{
 		int i = 0;
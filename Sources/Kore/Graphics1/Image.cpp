@@ -3,6 +3,7 @@
 #include <Kore/Graphics4/Graphics.h>
 #include <Kore/IO/BufferReader.h>
 #include <Kore/IO/FileReader.h>
+#include <Kore/Memory.h>
 #include <Kore/IO/Reader.h>
 
 #include <kinc/image.h>
@@ -45,7 +46,7 @@ namespace {
 
 		size_t size = kinc_image_size_from_callbacks(callbacks, &file, filename);
 		file.seek(0);
-		output = new u8[size];
+		output = createArray<u8>((int)size, KINC_MEMORY_TAG_IMAGE);
 		kinc_image_t image;
 		kinc_image_init_from_callbacks(&image, output, callbacks, &file, filename);
 		outputSize = (int)size;
@@ -82,14 +83,16 @@ int Graphics1::Image::sizeOf(Image::Format format) {
 Graphics1::Image::Image(int width, int height, Format format, bool readable) : width(width), height(height), depth(1), format(format), readable(readable) {
 	compression = ImageCompressionNone;
 	dataSize = width * height * sizeOf(format);
-	data = new u8[dataSize];
+	data = createArray<u8>(dataSize, KINC_MEMORY_TAG_IMAGE);
+	allocatedData = true;
 }
 
 Graphics1::Image::Image(int width, int height, int depth, Format format, bool readable)
     : width(width), height(height), depth(depth), format(format), readable(readable) {
 	compression = ImageCompressionNone;
 	dataSize = width * height * depth * sizeOf(format);
-	data = new u8[dataSize];
+	data = createArray<u8>(dataSize, KINC_MEMORY_TAG_IMAGE);
+	allocatedData = true;
 }
 
 Graphics1::Image::Image(const char *filename, bool readable) : depth(1), format(RGBA32), readable(readable) {
@@ -105,25 +108,37 @@ Graphics1::Image::Image(void *data, int width, int height, Format format, bool r
     : width(width), height(height), depth(1), format(format), readable(readable) {
 	compression = ImageCompressionNone;
 	this->data = data;
+	allocatedData = false;
 }
 
 Graphics1::Image::Image(void *data, int width, int height, int depth, Format format, bool readable)
     : width(width), height(height), depth(depth), format(format), readable(readable) {
 	compression = ImageCompressionNone;
 	this->data = data;
+	allocatedData = false;
 }
 
-Graphics1::Image::Image() : depth(1), format(RGBA32), readable(false) {}
+Graphics1::Image::Image() : depth(1), format(RGBA32), readable(false), data(nullptr), allocatedData(false) {}
 
 void Graphics1::Image::init(Kore::Reader &file, const char *filename, bool readable) {
 	u8 *imageData;
 	loadImage(file, filename, imageData, dataSize, width, height, compression, this->format, internalFormat);
 	data = imageData;
+	allocatedData = true;
 }
 
 Graphics1::Image::~Image() {
+	freeData();
+}
+
+void Graphics1::Image::freeData() {
 	if (data != nullptr) {
-		free(data);
+		if (allocatedData) {
+			destroyArray((u8 *)data);
+		}
+		else {
+			free(data);
+		}
 		data = nullptr;
 	}
 }
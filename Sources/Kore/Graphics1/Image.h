@@ -35,6 +35,11 @@ namespace Kore {
 		protected:
 			Image();
 			void init(Kore::Reader &reader, const char *format, bool readable);
+			void freeData();
+
+		private:
+			// data which was passed in by the caller is released using free, everything else was allocated using kinc_memory
+			bool allocatedData;
 		};
 	}
 }
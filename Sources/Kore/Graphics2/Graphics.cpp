@@ -2,6 +2,7 @@
 
 #include <Kore/Graphics3/Graphics.h>
 #include <Kore/IO/FileReader.h>
+#include <Kore/Memory.h>
 #include <Kore/Simd/float32x4.h>
 
 #include <string.h>
@@ -50,10 +51,10 @@ void Graphics2::ImageShaderPainter::initShaders() {
 
 	FileReader fs("painter-image.frag");
 	FileReader vs("painter-image.vert");
-	Graphics4::Shader *fragmentShader = new Graphics4::Shader(fs.readAll(), fs.size(), Graphics4::FragmentShader);
-	Graphics4::Shader *vertexShader = new Graphics4::Shader(vs.readAll(), vs.size(), Graphics4::VertexShader);
+	Graphics4::Shader *fragmentShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, fs.readAll(), fs.size(), Graphics4::FragmentShader);
+	Graphics4::Shader *vertexShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, vs.readAll(), vs.size(), Graphics4::VertexShader);
 
-	shaderPipeline = new Graphics4::PipelineState;
+	shaderPipeline = createObject<Graphics4::PipelineState>(KINC_MEMORY_TAG_GRAPHICS);
 	shaderPipeline->fragmentShader = fragmentShader;
 	shaderPipeline->vertexShader = vertexShader;
 
@@ -75,10 +76,10 @@ void Graphics2::ImageShaderPainter::initShaders() {
 }
 
 void Graphics2::ImageShaderPainter::initBuffers() {
-	rectVertexBuffer = new Graphics4::VertexBuffer(bufferSize * 4, structure, Graphics4::DynamicUsage);
+	rectVertexBuffer = createObject<Graphics4::VertexBuffer>(KINC_MEMORY_TAG_GRAPHICS, bufferSize * 4, structure, Graphics4::DynamicUsage);
 	rectVertices = rectVertexBuffer->lock();
 
-	indexBuffer = new Graphics4::IndexBuffer(bufferSize * 3 * 2);
+	indexBuffer = createObject<Graphics4::IndexBuffer>(KINC_MEMORY_TAG_GRAPHICS, bufferSize * 3 * 2);
 	int *indices = indexBuffer->lock();
 	for (int i = 0; i < bufferSize; ++i) {
 		indices[i * 3 * 2 + 0] = i * 4 + 0;
@@ -288,9 +289,9 @@ void Graphics2::ImageShaderPainter::end() {
 }
 
 Graphics2::ImageShaderPainter::~ImageShaderPainter() {
-	delete shaderPipeline;
-	delete rectVertexBuffer;
-	delete indexBuffer;
+	destroyObject(shaderPipeline);
+	destroyObject(rectVertexBuffer);
+	destroyObject(indexBuffer);
 }
 
 //==========
@@ -330,10 +331,10 @@ void Graphics2::ColoredShaderPainter::initShaders() {
 
 	FileReader fs("painter-colored.frag");
 	FileReader vs("painter-colored.vert");
-	Graphics4::Shader *fragmentShader = new Graphics4::Shader(fs.readAll(), fs.size(), Graphics4::FragmentShader);
-	Graphics4::Shader *vertexShader = new Graphics4::Shader(vs.readAll(), vs.size(), Graphics4::VertexShader);
+	Graphics4::Shader *fragmentShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, fs.readAll(), fs.size(), Graphics4::FragmentShader);
+	Graphics4::Shader *vertexShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, vs.readAll(), vs.size(), Graphics4::VertexShader);
 
-	shaderPipeline = new Graphics4::PipelineState();
+	shaderPipeline = createObject<Graphics4::PipelineState>(KINC_MEMORY_TAG_GRAPHICS);
 	shaderPipeline->fragmentShader = fragmentShader;
 	shaderPipeline->vertexShader = vertexShader;
 
@@ -353,10 +354,10 @@ void Graphics2::ColoredShaderPainter::initShaders() {
 }
 
 void Graphics2::ColoredShaderPainter::initBuffers() {
-	rectVertexBuffer = new Graphics4::VertexBuffer(bufferSize * 4, structure);
+	rectVertexBuffer = createObject<Graphics4::VertexBuffer>(KINC_MEMORY_TAG_GRAPHICS, bufferSize * 4, structure);
 	rectVertices = rectVertexBuffer->lock();
 
-	indexBuffer = new Graphics4::IndexBuffer(bufferSize * 3 * 2);
+	indexBuffer = createObject<Graphics4::IndexBuffer>(KINC_MEMORY_TAG_GRAPHICS, bufferSize * 3 * 2);
 	int *indices = indexBuffer->lock();
 	for (int i = 0; i < bufferSize; ++i) {
 		indices[i * 3 * 2 + 0] = i * 4 + 0;
@@ -368,10 +369,10 @@ void Graphics2::ColoredShaderPainter::initBuffers() {
 	}
 	indexBuffer->unlock();
 
-	triangleVertexBuffer = new Graphics4::VertexBuffer(triangleBufferSize * 3, structure);
+	triangleVertexBuffer = createObject<Graphics4::VertexBuffer>(KINC_MEMORY_TAG_GRAPHICS, triangleBufferSize * 3, structure);
 	triangleVertices = triangleVertexBuffer->lock();
 
-	triangleIndexBuffer = new Graphics4::IndexBuffer(triangleBufferSize * 3);
+	triangleIndexBuffer = createObject<Graphics4::IndexBuffer>(KINC_MEMORY_TAG_GRAPHICS, triangleBufferSize * 3);
 	int *triIndices = triangleIndexBuffer->lock();
 	for (int i = 0; i < bufferSize; ++i) {
 		triIndices[i * 3 + 0] = i * 3 + 0;
@@ -550,11 +551,11 @@ void Graphics2::ColoredShaderPainter::end() {
 }
 
 Graphics2::ColoredShaderPainter::~ColoredShaderPainter() {
-	delete shaderPipeline;
-	delete rectVertexBuffer;
-	delete indexBuffer;
-	delete triangleVertexBuffer;
-	delete triangleIndexBuffer;
+	destroyObject(shaderPipeline);
+	destroyObject(rectVertexBuffer);
+	destroyObject(indexBuffer);
+	destroyObject(triangleVertexBuffer);
+	destroyObject(triangleIndexBuffer);
 }
 
 //==========
@@ -595,10 +596,10 @@ void Graphics2::TextShaderPainter::initShaders() {
 
 	FileReader fs("painter-text.frag");
 	FileReader vs("painter-text.vert");
-	Graphics4::Shader *fragmentShader = new Graphics4::Shader(fs.readAll(), fs.size(), Graphics4::FragmentShader);
-	Graphics4::Shader *vertexShader = new Graphics4::Shader(vs.readAll(), vs.size(), Graphics4::VertexShader);
+	Graphics4::Shader *fragmentShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, fs.readAll(), fs.size(), Graphics4::FragmentShader);
+	Graphics4::Shader *vertexShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, vs.readAll(), vs.size(), Graphics4::VertexShader);
 
-	shaderPipeline = new Graphics4::PipelineState();
+	shaderPipeline = createObject<Graphics4::PipelineState>(KINC_MEMORY_TAG_GRAPHICS);
 	shaderPipeline->fragmentShader = fragmentShader;
 	shaderPipeline->vertexShader = vertexShader;
 
@@ -616,10 +617,10 @@ void Graphics2::TextShaderPainter::initShaders() {
 }
 
 void Graphics2::TextShaderPainter::initBuffers() {
-	rectVertexBuffer = new Graphics4::VertexBuffer(bufferSize * 4, structure);
+	rectVertexBuffer = createObject<Graphics4::VertexBuffer>(KINC_MEMORY_TAG_GRAPHICS, bufferSize * 4, structure);
 	rectVertices = rectVertexBuffer->lock();
 
-	indexBuffer = new Graphics4::IndexBuffer(bufferSize * 3 * 2);
+	indexBuffer = createObject<Graphics4::IndexBuffer>(KINC_MEMORY_TAG_GRAPHICS, bufferSize * 3 * 2);
 	int *indices = indexBuffer->lock();
 	for (int i = 0; i < bufferSize; ++i) {
 		indices[i * 3 * 2 + 0] = i * 4 + 0;
@@ -774,9 +775,9 @@ void Graphics2::TextShaderPainter::end() {
 }
 
 Graphics2::TextShaderPainter::~TextShaderPainter() {
-	delete shaderPipeline;
-	delete rectVertexBuffer;
-	delete indexBuffer;
+	destroyObject(shaderPipeline);
+	destroyObject(rectVertexBuffer);
+	destroyObject(indexBuffer);
 }
 
 //==========
@@ -793,9 +794,9 @@ Graphics2::Graphics2::Graphics2(int width, int height, bool rTargets)
 	myImageScaleQuality = High;
 	myMipmapScaleQuality = High;
 
-	imagePainter = new ImageShaderPainter();
-	coloredPainter = new ColoredShaderPainter();
-	textPainter = new TextShaderPainter();
+	imagePainter = createObject<ImageShaderPainter>(KINC_MEMORY_TAG_GRAPHICS);
+	coloredPainter = createObject<ColoredShaderPainter>(KINC_MEMORY_TAG_GRAPHICS);
+	textPainter = createObject<TextShaderPainter>(KINC_MEMORY_TAG_GRAPHICS);
 	textPainter->fontSize = fontSize;
 
 	setProjection();
@@ -813,10 +814,10 @@ void Graphics2::Graphics2::initShaders() {
 
 	FileReader fs("painter-video.frag");
 	FileReader vs("painter-video.vert");
-	Graphics4::Shader *fragmentShader = new Graphics4::Shader(fs.readAll(), fs.size(), Graphics4::FragmentShader);
-	Graphics4::Shader *vertexShader = new Graphics4::Shader(vs.readAll(), vs.size(), Graphics4::VertexShader);
+	Graphics4::Shader *fragmentShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, fs.readAll(), fs.size(), Graphics4::FragmentShader);
+	Graphics4::Shader *vertexShader = createObject<Graphics4::Shader>(KINC_MEMORY_TAG_GRAPHICS, vs.readAll(), vs.size(), Graphics4::VertexShader);
 
-	videoPipeline = new Graphics4::PipelineState();
+	videoPipeline = createObject<Graphics4::PipelineState>(KINC_MEMORY_TAG_GRAPHICS);
 	videoPipeline->fragmentShader = fragmentShader;
 	videoPipeline->vertexShader = vertexShader;
 
@@ -1153,10 +1154,10 @@ void Graphics2::Graphics2::setFontColor(uint color) {
 }
 
 Graphics2::Graphics2::~Graphics2() {
-	delete imagePainter;
-	delete coloredPainter;
-	delete textPainter;
-	delete videoPipeline;
+	destroyObject(imagePainter);
+	destroyObject(coloredPainter);
+	destroyObject(textPainter);
+	destroyObject(videoPipeline);
 }
 
 #endif
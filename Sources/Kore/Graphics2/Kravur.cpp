@@ -1,6 +1,8 @@
 #include "Kravur.h"
 
 #include <Kore/IO/FileReader.h>
+#include <Kore/Memory.h>
+
 #include <map>
 #include <sstream>
 #include <string.h>
@@ -32,7 +34,8 @@ Kravur *Kravur::load(const char *name, FontStyle style, float size) {
 	Kravur *kravur = fontCache[key];
 	if (kravur == nullptr) {
 		FileReader reader(key.c_str());
-		kravur = new Kravur(&reader);
+		// the constructor is private so createObject can not be used
+		kravur = new (kinc_memory_allocate(sizeof(Kravur), KINC_MEMORY_TAG_GRAPHICS)) Kravur(&reader);
 		kravur->name = name;
 		kravur->style = style;
 		kravur->size = size;
@@ -72,7 +75,7 @@ Kravur::Kravur(Reader *reader) {
 		w = w / 2;
 		h = h / 2;
 	}
-	texture = new Graphics4::Texture(w, h, Graphics4::Image::Grey8, true);
+	texture = createObject<Graphics4::Texture>(KINC_MEMORY_TAG_GRAPHICS, w, h, Graphics4::Image::Grey8, true);
 	u8 *bytes = texture->lock();
 	reader->read(bytes, w * h);
 	texture->unlock();
@@ -10,8 +10,7 @@ Graphics4::Texture::Texture(kinc_g4_texture_t texture) : Image(texture.tex_width
 	texHeight = kincTexture.tex_height;
 	texDepth = kincTexture.tex_depth;
 
-	free(data);
-	data = nullptr;
+	freeData();
 }
 
 Graphics4::Texture::Texture(const char *filename, bool readable) : Image(filename, readable) {
@@ -24,8 +23,7 @@ Graphics4::Texture::Texture(const char *filename, bool readable) : Image(filenam
 	kinc_image_destroy(&image);
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -36,8 +34,7 @@ Graphics4::Texture::Texture(int width, int height, Graphics4::Image::Format form
 	texDepth = 1;
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -48,8 +45,7 @@ Graphics4::Texture::Texture(int width, int height, int depth, Format format, boo
 	texDepth = kincTexture.tex_depth;
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -63,8 +59,7 @@ Graphics4::Texture::Texture(void *imageData, int width, int height, Format forma
 	kinc_image_destroy(&image);
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -79,8 +74,7 @@ Graphics4::Texture::Texture(void *imageData, int width, int height, int depth, F
 	kinc_image_destroy(&image);
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -97,8 +91,7 @@ Graphics4::Texture::Texture(void *filedata, int size, const char *format, bool r
 	kinc_image_destroy(&image);
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -112,8 +105,7 @@ Graphics4::Texture::Texture(Kore::Reader &reader, const char *format, bool reada
 	kinc_image_destroy(&image);
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
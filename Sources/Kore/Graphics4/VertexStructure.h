@@ -11,7 +11,14 @@ namespace Kore {
 			Float4x4VertexData, // not supported in fixed function OpenGL
 			Short2NormVertexData,
 			Short4NormVertexData,
-			ColorVertexData
+			ColorVertexData,
+			Half2VertexData,
+			Half4VertexData,
+			Byte4NormVertexData,
+			Byte4UNormVertexData,
+			UInt10_10_10_2VertexData,
+			Short2VertexData,
+			Short4VertexData
 		};
 
 		enum Usage {
@@ -10,8 +10,7 @@ using namespace Kore::Graphics5;
     texHeight = kincTexture.tex_height;
     texDepth = kincTexture.tex_depth;
 
-    free(data);
-    data = nullptr;
+    freeData();
 }*/
 
 Texture::Texture(const char *filename, bool readable) : Image(filename, readable) {
@@ -24,8 +23,7 @@ Texture::Texture(const char *filename, bool readable) : Image(filename, readable
 	kinc_image_destroy(&image);
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -36,8 +34,7 @@ Texture::Texture(int width, int height, Image::Format format, bool readable) : I
 	texDepth = 1;
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -48,8 +45,7 @@ Texture::Texture(int width, int height, int depth, Format format, bool readable)
 	texDepth = 1; // kincTexture.texDepth;
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -64,8 +60,7 @@ Texture::Texture(void *imageData, int width, int height, int format, bool readab
 	kinc_image_destroy(&image);
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -80,8 +75,7 @@ Texture::Texture(void *imageData, int width, int height, int depth, int format,
 	kinc_image_destroy(&image);
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
@@ -98,8 +92,7 @@ Texture::Texture(void *imageData, int width, int height, int depth, int format,
     kinc_image_destroy(&image);
 
     if (!readable) {
-        free(data);
-        data = nullptr;
+        freeData();
     }
 }*/
 
@@ -113,8 +106,7 @@ Texture::Texture(Kore::Reader &reader, const char *format, bool readable) : Imag
 	kinc_image_destroy(&image);
 
 	if (!readable) {
-		free(data);
-		data = nullptr;
+		freeData();
 	}
 }
 
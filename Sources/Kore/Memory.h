@@ -0,0 +1,29 @@
+#pragma once
+
+#include <kinc/memory.h>
+
+#include <new>
+
+namespace Kore {
+	// like new but allocates through kinc_memory_allocate, destroy the object with destroyObject
+	template <class T, class... Args> T *createObject(kinc_memory_tag_t tag, Args &&... args) {
+		void *memory = kinc_memory_allocate(sizeof(T), tag);
+		return new (memory) T(static_cast<Args &&>(args)...);
+	}
+
+	template <class T> void destroyObject(T *object) {
+		if (object != nullptr) {
+			object->~T();
+			kinc_memory_free(object);
+		}
+	}
+
+	// like new[] for types which do not need a constructor or destructor, free the array with destroyArray
+	template <class T> T *createArray(int count, kinc_memory_tag_t tag) {
+		return (T *)kinc_memory_allocate(count * sizeof(T), tag);
+	}
+
+	template <class T> void destroyArray(T *array) {
+		kinc_memory_free(array);
+	}
+}
@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstring>
 
+#include <Kore/Memory.h>
 #include <Kore/System.h>
 
 using namespace Kore;
@@ -26,24 +27,24 @@ Connection::Connection(int receivePort, int maxConns, double timeout, double png
 	socket.init();
 	socket.open(KINC_SOCKET_PROTOCOL_UDP, receivePort, &options);
 
-	sndBuff = new u8[buffSize];
-	sndCache = new u8[(buffSize + 12) * cacheCount];
-	recBuff = new u8[buffSize];
-
-	states = new State[maxConns];
-	pings = new double[maxConns];
-	congests = new bool[maxConns];
-
-	connAdds = new unsigned[maxConns];
-	connPorts = new int[maxConns];
-	lastRecs = new double[maxConns];
-	lastSndNrsRel = new u32[maxConns];
-	lastSndNrsURel = new u32[maxConns];
-	lastAckNrsRel = new u32[maxConns];
-	lastRecNrsRel = new u32[maxConns];
-	lastRecNrsURel = new u32[maxConns];
-	congestBits = new u32[maxConns];
-	recCaches = new u8[(buffSize + 12) * cacheCount * maxConns];
+	sndBuff = createArray<u8>(buffSize, KINC_MEMORY_TAG_NETWORK);
+	sndCache = createArray<u8>((buffSize + 12) * cacheCount, KINC_MEMORY_TAG_NETWORK);
+	recBuff = createArray<u8>(buffSize, KINC_MEMORY_TAG_NETWORK);
+
+	states = createArray<State>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	pings = createArray<double>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	congests = createArray<bool>(maxConns, KINC_MEMORY_TAG_NETWORK);
+
+	connAdds = createArray<unsigned>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	connPorts = createArray<int>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	lastRecs = createArray<double>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	lastSndNrsRel = createArray<u32>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	lastSndNrsURel = createArray<u32>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	lastAckNrsRel = createArray<u32>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	lastRecNrsRel = createArray<u32>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	lastRecNrsURel = createArray<u32>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	congestBits = createArray<u32>(maxConns, KINC_MEMORY_TAG_NETWORK);
+	recCaches = createArray<u8>((buffSize + 12) * cacheCount * maxConns, KINC_MEMORY_TAG_NETWORK);
 
 	for (int id = 0; id < maxConns; ++id) {
 		reset(id, false);
@@ -52,23 +53,23 @@ Connection::Connection(int receivePort, int maxConns, double timeout, double png
 }
 
 Connection::~Connection() {
-	delete[] sndBuff;
-	delete[] sndCache;
-	delete[] recBuff;
-	delete[] recCaches;
-
-	delete[] states;
-	delete[] pings;
-	delete[] congests;
-	delete[] connAdds;
-	delete[] connPorts;
-	delete[] lastSndNrsRel;
-	delete[] lastSndNrsURel;
-	delete[] lastAckNrsRel;
-	delete[] lastRecNrsRel;
-	delete[] lastRecNrsURel;
-	delete[] congestBits;
-	delete[] lastRecs;
+	destroyArray(sndBuff);
+	destroyArray(sndCache);
+	destroyArray(recBuff);
+	destroyArray(recCaches);
+
+	destroyArray(states);
+	destroyArray(pings);
+	destroyArray(congests);
+	destroyArray(connAdds);
+	destroyArray(connPorts);
+	destroyArray(lastSndNrsRel);
+	destroyArray(lastSndNrsURel);
+	destroyArray(lastAckNrsRel);
+	destroyArray(lastRecNrsRel);
+	destroyArray(lastRecNrsURel);
+	destroyArray(congestBits);
+	destroyArray(lastRecs);
 }
 
 int Connection::getID(unsigned int recAddr, unsigned int recPort) {
@@ -1,5 +1,6 @@
 #include "Thread.h"
 
+#include <Kore/Memory.h>
 #include <kinc/threads/thread.h>
 
 void Kore::threadsInit() {}
@@ -7,19 +8,19 @@ void Kore::threadsInit() {}
 void Kore::threadsQuit() {}
 
 Kore::Thread *Kore::createAndRunThread(void (*func)(void *param), void *param) {
-	Kore::Thread *thread = new Kore::Thread;
+	Kore::Thread *thread = Kore::createObject<Kore::Thread>(KINC_MEMORY_TAG_GENERAL);
 	kinc_thread_init(&thread->thread, func, param);
 	return thread;
 }
 
 void Kore::waitForThreadStopThenFree(Thread *thread) {
 	kinc_thread_wait_and_destroy(&thread->thread);
-	delete thread;
+	Kore::destroyObject(thread);
 }
 
 bool Kore::isThreadStoppedThenFree(Thread *thread) {
 	if (kinc_thread_try_to_destroy(&thread->thread)) {
-		delete thread;
+		Kore::destroyObject(thread);
 		return true;
 	}
 	else {
@@ -4,6 +4,8 @@
 
 #include <kinc/audio2/audio.h>
 #include <kinc/math/core.h>
+#include <kinc/profiler.h>
+#include <kinc/simd/float32x4.h>
 #include <kinc/threads/mutex.h>
 #include <kinc/video.h>
 
@@ -16,102 +18,293 @@ static kinc_a1_channel_t channels[CHANNEL_COUNT];
 static kinc_a1_stream_channel_t streams[CHANNEL_COUNT];
 static kinc_internal_video_channel_t videos[CHANNEL_COUNT];
 
-static float sampleLinear(int16_t *data, float position) {
-	int pos1 = (int)position;
-	int pos2 = (int)(position + 1);
-	float sample1 = data[pos1] / 32767.0f;
-	float sample2 = data[pos2] / 32767.0f;
-	float a = position - pos1;
-	return sample1 * (1 - a) + sample2 * a;
+static kinc_a1_interpolation_t interpolation = KINC_A1_INTERPOLATION_LINEAR;
+
+// source-samples which are read before and after the interpolated position, the sinc-kernel uses all of them
+#define TAPS_BEFORE 3
+#define TAPS_AFTER 4
+#define TAPS (TAPS_BEFORE + TAPS_AFTER + 1)
+#define SINC_PHASES 128
+
+static float sinc_table[SINC_PHASES + 1][TAPS];
+
+// source-samples of one channel converted to float, each chunk of output-frames is interpolated from it
+#define WINDOW_SIZE 2048
+#define CHUNK_FRAMES 256
+static float window[WINDOW_SIZE];
+static float rendered[CHUNK_FRAMES];
+
+static void init_sinc_table(void) {
+	const float pi = 3.14159265358979f;
+	for (int phase = 0; phase <= SINC_PHASES; ++phase) {
+		float fraction = phase / (float)SINC_PHASES;
+		float sum = 0.0f;
+		for (int tap = 0; tap < TAPS; ++tap) {
+			float x = tap - TAPS_BEFORE - fraction;
+			float sinc = x == 0.0f ? 1.0f : kinc_sin(pi * x) / (pi * x);
+			// Blackman-window spanning all taps
+			float w = (x + TAPS_BEFORE + 1) / (TAPS + 1);
+			float blackman = 0.42f - 0.5f * kinc_cos(2.0f * pi * w) + 0.08f * kinc_cos(4.0f * pi * w);
+			sinc_table[phase][tap] = sinc * blackman;
+			sum += sinc_table[phase][tap];
+		}
+		for (int tap = 0; tap < TAPS; ++tap) {
+			sinc_table[phase][tap] /= sum;
+		}
+	}
 }
 
-/*float sampleHermite4pt3oX(s16* data, float position) {
-    float s0 = data[(int)(position - 1)] / 32767.0f;
-    float s1 = data[(int)(position + 0)] / 32767.0f;
-    float s2 = data[(int)(position + 1)] / 32767.0f;
-    float s3 = data[(int)(position + 2)] / 32767.0f;
+static int16_t *cached_block(kinc_a1_channel_t *channel, int side, int block) {
+	kinc_a1_sound_cache_t *cache;
+	// two blocks are kept so windows which reach back across a block-border do not decode the previous block again
+	if (channel->cache[0].block == block) {
+		cache = &channel->cache[0];
+	}
+	else if (channel->cache[1].block == block) {
+		cache = &channel->cache[1];
+	}
+	else {
+		cache = channel->cache[0].block < channel->cache[1].block ? &channel->cache[0] : &channel->cache[1];
+		kinc_internal_a1_sound_decode_block(channel->sound, block, cache);
+	}
+	return cache->samples[channel->sound->format.channels == 1 ? 0 : side];
+}
 
-    float x = position - (int)(position);
+// converts the source-samples [first, first + count) to float, samples outside of the sound are wrapped around for looping sounds or silent
+static void fetch(kinc_a1_channel_t *channel, int side, int first, int count, float *destination) {
+	const float scale = 1.0f / 32767.0f;
+	kinc_a1_sound_t *sound = channel->sound;
+	int size = sound->size;
+	int16_t *data = side == 0 ? sound->left : sound->right;
+	while (count > 0) {
+		int index = first;
+		if (index < 0 || index >= size) {
+			if (!channel->loop) {
+				*destination++ = 0.0f;
+				++first;
+				--count;
+				continue;
+			}
+			index = ((index % size) + size) % size;
+		}
+		int run = size - index < count ? size - index : count;
+		if (sound->storage == KINC_A1_SOUND_STORAGE_ADPCM) {
+			int block = index / KINC_A1_ADPCM_BLOCK_SAMPLES;
+			int offset = index - block * KINC_A1_ADPCM_BLOCK_SAMPLES;
+			if (KINC_A1_ADPCM_BLOCK_SAMPLES - offset < run) {
+				run = KINC_A1_ADPCM_BLOCK_SAMPLES - offset;
+			}
+			int16_t *samples = cached_block(channel, side, block) + offset;
+			for (int i = 0; i < run; ++i) {
+				destination[i] = samples[i] * scale;
+			}
+		}
+		else {
+			for (int i = 0; i < run; ++i) {
+				destination[i] = data[index + i] * scale;
+			}
+		}
+		destination += run;
+		first += run;
+		count -= run;
+	}
+}
 
-    // 4-point, 3rd-order Hermite (x-form)
-    float c0 = s1;
-    float c1 = 0.5f * (s2 - s0);
-    float c2 = s0 - 2.5f * s1 + 2 * s2 - 0.5f * s3;
-    float c3 = 0.5f * (s3 - s0) + 1.5f * (s1 - s2);
-    return ((c3 * x + c2) * x + c1) * x + c0;
-}*/
+// The kernels interpolate frames from the window where the first frame is at position start and the following ones are step apart.
+// They gather four frames at a time, the tail of a chunk is handled by gathering zeroes which are never read back.
 
-void kinc_internal_a1_mix(kinc_a2_buffer_t *buffer, int samples) {
-	for (int i = 0; i < samples; ++i) {
-		bool left = (i % 2) == 0;
-		float value = 0;
-#if 0
-		__m128 sseSamples[4];
-		for (int i = 0; i < channelCount; i += 4) {
-			s16 data[4];
-			for (int i2 = 0; i2 < 4; ++i2) {
-				if (channels[i + i2].sound != nullptr) {
-					data[i2] = *(s16*)&channels[i + i2].sound->data[channels[i + i2].position];
-					channels[i + i2].position += 2;
-					if (channels[i + i2].position >= channels[i + i2].sound->size) channels[i + i2].sound = nullptr;
-				}
-				else {
-					data[i2] = 0;
+static void interpolate_linear(const float *samples, float start, float step, int frames, float *out) {
+	for (int f = 0; f < frames; f += 4) {
+		float fractions[4] = {0};
+		float a[4] = {0}, b[4] = {0};
+		for (int lane = 0; lane < 4 && f + lane < frames; ++lane) {
+			float position = start + (f + lane) * step;
+			int index = (int)position;
+			fractions[lane] = position - index;
+			a[lane] = samples[index];
+			b[lane] = samples[index + 1];
+		}
+		kinc_float32x4_t s0 = kinc_float32x4_load_unaligned(a);
+		kinc_float32x4_t s1 = kinc_float32x4_load_unaligned(b);
+		kinc_float32x4_t x = kinc_float32x4_load_unaligned(fractions);
+		kinc_float32x4_store_unaligned(&out[f], kinc_float32x4_add(s0, kinc_float32x4_mul(kinc_float32x4_sub(s1, s0), x)));
+	}
+}
+
+// 4-point, 3rd-order Hermite (x-form)
+static void interpolate_hermite(const float *samples, float start, float step, int frames, float *out) {
+	const kinc_float32x4_t half = kinc_float32x4_load_all(0.5f);
+	const kinc_float32x4_t one_and_a_half = kinc_float32x4_load_all(1.5f);
+	const kinc_float32x4_t two = kinc_float32x4_load_all(2.0f);
+	const kinc_float32x4_t two_and_a_half = kinc_float32x4_load_all(2.5f);
+	for (int f = 0; f < frames; f += 4) {
+		float fractions[4] = {0};
+		float gathered[4][4] = {{0}};
+		for (int lane = 0; lane < 4 && f + lane < frames; ++lane) {
+			float position = start + (f + lane) * step;
+			int index = (int)position;
+			fractions[lane] = position - index;
+			for (int tap = 0; tap < 4; ++tap) {
+				gathered[tap][lane] = samples[index - 1 + tap];
+			}
+		}
+		kinc_float32x4_t s0 = kinc_float32x4_load_unaligned(gathered[0]);
+		kinc_float32x4_t s1 = kinc_float32x4_load_unaligned(gathered[1]);
+		kinc_float32x4_t s2 = kinc_float32x4_load_unaligned(gathered[2]);
+		kinc_float32x4_t s3 = kinc_float32x4_load_unaligned(gathered[3]);
+		kinc_float32x4_t x = kinc_float32x4_load_unaligned(fractions);
+
+		kinc_float32x4_t c1 = kinc_float32x4_mul(half, kinc_float32x4_sub(s2, s0));
+		kinc_float32x4_t c2 = kinc_float32x4_sub(kinc_float32x4_add(s0, kinc_float32x4_mul(two, s2)),
+		                                         kinc_float32x4_add(kinc_float32x4_mul(two_and_a_half, s1), kinc_float32x4_mul(half, s3)));
+		kinc_float32x4_t c3 =
+		    kinc_float32x4_add(kinc_float32x4_mul(half, kinc_float32x4_sub(s3, s0)), kinc_float32x4_mul(one_and_a_half, kinc_float32x4_sub(s1, s2)));
+		kinc_float32x4_t value = kinc_float32x4_add(kinc_float32x4_mul(c3, x), c2);
+		value = kinc_float32x4_add(kinc_float32x4_mul(value, x), c1);
+		value = kinc_float32x4_add(kinc_float32x4_mul(value, x), s1);
+		kinc_float32x4_store_unaligned(&out[f], value);
+	}
+}
+
+// 8-tap Blackman-windowed sinc, the coefficients are interpolated between the tabulated phases
+static void interpolate_sinc(const float *samples, float start, float step, int frames, float *out) {
+	for (int f = 0; f < frames; ++f) {
+		float position = start + f * step;
+		int index = (int)position;
+		float phase = (position - index) * SINC_PHASES;
+		int row = (int)phase;
+		kinc_float32x4_t t = kinc_float32x4_load_all(phase - row);
+
+		kinc_float32x4_t low0 = kinc_float32x4_load_unaligned(&sinc_table[row][0]);
+		kinc_float32x4_t low1 = kinc_float32x4_load_unaligned(&sinc_table[row][4]);
+		kinc_float32x4_t high0 = kinc_float32x4_load_unaligned(&sinc_table[row + 1][0]);
+		kinc_float32x4_t high1 = kinc_float32x4_load_unaligned(&sinc_table[row + 1][4]);
+		kinc_float32x4_t c0 = kinc_float32x4_add(low0, kinc_float32x4_mul(kinc_float32x4_sub(high0, low0), t));
+		kinc_float32x4_t c1 = kinc_float32x4_add(low1, kinc_float32x4_mul(kinc_float32x4_sub(high1, low1), t));
+
+		const float *taps = &samples[index - TAPS_BEFORE];
+		kinc_float32x4_t sum =
+		    kinc_float32x4_add(kinc_float32x4_mul(kinc_float32x4_load_unaligned(taps), c0), kinc_float32x4_mul(kinc_float32x4_load_unaligned(&taps[4]), c1));
+		out[f] = kinc_float32x4_get(sum, 0) + kinc_float32x4_get(sum, 1) + kinc_float32x4_get(sum, 2) + kinc_float32x4_get(sum, 3);
+	}
+}
+
+static void interpolate(const float *samples, float start, float step, int frames, float *out) {
+	switch (interpolation) {
+	case KINC_A1_INTERPOLATION_LINEAR:
+		interpolate_linear(samples, start, step, frames, out);
+		break;
+	case KINC_A1_INTERPOLATION_HERMITE:
+		interpolate_hermite(samples, start, step, frames, out);
+		break;
+	case KINC_A1_INTERPOLATION_SINC:
+		interpolate_sinc(samples, start, step, frames, out);
+		break;
+	}
+}
+
+// adds the channel to the interleaved stereo-output and returns false once a non-looping sound has ended
+static bool mix_channel(kinc_a1_channel_t *channel, float *out, int frames) {
+	kinc_a1_sound_t *sound = channel->sound;
+	float step = channel->pitch / sound->sample_rate_pos;
+	if (step < 0.0f) step = 0.0f;
+	float gain = channel->volume * channel->volume;
+	bool mono = sound->format.channels == 1;
+	// looping sounds interpolate between the last and the first sample
+	int end = channel->loop ? sound->size : sound->size - 1;
+
+	while (frames > 0) {
+		int count = frames < CHUNK_FRAMES ? frames : CHUNK_FRAMES;
+		// frames which fit into the window
+		float fit = (WINDOW_SIZE - TAPS - 2) / (step > 0.0f ? step : 1.0f);
+		if (fit < count) count = (int)fit + 1;
+		// frames until the sound ends
+		if (step > 0.0f) {
+			float remaining = (end - channel->position) / step;
+			int until_end = (int)remaining + ((int)remaining < remaining ? 1 : 0);
+			if (until_end < 1) until_end = 1;
+			if (until_end < count) count = until_end;
+		}
+
+		int first = (int)channel->position;
+		float start = channel->position - first + TAPS_BEFORE;
+		int last = (int)(channel->position + (count - 1) * step) + 1;
+		int length = last - first + TAPS;
+
+		for (int side = 0; side < (mono ? 1 : 2); ++side) {
+			fetch(channel, side, first - TAPS_BEFORE, length, window);
+			interpolate(window, start, step, count, rendered);
+			if (mono) {
+				for (int f = 0; f < count; ++f) {
+					out[f * 2 + 0] += rendered[f] * gain;
+					out[f * 2 + 1] += rendered[f] * gain;
 				}
 			}
-			sseSamples[i / 4] = _mm_set_ps(data[3] / 32767.0f, data[2] / 32767.0f, data[1] / 32767.0f, data[0] / 32767.0f);
-		}
-		__m128 a = _mm_add_ps(sseSamples[0], sseSamples[1]);
-		__m128 b = _mm_add_ps(sseSamples[2], sseSamples[3]);
-		__m128 c = _mm_add_ps(a, b);
-		value = c.m128_f32[0] + c.m128_f32[1] + c.m128_f32[2] + c.m128_f32[3];
-		value = max(min(value, 1.0f), -1.0f);
-#else
-		kinc_mutex_lock(&mutex);
-		for (int i = 0; i < CHANNEL_COUNT; ++i) {
-			if (channels[i].sound != NULL) {
-				// value += *(s16*)&channels[i].sound->data[(int)channels[i].position] / 32767.0f * channels[i].sound->volume();
-				if (left)
-					value += sampleLinear(channels[i].sound->left, channels[i].position) * channels[i].volume * channels[i].volume;
-				else
-					value += sampleLinear(channels[i].sound->right, channels[i].position) * channels[i].volume * channels[i].volume;
-				value = kinc_max(kinc_min(value, 1.0f), -1.0f);
-				if (!left) channels[i].position += channels[i].pitch / channels[i].sound->sample_rate_pos;
-				// channels[i].position += 2;
-				if (channels[i].position + 1 >= channels[i].sound->size) {
-					if (channels[i].loop) {
-						channels[i].position = 0;
-					}
-					else {
-						channels[i].sound = NULL;
-					}
+			else {
+				for (int f = 0; f < count; ++f) {
+					out[f * 2 + side] += rendered[f] * gain;
 				}
 			}
 		}
-		for (int i = 0; i < CHANNEL_COUNT; ++i) {
-			if (streams[i].stream != NULL) {
-				value += kinc_a1_sound_stream_next_sample(streams[i].stream) * kinc_a1_sound_stream_volume(streams[i].stream);
-				value = kinc_max(kinc_min(value, 1.0f), -1.0f);
-				if (kinc_a1_sound_stream_ended(streams[i].stream)) streams[i].stream = NULL;
+
+		channel->position += count * step;
+		if (channel->position >= end) {
+			if (channel->loop) {
+				channel->position -= sound->size;
+			}
+			else {
+				return false;
 			}
 		}
+		out += count * 2;
+		frames -= count;
+	}
+	return true;
+}
 
-		for (int i = 0; i < CHANNEL_COUNT; ++i) {
-			if (videos[i].stream != NULL) {
-				value += kinc_internal_video_sound_stream_next_sample(videos[i].stream);
-				value = kinc_max(kinc_min(value, 1.0f), -1.0f);
-				if (kinc_internal_video_sound_stream_ended(videos[i].stream)) {
-					videos[i].stream = NULL;
-				}
+void kinc_internal_a1_mix(kinc_a2_block_t *block, void *userdata) {
+	KINC_PROFILER_BEGIN("Audio1 mix");
+	float *out = block->data[0];
+	int samples = block->frames * 2;
+	for (int i = 0; i < samples; ++i) {
+		out[i] = 0.0f;
+	}
+
+	kinc_mutex_lock(&mutex);
+	for (int i = 0; i < CHANNEL_COUNT; ++i) {
+		if (channels[i].sound != NULL) {
+			if (!mix_channel(&channels[i], out, block->frames)) {
+				channels[i].sound = NULL;
 			}
 		}
+	}
 
-		kinc_mutex_unlock(&mutex);
-#endif
-		*(float *)&buffer->data[buffer->write_location] = value;
-		buffer->write_location += 4;
-		if (buffer->write_location >= buffer->data_size) buffer->write_location = 0;
+	for (int i = 0; i < samples; ++i) {
+		float value = out[i];
+		for (int s = 0; s < CHANNEL_COUNT; ++s) {
+			if (streams[s].stream != NULL) {
+				value += kinc_a1_sound_stream_next_sample(streams[s].stream) * kinc_a1_sound_stream_volume(streams[s].stream);
+				if (kinc_a1_sound_stream_ended(streams[s].stream)) streams[s].stream = NULL;
+			}
+		}
+		for (int v = 0; v < CHANNEL_COUNT; ++v) {
+			if (videos[v].stream != NULL) {
+				value += kinc_internal_video_sound_stream_next_sample(videos[v].stream);
+				if (kinc_internal_video_sound_stream_ended(videos[v].stream)) {
+					videos[v].stream = NULL;
+				}
+			}
+		}
+		out[i] = kinc_max(kinc_min(value, 1.0f), -1.0f);
 	}
+	kinc_mutex_unlock(&mutex);
+	KINC_PROFILER_END();
+}
+
+void kinc_a1_set_interpolation(kinc_a1_interpolation_t quality) {
+	kinc_mutex_lock(&mutex);
+	interpolation = quality;
+	kinc_mutex_unlock(&mutex);
 }
 
 void kinc_a1_init() {
@@ -124,7 +317,9 @@ void kinc_a1_init() {
 		streams[i].position = 0;
 	}
 	kinc_mutex_init(&mutex);
-	kinc_a2_set_callback(kinc_internal_a1_mix);
+	init_sinc_table();
+	kinc_a2_set_block_format(2, kinc_internal_a2_requested_samples_per_second, false);
+	kinc_a2_set_block_callback(kinc_internal_a1_mix, NULL);
 }
 
 kinc_a1_channel_t *kinc_a1_play_sound(kinc_a1_sound_t *sound, bool loop, float pitch, bool unique) {
@@ -145,6 +340,8 @@ kinc_a1_channel_t *kinc_a1_play_sound(kinc_a1_sound_t *sound, bool loop, float p
 				channels[i].loop = loop;
 				channels[i].pitch = pitch;
 				channels[i].volume = 1.0f;
+				channels[i].cache[0].block = -1;
+				channels[i].cache[1].block = -1;
 				channel = &channels[i];
 				break;
 			}
@@ -18,12 +18,23 @@ extern "C" {
 
 struct kinc_internal_video_sound_stream;
 
+typedef enum kinc_a1_interpolation {
+	// two samples per output-sample, the cheapest option
+	KINC_A1_INTERPOLATION_LINEAR,
+	// 4-point cubic Hermite, removes most of the high-frequency noise of linear interpolation
+	KINC_A1_INTERPOLATION_HERMITE,
+	// 8-point windowed sinc, the best quality for strongly pitched sounds
+	KINC_A1_INTERPOLATION_SINC
+} kinc_a1_interpolation_t;
+
 typedef struct kinc_a1_channel {
 	kinc_a1_sound_t *sound;
 	float position;
 	bool loop;
 	float volume;
 	float pitch;
+	// the two most recently decoded blocks of ADPCM-compressed sounds
+	kinc_a1_sound_cache_t cache[2];
 } kinc_a1_channel_t;
 
 typedef struct kinc_a1_stream_channel {
@@ -69,9 +80,15 @@ KINC_FUNC void kinc_a1_play_sound_stream(kinc_a1_sound_stream_t *stream);
 /// <param name="stream">The stream to stop.</param>
 KINC_FUNC void kinc_a1_stop_sound_stream(kinc_a1_sound_stream_t *stream);
 
+/// <summary>
+/// Sets how sounds are resampled when they are pitched or do not match the output's sample-rate. Linear interpolation is used by default.
+/// </summary>
+/// <param name="quality">The interpolation to use for all sounds</param>
+KINC_FUNC void kinc_a1_set_interpolation(kinc_a1_interpolation_t quality);
+
 void kinc_internal_play_video_sound_stream(struct kinc_internal_video_sound_stream *stream);
 void kinc_internal_stop_video_sound_stream(struct kinc_internal_video_sound_stream *stream);
-void kinc_internal_a1_mix(kinc_a2_buffer_t *buffer, int samples);
+void kinc_internal_a1_mix(kinc_a2_block_t *block, void *userdata);
 
 #ifdef __cplusplus
 }
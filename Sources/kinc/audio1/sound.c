@@ -6,8 +6,10 @@
 #include <kinc/audio2/audio.h>
 #include <kinc/error.h>
 #include <kinc/io/filereader.h>
+#include <kinc/memory.h>
 
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 
 struct WaveData {
@@ -50,7 +52,7 @@ static void readChunk(uint8_t **data, struct WaveData *wave) {
 	}
 	else if (strcmp(fourcc, "data") == 0) {
 		wave->dataSize = chunksize;
-		wave->data = (uint8_t *)malloc(chunksize * sizeof(uint8_t));
+		wave->data = (uint8_t *)kinc_memory_allocate(chunksize * sizeof(uint8_t), KINC_MEMORY_TAG_AUDIO);
 		kinc_affirm(wave->data != NULL);
 		memcpy(wave->data, *data, chunksize);
 		*data += chunksize;
@@ -78,47 +80,184 @@ static void splitStereo16(int16_t *data, int size, int16_t *left, int16_t *right
 	}
 }
 
-static void splitMono8(uint8_t *data, int size, int16_t *left, int16_t *right) {
+static void convertMono8(uint8_t *data, int size, int16_t *samples) {
 	for (int i = 0; i < size; ++i) {
-		left[i] = convert8to16(data[i]);
-		right[i] = convert8to16(data[i]);
+		samples[i] = convert8to16(data[i]);
 	}
 }
 
-static void splitMono16(int16_t *data, int size, int16_t *left, int16_t *right) {
-	for (int i = 0; i < size; ++i) {
-		left[i] = data[i];
-		right[i] = data[i];
+// every block starts with the predictor and step-index before its first sample, followed by two samples per byte (low nibble first)
+#define ADPCM_BLOCK_BYTES (4 + KINC_A1_ADPCM_BLOCK_SAMPLES / 2)
+
+static const int adpcm_index_table[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+static const int adpcm_step_table[89] = {7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+                                         31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+                                         130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+                                         544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+                                         2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+                                         9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static int16_t adpcm_decode(uint8_t nibble, int *predictor, int *index) {
+	int step = adpcm_step_table[*index];
+	int delta = step >> 3;
+	if (nibble & 4) delta += step;
+	if (nibble & 2) delta += step >> 1;
+	if (nibble & 1) delta += step >> 2;
+	*predictor += (nibble & 8) ? -delta : delta;
+	if (*predictor > 32767) *predictor = 32767;
+	if (*predictor < -32768) *predictor = -32768;
+	*index += adpcm_index_table[nibble];
+	if (*index < 0) *index = 0;
+	if (*index > 88) *index = 88;
+	return (int16_t)*predictor;
+}
+
+static uint8_t adpcm_encode(int16_t sample, int *predictor, int *index) {
+	int step = adpcm_step_table[*index];
+	int difference = sample - *predictor;
+	uint8_t nibble = 0;
+	if (difference < 0) {
+		nibble = 8;
+		difference = -difference;
+	}
+	if (difference >= step) {
+		nibble |= 4;
+		difference -= step;
+	}
+	step >>= 1;
+	if (difference >= step) {
+		nibble |= 2;
+		difference -= step;
+	}
+	step >>= 1;
+	if (difference >= step) {
+		nibble |= 1;
+	}
+	// keeps the encoder's state identical to the decoder's
+	adpcm_decode(nibble, predictor, index);
+	return nibble;
+}
+
+static void encode_adpcm(int16_t *samples, int size, int block_count, uint8_t *blocks, int stride) {
+	int predictor = 0;
+	int index = 0;
+	for (int b = 0; b < block_count; ++b) {
+		uint8_t *block = &blocks[b * stride];
+		block[0] = (uint8_t)(predictor & 0xff);
+		block[1] = (uint8_t)((predictor >> 8) & 0xff);
+		block[2] = (uint8_t)index;
+		block[3] = 0;
+		for (int i = 0; i < KINC_A1_ADPCM_BLOCK_SAMPLES; i += 2) {
+			int position = b * KINC_A1_ADPCM_BLOCK_SAMPLES + i;
+			uint8_t low = adpcm_encode(position < size ? samples[position] : 0, &predictor, &index);
+			uint8_t high = adpcm_encode(position + 1 < size ? samples[position + 1] : 0, &predictor, &index);
+			block[4 + i / 2] = low | (high << 4);
+		}
+	}
+}
+
+static void decode_adpcm(uint8_t *block, int16_t *samples, int count) {
+	int predictor = kinc_read_s16le(block);
+	int index = block[2];
+	for (int i = 0; i < count; ++i) {
+		uint8_t byte = block[4 + i / 2];
+		samples[i] = adpcm_decode((i & 1) ? (byte >> 4) : (byte & 0xf), &predictor, &index);
+	}
+}
+
+void kinc_internal_a1_sound_decode_block(kinc_a1_sound_t *sound, int block, kinc_a1_sound_cache_t *cache) {
+	int channels = sound->format.channels == 1 ? 1 : 2;
+	int block_count = (sound->size + KINC_A1_ADPCM_BLOCK_SAMPLES - 1) / KINC_A1_ADPCM_BLOCK_SAMPLES;
+	for (int c = 0; c < channels; ++c) {
+		int16_t *samples = cache->samples[c];
+		decode_adpcm(&sound->compressed[(block * channels + c) * ADPCM_BLOCK_BYTES], samples, KINC_A1_ADPCM_BLOCK_SAMPLES);
+		if (block + 1 < block_count) {
+			decode_adpcm(&sound->compressed[((block + 1) * channels + c) * ADPCM_BLOCK_BYTES], &samples[KINC_A1_ADPCM_BLOCK_SAMPLES], 1);
+		}
+		else {
+			samples[KINC_A1_ADPCM_BLOCK_SAMPLES] = samples[KINC_A1_ADPCM_BLOCK_SAMPLES - 1];
+		}
+	}
+	cache->block = block;
+}
+
+static void compress(kinc_a1_sound_t *sound) {
+	int channels = sound->format.channels == 1 ? 1 : 2;
+	int block_count = (sound->size + KINC_A1_ADPCM_BLOCK_SAMPLES - 1) / KINC_A1_ADPCM_BLOCK_SAMPLES;
+	sound->compressed = (uint8_t *)kinc_memory_allocate(block_count * channels * ADPCM_BLOCK_BYTES, KINC_MEMORY_TAG_AUDIO);
+	kinc_affirm(sound->compressed != NULL);
+	encode_adpcm(sound->left, sound->size, block_count, sound->compressed, channels * ADPCM_BLOCK_BYTES);
+	if (channels == 2) {
+		encode_adpcm(sound->right, sound->size, block_count, sound->compressed + ADPCM_BLOCK_BYTES, channels * ADPCM_BLOCK_BYTES);
+		kinc_memory_free(sound->right);
 	}
+	kinc_memory_free(sound->left);
+	sound->left = NULL;
+	sound->right = NULL;
 }
 
 #define MAXIMUM_SOUNDS 4096
-static kinc_a1_sound_t sounds[MAXIMUM_SOUNDS] = {0};
+#define SOUNDS_PER_PAGE 64
+// pages are allocated when they are needed and freed when all of their sounds are destroyed
+static kinc_a1_sound_t *sound_pages[MAXIMUM_SOUNDS / SOUNDS_PER_PAGE] = {0};
 
 static kinc_a1_sound_t *find_sound() {
-	for (int i = 0; i < MAXIMUM_SOUNDS; ++i) {
-		if (!sounds[i].in_use) {
-			return &sounds[i];
+	for (int page = 0; page < MAXIMUM_SOUNDS / SOUNDS_PER_PAGE; ++page) {
+		if (sound_pages[page] == NULL) {
+			sound_pages[page] = (kinc_a1_sound_t *)kinc_memory_allocate_zeroed(SOUNDS_PER_PAGE * sizeof(kinc_a1_sound_t), KINC_MEMORY_TAG_AUDIO);
+			if (sound_pages[page] == NULL) {
+				return NULL;
+			}
+		}
+		for (int i = 0; i < SOUNDS_PER_PAGE; ++i) {
+			if (!sound_pages[page][i].in_use) {
+				return &sound_pages[page][i];
+			}
 		}
 	}
 	return NULL;
 }
 
+static void release_sound(kinc_a1_sound_t *sound) {
+	sound->in_use = false;
+	for (int page = 0; page < MAXIMUM_SOUNDS / SOUNDS_PER_PAGE; ++page) {
+		if (sound_pages[page] != NULL && sound >= sound_pages[page] && sound < sound_pages[page] + SOUNDS_PER_PAGE) {
+			for (int i = 0; i < SOUNDS_PER_PAGE; ++i) {
+				if (sound_pages[page][i].in_use) {
+					return;
+				}
+			}
+			kinc_memory_free(sound_pages[page]);
+			sound_pages[page] = NULL;
+			return;
+		}
+	}
+}
+
 kinc_a1_sound_t *kinc_a1_sound_create(const char *filename) {
+	return kinc_a1_sound_create_with_storage(filename, KINC_A1_SOUND_STORAGE_PCM);
+}
+
+kinc_a1_sound_t *kinc_a1_sound_create_with_storage(const char *filename, kinc_a1_sound_storage_t storage) {
 	kinc_a1_sound_t *sound = find_sound();
 	assert(sound != NULL);
 	sound->in_use = true;
 	sound->my_volume = 1;
 	sound->size = 0;
+	sound->storage = storage;
 	sound->left = NULL;
 	sound->right = NULL;
+	sound->compressed = NULL;
 	size_t filenameLength = strlen(filename);
 	uint8_t *data = NULL;
+	// stb_vorbis allocates with malloc
+	bool vorbis_data = false;
 
 	if (strncmp(&filename[filenameLength - 4], ".ogg", 4) == 0) {
 		kinc_file_reader_t file;
 		kinc_file_reader_open(&file, filename, KINC_FILE_TYPE_ASSET);
-		uint8_t *filedata = (uint8_t *)malloc(kinc_file_reader_size(&file));
+		uint8_t *filedata = (uint8_t *)kinc_memory_allocate(kinc_file_reader_size(&file), KINC_MEMORY_TAG_AUDIO);
 		kinc_file_reader_read(&file, filedata, kinc_file_reader_size(&file));
 		kinc_file_reader_close(&file);
 
@@ -126,14 +265,15 @@ kinc_a1_sound_t *kinc_a1_sound_create(const char *filename) {
 		    stb_vorbis_decode_memory(filedata, (int)kinc_file_reader_size(&file), &sound->format.channels, &sound->format.samples_per_second, (short **)&data);
 		sound->size = samples * 2 * sound->format.channels;
 		sound->format.bits_per_sample = 16;
-		free(filedata);
+		kinc_memory_free(filedata);
+		vorbis_data = true;
 	}
 	else if (strncmp(&filename[filenameLength - 4], ".wav", 4) == 0) {
 		struct WaveData wave = {0};
 		{
 			kinc_file_reader_t file;
 			kinc_file_reader_open(&file, filename, KINC_FILE_TYPE_ASSET);
-			uint8_t *filedata = (uint8_t *)malloc(kinc_file_reader_size(&file));
+			uint8_t *filedata = (uint8_t *)kinc_memory_allocate(kinc_file_reader_size(&file), KINC_MEMORY_TAG_AUDIO);
 			kinc_file_reader_read(&file, filedata, kinc_file_reader_size(&file));
 			kinc_file_reader_close(&file);
 			uint8_t *data = filedata;
@@ -146,7 +286,7 @@ kinc_a1_sound_t *kinc_a1_sound_create(const char *filename) {
 				readChunk(&data, &wave);
 			}
 
-			free(filedata);
+			kinc_memory_free(filedata);
 		}
 
 		sound->format.bits_per_sample = wave.bitsPerSample;
@@ -160,33 +300,33 @@ kinc_a1_sound_t *kinc_a1_sound_create(const char *filename) {
 	}
 
 	if (sound->format.channels == 1) {
+		// both channels share the samples
 		if (sound->format.bits_per_sample == 8) {
-			sound->left = (int16_t *)malloc(sound->size * sizeof(int16_t));
-			sound->right = (int16_t *)malloc(sound->size * sizeof(int16_t));
-			splitMono8(data, sound->size, sound->left, sound->right);
+			sound->left = (int16_t *)kinc_memory_allocate(sound->size * sizeof(int16_t), KINC_MEMORY_TAG_AUDIO);
+			convertMono8(data, sound->size, sound->left);
 		}
 		else if (sound->format.bits_per_sample == 16) {
 			sound->size /= 2;
-			sound->left = (int16_t *)malloc(sound->size * sizeof(int16_t));
-			sound->right = (int16_t *)malloc(sound->size * sizeof(int16_t));
-			splitMono16((int16_t *)data, sound->size, sound->left, sound->right);
+			sound->left = (int16_t *)kinc_memory_allocate(sound->size * sizeof(int16_t), KINC_MEMORY_TAG_AUDIO);
+			memcpy(sound->left, data, sound->size * sizeof(int16_t));
 		}
 		else {
 			kinc_affirm(false);
 		}
+		sound->right = sound->left;
 	}
 	else {
 		// Left and right channel are in s16 audio stream, alternating.
 		if (sound->format.bits_per_sample == 8) {
 			sound->size /= 2;
-			sound->left = (int16_t *)malloc(sound->size * sizeof(int16_t));
-			sound->right = (int16_t *)malloc(sound->size * sizeof(int16_t));
+			sound->left = (int16_t *)kinc_memory_allocate(sound->size * sizeof(int16_t), KINC_MEMORY_TAG_AUDIO);
+			sound->right = (int16_t *)kinc_memory_allocate(sound->size * sizeof(int16_t), KINC_MEMORY_TAG_AUDIO);
 			splitStereo8(data, sound->size, sound->left, sound->right);
 		}
 		else if (sound->format.bits_per_sample == 16) {
 			sound->size /= 4;
-			sound->left = (int16_t *)malloc(sound->size * sizeof(int16_t));
-			sound->right = (int16_t *)malloc(sound->size * sizeof(int16_t));
+			sound->left = (int16_t *)kinc_memory_allocate(sound->size * sizeof(int16_t), KINC_MEMORY_TAG_AUDIO);
+			sound->right = (int16_t *)kinc_memory_allocate(sound->size * sizeof(int16_t), KINC_MEMORY_TAG_AUDIO);
 			splitStereo16((int16_t *)data, sound->size, sound->left, sound->right);
 		}
 		else {
@@ -194,17 +334,39 @@ kinc_a1_sound_t *kinc_a1_sound_create(const char *filename) {
 		}
 	}
 	sound->sample_rate_pos = 44100 / (float)sound->format.samples_per_second;
-	free(data);
+	if (vorbis_data) {
+		free(data);
+	}
+	else {
+		kinc_memory_free(data);
+	}
+
+	if (storage == KINC_A1_SOUND_STORAGE_ADPCM) {
+		compress(sound);
+	}
 
 	return sound;
 }
 
 void kinc_a1_sound_destroy(kinc_a1_sound_t *sound) {
-	free(sound->left);
-	free(sound->right);
+	if (sound->right != sound->left) {
+		kinc_memory_free(sound->right);
+	}
+	kinc_memory_free(sound->left);
+	kinc_memory_free(sound->compressed);
 	sound->left = NULL;
 	sound->right = NULL;
-	sound->in_use = false;
+	sound->compressed = NULL;
+	release_sound(sound);
+}
+
+size_t kinc_a1_sound_memory(kinc_a1_sound_t *sound) {
+	int channels = sound->format.channels == 1 ? 1 : 2;
+	if (sound->storage == KINC_A1_SOUND_STORAGE_ADPCM) {
+		int block_count = (sound->size + KINC_A1_ADPCM_BLOCK_SAMPLES - 1) / KINC_A1_ADPCM_BLOCK_SAMPLES;
+		return (size_t)block_count * channels * ADPCM_BLOCK_BYTES;
+	}
+	return (size_t)sound->size * channels * sizeof(int16_t);
 }
 
 float kinc_a1_sound_volume(kinc_a1_sound_t *sound) {
@@ -4,20 +4,43 @@
 
 #include <kinc/audio2/audio.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 /*! \file sound.h
-    \brief Sounds are pre-decoded on load and therefore primarily useful for playing sound-effects.
+    \brief Sounds are pre-decoded on load and therefore primarily useful for playing sound-effects. To save memory they can optionally be kept as
+   IMA-ADPCM which is decoded block by block while playing.
 */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/// <summary>
+/// Samples per channel in one block of an ADPCM-compressed sound
+/// </summary>
+#define KINC_A1_ADPCM_BLOCK_SAMPLES 1024
+
+typedef enum kinc_a1_sound_storage {
+	// 16 bit samples
+	KINC_A1_SOUND_STORAGE_PCM,
+	// 4 bit IMA-ADPCM, a quarter of the size of PCM at a slightly reduced quality
+	KINC_A1_SOUND_STORAGE_ADPCM
+} kinc_a1_sound_storage_t;
+
+// holds the decoded block of an ADPCM-compressed sound, plus the first sample of the following block
+typedef struct kinc_a1_sound_cache {
+	int block;
+	int16_t samples[2][KINC_A1_ADPCM_BLOCK_SAMPLES + 1];
+} kinc_a1_sound_cache_t;
+
 typedef struct kinc_a1_sound {
 	kinc_a2_buffer_format_t format;
+	kinc_a1_sound_storage_t storage;
+	// for mono sounds both point to the same samples, NULL when ADPCM is used
 	int16_t *left;
 	int16_t *right;
+	uint8_t *compressed;
 	int size;
 	float sample_rate_pos;
 	float my_volume;
@@ -31,6 +54,21 @@ typedef struct kinc_a1_sound {
 /// <returns>The newly created sound</returns>
 KINC_FUNC kinc_a1_sound_t *kinc_a1_sound_create(const char *filename);
 
+/// <summary>
+/// Create a sound from a wav or ogg file and chooses how its samples are stored in memory.
+/// </summary>
+/// <param name="filename">Path to a wav or ogg file</param>
+/// <param name="storage">How the samples are stored</param>
+/// <returns>The newly created sound</returns>
+KINC_FUNC kinc_a1_sound_t *kinc_a1_sound_create_with_storage(const char *filename, kinc_a1_sound_storage_t storage);
+
+/// <summary>
+/// Returns the number of bytes which are used for the sound's samples.
+/// </summary>
+/// <param name="sound">The sound to query</param>
+/// <returns>The number of bytes</returns>
+KINC_FUNC size_t kinc_a1_sound_memory(kinc_a1_sound_t *sound);
+
 /// <summary>
 /// Destroy a sound.
 /// </summary>
@@ -51,6 +89,8 @@ KINC_FUNC float kinc_a1_sound_volume(kinc_a1_sound_t *sound);
 /// <param name="value">The volume-multiplicator to set</param>
 KINC_FUNC void kinc_a1_sound_set_volume(kinc_a1_sound_t *sound, float value);
 
+void kinc_internal_a1_sound_decode_block(kinc_a1_sound_t *sound, int block, kinc_a1_sound_cache_t *cache);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,18 +4,12 @@
 #include "stb_vorbis.c"
 
 #include <kinc/io/filereader.h>
+#include <kinc/memory.h>
 
-#include <stdlib.h>
 #include <string.h>
 
 static kinc_a1_sound_stream_t streams[256];
 static int nextStream = 0;
-static uint8_t *buffer;
-static int bufferIndex;
-
-void initSoundStreams() {
-	buffer = (uint8_t *)malloc(1024 * 10);
-}
 
 kinc_a1_sound_stream_t *kinc_a1_sound_stream_create(const char *filename, bool looping) {
 	kinc_a1_sound_stream_t *stream = &streams[nextStream];
@@ -26,14 +20,11 @@ kinc_a1_sound_stream_t *kinc_a1_sound_stream_create(const char *filename, bool l
 	stream->end = false;
 	kinc_file_reader_t file;
 	kinc_file_reader_open(&file, filename, KINC_FILE_TYPE_ASSET);
-	stream->buffer = &buffer[bufferIndex];
-	bufferIndex += (int)kinc_file_reader_size(&file);
-	uint8_t *filecontent = (uint8_t *)malloc(kinc_file_reader_size(&file));
-	kinc_file_reader_read(&file, filecontent, kinc_file_reader_size(&file));
+	size_t size = kinc_file_reader_size(&file);
+	stream->buffer = (uint8_t *)kinc_memory_allocate(size, KINC_MEMORY_TAG_AUDIO);
+	kinc_file_reader_read(&file, stream->buffer, size);
 	kinc_file_reader_close(&file);
-	memcpy(stream->buffer, filecontent, kinc_file_reader_size(&file));
-	free(filecontent);
-	stream->vorbis = stb_vorbis_open_memory(buffer, (int)kinc_file_reader_size(&file), NULL, NULL);
+	stream->vorbis = stb_vorbis_open_memory(stream->buffer, (int)size, NULL, NULL);
 	if (stream->vorbis != NULL) {
 		stb_vorbis_info info = stb_vorbis_get_info(stream->vorbis);
 		stream->chans = info.channels;
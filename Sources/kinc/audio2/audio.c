@@ -1,3 +1,237 @@
 #include "audio.h"
 
+#include <kinc/threads/atomic.h>
+
+#include <stddef.h>
+#include <string.h>
+
 int kinc_a2_samples_per_second = 44100;
+
+int kinc_internal_a2_requested_channels = 2;
+int kinc_internal_a2_requested_samples_per_second = 0;
+
+enum { SPEAKER_FL, SPEAKER_FR, SPEAKER_FC, SPEAKER_LFE, SPEAKER_BL, SPEAKER_BR, SPEAKER_BC, SPEAKER_SL, SPEAKER_SR };
+
+// the speakers of the channel-layouts by channel-count, ordered like in WAVE-files
+static const int layouts[KINC_A2_MAX_CHANNELS][KINC_A2_MAX_CHANNELS] = {
+    {SPEAKER_FC},
+    {SPEAKER_FL, SPEAKER_FR},
+    {SPEAKER_FL, SPEAKER_FR, SPEAKER_FC},
+    {SPEAKER_FL, SPEAKER_FR, SPEAKER_BL, SPEAKER_BR},
+    {SPEAKER_FL, SPEAKER_FR, SPEAKER_FC, SPEAKER_BL, SPEAKER_BR},
+    {SPEAKER_FL, SPEAKER_FR, SPEAKER_FC, SPEAKER_LFE, SPEAKER_BL, SPEAKER_BR},
+    {SPEAKER_FL, SPEAKER_FR, SPEAKER_FC, SPEAKER_LFE, SPEAKER_BC, SPEAKER_SL, SPEAKER_SR},
+    {SPEAKER_FL, SPEAKER_FR, SPEAKER_FC, SPEAKER_LFE, SPEAKER_BL, SPEAKER_BR, SPEAKER_SL, SPEAKER_SR},
+};
+
+// frames which are converted at once when the blocks do not match the system's format
+#define SCRATCH_FRAMES 512
+
+static void (*block_callback)(kinc_a2_block_t *block, void *userdata) = NULL;
+static void *block_userdata = NULL;
+static int block_channels = 2;
+static bool block_planar = false;
+
+static int device_channels = 2;
+static int matrix_channels = 0;
+static float matrix[KINC_A2_MAX_CHANNELS][KINC_A2_MAX_CHANNELS];
+static float scratch[SCRATCH_FRAMES * KINC_A2_MAX_CHANNELS];
+
+// keeps the callback and its userdata consistent while they are replaced, the audio-thread only holds it to copy them
+#ifdef KORE_HTML5
+static void lock_callback(void) {}
+static void unlock_callback(void) {}
+#else
+static volatile int32_t callback_lock = 0;
+
+static void lock_callback(void) {
+	while (!KINC_ATOMIC_COMPARE_EXCHANGE(&callback_lock, 0, 1)) {
+	}
+}
+
+static void unlock_callback(void) {
+	KINC_ATOMIC_COMPARE_EXCHANGE(&callback_lock, 1, 0);
+}
+#endif
+
+static int find_speaker(int channels, int speaker) {
+	for (int i = 0; i < channels; ++i) {
+		if (layouts[channels - 1][i] == speaker) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// adds a source-channel to the closest speakers which exist in the output-layout
+static void route(int channels, int speaker, int source, float gain) {
+	const float half_power = 0.70710678f;
+	int index = find_speaker(channels, speaker);
+	if (index >= 0) {
+		matrix[index][source] += gain;
+		return;
+	}
+	switch (speaker) {
+	case SPEAKER_FL:
+	case SPEAKER_FR:
+		// only a mono-output has no front-speakers
+		route(channels, SPEAKER_FC, source, gain * half_power);
+		break;
+	case SPEAKER_FC:
+		route(channels, SPEAKER_FL, source, gain * half_power);
+		route(channels, SPEAKER_FR, source, gain * half_power);
+		break;
+	case SPEAKER_LFE:
+		break;
+	case SPEAKER_BL:
+	case SPEAKER_SL: {
+		int other = find_speaker(channels, speaker == SPEAKER_BL ? SPEAKER_SL : SPEAKER_BL);
+		if (other >= 0) {
+			matrix[other][source] += gain;
+		}
+		else {
+			route(channels, SPEAKER_FL, source, gain * half_power);
+		}
+		break;
+	}
+	case SPEAKER_BR:
+	case SPEAKER_SR: {
+		int other = find_speaker(channels, speaker == SPEAKER_BR ? SPEAKER_SR : SPEAKER_BR);
+		if (other >= 0) {
+			matrix[other][source] += gain;
+		}
+		else {
+			route(channels, SPEAKER_FR, source, gain * half_power);
+		}
+		break;
+	}
+	case SPEAKER_BC:
+		route(channels, SPEAKER_BL, source, gain * half_power);
+		route(channels, SPEAKER_BR, source, gain * half_power);
+		break;
+	}
+}
+
+static void update_matrix(int channels) {
+	for (int o = 0; o < KINC_A2_MAX_CHANNELS; ++o) {
+		for (int i = 0; i < KINC_A2_MAX_CHANNELS; ++i) {
+			matrix[o][i] = 0.0f;
+		}
+	}
+	for (int i = 0; i < block_channels; ++i) {
+		route(channels, layouts[block_channels - 1][i], i, 1.0f);
+	}
+	matrix_channels = channels;
+}
+
+void kinc_internal_a2_render_interleaved(float *samples, int frames, int channels) {
+	lock_callback();
+	void (*callback)(kinc_a2_block_t *block, void *userdata) = block_callback;
+	void *userdata = block_userdata;
+	unlock_callback();
+	if (callback == NULL) {
+		// the block-callback was just replaced by a regular callback
+		memset(samples, 0, frames * channels * sizeof(float));
+		return;
+	}
+
+	kinc_a2_block_t block;
+	block.channels = block_channels;
+	block.samples_per_second = kinc_a2_samples_per_second;
+	block.planar = block_planar;
+
+	if (!block_planar && block_channels == channels) {
+		block.data[0] = samples;
+		block.frames = frames;
+		callback(&block, userdata);
+		return;
+	}
+
+	if (matrix_channels != channels) {
+		update_matrix(channels);
+	}
+
+	while (frames > 0) {
+		int count = frames < SCRATCH_FRAMES ? frames : SCRATCH_FRAMES;
+		block.frames = count;
+		for (int c = 0; c < block_channels; ++c) {
+			block.data[c] = block_planar ? &scratch[c * count] : scratch;
+		}
+		callback(&block, userdata);
+
+		int frame_stride = block_planar ? 1 : block_channels;
+		for (int f = 0; f < count; ++f) {
+			for (int o = 0; o < channels; ++o) {
+				float value = 0.0f;
+				for (int i = 0; i < block_channels; ++i) {
+					value += matrix[o][i] * block.data[i][f * frame_stride + (block_planar ? 0 : i)];
+				}
+				samples[f * channels + o] = value;
+			}
+		}
+
+		samples += count * channels;
+		frames -= count;
+	}
+}
+
+// the ring-buffers of the systems contain interleaved stereo
+static void ring_callback(kinc_a2_buffer_t *buffer, int samples) {
+	int frames = samples / 2;
+	while (frames > 0) {
+		int contiguous = (buffer->data_size - buffer->write_location) / 8;
+		if (contiguous == 0) {
+			// a frame wraps around the end of the buffer
+			float frame[2];
+			kinc_internal_a2_render_interleaved(frame, 1, 2);
+			for (int i = 0; i < 2; ++i) {
+				*(float *)&buffer->data[buffer->write_location] = frame[i];
+				buffer->write_location += 4;
+				if (buffer->write_location >= buffer->data_size) buffer->write_location = 0;
+			}
+			--frames;
+			continue;
+		}
+		int count = frames < contiguous ? frames : contiguous;
+		kinc_internal_a2_render_interleaved((float *)&buffer->data[buffer->write_location], count, 2);
+		buffer->write_location += count * 8;
+		if (buffer->write_location >= buffer->data_size) buffer->write_location = 0;
+		frames -= count;
+	}
+}
+
+void kinc_a2_set_callback(void (*kinc_a2_audio_callback)(kinc_a2_buffer_t *buffer, int samples)) {
+	// replaces a block-callback, both render into the same ring-buffer
+	kinc_internal_a2_set_callback(kinc_a2_audio_callback);
+	lock_callback();
+	block_callback = NULL;
+	block_userdata = NULL;
+	unlock_callback();
+}
+
+void kinc_a2_set_block_callback(void (*callback)(kinc_a2_block_t *block, void *userdata), void *userdata) {
+	lock_callback();
+	block_userdata = userdata;
+	block_callback = callback;
+	unlock_callback();
+	kinc_internal_a2_set_callback(callback != NULL ? ring_callback : NULL);
+}
+
+void kinc_a2_set_block_format(int channels, int samples_per_second, bool planar) {
+	if (channels < 1) channels = 1;
+	if (channels > KINC_A2_MAX_CHANNELS) channels = KINC_A2_MAX_CHANNELS;
+	block_channels = channels;
+	block_planar = planar;
+	matrix_channels = 0;
+	// the ring-buffers of the systems are stereo, more channels are mixed down by kinc_internal_a2_render_interleaved
+	kinc_internal_a2_requested_channels = channels < 2 ? channels : 2;
+	kinc_internal_a2_requested_samples_per_second = samples_per_second;
+}
+
+int kinc_a2_device_channels(void) {
+	return device_channels;
+}
+
+void kinc_internal_a2_set_device_channels(int channels) {
+	device_channels = channels;
+}
@@ -26,6 +26,26 @@ typedef struct kinc_a2_buffer {
 	int write_location;
 } kinc_a2_buffer_t;
 
+/// <summary>
+/// Maximum number of channels of a block
+/// </summary>
+#define KINC_A2_MAX_CHANNELS 8
+
+/// <summary>
+/// A span of float-samples which a block-callback fills. Channels are ordered like in WAVE-files: 1 is mono, 2 is stereo, 3 is front-left,
+/// front-right, front-center, 4 is front-left, front-right, back-left, back-right, 5 adds front-center to that, 6 is 5.1 (front-left, front-right,
+/// front-center, low-frequency, back-left, back-right), 7 is 6.1 (front-left, front-right, front-center, low-frequency, back-center, side-left,
+/// side-right) and 8 is 7.1 (5.1 plus side-left and side-right).
+/// </summary>
+typedef struct kinc_a2_block {
+	// interleaved: data[0] points to frames * channels samples, planar: data[c] points to the frames samples of channel c
+	float *data[KINC_A2_MAX_CHANNELS];
+	int frames;
+	int channels;
+	int samples_per_second;
+	bool planar;
+} kinc_a2_block_t;
+
 /// <summary>
 /// Initializes the Audio2-API.
 /// </summary>
@@ -38,6 +58,30 @@ KINC_FUNC void kinc_a2_init(void);
 /// <param name="kinc_a2_audio_callback">The callback to set</param>
 KINC_FUNC void kinc_a2_set_callback(void (*kinc_a2_audio_callback)(kinc_a2_buffer_t *buffer, int samples));
 
+/// <summary>
+/// Sets a callback which provides audio in whole blocks of float-samples instead of writing single samples into a ring-buffer. It replaces the callback
+/// which was set using kinc_a2_set_callback. The blocks use the format which was set using kinc_a2_set_block_format and are converted to the
+/// system's channel-layout when necessary. The callback is called from the system's audio-thread.
+/// </summary>
+/// <param name="callback">The callback to set, it has to completely fill the block</param>
+/// <param name="userdata">Passed on to the callback</param>
+KINC_FUNC void kinc_a2_set_block_callback(void (*callback)(kinc_a2_block_t *block, void *userdata), void *userdata);
+
+/// <summary>
+/// Sets the format of the blocks which are passed to the block-callback. The sample-rate and a mono- or stereo-output are also requested from the
+/// system when called before kinc_a2_init, systems which can not provide the sample-rate report their actual one in the blocks and in
+/// kinc_a2_samples_per_second. The output of the systems is at most stereo, blocks with more channels are mixed down.
+/// </summary>
+/// <param name="channels">1 to KINC_A2_MAX_CHANNELS, 2 by default</param>
+/// <param name="samples_per_second">The preferred sample-rate or 0 to use the system's default</param>
+/// <param name="planar">Whether every channel gets its own span, false by default</param>
+KINC_FUNC void kinc_a2_set_block_format(int channels, int samples_per_second, bool planar);
+
+/// <summary>
+/// Returns the number of channels of the system's output, which can differ from the number of channels of the blocks.
+/// </summary>
+KINC_FUNC int kinc_a2_device_channels(void);
+
 /// <summary>
 /// Sets a callback that's called when the system's sample-rate changes.
 /// </summary>
@@ -60,6 +104,13 @@ KINC_FUNC void kinc_a2_update(void);
 /// </summary>
 KINC_FUNC void kinc_a2_shutdown(void);
 
+KINC_FUNC extern int kinc_internal_a2_requested_channels;
+KINC_FUNC extern int kinc_internal_a2_requested_samples_per_second;
+
+void kinc_internal_a2_set_callback(void (*kinc_a2_audio_callback)(kinc_a2_buffer_t *buffer, int samples));
+void kinc_internal_a2_set_device_channels(int channels);
+void kinc_internal_a2_render_interleaved(float *samples, int frames, int channels);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,752 @@
+#include "bvh.h"
+
+#include <kinc/memory.h>
+#include <kinc/simd/float32x4.h>
+#include <kinc/threads/atomic.h>
+#include <kinc/threads/parallel.h>
+
+#ifdef KORE_G5
+#include <kinc/graphics5/indexbuffer.h>
+#include <kinc/graphics5/vertexbuffer.h>
+#endif
+
+#include <float.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BIN_COUNT 16
+// leaves which are this small are never split
+#define MIN_LEAF_SIZE 2
+// leaves which are larger are always split, even if the heuristic disagrees
+#define MAX_LEAF_SIZE 16
+// deeper nodes are split at the median which bounds the depth of the tree and therefore the size of the traversal-stacks
+#define MAX_SAH_DEPTH 40
+#define STACK_SIZE 96
+// nodes with fewer triangles are not worth handing to another thread
+#define MIN_TASK_SIZE 4096
+
+typedef struct reference {
+	float min[3];
+	float max[3];
+	int triangle;
+} reference_t;
+
+typedef struct task {
+	int node;
+	int start;
+	int end;
+	int depth;
+} task_t;
+
+typedef struct builder {
+	kinc_bvh_t *bvh;
+	const float *positions;
+	int position_stride;
+	const int *indices;
+	reference_t *references;
+	volatile int32_t node_count;
+	task_t *tasks;
+} builder_t;
+
+static const float *get_position(const float *positions, int position_stride, int vertex) {
+	return (const float *)((const uint8_t *)positions + (size_t)vertex * position_stride);
+}
+
+static float half_area(const float *min, const float *max) {
+	float x = max[0] - min[0];
+	float y = max[1] - min[1];
+	float z = max[2] - min[2];
+	return x * y + y * z + z * x;
+}
+
+static void grow(float *min, float *max, const float *other_min, const float *other_max) {
+	for (int axis = 0; axis < 3; ++axis) {
+		min[axis] = other_min[axis] < min[axis] ? other_min[axis] : min[axis];
+		max[axis] = other_max[axis] > max[axis] ? other_max[axis] : max[axis];
+	}
+}
+
+static void reset_bounds(float *min, float *max) {
+	for (int axis = 0; axis < 3; ++axis) {
+		min[axis] = FLT_MAX;
+		max[axis] = -FLT_MAX;
+	}
+}
+
+static int allocate_node_pair(builder_t *builder) {
+#ifdef KORE_HTML5
+	int32_t first = builder->node_count;
+	builder->node_count += 2;
+	return first;
+#else
+	for (;;) {
+		int32_t first = builder->node_count;
+		if (KINC_ATOMIC_COMPARE_EXCHANGE(&builder->node_count, first, first + 2)) {
+			return first;
+		}
+	}
+#endif
+}
+
+static void init_references(int start, int end, void *data) {
+	builder_t *builder = (builder_t *)data;
+	for (int triangle = start; triangle < end; ++triangle) {
+		reference_t *reference = &builder->references[triangle];
+		reset_bounds(reference->min, reference->max);
+		for (int corner = 0; corner < 3; ++corner) {
+			const float *position = get_position(builder->positions, builder->position_stride, builder->indices[triangle * 3 + corner]);
+			grow(reference->min, reference->max, position, position);
+		}
+		reference->triangle = triangle;
+	}
+}
+
+static float get_centroid(const reference_t *reference, int axis) {
+	return (reference->min[axis] + reference->max[axis]) * 0.5f;
+}
+
+static void select_nth(reference_t *references, int axis, int start, int end, int nth) {
+	while (end - start > 1) {
+		float pivot = get_centroid(&references[(start + end) / 2], axis);
+		int i = start;
+		int j = end - 1;
+		while (i <= j) {
+			while (get_centroid(&references[i], axis) < pivot) {
+				++i;
+			}
+			while (get_centroid(&references[j], axis) > pivot) {
+				--j;
+			}
+			if (i <= j) {
+				reference_t temp = references[i];
+				references[i] = references[j];
+				references[j] = temp;
+				++i;
+				--j;
+			}
+		}
+		if (nth <= j) {
+			end = j + 1;
+		}
+		else if (nth >= i) {
+			start = i;
+		}
+		else {
+			return;
+		}
+	}
+}
+
+typedef struct bin {
+	float min[3];
+	float max[3];
+	int count;
+} bin_t;
+
+static int get_bin(float centroid, float centroid_min, float scale, int bin_count) {
+	int bin = (int)((centroid - centroid_min) * scale);
+	return bin < 0 ? 0 : (bin >= bin_count ? bin_count - 1 : bin);
+}
+
+// Turns a node into a leaf or splits it, writing the two children to left and right.
+static bool split_node(builder_t *builder, const task_t *task, task_t *left, task_t *right) {
+	kinc_bvh_node_t *node = &builder->bvh->nodes[task->node];
+	reference_t *references = builder->references;
+	int count = task->end - task->start;
+
+	// accumulated in locals because writing through node would have to assume it aliases the references
+	float min[3], max[3], centroid_min[3], centroid_max[3];
+	reset_bounds(min, max);
+	reset_bounds(centroid_min, centroid_max);
+	for (int i = task->start; i < task->end; ++i) {
+		grow(min, max, references[i].min, references[i].max);
+		float centroid[3] = {get_centroid(&references[i], 0), get_centroid(&references[i], 1), get_centroid(&references[i], 2)};
+		grow(centroid_min, centroid_max, centroid, centroid);
+	}
+	memcpy(node->min, min, sizeof(min));
+	memcpy(node->max, max, sizeof(max));
+
+	if (count <= MIN_LEAF_SIZE) {
+		node->first = task->start;
+		node->count = count;
+		return false;
+	}
+
+	int middle = -1;
+	if (task->depth < MAX_SAH_DEPTH) {
+		int best_axis = -1;
+		int best_split = 0;
+		float best_cost = FLT_MAX;
+		// small nodes do not need as many candidate-splits as they have triangles
+		int bin_count = count < BIN_COUNT ? count : BIN_COUNT;
+		float scales[3];
+		for (int axis = 0; axis < 3; ++axis) {
+			float extent = centroid_max[axis] - centroid_min[axis];
+			scales[axis] = extent > 0.0f ? bin_count / extent : 0.0f;
+		}
+
+		// all three axes are binned in one pass over the triangles
+		bin_t bins[3][BIN_COUNT];
+		for (int axis = 0; axis < 3; ++axis) {
+			for (int i = 0; i < bin_count; ++i) {
+				reset_bounds(bins[axis][i].min, bins[axis][i].max);
+				bins[axis][i].count = 0;
+			}
+		}
+		for (int i = task->start; i < task->end; ++i) {
+			for (int axis = 0; axis < 3; ++axis) {
+				bin_t *bin = &bins[axis][get_bin(get_centroid(&references[i], axis), centroid_min[axis], scales[axis], bin_count)];
+				grow(bin->min, bin->max, references[i].min, references[i].max);
+				bin->count += 1;
+			}
+		}
+
+		for (int axis = 0; axis < 3; ++axis) {
+			if (scales[axis] == 0.0f) {
+				continue;
+			}
+
+			// sweeping from the right first stores the cost of everything right of each split
+			float right_costs[BIN_COUNT];
+			float sweep_min[3], sweep_max[3];
+			reset_bounds(sweep_min, sweep_max);
+			int right_count = 0;
+			for (int i = bin_count - 1; i > 0; --i) {
+				grow(sweep_min, sweep_max, bins[axis][i].min, bins[axis][i].max);
+				right_count += bins[axis][i].count;
+				right_costs[i] = right_count > 0 ? half_area(sweep_min, sweep_max) * right_count : 0.0f;
+			}
+			reset_bounds(sweep_min, sweep_max);
+			int left_count = 0;
+			for (int i = 0; i < bin_count - 1; ++i) {
+				grow(sweep_min, sweep_max, bins[axis][i].min, bins[axis][i].max);
+				left_count += bins[axis][i].count;
+				if (left_count == 0 || left_count == count) {
+					continue;
+				}
+				float cost = half_area(sweep_min, sweep_max) * left_count + right_costs[i + 1];
+				if (cost < best_cost) {
+					best_cost = cost;
+					best_axis = axis;
+					best_split = i + 1;
+				}
+			}
+		}
+
+		// a traversal-step is assumed to cost as much as one triangle-test
+		float node_area = half_area(node->min, node->max);
+		float leaf_cost = (float)count;
+		float split_cost = node_area > 0.0f ? 1.0f + best_cost / node_area : FLT_MAX;
+		if (count <= MAX_LEAF_SIZE && (best_axis < 0 || leaf_cost <= split_cost)) {
+			node->first = task->start;
+			node->count = count;
+			return false;
+		}
+
+		if (best_axis >= 0) {
+			int i = task->start;
+			int j = task->end - 1;
+			while (i <= j) {
+				if (get_bin(get_centroid(&references[i], best_axis), centroid_min[best_axis], scales[best_axis], bin_count) < best_split) {
+					++i;
+				}
+				else {
+					reference_t temp = references[i];
+					references[i] = references[j];
+					references[j] = temp;
+					--j;
+				}
+			}
+			middle = i;
+		}
+	}
+
+	if (middle <= task->start || middle >= task->end) {
+		// the heuristic found nothing, identical centroids or a very deep node, so split at the median of the largest axis
+		int axis = 0;
+		for (int i = 1; i < 3; ++i) {
+			if (centroid_max[i] - centroid_min[i] > centroid_max[axis] - centroid_min[axis]) {
+				axis = i;
+			}
+		}
+		middle = (task->start + task->end) / 2;
+		select_nth(references, axis, task->start, task->end, middle);
+	}
+
+	int first = allocate_node_pair(builder);
+	node->first = first;
+	node->count = 0;
+	left->node = first;
+	left->start = task->start;
+	left->end = middle;
+	left->depth = task->depth + 1;
+	right->node = first + 1;
+	right->start = middle;
+	right->end = task->end;
+	right->depth = task->depth + 1;
+	return true;
+}
+
+static void build_subtree(builder_t *builder, task_t task) {
+	task_t left, right;
+	while (split_node(builder, &task, &left, &right)) {
+		// recursing into the smaller child keeps the recursion shallow
+		if (left.end - left.start < right.end - right.start) {
+			build_subtree(builder, left);
+			task = right;
+		}
+		else {
+			build_subtree(builder, right);
+			task = left;
+		}
+	}
+}
+
+static void build_tasks(int start, int end, void *data) {
+	builder_t *builder = (builder_t *)data;
+	for (int i = start; i < end; ++i) {
+		build_subtree(builder, builder->tasks[i]);
+	}
+}
+
+static void update_triangles(int start, int end, void *data) {
+	builder_t *builder = (builder_t *)data;
+	kinc_bvh_t *bvh = builder->bvh;
+	for (int triangle = start; triangle < end; ++triangle) {
+		const float *a = get_position(builder->positions, builder->position_stride, bvh->indices[triangle * 3 + 0]);
+		const float *b = get_position(builder->positions, builder->position_stride, bvh->indices[triangle * 3 + 1]);
+		const float *c = get_position(builder->positions, builder->position_stride, bvh->indices[triangle * 3 + 2]);
+		float *data = &bvh->triangles[triangle * 9];
+		for (int axis = 0; axis < 3; ++axis) {
+			data[axis] = a[axis];
+			data[3 + axis] = b[axis] - a[axis];
+			data[6 + axis] = c[axis] - a[axis];
+		}
+	}
+}
+
+void kinc_bvh_init(kinc_bvh_t *bvh, const float *positions, int position_stride, int vertex_count, const int *indices, int index_count) {
+	memset(bvh, 0, sizeof(*bvh));
+	int triangle_count = index_count / 3;
+	bvh->triangle_count = triangle_count;
+	bvh->vertex_count = vertex_count;
+	bvh->nodes = (kinc_bvh_node_t *)kinc_memory_allocate((triangle_count > 0 ? 2 * triangle_count - 1 : 1) * sizeof(kinc_bvh_node_t), KINC_MEMORY_TAG_GENERAL);
+	bvh->triangles = (float *)kinc_memory_allocate((triangle_count > 0 ? triangle_count : 1) * 9 * sizeof(float), KINC_MEMORY_TAG_GENERAL);
+	bvh->indices = (int *)kinc_memory_allocate((triangle_count > 0 ? triangle_count : 1) * 3 * sizeof(int), KINC_MEMORY_TAG_GENERAL);
+	bvh->triangle_ids = (int *)kinc_memory_allocate((triangle_count > 0 ? triangle_count : 1) * sizeof(int), KINC_MEMORY_TAG_GENERAL);
+	if (triangle_count == 0) {
+		return;
+	}
+
+	builder_t builder;
+	builder.bvh = bvh;
+	builder.positions = positions;
+	builder.position_stride = position_stride;
+	builder.indices = indices;
+	builder.references = (reference_t *)kinc_memory_allocate(triangle_count * sizeof(reference_t), KINC_MEMORY_TAG_GENERAL);
+	builder.node_count = 1;
+	kinc_parallel_for(triangle_count, 1024, init_references, &builder);
+
+	// the upper levels are split on this thread until there is enough independent work for all threads
+	int max_tasks = kinc_parallel_thread_count() * 4;
+	builder.tasks = (task_t *)kinc_memory_allocate(max_tasks * sizeof(task_t), KINC_MEMORY_TAG_GENERAL);
+	int task_count = 1;
+	builder.tasks[0].node = 0;
+	builder.tasks[0].start = 0;
+	builder.tasks[0].end = triangle_count;
+	builder.tasks[0].depth = 0;
+	while (max_tasks > 1 && task_count < max_tasks) {
+		int largest = 0;
+		for (int i = 1; i < task_count; ++i) {
+			if (builder.tasks[i].end - builder.tasks[i].start > builder.tasks[largest].end - builder.tasks[largest].start) {
+				largest = i;
+			}
+		}
+		task_t task = builder.tasks[largest];
+		if (task.end - task.start < MIN_TASK_SIZE) {
+			break;
+		}
+		task_t left, right;
+		if (split_node(&builder, &task, &left, &right)) {
+			builder.tasks[largest] = left;
+			builder.tasks[task_count++] = right;
+		}
+		else {
+			builder.tasks[largest] = builder.tasks[--task_count];
+		}
+	}
+	kinc_parallel_for(task_count, 1, build_tasks, &builder);
+	bvh->node_count = builder.node_count;
+
+	for (int i = 0; i < triangle_count; ++i) {
+		int triangle = builder.references[i].triangle;
+		bvh->triangle_ids[i] = triangle;
+		bvh->indices[i * 3 + 0] = indices[triangle * 3 + 0];
+		bvh->indices[i * 3 + 1] = indices[triangle * 3 + 1];
+		bvh->indices[i * 3 + 2] = indices[triangle * 3 + 2];
+	}
+	kinc_parallel_for(triangle_count, 1024, update_triangles, &builder);
+
+	kinc_memory_free(builder.tasks);
+	kinc_memory_free(builder.references);
+}
+
+#ifdef KORE_G5
+void kinc_bvh_init_from_g5_buffers(kinc_bvh_t *bvh, struct kinc_g5_vertex_buffer *vertex_buffer, struct kinc_g5_index_buffer *index_buffer) {
+	float *vertices = kinc_g5_vertex_buffer_lock_all(vertex_buffer);
+	int *indices = kinc_g5_index_buffer_lock(index_buffer);
+	kinc_bvh_init(bvh, vertices, kinc_g5_vertex_buffer_stride(vertex_buffer), kinc_g5_vertex_buffer_count(vertex_buffer), indices,
+	              kinc_g5_index_buffer_count(index_buffer));
+	kinc_g5_index_buffer_unlock(index_buffer);
+	kinc_g5_vertex_buffer_unlock_all(vertex_buffer);
+}
+#endif
+
+void kinc_bvh_destroy(kinc_bvh_t *bvh) {
+	kinc_memory_free(bvh->nodes);
+	kinc_memory_free(bvh->triangles);
+	kinc_memory_free(bvh->indices);
+	kinc_memory_free(bvh->triangle_ids);
+	memset(bvh, 0, sizeof(*bvh));
+}
+
+void kinc_bvh_refit(kinc_bvh_t *bvh, const float *positions, int position_stride) {
+	if (bvh->triangle_count == 0) {
+		return;
+	}
+	builder_t builder;
+	builder.bvh = bvh;
+	builder.positions = positions;
+	builder.position_stride = position_stride;
+	kinc_parallel_for(bvh->triangle_count, 1024, update_triangles, &builder);
+
+	// children are always allocated after their parents so walking backwards visits them first
+	for (int i = bvh->node_count - 1; i >= 0; --i) {
+		kinc_bvh_node_t *node = &bvh->nodes[i];
+		reset_bounds(node->min, node->max);
+		if (node->count > 0) {
+			for (int triangle = node->first; triangle < node->first + node->count; ++triangle) {
+				const float *data = &bvh->triangles[triangle * 9];
+				float b[3] = {data[0] + data[3], data[1] + data[4], data[2] + data[5]};
+				float c[3] = {data[0] + data[6], data[1] + data[7], data[2] + data[8]};
+				grow(node->min, node->max, data, data);
+				grow(node->min, node->max, b, b);
+				grow(node->min, node->max, c, c);
+			}
+		}
+		else {
+			grow(node->min, node->max, bvh->nodes[node->first].min, bvh->nodes[node->first].max);
+			grow(node->min, node->max, bvh->nodes[node->first + 1].min, bvh->nodes[node->first + 1].max);
+		}
+	}
+}
+
+// Rays which are closer to parallel to a triangle than this (the cosine of the angle between the ray and the triangle's normal) miss it.
+// Comparing the determinant against the lengths of the ray-direction and the triangle-normal keeps this independent of the scale of the scene.
+#define PARALLEL_EPSILON 1e-6f
+
+typedef struct prepared_ray {
+	float origin[3];
+	float direction[3];
+	float inverse_direction[3];
+	// PARALLEL_EPSILON squared times the squared length of the direction
+	float parallel_threshold;
+} prepared_ray_t;
+
+static void prepare_ray(prepared_ray_t *prepared, const kinc_bvh_ray_t *ray) {
+	for (int axis = 0; axis < 3; ++axis) {
+		prepared->origin[axis] = ray->origin[axis];
+		prepared->direction[axis] = ray->direction[axis];
+		// avoids infinities which would turn into NaNs in the slab-test
+		float direction = ray->direction[axis];
+		if (direction < 1e-20f && direction > -1e-20f) {
+			direction = direction < 0.0f ? -1e-20f : 1e-20f;
+		}
+		prepared->inverse_direction[axis] = 1.0f / direction;
+	}
+	const float *d = ray->direction;
+	prepared->parallel_threshold = PARALLEL_EPSILON * PARALLEL_EPSILON * (d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+}
+
+// the squared length of the normal of a triangle given by its first vertex and two edges
+static float normal_length_squared(const float *triangle) {
+	const float *e1 = &triangle[3];
+	const float *e2 = &triangle[6];
+	float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+	return n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+}
+
+// returns the distance at which the ray enters the box or FLT_MAX
+static float intersect_box(const prepared_ray_t *ray, const kinc_bvh_node_t *node, float max_distance) {
+	float entry = 0.0f;
+	float exit = max_distance;
+	for (int axis = 0; axis < 3; ++axis) {
+		float t0 = (node->min[axis] - ray->origin[axis]) * ray->inverse_direction[axis];
+		float t1 = (node->max[axis] - ray->origin[axis]) * ray->inverse_direction[axis];
+		entry = t0 < t1 ? (t0 > entry ? t0 : entry) : (t1 > entry ? t1 : entry);
+		exit = t0 < t1 ? (t1 < exit ? t1 : exit) : (t0 < exit ? t0 : exit);
+	}
+	return entry <= exit ? entry : FLT_MAX;
+}
+
+// Möller-Trumbore, returns whether the triangle is hit closer than hit->distance
+static bool intersect_triangle(const prepared_ray_t *ray, const float *triangle, float *distance, float *u_result, float *v_result) {
+	const float *e1 = &triangle[3];
+	const float *e2 = &triangle[6];
+	const float *d = ray->direction;
+	float p[3] = {d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0]};
+	float determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+	// also rejects degenerate triangles
+	if (determinant * determinant <= ray->parallel_threshold * normal_length_squared(triangle)) {
+		return false;
+	}
+	float inverse = 1.0f / determinant;
+	float s[3] = {ray->origin[0] - triangle[0], ray->origin[1] - triangle[1], ray->origin[2] - triangle[2]};
+	float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+	if (u < 0.0f || u > 1.0f) {
+		return false;
+	}
+	float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+	float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverse;
+	if (v < 0.0f || u + v > 1.0f) {
+		return false;
+	}
+	float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+	if (t < 0.0f || t >= *distance) {
+		return false;
+	}
+	*distance = t;
+	*u_result = u;
+	*v_result = v;
+	return true;
+}
+
+static bool traverse(const kinc_bvh_t *bvh, const kinc_bvh_ray_t *ray, kinc_bvh_hit_t *hit, bool any) {
+	hit->triangle = -1;
+	hit->distance = ray->max_distance;
+	hit->u = hit->v = 0.0f;
+	if (bvh->triangle_count == 0) {
+		return false;
+	}
+
+	prepared_ray_t prepared;
+	prepare_ray(&prepared, ray);
+	if (intersect_box(&prepared, &bvh->nodes[0], hit->distance) == FLT_MAX) {
+		return false;
+	}
+
+	int stack[STACK_SIZE];
+	int stack_size = 0;
+	int node_index = 0;
+	for (;;) {
+		const kinc_bvh_node_t *node = &bvh->nodes[node_index];
+		if (node->count > 0) {
+			for (int triangle = node->first; triangle < node->first + node->count; ++triangle) {
+				if (intersect_triangle(&prepared, &bvh->triangles[triangle * 9], &hit->distance, &hit->u, &hit->v)) {
+					hit->triangle = bvh->triangle_ids[triangle];
+					if (any) {
+						return true;
+					}
+				}
+			}
+		}
+		else {
+			float entry_first = intersect_box(&prepared, &bvh->nodes[node->first], hit->distance);
+			float entry_second = intersect_box(&prepared, &bvh->nodes[node->first + 1], hit->distance);
+			if (entry_first != FLT_MAX && entry_second != FLT_MAX) {
+				// the farther child waits on the stack
+				bool first_is_nearer = entry_first <= entry_second;
+				stack[stack_size++] = first_is_nearer ? node->first + 1 : node->first;
+				node_index = first_is_nearer ? node->first : node->first + 1;
+				continue;
+			}
+			if (entry_first != FLT_MAX) {
+				node_index = node->first;
+				continue;
+			}
+			if (entry_second != FLT_MAX) {
+				node_index = node->first + 1;
+				continue;
+			}
+		}
+		if (stack_size == 0) {
+			break;
+		}
+		node_index = stack[--stack_size];
+	}
+	return hit->triangle >= 0;
+}
+
+bool kinc_bvh_intersect(const kinc_bvh_t *bvh, const kinc_bvh_ray_t *ray, kinc_bvh_hit_t *hit) {
+	return traverse(bvh, ray, hit, false);
+}
+
+bool kinc_bvh_occluded(const kinc_bvh_t *bvh, const kinc_bvh_ray_t *ray) {
+	kinc_bvh_hit_t hit;
+	return traverse(bvh, ray, &hit, true);
+}
+
+typedef struct ray_packet {
+	kinc_float32x4_t origin[3];
+	kinc_float32x4_t direction[3];
+	kinc_float32x4_t inverse_direction[3];
+	kinc_float32x4_t parallel_threshold;
+	// the closest hit so far, -FLT_MAX for unused lanes so they never hit anything
+	kinc_float32x4_t distance;
+	kinc_float32x4_t u;
+	kinc_float32x4_t v;
+	int triangles[4];
+} ray_packet_t;
+
+// returns one bit per ray which intersects the box closer than its closest hit
+static int intersect_box_packet(const ray_packet_t *packet, const kinc_bvh_node_t *node) {
+	kinc_float32x4_t entry = kinc_float32x4_load_all(0.0f);
+	kinc_float32x4_t exit = packet->distance;
+	for (int axis = 0; axis < 3; ++axis) {
+		kinc_float32x4_t t0 = kinc_float32x4_mul(kinc_float32x4_sub(kinc_float32x4_load_all(node->min[axis]), packet->origin[axis]), packet->inverse_direction[axis]);
+		kinc_float32x4_t t1 = kinc_float32x4_mul(kinc_float32x4_sub(kinc_float32x4_load_all(node->max[axis]), packet->origin[axis]), packet->inverse_direction[axis]);
+		entry = kinc_float32x4_max(entry, kinc_float32x4_min(t0, t1));
+		exit = kinc_float32x4_min(exit, kinc_float32x4_max(t0, t1));
+	}
+	return kinc_float32x4_mask_bits(kinc_float32x4_cmple(entry, exit));
+}
+
+static void intersect_triangle_packet(ray_packet_t *packet, const float *triangle, int triangle_id) {
+	const kinc_float32x4_t zero = kinc_float32x4_load_all(0.0f);
+	const kinc_float32x4_t one = kinc_float32x4_load_all(1.0f);
+	kinc_float32x4_t e1[3], e2[3], s[3];
+	for (int axis = 0; axis < 3; ++axis) {
+		e1[axis] = kinc_float32x4_load_all(triangle[3 + axis]);
+		e2[axis] = kinc_float32x4_load_all(triangle[6 + axis]);
+		s[axis] = kinc_float32x4_sub(packet->origin[axis], kinc_float32x4_load_all(triangle[axis]));
+	}
+	const kinc_float32x4_t *d = packet->direction;
+
+	kinc_float32x4_t p[3];
+	p[0] = kinc_float32x4_sub(kinc_float32x4_mul(d[1], e2[2]), kinc_float32x4_mul(d[2], e2[1]));
+	p[1] = kinc_float32x4_sub(kinc_float32x4_mul(d[2], e2[0]), kinc_float32x4_mul(d[0], e2[2]));
+	p[2] = kinc_float32x4_sub(kinc_float32x4_mul(d[0], e2[1]), kinc_float32x4_mul(d[1], e2[0]));
+	kinc_float32x4_t determinant =
+	    kinc_float32x4_add(kinc_float32x4_add(kinc_float32x4_mul(e1[0], p[0]), kinc_float32x4_mul(e1[1], p[1])), kinc_float32x4_mul(e1[2], p[2]));
+	kinc_float32x4_t inverse = kinc_float32x4_div(one, determinant);
+
+	kinc_float32x4_t u = kinc_float32x4_mul(
+	    kinc_float32x4_add(kinc_float32x4_add(kinc_float32x4_mul(s[0], p[0]), kinc_float32x4_mul(s[1], p[1])), kinc_float32x4_mul(s[2], p[2])), inverse);
+	kinc_float32x4_t q[3];
+	q[0] = kinc_float32x4_sub(kinc_float32x4_mul(s[1], e1[2]), kinc_float32x4_mul(s[2], e1[1]));
+	q[1] = kinc_float32x4_sub(kinc_float32x4_mul(s[2], e1[0]), kinc_float32x4_mul(s[0], e1[2]));
+	q[2] = kinc_float32x4_sub(kinc_float32x4_mul(s[0], e1[1]), kinc_float32x4_mul(s[1], e1[0]));
+	kinc_float32x4_t v = kinc_float32x4_mul(
+	    kinc_float32x4_add(kinc_float32x4_add(kinc_float32x4_mul(d[0], q[0]), kinc_float32x4_mul(d[1], q[1])), kinc_float32x4_mul(d[2], q[2])), inverse);
+	kinc_float32x4_t t = kinc_float32x4_mul(
+	    kinc_float32x4_add(kinc_float32x4_add(kinc_float32x4_mul(e2[0], q[0]), kinc_float32x4_mul(e2[1], q[1])), kinc_float32x4_mul(e2[2], q[2])), inverse);
+
+	// parallel rays get a negative u so they fail below, the other conditions are combined by taking the minimum which has to be positive
+	kinc_float32x4_t parallel_threshold = kinc_float32x4_mul(packet->parallel_threshold, kinc_float32x4_load_all(normal_length_squared(triangle)));
+	u = kinc_float32x4_sel(u, kinc_float32x4_load_all(-1.0f), kinc_float32x4_cmpgt(kinc_float32x4_mul(determinant, determinant), parallel_threshold));
+	kinc_float32x4_t inside = kinc_float32x4_min(kinc_float32x4_min(u, v), kinc_float32x4_min(kinc_float32x4_sub(kinc_float32x4_sub(one, u), v), t));
+	kinc_float32x4_t candidate = kinc_float32x4_sel(t, packet->distance, kinc_float32x4_cmpge(inside, zero));
+	kinc_float32x4_mask_t closer = kinc_float32x4_cmplt(candidate, packet->distance);
+	int bits = kinc_float32x4_mask_bits(closer);
+	if (bits == 0) {
+		return;
+	}
+	packet->distance = kinc_float32x4_sel(candidate, packet->distance, closer);
+	packet->u = kinc_float32x4_sel(u, packet->u, closer);
+	packet->v = kinc_float32x4_sel(v, packet->v, closer);
+	for (int lane = 0; lane < 4; ++lane) {
+		if (bits & (1 << lane)) {
+			packet->triangles[lane] = triangle_id;
+		}
+	}
+}
+
+static void trace_packet(const kinc_bvh_t *bvh, const kinc_bvh_ray_t *rays, kinc_bvh_hit_t *hits, int count) {
+	prepared_ray_t prepared[4];
+	float distances[4];
+	float average_direction[3] = {0.0f, 0.0f, 0.0f};
+	for (int lane = 0; lane < 4; ++lane) {
+		// unused lanes copy the first ray so all values stay finite
+		const kinc_bvh_ray_t *ray = &rays[lane < count ? lane : 0];
+		prepare_ray(&prepared[lane], ray);
+		distances[lane] = lane < count ? ray->max_distance : -FLT_MAX;
+		for (int axis = 0; axis < 3; ++axis) {
+			average_direction[axis] += ray->direction[axis];
+		}
+	}
+
+	ray_packet_t packet;
+	for (int axis = 0; axis < 3; ++axis) {
+		packet.origin[axis] = kinc_float32x4_load(prepared[0].origin[axis], prepared[1].origin[axis], prepared[2].origin[axis], prepared[3].origin[axis]);
+		packet.direction[axis] =
+		    kinc_float32x4_load(prepared[0].direction[axis], prepared[1].direction[axis], prepared[2].direction[axis], prepared[3].direction[axis]);
+		packet.inverse_direction[axis] = kinc_float32x4_load(prepared[0].inverse_direction[axis], prepared[1].inverse_direction[axis],
+		                                                     prepared[2].inverse_direction[axis], prepared[3].inverse_direction[axis]);
+	}
+	packet.parallel_threshold = kinc_float32x4_load(prepared[0].parallel_threshold, prepared[1].parallel_threshold, prepared[2].parallel_threshold,
+	                                                prepared[3].parallel_threshold);
+	packet.distance = kinc_float32x4_load(distances[0], distances[1], distances[2], distances[3]);
+	packet.u = packet.v = kinc_float32x4_load_all(0.0f);
+	for (int lane = 0; lane < 4; ++lane) {
+		packet.triangles[lane] = -1;
+	}
+
+	int stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = 0;
+	while (stack_size > 0) {
+		const kinc_bvh_node_t *node = &bvh->nodes[stack[--stack_size]];
+		if (intersect_box_packet(&packet, node) == 0) {
+			continue;
+		}
+		if (node->count > 0) {
+			for (int triangle = node->first; triangle < node->first + node->count; ++triangle) {
+				intersect_triangle_packet(&packet, &bvh->triangles[triangle * 9], bvh->triangle_ids[triangle]);
+			}
+		}
+		else {
+			// the child which the rays reach first along the axis separating the children is visited first
+			const kinc_bvh_node_t *first = &bvh->nodes[node->first];
+			const kinc_bvh_node_t *second = &bvh->nodes[node->first + 1];
+			int axis = 0;
+			float largest = -1.0f;
+			for (int i = 0; i < 3; ++i) {
+				float separation = (second->min[i] + second->max[i]) - (first->min[i] + first->max[i]);
+				separation = separation < 0.0f ? -separation : separation;
+				if (separation > largest) {
+					largest = separation;
+					axis = i;
+				}
+			}
+			bool second_is_nearer = ((second->min[axis] + second->max[axis]) - (first->min[axis] + first->max[axis])) * average_direction[axis] < 0.0f;
+			stack[stack_size++] = second_is_nearer ? node->first : node->first + 1;
+			stack[stack_size++] = second_is_nearer ? node->first + 1 : node->first;
+		}
+	}
+
+	float results[3][4];
+	kinc_float32x4_store_unaligned(results[0], packet.distance);
+	kinc_float32x4_store_unaligned(results[1], packet.u);
+	kinc_float32x4_store_unaligned(results[2], packet.v);
+	for (int lane = 0; lane < count; ++lane) {
+		hits[lane].distance = results[0][lane];
+		hits[lane].u = results[1][lane];
+		hits[lane].v = results[2][lane];
+		hits[lane].triangle = packet.triangles[lane];
+	}
+}
+
+void kinc_bvh_intersect_packets(const kinc_bvh_t *bvh, const kinc_bvh_ray_t *rays, kinc_bvh_hit_t *hits, int count) {
+	if (bvh->triangle_count == 0) {
+		for (int i = 0; i < count; ++i) {
+			hits[i].distance = rays[i].max_distance;
+			hits[i].u = hits[i].v = 0.0f;
+			hits[i].triangle = -1;
+		}
+		return;
+	}
+	for (int i = 0; i < count; i += 4) {
+		trace_packet(bvh, &rays[i], &hits[i], count - i < 4 ? count - i : 4);
+	}
+}
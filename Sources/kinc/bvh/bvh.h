@@ -0,0 +1,127 @@
+#pragma once
+
+#include <kinc/global.h>
+
+#include <stdbool.h>
+
+/*! \file bvh.h
+    \brief Provides a bounding-volume-hierarchy over triangles on the CPU for picking, visibility- and line-of-sight-queries. It is built from
+   the same data as a kinc_raytrace_acceleration_structure using a binned surface-area-heuristic, in parallel when kinc/threads/parallel.h is
+   initialized, and can be refitted cheaply when the vertices of a mesh move. Rays are in the space of the vertex-data.
+   This is not a software-backend for kinc/graphics5/raytrace.h - ray-shaders only run on raytracing-GPUs. It is what to use for ray-queries
+   where KORE_RAYTRACE is not available, the application traces the rays itself.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct kinc_bvh_node {
+	float min[3];
+	float max[3];
+	// the first triangle of a leaf or the index of the first child of an inner node, the second child always follows the first
+	int first;
+	// the number of triangles in a leaf, 0 for inner nodes
+	int count;
+} kinc_bvh_node_t;
+
+typedef struct kinc_bvh {
+	kinc_bvh_node_t *nodes;
+	int node_count;
+	// per triangle in leaf-order the first vertex and the two edges starting at it
+	float *triangles;
+	// per triangle in leaf-order the three vertex-indices, used for refitting
+	int *indices;
+	// per triangle in leaf-order the index of the triangle in the index-buffer it was built from
+	int *triangle_ids;
+	int triangle_count;
+	int vertex_count;
+} kinc_bvh_t;
+
+typedef struct kinc_bvh_ray {
+	float origin[3];
+	// does not need to be normalized, distances are measured in multiples of it
+	float direction[3];
+	float max_distance;
+} kinc_bvh_ray_t;
+
+typedef struct kinc_bvh_hit {
+	float distance;
+	// the barycentric coordinates of the hit, the weights of the second and third vertex of the triangle
+	float u;
+	float v;
+	// the index of the triangle which was hit (the index of its first index divided by three) or -1
+	int triangle;
+} kinc_bvh_hit_t;
+
+struct kinc_g5_index_buffer;
+struct kinc_g5_vertex_buffer;
+
+/// <summary>
+/// Builds a bvh over a triangle-list.
+/// </summary>
+/// <param name="bvh">The bvh to initialize</param>
+/// <param name="positions">The x, y and z components of the vertex-positions</param>
+/// <param name="position_stride">The distance between two positions in bytes</param>
+/// <param name="vertex_count">The number of vertices</param>
+/// <param name="indices">The triangle-list</param>
+/// <param name="index_count">The number of indices</param>
+KINC_FUNC void kinc_bvh_init(kinc_bvh_t *bvh, const float *positions, int position_stride, int vertex_count, const int *indices, int index_count);
+
+#ifdef KORE_G5
+/// <summary>
+/// Builds a bvh from the buffers which are also passed to kinc_raytrace_acceleration_structure_init, so the same scenes can be queried on
+/// the CPU, with or without KORE_RAYTRACE. The positions have to be the first element of the vertex-structure as three floats. Both
+/// buffers are locked and unlocked again.
+/// </summary>
+/// <param name="bvh">The bvh to initialize</param>
+/// <param name="vertex_buffer">The vertices</param>
+/// <param name="index_buffer">The triangle-list</param>
+KINC_FUNC void kinc_bvh_init_from_g5_buffers(kinc_bvh_t *bvh, struct kinc_g5_vertex_buffer *vertex_buffer, struct kinc_g5_index_buffer *index_buffer);
+#endif
+
+/// <summary>
+/// Destroys a bvh.
+/// </summary>
+KINC_FUNC void kinc_bvh_destroy(kinc_bvh_t *bvh);
+
+/// <summary>
+/// Updates a bvh for moved vertices while keeping its structure. This is much faster than building a new bvh but queries slow down when
+/// the triangles move far from where they were when the bvh was built.
+/// </summary>
+/// <param name="bvh">The bvh to update</param>
+/// <param name="positions">The new positions of the same vertices the bvh was built from</param>
+/// <param name="position_stride">The distance between two positions in bytes</param>
+KINC_FUNC void kinc_bvh_refit(kinc_bvh_t *bvh, const float *positions, int position_stride);
+
+/// <summary>
+/// Finds the closest triangle a ray hits. Triangles are hit from both sides.
+/// </summary>
+/// <param name="bvh">The bvh to search</param>
+/// <param name="ray">The ray</param>
+/// <param name="hit">Receives the closest hit</param>
+/// <returns>Whether anything was hit</returns>
+KINC_FUNC bool kinc_bvh_intersect(const kinc_bvh_t *bvh, const kinc_bvh_ray_t *ray, kinc_bvh_hit_t *hit);
+
+/// <summary>
+/// Checks whether a ray hits any triangle before its max_distance, which is faster than finding the closest hit. Useful for shadows and
+/// line-of-sight-checks.
+/// </summary>
+/// <param name="bvh">The bvh to search</param>
+/// <param name="ray">The ray</param>
+/// <returns>Whether anything was hit</returns>
+KINC_FUNC bool kinc_bvh_occluded(const kinc_bvh_t *bvh, const kinc_bvh_ray_t *ray);
+
+/// <summary>
+/// Finds the closest hits of many rays, traversing the bvh with packets of four rays using kinc_float32x4. This is the fastest way to
+/// trace coherent rays like the ones of neighbouring pixels.
+/// </summary>
+/// <param name="bvh">The bvh to search</param>
+/// <param name="rays">The rays, neighbouring rays should be similar</param>
+/// <param name="hits">Receives the closest hit of every ray, triangle is -1 for rays which did not hit anything</param>
+/// <param name="count">The number of rays</param>
+KINC_FUNC void kinc_bvh_intersect_packets(const kinc_bvh_t *bvh, const kinc_bvh_ray_t *rays, kinc_bvh_hit_t *hits, int count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,495 @@
+#include "culling.h"
+
+#include <kinc/math/core.h>
+#include <kinc/memory.h>
+#include <kinc/simd/float32x8.h>
+#include <kinc/threads/parallel.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+// the number of objects a thread tests in one go in the parallel variants
+#define PARALLEL_BATCH_SIZE 4096
+
+// the eight lanes which are tested together may reach seven floats beyond the last object
+static float *allocate_array(float *array, int capacity) {
+	return (float *)kinc_memory_reallocate(array, (capacity + 7) * sizeof(float), KINC_MEMORY_TAG_GENERAL);
+}
+
+kinc_frustum_t kinc_frustum_from_matrix(kinc_matrix4x4_t *view_projection) {
+	// the matrix is column-major, row r of it is m[r], m[4 + r], m[8 + r], m[12 + r]
+	const float *m = view_projection->m;
+	static const int rows[6] = {0, 0, 1, 1, 2, 2};
+	static const float signs[6] = {1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f};
+
+	kinc_frustum_t frustum;
+	for (int plane = 0; plane < 6; ++plane) {
+		int row = rows[plane];
+		float sign = signs[plane];
+		for (int column = 0; column < 4; ++column) {
+			frustum.planes[plane][column] = m[column * 4 + 3] + sign * m[column * 4 + row];
+		}
+		float *p = frustum.planes[plane];
+		float length = kinc_sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+		if (length > 0.0f) {
+			for (int component = 0; component < 4; ++component) {
+				p[component] /= length;
+			}
+		}
+	}
+	return frustum;
+}
+
+void kinc_cull_spheres_init(kinc_cull_spheres_t *spheres, int capacity) {
+	memset(spheres, 0, sizeof(*spheres));
+	spheres->capacity = capacity > 0 ? capacity : 1;
+	spheres->x = allocate_array(NULL, spheres->capacity);
+	spheres->y = allocate_array(NULL, spheres->capacity);
+	spheres->z = allocate_array(NULL, spheres->capacity);
+	spheres->radius = allocate_array(NULL, spheres->capacity);
+}
+
+void kinc_cull_spheres_destroy(kinc_cull_spheres_t *spheres) {
+	kinc_memory_free(spheres->x);
+	kinc_memory_free(spheres->y);
+	kinc_memory_free(spheres->z);
+	kinc_memory_free(spheres->radius);
+	memset(spheres, 0, sizeof(*spheres));
+}
+
+int kinc_cull_spheres_add(kinc_cull_spheres_t *spheres, kinc_vector3_t center, float radius) {
+	if (spheres->count == spheres->capacity) {
+		spheres->capacity *= 2;
+		spheres->x = allocate_array(spheres->x, spheres->capacity);
+		spheres->y = allocate_array(spheres->y, spheres->capacity);
+		spheres->z = allocate_array(spheres->z, spheres->capacity);
+		spheres->radius = allocate_array(spheres->radius, spheres->capacity);
+	}
+	int index = spheres->count++;
+	kinc_cull_spheres_set(spheres, index, center, radius);
+	return index;
+}
+
+void kinc_cull_spheres_set(kinc_cull_spheres_t *spheres, int index, kinc_vector3_t center, float radius) {
+	spheres->x[index] = center.x;
+	spheres->y[index] = center.y;
+	spheres->z[index] = center.z;
+	spheres->radius[index] = radius;
+}
+
+void kinc_cull_boxes_init(kinc_cull_boxes_t *boxes, int capacity) {
+	memset(boxes, 0, sizeof(*boxes));
+	boxes->capacity = capacity > 0 ? capacity : 1;
+	boxes->center_x = allocate_array(NULL, boxes->capacity);
+	boxes->center_y = allocate_array(NULL, boxes->capacity);
+	boxes->center_z = allocate_array(NULL, boxes->capacity);
+	boxes->extent_x = allocate_array(NULL, boxes->capacity);
+	boxes->extent_y = allocate_array(NULL, boxes->capacity);
+	boxes->extent_z = allocate_array(NULL, boxes->capacity);
+}
+
+void kinc_cull_boxes_destroy(kinc_cull_boxes_t *boxes) {
+	kinc_memory_free(boxes->center_x);
+	kinc_memory_free(boxes->center_y);
+	kinc_memory_free(boxes->center_z);
+	kinc_memory_free(boxes->extent_x);
+	kinc_memory_free(boxes->extent_y);
+	kinc_memory_free(boxes->extent_z);
+	memset(boxes, 0, sizeof(*boxes));
+}
+
+int kinc_cull_boxes_add(kinc_cull_boxes_t *boxes, kinc_vector3_t min, kinc_vector3_t max) {
+	if (boxes->count == boxes->capacity) {
+		boxes->capacity *= 2;
+		boxes->center_x = allocate_array(boxes->center_x, boxes->capacity);
+		boxes->center_y = allocate_array(boxes->center_y, boxes->capacity);
+		boxes->center_z = allocate_array(boxes->center_z, boxes->capacity);
+		boxes->extent_x = allocate_array(boxes->extent_x, boxes->capacity);
+		boxes->extent_y = allocate_array(boxes->extent_y, boxes->capacity);
+		boxes->extent_z = allocate_array(boxes->extent_z, boxes->capacity);
+	}
+	int index = boxes->count++;
+	kinc_cull_boxes_set(boxes, index, min, max);
+	return index;
+}
+
+void kinc_cull_boxes_set(kinc_cull_boxes_t *boxes, int index, kinc_vector3_t min, kinc_vector3_t max) {
+	boxes->center_x[index] = (min.x + max.x) * 0.5f;
+	boxes->center_y[index] = (min.y + max.y) * 0.5f;
+	boxes->center_z[index] = (min.z + max.z) * 0.5f;
+	boxes->extent_x[index] = (max.x - min.x) * 0.5f;
+	boxes->extent_y[index] = (max.y - min.y) * 0.5f;
+	boxes->extent_z[index] = (max.z - min.z) * 0.5f;
+}
+
+typedef struct simd_frustum {
+	kinc_float32x8_t x[6];
+	kinc_float32x8_t y[6];
+	kinc_float32x8_t z[6];
+	kinc_float32x8_t w[6];
+	// the absolute values of the normals for the box-extents
+	kinc_float32x8_t abs_x[6];
+	kinc_float32x8_t abs_y[6];
+	kinc_float32x8_t abs_z[6];
+} simd_frustum_t;
+
+static void load_frustum(simd_frustum_t *simd, const kinc_frustum_t *frustum) {
+	for (int plane = 0; plane < 6; ++plane) {
+		const float *p = frustum->planes[plane];
+		simd->x[plane] = kinc_float32x8_load_all(p[0]);
+		simd->y[plane] = kinc_float32x8_load_all(p[1]);
+		simd->z[plane] = kinc_float32x8_load_all(p[2]);
+		simd->w[plane] = kinc_float32x8_load_all(p[3]);
+		simd->abs_x[plane] = kinc_float32x8_load_all(p[0] < 0.0f ? -p[0] : p[0]);
+		simd->abs_y[plane] = kinc_float32x8_load_all(p[1] < 0.0f ? -p[1] : p[1]);
+		simd->abs_z[plane] = kinc_float32x8_load_all(p[2] < 0.0f ? -p[2] : p[2]);
+	}
+}
+
+static kinc_float32x8_t plane_distance(const simd_frustum_t *frustum, int plane, kinc_float32x8_t x, kinc_float32x8_t y, kinc_float32x8_t z) {
+	kinc_float32x8_t distance = kinc_float32x8_add(kinc_float32x8_mul(frustum->x[plane], x), frustum->w[plane]);
+	distance = kinc_float32x8_add(distance, kinc_float32x8_mul(frustum->y[plane], y));
+	return kinc_float32x8_add(distance, kinc_float32x8_mul(frustum->z[plane], z));
+}
+
+// returns one bit per lane which is set for volumes intersecting the frustum
+static int test_spheres(const simd_frustum_t *frustum, const kinc_cull_spheres_t *spheres, int index) {
+	kinc_float32x8_t x = kinc_float32x8_load_unaligned(&spheres->x[index]);
+	kinc_float32x8_t y = kinc_float32x8_load_unaligned(&spheres->y[index]);
+	kinc_float32x8_t z = kinc_float32x8_load_unaligned(&spheres->z[index]);
+	kinc_float32x8_t radius = kinc_float32x8_load_unaligned(&spheres->radius[index]);
+
+	// a sphere is outside if it is behind any plane, so only the smallest distance matters
+	kinc_float32x8_t nearest = plane_distance(frustum, 0, x, y, z);
+	for (int plane = 1; plane < 6; ++plane) {
+		nearest = kinc_float32x8_min(nearest, plane_distance(frustum, plane, x, y, z));
+	}
+	return kinc_float32x8_mask_bits(kinc_float32x8_cmpge(kinc_float32x8_add(nearest, radius), kinc_float32x8_load_all(0.0f)));
+}
+
+static int test_boxes(const simd_frustum_t *frustum, const kinc_cull_boxes_t *boxes, int index) {
+	kinc_float32x8_t x = kinc_float32x8_load_unaligned(&boxes->center_x[index]);
+	kinc_float32x8_t y = kinc_float32x8_load_unaligned(&boxes->center_y[index]);
+	kinc_float32x8_t z = kinc_float32x8_load_unaligned(&boxes->center_z[index]);
+	kinc_float32x8_t extent_x = kinc_float32x8_load_unaligned(&boxes->extent_x[index]);
+	kinc_float32x8_t extent_y = kinc_float32x8_load_unaligned(&boxes->extent_y[index]);
+	kinc_float32x8_t extent_z = kinc_float32x8_load_unaligned(&boxes->extent_z[index]);
+
+	kinc_float32x8_t nearest = kinc_float32x8_load_all(0.0f);
+	for (int plane = 0; plane < 6; ++plane) {
+		// the box reaches as far towards the plane as its extents projected onto the normal
+		kinc_float32x8_t radius = kinc_float32x8_mul(frustum->abs_x[plane], extent_x);
+		radius = kinc_float32x8_add(radius, kinc_float32x8_mul(frustum->abs_y[plane], extent_y));
+		radius = kinc_float32x8_add(radius, kinc_float32x8_mul(frustum->abs_z[plane], extent_z));
+		kinc_float32x8_t distance = kinc_float32x8_add(plane_distance(frustum, plane, x, y, z), radius);
+		nearest = plane == 0 ? distance : kinc_float32x8_min(nearest, distance);
+	}
+	return kinc_float32x8_mask_bits(kinc_float32x8_cmpge(nearest, kinc_float32x8_load_all(0.0f)));
+}
+
+static int write_visible(int bits, int index, int *visible, int visible_count) {
+	while (bits != 0) {
+		int lane = 0;
+		while ((bits & (1 << lane)) == 0) {
+			++lane;
+		}
+		visible[visible_count++] = index + lane;
+		bits &= bits - 1;
+	}
+	return visible_count;
+}
+
+static int lane_mask(int remaining) {
+	return remaining >= 8 ? 0xff : (1 << remaining) - 1;
+}
+
+int kinc_frustum_cull_spheres(const kinc_frustum_t *frustum, const kinc_cull_spheres_t *spheres, int start, int count, int *visible) {
+	simd_frustum_t simd;
+	load_frustum(&simd, frustum);
+	int visible_count = 0;
+	for (int i = 0; i < count; i += 8) {
+		int bits = test_spheres(&simd, spheres, start + i) & lane_mask(count - i);
+		visible_count = write_visible(bits, start + i, visible, visible_count);
+	}
+	return visible_count;
+}
+
+int kinc_frustum_cull_boxes(const kinc_frustum_t *frustum, const kinc_cull_boxes_t *boxes, int start, int count, int *visible) {
+	simd_frustum_t simd;
+	load_frustum(&simd, frustum);
+	int visible_count = 0;
+	for (int i = 0; i < count; i += 8) {
+		int bits = test_boxes(&simd, boxes, start + i) & lane_mask(count - i);
+		visible_count = write_visible(bits, start + i, visible, visible_count);
+	}
+	return visible_count;
+}
+
+typedef struct parallel_cull {
+	const kinc_frustum_t *frustum;
+	const void *set;
+	bool boxes;
+	int *visible;
+	// the number of visible objects of every batch
+	int *counts;
+} parallel_cull_t;
+
+static void cull_batch(int start, int end, void *data) {
+	parallel_cull_t *cull = (parallel_cull_t *)data;
+	// every batch writes to the part of visible which corresponds to its own objects and is compacted afterwards
+	int count = cull->boxes ? kinc_frustum_cull_boxes(cull->frustum, (const kinc_cull_boxes_t *)cull->set, start, end - start, &cull->visible[start])
+	                        : kinc_frustum_cull_spheres(cull->frustum, (const kinc_cull_spheres_t *)cull->set, start, end - start, &cull->visible[start]);
+	cull->counts[start / PARALLEL_BATCH_SIZE] = count;
+}
+
+static int cull_parallel(const kinc_frustum_t *frustum, const void *set, bool boxes, int count, int *visible) {
+	int batches = (count + PARALLEL_BATCH_SIZE - 1) / PARALLEL_BATCH_SIZE;
+	parallel_cull_t cull;
+	cull.frustum = frustum;
+	cull.set = set;
+	cull.boxes = boxes;
+	cull.visible = visible;
+	cull.counts = (int *)kinc_memory_allocate((batches > 0 ? batches : 1) * sizeof(int), KINC_MEMORY_TAG_GENERAL);
+	kinc_parallel_for(count, PARALLEL_BATCH_SIZE, cull_batch, &cull);
+
+	int visible_count = 0;
+	for (int batch = 0; batch < batches; ++batch) {
+		memmove(&visible[visible_count], &visible[batch * PARALLEL_BATCH_SIZE], cull.counts[batch] * sizeof(int));
+		visible_count += cull.counts[batch];
+	}
+	kinc_memory_free(cull.counts);
+	return visible_count;
+}
+
+int kinc_frustum_cull_spheres_parallel(const kinc_frustum_t *frustum, const kinc_cull_spheres_t *spheres, int *visible) {
+	return cull_parallel(frustum, spheres, false, spheres->count, visible);
+}
+
+int kinc_frustum_cull_boxes_parallel(const kinc_frustum_t *frustum, const kinc_cull_boxes_t *boxes, int *visible) {
+	return cull_parallel(frustum, boxes, true, boxes->count, visible);
+}
+
+#define LEAF_SIZE 8
+
+typedef struct tree_item {
+	float center[3];
+	float extent[3];
+	int index;
+} tree_item_t;
+
+typedef struct tree_builder {
+	kinc_cull_tree_t *tree;
+	// copies of the boxes which are reordered in place, which keeps the memory-accesses sequential
+	tree_item_t *items;
+	int slot_count;
+} tree_builder_t;
+
+// moves the item with the nth-smallest center along axis to position nth, smaller ones before it and larger ones after it
+static void select_nth(tree_item_t *items, int axis, int start, int end, int nth) {
+	while (end - start > 1) {
+		float pivot = items[(start + end) / 2].center[axis];
+		int i = start;
+		int j = end - 1;
+		while (i <= j) {
+			while (items[i].center[axis] < pivot) {
+				++i;
+			}
+			while (items[j].center[axis] > pivot) {
+				--j;
+			}
+			if (i <= j) {
+				tree_item_t temp = items[i];
+				items[i] = items[j];
+				items[j] = temp;
+				++i;
+				--j;
+			}
+		}
+		if (nth <= j) {
+			end = j + 1;
+		}
+		else if (nth >= i) {
+			start = i;
+		}
+		else {
+			return;
+		}
+	}
+}
+
+static int build_node(tree_builder_t *builder, int start, int end) {
+	kinc_cull_tree_t *tree = builder->tree;
+	int node_index = tree->node_count++;
+	kinc_cull_tree_node_t *node = &tree->nodes[node_index];
+
+	float center_min[3], center_max[3];
+	for (int i = start; i < end; ++i) {
+		const tree_item_t *item = &builder->items[i];
+		for (int axis = 0; axis < 3; ++axis) {
+			float center = item->center[axis];
+			if (i == start || center - item->extent[axis] < node->min[axis]) {
+				node->min[axis] = center - item->extent[axis];
+			}
+			if (i == start || center + item->extent[axis] > node->max[axis]) {
+				node->max[axis] = center + item->extent[axis];
+			}
+			if (i == start || center < center_min[axis]) {
+				center_min[axis] = center;
+			}
+			if (i == start || center > center_max[axis]) {
+				center_max[axis] = center;
+			}
+		}
+	}
+
+	if (end - start <= LEAF_SIZE) {
+		node->first = builder->slot_count;
+		node->count = end - start;
+		for (int i = 0; i < LEAF_SIZE; ++i) {
+			int slot = builder->slot_count + i;
+			const tree_item_t *item = i < end - start ? &builder->items[start + i] : NULL;
+			tree->indices[slot] = item != NULL ? item->index : -1;
+			tree->slots.center_x[slot] = item != NULL ? item->center[0] : 0.0f;
+			tree->slots.center_y[slot] = item != NULL ? item->center[1] : 0.0f;
+			tree->slots.center_z[slot] = item != NULL ? item->center[2] : 0.0f;
+			tree->slots.extent_x[slot] = item != NULL ? item->extent[0] : 0.0f;
+			tree->slots.extent_y[slot] = item != NULL ? item->extent[1] : 0.0f;
+			tree->slots.extent_z[slot] = item != NULL ? item->extent[2] : 0.0f;
+		}
+		builder->slot_count += LEAF_SIZE;
+		tree->slots.count = builder->slot_count;
+		return node_index;
+	}
+
+	// median split along the axis in which the centers are spread the most
+	int split_axis = 0;
+	for (int axis = 1; axis < 3; ++axis) {
+		if (center_max[axis] - center_min[axis] > center_max[split_axis] - center_min[split_axis]) {
+			split_axis = axis;
+		}
+	}
+	int middle = (start + end) / 2;
+	select_nth(builder->items, split_axis, start, end, middle);
+
+	node->count = 0;
+	build_node(builder, start, middle);
+	int second = build_node(builder, middle, end);
+	tree->nodes[node_index].first = second;
+	return node_index;
+}
+
+void kinc_cull_tree_init(kinc_cull_tree_t *tree, const kinc_cull_boxes_t *boxes) {
+	memset(tree, 0, sizeof(*tree));
+	int count = boxes->count;
+	// leaves hold at least LEAF_SIZE / 2 boxes unless the whole tree is one leaf
+	int max_leaves = count / (LEAF_SIZE / 2) + 1;
+	tree->nodes = (kinc_cull_tree_node_t *)kinc_memory_allocate(2 * max_leaves * sizeof(kinc_cull_tree_node_t), KINC_MEMORY_TAG_GENERAL);
+	tree->indices = (int *)kinc_memory_allocate(max_leaves * LEAF_SIZE * sizeof(int), KINC_MEMORY_TAG_GENERAL);
+	kinc_cull_boxes_init(&tree->slots, max_leaves * LEAF_SIZE);
+	if (count == 0) {
+		return;
+	}
+
+	tree_builder_t builder;
+	builder.tree = tree;
+	builder.items = (tree_item_t *)kinc_memory_allocate(count * sizeof(tree_item_t), KINC_MEMORY_TAG_GENERAL);
+	builder.slot_count = 0;
+	for (int i = 0; i < count; ++i) {
+		tree_item_t *item = &builder.items[i];
+		item->center[0] = boxes->center_x[i];
+		item->center[1] = boxes->center_y[i];
+		item->center[2] = boxes->center_z[i];
+		item->extent[0] = boxes->extent_x[i];
+		item->extent[1] = boxes->extent_y[i];
+		item->extent[2] = boxes->extent_z[i];
+		item->index = i;
+	}
+	build_node(&builder, 0, count);
+	kinc_memory_free(builder.items);
+}
+
+void kinc_cull_tree_destroy(kinc_cull_tree_t *tree) {
+	kinc_memory_free(tree->nodes);
+	kinc_memory_free(tree->indices);
+	kinc_cull_boxes_destroy(&tree->slots);
+	memset(tree, 0, sizeof(*tree));
+}
+
+typedef enum { OUTSIDE, INTERSECTING, INSIDE } containment_t;
+
+static containment_t test_node(const kinc_frustum_t *frustum, const kinc_cull_tree_node_t *node) {
+	containment_t result = INSIDE;
+	for (int plane = 0; plane < 6; ++plane) {
+		const float *p = frustum->planes[plane];
+		float distance = p[3];
+		float radius = 0.0f;
+		for (int axis = 0; axis < 3; ++axis) {
+			float center = (node->min[axis] + node->max[axis]) * 0.5f;
+			float extent = (node->max[axis] - node->min[axis]) * 0.5f;
+			distance += p[axis] * center;
+			radius += (p[axis] < 0.0f ? -p[axis] : p[axis]) * extent;
+		}
+		if (distance + radius < 0.0f) {
+			return OUTSIDE;
+		}
+		if (distance - radius < 0.0f) {
+			result = INTERSECTING;
+		}
+	}
+	return result;
+}
+
+int kinc_cull_tree_frustum_cull(const kinc_cull_tree_t *tree, const kinc_frustum_t *frustum, int *visible) {
+	if (tree->node_count == 0) {
+		return 0;
+	}
+	simd_frustum_t simd;
+	load_frustum(&simd, frustum);
+
+	// median splits keep the depth logarithmic, 64 levels are more than any int-sized set can produce
+	struct {
+		int node;
+		bool inside;
+	} stack[64];
+	int stack_size = 0;
+	stack[stack_size].node = 0;
+	stack[stack_size].inside = false;
+	++stack_size;
+
+	int visible_count = 0;
+	while (stack_size > 0) {
+		--stack_size;
+		int node_index = stack[stack_size].node;
+		bool inside = stack[stack_size].inside;
+		const kinc_cull_tree_node_t *node = &tree->nodes[node_index];
+
+		if (!inside) {
+			containment_t containment = test_node(frustum, node);
+			if (containment == OUTSIDE) {
+				continue;
+			}
+			inside = containment == INSIDE;
+		}
+
+		if (node->count > 0) {
+			int bits = inside ? lane_mask(node->count) : test_boxes(&simd, &tree->slots, node->first) & lane_mask(node->count);
+			while (bits != 0) {
+				int lane = 0;
+				while ((bits & (1 << lane)) == 0) {
+					++lane;
+				}
+				visible[visible_count++] = tree->indices[node->first + lane];
+				bits &= bits - 1;
+			}
+		}
+		else {
+			stack[stack_size].node = node->first;
+			stack[stack_size].inside = inside;
+			++stack_size;
+			stack[stack_size].node = node_index + 1;
+			stack[stack_size].inside = inside;
+			++stack_size;
+		}
+	}
+	return visible_count;
+}
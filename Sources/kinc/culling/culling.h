@@ -0,0 +1,174 @@
+#pragma once
+
+#include <kinc/global.h>
+
+#include <kinc/math/matrix.h>
+#include <kinc/math/vector.h>
+
+/*! \file culling.h
+    \brief Tests large numbers of bounding volumes against a view-frustum. The volumes are stored as structures of arrays so eight of them are
+   tested at once using kinc_float32x8, kinc_cull_tree speeds up large static sets by skipping whole groups of boxes.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct kinc_frustum {
+	// normalized planes (x, y, z, w) in world-space, points p with x * p.x + y * p.y + z * p.z + w >= 0 are inside
+	float planes[6][4];
+} kinc_frustum_t;
+
+typedef struct kinc_cull_spheres {
+	float *x;
+	float *y;
+	float *z;
+	float *radius;
+	int count;
+	int capacity;
+} kinc_cull_spheres_t;
+
+typedef struct kinc_cull_boxes {
+	float *center_x;
+	float *center_y;
+	float *center_z;
+	float *extent_x;
+	float *extent_y;
+	float *extent_z;
+	int count;
+	int capacity;
+} kinc_cull_boxes_t;
+
+typedef struct kinc_cull_tree_node {
+	float min[3];
+	float max[3];
+	// the first slot of a leaf or the index of the second child of an inner node, the first child always follows its parent
+	int first;
+	// the number of boxes in a leaf, 0 for inner nodes
+	int count;
+} kinc_cull_tree_node_t;
+
+typedef struct kinc_cull_tree {
+	kinc_cull_tree_node_t *nodes;
+	int node_count;
+	// the boxes reordered so every leaf starts at a multiple of eight
+	kinc_cull_boxes_t slots;
+	// the original index of the box in every slot
+	int *indices;
+} kinc_cull_tree_t;
+
+/// <summary>
+/// Extracts the planes of a view-frustum. The near plane is placed at a clip-space depth of -w so it is conservative for depth-ranges of 0 to 1
+/// as well as -1 to 1.
+/// </summary>
+/// <param name="view_projection">The projection-matrix multiplied with the view-matrix, or with a model-matrix in addition to cull in object-space</param>
+/// <returns>The frustum</returns>
+KINC_FUNC kinc_frustum_t kinc_frustum_from_matrix(kinc_matrix4x4_t *view_projection);
+
+/// <summary>
+/// Initializes an empty set of bounding-spheres.
+/// </summary>
+/// <param name="spheres">The set to initialize</param>
+/// <param name="capacity">The number of spheres to allocate space for, the set grows when more are added</param>
+KINC_FUNC void kinc_cull_spheres_init(kinc_cull_spheres_t *spheres, int capacity);
+
+/// <summary>
+/// Destroys a set of bounding-spheres.
+/// </summary>
+KINC_FUNC void kinc_cull_spheres_destroy(kinc_cull_spheres_t *spheres);
+
+/// <summary>
+/// Adds a sphere to a set.
+/// </summary>
+/// <returns>The index of the sphere</returns>
+KINC_FUNC int kinc_cull_spheres_add(kinc_cull_spheres_t *spheres, kinc_vector3_t center, float radius);
+
+/// <summary>
+/// Moves or resizes a sphere of a set.
+/// </summary>
+KINC_FUNC void kinc_cull_spheres_set(kinc_cull_spheres_t *spheres, int index, kinc_vector3_t center, float radius);
+
+/// <summary>
+/// Initializes an empty set of axis-aligned bounding-boxes.
+/// </summary>
+/// <param name="boxes">The set to initialize</param>
+/// <param name="capacity">The number of boxes to allocate space for, the set grows when more are added</param>
+KINC_FUNC void kinc_cull_boxes_init(kinc_cull_boxes_t *boxes, int capacity);
+
+/// <summary>
+/// Destroys a set of axis-aligned bounding-boxes.
+/// </summary>
+KINC_FUNC void kinc_cull_boxes_destroy(kinc_cull_boxes_t *boxes);
+
+/// <summary>
+/// Adds a box to a set.
+/// </summary>
+/// <returns>The index of the box</returns>
+KINC_FUNC int kinc_cull_boxes_add(kinc_cull_boxes_t *boxes, kinc_vector3_t min, kinc_vector3_t max);
+
+/// <summary>
+/// Moves or resizes a box of a set.
+/// </summary>
+KINC_FUNC void kinc_cull_boxes_set(kinc_cull_boxes_t *boxes, int index, kinc_vector3_t min, kinc_vector3_t max);
+
+/// <summary>
+/// Tests a range of spheres against a frustum.
+/// </summary>
+/// <param name="frustum">The frustum to test against</param>
+/// <param name="spheres">The spheres to test</param>
+/// <param name="start">The index of the first sphere to test</param>
+/// <param name="count">The number of spheres to test</param>
+/// <param name="visible">Receives the indices of the spheres which intersect the frustum in ascending order, needs space for count indices</param>
+/// <returns>The number of visible spheres</returns>
+KINC_FUNC int kinc_frustum_cull_spheres(const kinc_frustum_t *frustum, const kinc_cull_spheres_t *spheres, int start, int count, int *visible);
+
+/// <summary>
+/// Tests a range of boxes against a frustum.
+/// </summary>
+/// <param name="frustum">The frustum to test against</param>
+/// <param name="boxes">The boxes to test</param>
+/// <param name="start">The index of the first box to test</param>
+/// <param name="count">The number of boxes to test</param>
+/// <param name="visible">Receives the indices of the boxes which intersect the frustum in ascending order, needs space for count indices</param>
+/// <returns>The number of visible boxes</returns>
+KINC_FUNC int kinc_frustum_cull_boxes(const kinc_frustum_t *frustum, const kinc_cull_boxes_t *boxes, int start, int count, int *visible);
+
+/// <summary>
+/// Tests all spheres of a set against a frustum, split across the threads of kinc/threads/parallel.h.
+/// </summary>
+/// <param name="visible">Receives the indices of the visible spheres in ascending order, needs space for spheres->count indices</param>
+/// <returns>The number of visible spheres</returns>
+KINC_FUNC int kinc_frustum_cull_spheres_parallel(const kinc_frustum_t *frustum, const kinc_cull_spheres_t *spheres, int *visible);
+
+/// <summary>
+/// Tests all boxes of a set against a frustum, split across the threads of kinc/threads/parallel.h.
+/// </summary>
+/// <param name="visible">Receives the indices of the visible boxes in ascending order, needs space for boxes->count indices</param>
+/// <returns>The number of visible boxes</returns>
+KINC_FUNC int kinc_frustum_cull_boxes_parallel(const kinc_frustum_t *frustum, const kinc_cull_boxes_t *boxes, int *visible);
+
+/// <summary>
+/// Builds a bounding-volume-hierarchy over a set of boxes which do not move. Groups of up to eight boxes are tested together and groups which
+/// are completely inside or outside of a frustum are accepted or rejected without testing their boxes.
+/// </summary>
+/// <param name="tree">The tree to initialize</param>
+/// <param name="boxes">The boxes, the tree keeps its own copy</param>
+KINC_FUNC void kinc_cull_tree_init(kinc_cull_tree_t *tree, const kinc_cull_boxes_t *boxes);
+
+/// <summary>
+/// Destroys a tree.
+/// </summary>
+KINC_FUNC void kinc_cull_tree_destroy(kinc_cull_tree_t *tree);
+
+/// <summary>
+/// Finds the boxes of a tree which intersect a frustum.
+/// </summary>
+/// <param name="tree">The tree to search</param>
+/// <param name="frustum">The frustum to test against</param>
+/// <param name="visible">Receives the indices the visible boxes had in the set the tree was built from, in no particular order</param>
+/// <returns>The number of visible boxes</returns>
+KINC_FUNC int kinc_cull_tree_frustum_cull(const kinc_cull_tree_t *tree, const kinc_frustum_t *frustum, int *visible);
+
+#ifdef __cplusplus
+}
+#endif
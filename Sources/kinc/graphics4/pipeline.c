@@ -1,5 +1,11 @@
 #include "pipeline.h"
 
+#include <kinc/graphics4/vertexstructure.h>
+
+#include <string.h>
+
+static kinc_g4_pipeline_statistics_t statistics = {0};
+
 void kinc_g4_internal_pipeline_set_defaults(kinc_g4_pipeline_t *state) {
 	for (int i = 0; i < 16; ++i) state->input_layout[i] = NULL;
 	state->vertex_shader = NULL;
@@ -41,3 +47,94 @@ void kinc_g4_internal_pipeline_set_defaults(kinc_g4_pipeline_t *state) {
 
 	state->conservative_rasterization = false;
 }
+
+uint64_t kinc_g4_internal_hash(const void *data, size_t size, uint64_t hash) {
+	if (hash == 0) {
+		hash = 14695981039346656037ull;
+	}
+	const uint8_t *bytes = (const uint8_t *)data;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static uint64_t hash_int(int value, uint64_t hash) {
+	return kinc_g4_internal_hash(&value, sizeof(value), hash);
+}
+
+uint64_t kinc_g4_internal_pipeline_hash_input_layout(kinc_g4_pipeline_t *pipeline, uint64_t hash) {
+	for (int i = 0; i < 16 && pipeline->input_layout[i] != NULL; ++i) {
+		kinc_g4_vertex_structure_t *structure = pipeline->input_layout[i];
+		hash = hash_int(structure->size, hash);
+		hash = hash_int(structure->instanced ? 1 : 0, hash);
+		for (int j = 0; j < structure->size; ++j) {
+			const char *name = structure->elements[j].name;
+			// including the terminator so neighbouring names can not merge
+			hash = kinc_g4_internal_hash(name, strlen(name) + 1, hash);
+			hash = hash_int(structure->elements[j].data, hash);
+		}
+	}
+	return hash;
+}
+
+int kinc_g4_internal_pipeline_state(kinc_g4_pipeline_t *pipeline, int *values) {
+	int count = 0;
+	// every field separately because the struct contains padding
+	values[count++] = pipeline->cull_mode;
+	values[count++] = pipeline->depth_write ? 1 : 0;
+	values[count++] = pipeline->depth_mode;
+	values[count++] = pipeline->stencil_mode;
+	values[count++] = pipeline->stencil_both_pass;
+	values[count++] = pipeline->stencil_depth_fail;
+	values[count++] = pipeline->stencil_fail;
+	values[count++] = pipeline->stencil_reference_value;
+	values[count++] = pipeline->stencil_read_mask;
+	values[count++] = pipeline->stencil_write_mask;
+	values[count++] = pipeline->blend_source;
+	values[count++] = pipeline->blend_destination;
+	values[count++] = pipeline->alpha_blend_source;
+	values[count++] = pipeline->alpha_blend_destination;
+	for (int i = 0; i < 8; ++i) {
+		values[count++] = (pipeline->color_write_mask_red[i] ? 1 : 0) | (pipeline->color_write_mask_green[i] ? 2 : 0) |
+		                  (pipeline->color_write_mask_blue[i] ? 4 : 0) | (pipeline->color_write_mask_alpha[i] ? 8 : 0);
+	}
+	values[count++] = pipeline->color_attachment_count;
+	for (int i = 0; i < pipeline->color_attachment_count && i < 8; ++i) {
+		values[count++] = pipeline->color_attachment[i];
+	}
+	values[count++] = pipeline->depth_attachment_bits;
+	values[count++] = pipeline->stencil_attachment_bits;
+	values[count++] = pipeline->conservative_rasterization ? 1 : 0;
+	return count;
+}
+
+uint64_t kinc_g4_pipeline_hash(kinc_g4_pipeline_t *pipeline) {
+	struct kinc_g4_shader *shaders[5] = {pipeline->vertex_shader, pipeline->fragment_shader, pipeline->geometry_shader,
+	                                     pipeline->tessellation_control_shader, pipeline->tessellation_evaluation_shader};
+	uint64_t hash = kinc_g4_internal_hash(shaders, sizeof(shaders), 0);
+	hash = kinc_g4_internal_pipeline_hash_input_layout(pipeline, hash);
+	int values[KINC_G4_INTERNAL_PIPELINE_STATE_SIZE];
+	int count = kinc_g4_internal_pipeline_state(pipeline, values);
+	return kinc_g4_internal_hash(values, count * sizeof(int), hash);
+}
+
+kinc_g4_pipeline_statistics_t kinc_g4_pipeline_get_statistics(void) {
+	return statistics;
+}
+
+void kinc_g4_pipeline_reset_statistics(void) {
+	memset(&statistics, 0, sizeof(statistics));
+}
+
+void kinc_g4_internal_pipeline_count_compilation(double seconds, bool cache_hit, bool binary_load) {
+	++statistics.compilations;
+	if (cache_hit) {
+		++statistics.cache_hits;
+	}
+	if (binary_load) {
+		++statistics.binary_loads;
+	}
+	statistics.compile_time += seconds;
+}
@@ -8,6 +8,8 @@
 
 #include <kinc/backend/graphics4/pipeline.h>
 
+#include <stddef.h>
+
 /*! \file pipeline.h
     \brief Provides functions for creating and using pipelines which configure the GPU for rendering.
 */
@@ -101,6 +103,17 @@ typedef struct kinc_g4_pipeline {
 	kinc_g4_pipeline_impl_t impl;
 } kinc_g4_pipeline_t;
 
+typedef struct kinc_g4_pipeline_statistics {
+	// pipelines which were compiled, including the ones which were found in a cache
+	int compilations;
+	// compilations which reused the backend-objects of an identical pipeline instead of creating new ones
+	int cache_hits;
+	// compilations which loaded a program-binary from the save-directory instead of linking shaders
+	int binary_loads;
+	// the time spent in kinc_g4_pipeline_compile in seconds
+	double compile_time;
+} kinc_g4_pipeline_statistics_t;
+
 /// <summary>
 /// Initializes a pipeline.
 /// </summary>
@@ -115,7 +128,8 @@ KINC_FUNC void kinc_g4_pipeline_destroy(kinc_g4_pipeline_t *pipeline);
 
 /// <summary>
 /// Compiles a pipeline. After a pipeline was compiled it is finalized. It can not be compiled again and changes to the pipeline are ignored after it was
-/// compiled.
+/// compiled. On OpenGL pipelines whose complete state is equal share one program and linked programs are stored in the save-directory so
+/// later runs can skip linking.
 /// </summary>
 /// <param name="pipeline">The pipeline to compile</param>
 KINC_FUNC void kinc_g4_pipeline_compile(kinc_g4_pipeline_t *pipeline);
@@ -136,8 +150,35 @@ KINC_FUNC kinc_g4_constant_location_t kinc_g4_pipeline_get_constant_location(kin
 /// <returns>The texture-unit of the texture-declaration</returns>
 KINC_FUNC kinc_g4_texture_unit_t kinc_g4_pipeline_get_texture_unit(kinc_g4_pipeline_t *pipeline, const char *name);
 
+/// <summary>
+/// Calculates a hash of the complete state of a pipeline - the shaders, the input-layout, blending, depth-, stencil- and cull-settings and the
+/// attachments. Pipelines with equal hashes are interchangeable which can be used to deduplicate pipelines which are created for materials.
+/// Shaders are identified by their addresses.
+/// </summary>
+/// <param name="pipeline">The pipeline to calculate a hash for</param>
+/// <returns>The hash</returns>
+KINC_FUNC uint64_t kinc_g4_pipeline_hash(kinc_g4_pipeline_t *pipeline);
+
+/// <summary>
+/// Returns how many pipelines were compiled, how many of them were found in a cache and how long compiling took.
+/// </summary>
+KINC_FUNC kinc_g4_pipeline_statistics_t kinc_g4_pipeline_get_statistics(void);
+
+/// <summary>
+/// Sets all pipeline-statistics back to zero, for example to measure the compilations of a single level.
+/// </summary>
+KINC_FUNC void kinc_g4_pipeline_reset_statistics(void);
+
 void kinc_g4_internal_set_pipeline(kinc_g4_pipeline_t *pipeline);
 void kinc_g4_internal_pipeline_set_defaults(kinc_g4_pipeline_t *pipeline);
+// FNV-1a, pass 0 as hash to start a new hash
+uint64_t kinc_g4_internal_hash(const void *data, size_t size, uint64_t hash);
+uint64_t kinc_g4_internal_pipeline_hash_input_layout(kinc_g4_pipeline_t *pipeline, uint64_t hash);
+// the largest number of values kinc_g4_internal_pipeline_state writes
+#define KINC_G4_INTERNAL_PIPELINE_STATE_SIZE 40
+// writes the blend-, depth-, stencil- and cull-settings and the attachments without padding, returns the number of values
+int kinc_g4_internal_pipeline_state(kinc_g4_pipeline_t *pipeline, int *values);
+void kinc_g4_internal_pipeline_count_compilation(double seconds, bool cache_hit, bool binary_load);
 
 #ifdef __cplusplus
 }
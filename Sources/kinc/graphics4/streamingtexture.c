@@ -0,0 +1,564 @@
+#include "streamingtexture.h"
+
+#ifdef KORE_LZ4X
+int LZ4_decompress_safe(const char *source, char *dest, int compressedSize, int maxOutputSize);
+#else
+#include <kinc/io/lz4/lz4.h>
+#endif
+
+#include <kinc/io/filereader.h>
+#include <kinc/log.h>
+#include <kinc/memory.h>
+#include <kinc/threads/mutex.h>
+#include <kinc/threads/semaphore.h>
+#include <kinc/threads/thread.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+// finer levels which are requested at the same time, loads which coarsen textures are not limited
+#define MAX_PENDING_REFINEMENTS 8
+// frames to wait before a texture is requested again after a failed load, doubled with every further failure up to MAX_RETRY_DELAY
+#define RETRY_DELAY 30
+#define MAX_RETRY_DELAY 3840
+
+struct kinc_g4_internal_streaming_request {
+	// NULL when the texture was destroyed while the request was loading
+	kinc_g4_streaming_texture_t *texture;
+	// a copy of the file-description so the loader never touches the texture
+	char filename[256];
+	int width;
+	int height;
+	kinc_image_format_t format;
+	int level_count;
+	uint32_t level_offsets[KINC_G4_STREAMING_TEXTURE_MAX_LEVELS];
+	uint32_t level_sizes[KINC_G4_STREAMING_TEXTURE_MAX_LEVELS];
+	// the largest level to load, all smaller levels are loaded with it
+	int level;
+	// the levels one after another as read from the file and decompressed
+	char *compressed;
+	uint8_t *data;
+	bool failed;
+	struct kinc_g4_internal_streaming_request *next;
+};
+
+typedef struct kinc_g4_internal_streaming_request request_t;
+
+typedef struct candidate {
+	kinc_g4_streaming_texture_t *texture;
+	int target_level;
+	bool seen;
+	double key;
+} candidate_t;
+
+static kinc_g4_streaming_texture_t **textures = NULL;
+static int texture_count = 0;
+static int texture_capacity = 0;
+static candidate_t *candidates = NULL;
+static int candidate_capacity = 0;
+
+static size_t budget = 0;
+static int64_t frame = 0;
+static int pending_count = 0;
+static int completed_count = 0;
+static int eviction_count = 0;
+
+static request_t *queue_first = NULL;
+static request_t *queue_last = NULL;
+static request_t *finished = NULL;
+
+#ifndef KORE_HTML5
+static kinc_thread_t thread;
+static kinc_mutex_t mutex;
+static kinc_semaphore_t semaphore;
+static volatile bool quit = false;
+#endif
+
+static int levelSize(int size, int level) {
+	int levelSize = size >> level;
+	return levelSize < 1 ? 1 : levelSize;
+}
+
+static size_t levelBytes(int width, int height, kinc_image_format_t format, int level) {
+	return (size_t)levelSize(width, level) * (size_t)levelSize(height, level) * (size_t)kinc_image_format_sizeof(format);
+}
+
+// the memory used by a level and all smaller levels
+static size_t chainBytes(kinc_g4_streaming_texture_t *texture, int level) {
+	size_t bytes = 0;
+	for (int i = level; i < texture->level_count; ++i) {
+		bytes += levelBytes(texture->width, texture->height, texture->format, i);
+	}
+	return bytes;
+}
+
+static void readLevels(request_t *request) {
+	size_t total = 0;
+	for (int i = request->level; i < request->level_count; ++i) {
+		total += request->level_sizes[i];
+	}
+	request->compressed = (char *)kinc_memory_allocate(total, KINC_MEMORY_TAG_GRAPHICS);
+	request->failed = true;
+
+	kinc_file_reader_t reader;
+	if (request->compressed == NULL || !kinc_file_reader_open(&reader, request->filename, KINC_FILE_TYPE_ASSET)) {
+		return;
+	}
+	char *output = request->compressed;
+	int level = request->level;
+	for (; level < request->level_count; ++level) {
+		kinc_file_reader_seek(&reader, (int)request->level_offsets[level]);
+		if (kinc_file_reader_read(&reader, output, request->level_sizes[level]) != (int)request->level_sizes[level]) {
+			break;
+		}
+		output += request->level_sizes[level];
+	}
+	request->failed = level != request->level_count;
+	kinc_file_reader_close(&reader);
+}
+
+static void decompressLevels(request_t *request) {
+	if (request->failed) {
+		return;
+	}
+	size_t total = 0;
+	for (int i = request->level; i < request->level_count; ++i) {
+		total += levelBytes(request->width, request->height, request->format, i);
+	}
+	request->data = (uint8_t *)kinc_memory_allocate(total, KINC_MEMORY_TAG_GRAPHICS);
+	request->failed = request->data == NULL;
+
+	char *input = request->compressed;
+	uint8_t *output = request->data;
+	for (int level = request->level; !request->failed && level < request->level_count; ++level) {
+		int size = (int)levelBytes(request->width, request->height, request->format, level);
+		request->failed = LZ4_decompress_safe(input, (char *)output, (int)request->level_sizes[level], size) != size;
+		input += request->level_sizes[level];
+		output += size;
+	}
+	kinc_memory_free(request->compressed);
+	request->compressed = NULL;
+}
+
+static void freeRequest(request_t *request) {
+	kinc_memory_free(request->compressed);
+	kinc_memory_free(request->data);
+	kinc_memory_free(request);
+}
+
+static void createTexture(kinc_g4_texture_t *texture, request_t *request) {
+	uint8_t *data = request->data;
+	for (int level = request->level; level < request->level_count; ++level) {
+		kinc_image_t image;
+		kinc_image_init_from_bytes(&image, data, levelSize(request->width, level), levelSize(request->height, level), request->format);
+		if (level == request->level) {
+			kinc_g4_texture_init_from_image(texture, &image);
+		}
+		else {
+			kinc_g4_texture_set_mipmap(texture, &image, level - request->level);
+		}
+		kinc_image_destroy(&image);
+		data += levelBytes(request->width, request->height, request->format, level);
+	}
+}
+
+static void fillRequest(request_t *request, kinc_g4_streaming_texture_t *texture, int level) {
+	request->texture = texture;
+	strcpy(request->filename, texture->filename);
+	request->width = texture->width;
+	request->height = texture->height;
+	request->format = texture->format;
+	request->level_count = texture->level_count;
+	memcpy(request->level_offsets, texture->level_offsets, sizeof(request->level_offsets));
+	memcpy(request->level_sizes, texture->level_sizes, sizeof(request->level_sizes));
+	request->level = level;
+	request->compressed = NULL;
+	request->data = NULL;
+	request->failed = false;
+	request->next = NULL;
+}
+
+#ifndef KORE_HTML5
+static void loader(void *param) {
+	for (;;) {
+		kinc_semaphore_acquire(&semaphore);
+		if (quit) {
+			break;
+		}
+
+		kinc_mutex_lock(&mutex);
+		request_t *request = queue_first;
+		if (request != NULL) {
+			queue_first = request->next;
+			if (queue_first == NULL) {
+				queue_last = NULL;
+			}
+		}
+		kinc_mutex_unlock(&mutex);
+
+		if (request == NULL) {
+			continue;
+		}
+		readLevels(request);
+		// lz4x decompresses using a global buffer which image.c uses as well, so then it has to happen on the main thread
+#ifndef KORE_LZ4X
+		decompressLevels(request);
+#endif
+
+		kinc_mutex_lock(&mutex);
+		request->next = finished;
+		finished = request;
+		kinc_mutex_unlock(&mutex);
+	}
+}
+#endif
+
+static void requestLevel(kinc_g4_streaming_texture_t *texture, int level) {
+	request_t *request = (request_t *)kinc_memory_allocate(sizeof(request_t), KINC_MEMORY_TAG_GRAPHICS);
+	fillRequest(request, texture, level);
+	texture->request = request;
+	++pending_count;
+#ifdef KORE_HTML5
+	// no threads, the load is finished right away and uploaded in the next update
+	readLevels(request);
+	request->next = finished;
+	finished = request;
+#else
+	kinc_mutex_lock(&mutex);
+	if (queue_last != NULL) {
+		queue_last->next = request;
+	}
+	else {
+		queue_first = request;
+	}
+	queue_last = request;
+	kinc_mutex_unlock(&mutex);
+	kinc_semaphore_release(&semaphore, 1);
+#endif
+}
+
+void kinc_g4_texture_streamer_init(size_t new_budget) {
+	budget = new_budget;
+	frame = 0;
+	pending_count = 0;
+	completed_count = 0;
+	eviction_count = 0;
+#ifndef KORE_HTML5
+	quit = false;
+	kinc_mutex_init(&mutex);
+	kinc_semaphore_init(&semaphore, 0, 0x7fffffff);
+	kinc_thread_init(&thread, loader, NULL);
+#endif
+}
+
+static void freeRequests(request_t *request) {
+	while (request != NULL) {
+		request_t *next = request->next;
+		freeRequest(request);
+		request = next;
+	}
+}
+
+void kinc_g4_texture_streamer_destroy(void) {
+#ifndef KORE_HTML5
+	quit = true;
+	kinc_semaphore_release(&semaphore, 1);
+	kinc_thread_wait_and_destroy(&thread);
+	kinc_semaphore_destroy(&semaphore);
+	kinc_mutex_destroy(&mutex);
+#endif
+	freeRequests(queue_first);
+	freeRequests(finished);
+	queue_first = queue_last = finished = NULL;
+
+	kinc_memory_free(textures);
+	textures = NULL;
+	texture_count = texture_capacity = 0;
+	kinc_memory_free(candidates);
+	candidates = NULL;
+	candidate_capacity = 0;
+}
+
+void kinc_g4_texture_streamer_set_budget(size_t new_budget) {
+	budget = new_budget;
+}
+
+static int compareCandidates(const void *a, const void *b) {
+	const candidate_t *first = (const candidate_t *)a;
+	const candidate_t *second = (const candidate_t *)b;
+	if (first->seen != second->seen) {
+		return first->seen ? 1 : -1;
+	}
+	if (first->key != second->key) {
+		return first->key < second->key ? -1 : 1;
+	}
+	return 0;
+}
+
+static void applyFinishedRequests(void) {
+#ifdef KORE_HTML5
+	request_t *request = finished;
+	finished = NULL;
+#else
+	kinc_mutex_lock(&mutex);
+	request_t *request = finished;
+	finished = NULL;
+	kinc_mutex_unlock(&mutex);
+#endif
+
+	while (request != NULL) {
+		request_t *next = request->next;
+		kinc_g4_streaming_texture_t *texture = request->texture;
+		if (texture != NULL) {
+			texture->request = NULL;
+			--pending_count;
+			++completed_count;
+#if defined(KORE_LZ4X) || defined(KORE_HTML5)
+			decompressLevels(request);
+#endif
+			if (request->failed) {
+				int delay = RETRY_DELAY;
+				for (int i = 0; i < texture->failed_requests && delay < MAX_RETRY_DELAY; ++i) {
+					delay *= 2;
+				}
+				++texture->failed_requests;
+				texture->retry_frame = frame + (delay < MAX_RETRY_DELAY ? delay : MAX_RETRY_DELAY);
+				kinc_log(KINC_LOG_LEVEL_WARNING, "Could not stream level %i of %s, retrying in %i frames.", request->level, request->filename,
+				         (int)(texture->retry_frame - frame));
+			}
+			else {
+				kinc_g4_texture_destroy(&texture->texture);
+				createTexture(&texture->texture, request);
+				texture->resident_level = request->level;
+				texture->failed_requests = 0;
+			}
+		}
+		freeRequest(request);
+		request = next;
+	}
+}
+
+void kinc_g4_texture_streamer_update(void) {
+	applyFinishedRequests();
+
+	if (candidate_capacity < texture_count) {
+		candidate_capacity = texture_capacity;
+		candidates = (candidate_t *)kinc_memory_reallocate(candidates, candidate_capacity * sizeof(candidate_t), KINC_MEMORY_TAG_GRAPHICS);
+	}
+
+	// textures without feedback keep what they have, the ones which were not seen for the longest time are coarsened first
+	size_t total = 0;
+	for (int i = 0; i < texture_count; ++i) {
+		kinc_g4_streaming_texture_t *texture = textures[i];
+		candidate_t *candidate = &candidates[i];
+		candidate->texture = texture;
+		candidate->seen = texture->last_feedback_frame == frame;
+		candidate->target_level = candidate->seen ? texture->wanted_level : texture->resident_level;
+		candidate->key = candidate->seen ? texture->priority : (double)texture->last_feedback_frame;
+		total += chainBytes(texture, candidate->target_level);
+	}
+	qsort(candidates, texture_count, sizeof(candidate_t), compareCandidates);
+
+	// coarsen groups of equally important textures one level at a time until everything fits
+	for (int start = 0; start < texture_count && total > budget;) {
+		int end = start + 1;
+		while (end < texture_count && compareCandidates(&candidates[start], &candidates[end]) == 0) {
+			++end;
+		}
+		bool coarsened = true;
+		while (coarsened && total > budget) {
+			coarsened = false;
+			for (int i = start; i < end && total > budget; ++i) {
+				candidate_t *candidate = &candidates[i];
+				if (candidate->target_level < candidate->texture->base_level) {
+					kinc_g4_streaming_texture_t *texture = candidate->texture;
+					total -= levelBytes(texture->width, texture->height, texture->format, candidate->target_level);
+					++candidate->target_level;
+					coarsened = true;
+				}
+			}
+		}
+		start = end;
+	}
+
+	// coarsening frees memory and is never postponed, finer levels are requested for the most important textures first
+	for (int i = texture_count - 1; i >= 0; --i) {
+		candidate_t *candidate = &candidates[i];
+		kinc_g4_streaming_texture_t *texture = candidate->texture;
+		if (texture->request != NULL || candidate->target_level == texture->resident_level || frame < texture->retry_frame) {
+			continue;
+		}
+		if (candidate->target_level > texture->resident_level) {
+			++eviction_count;
+			requestLevel(texture, candidate->target_level);
+		}
+		else if (pending_count < MAX_PENDING_REFINEMENTS) {
+			requestLevel(texture, candidate->target_level);
+		}
+	}
+
+	++frame;
+}
+
+kinc_g4_texture_streamer_statistics_t kinc_g4_texture_streamer_get_statistics(void) {
+	kinc_g4_texture_streamer_statistics_t statistics;
+	statistics.resident_bytes = 0;
+	for (int i = 0; i < texture_count; ++i) {
+		statistics.resident_bytes += chainBytes(textures[i], textures[i]->resident_level);
+	}
+	statistics.budget = budget;
+	statistics.textures = texture_count;
+	statistics.pending_requests = pending_count;
+	statistics.completed_requests = completed_count;
+	statistics.evictions = eviction_count;
+	return statistics;
+}
+
+bool kinc_g4_streaming_texture_init(kinc_g4_streaming_texture_t *texture, const char *filename) {
+	memset(texture, 0, sizeof(*texture));
+
+	kinc_file_reader_t reader;
+	if (strlen(filename) >= sizeof(texture->filename) || !kinc_file_reader_open(&reader, filename, KINC_FILE_TYPE_ASSET)) {
+		kinc_log(KINC_LOG_LEVEL_ERROR, "Could not open %s.", filename);
+		return false;
+	}
+	strcpy(texture->filename, filename);
+
+	uint8_t header[20];
+	bool valid = kinc_file_reader_read(&reader, header, sizeof(header)) == sizeof(header) && memcmp(&header[8], "MIPS", 4) == 0;
+	if (valid) {
+		texture->width = kinc_read_s32le(&header[0]);
+		texture->height = kinc_read_s32le(&header[4]);
+		if (memcmp(&header[12], "LZ4 ", 4) == 0) {
+			texture->format = KINC_IMAGE_FORMAT_RGBA32;
+		}
+		else if (memcmp(&header[12], "LZ4F", 4) == 0) {
+			texture->format = KINC_IMAGE_FORMAT_RGBA128;
+		}
+		else {
+			valid = false;
+		}
+		texture->level_count = kinc_read_s32le(&header[16]);
+		valid = valid && texture->level_count > 0 && texture->level_count <= KINC_G4_STREAMING_TEXTURE_MAX_LEVELS &&
+		        levelSize(texture->width, texture->level_count - 1) == 1 && levelSize(texture->height, texture->level_count - 1) == 1;
+	}
+	for (int level = 0; valid && level < texture->level_count; ++level) {
+		uint8_t entry[8];
+		valid = kinc_file_reader_read(&reader, entry, sizeof(entry)) == sizeof(entry);
+		texture->level_offsets[level] = kinc_read_u32le(&entry[0]);
+		texture->level_sizes[level] = kinc_read_u32le(&entry[4]);
+	}
+	kinc_file_reader_close(&reader);
+	if (!valid) {
+		kinc_log(KINC_LOG_LEVEL_ERROR, "%s is not a mip-chained K file.", filename);
+		return false;
+	}
+
+	texture->base_level = texture->level_count - 1;
+	for (int level = 0; level < texture->level_count; ++level) {
+		if (levelSize(texture->width, level) <= KINC_G4_STREAMING_TEXTURE_BASE_SIZE && levelSize(texture->height, level) <= KINC_G4_STREAMING_TEXTURE_BASE_SIZE) {
+			texture->base_level = level;
+			break;
+		}
+	}
+
+	// the smallest levels are loaded right away so the texture can be used immediately
+	request_t request;
+	fillRequest(&request, texture, texture->base_level);
+	readLevels(&request);
+	decompressLevels(&request);
+	if (request.failed) {
+		kinc_memory_free(request.compressed);
+		kinc_memory_free(request.data);
+		kinc_log(KINC_LOG_LEVEL_ERROR, "Could not load %s.", filename);
+		return false;
+	}
+	createTexture(&texture->texture, &request);
+	kinc_memory_free(request.data);
+
+	texture->resident_level = texture->base_level;
+	texture->wanted_level = texture->base_level;
+	texture->priority = 0.0f;
+	texture->last_feedback_frame = -1;
+	texture->request = NULL;
+
+	if (texture_count == texture_capacity) {
+		texture_capacity = texture_capacity == 0 ? 64 : texture_capacity * 2;
+		textures =
+		    (kinc_g4_streaming_texture_t **)kinc_memory_reallocate(textures, texture_capacity * sizeof(kinc_g4_streaming_texture_t *), KINC_MEMORY_TAG_GRAPHICS);
+	}
+	textures[texture_count++] = texture;
+	return true;
+}
+
+void kinc_g4_streaming_texture_destroy(kinc_g4_streaming_texture_t *texture) {
+	for (int i = 0; i < texture_count; ++i) {
+		if (textures[i] == texture) {
+			textures[i] = textures[texture_count - 1];
+			--texture_count;
+			break;
+		}
+	}
+
+	request_t *request = texture->request;
+	if (request != NULL) {
+		--pending_count;
+		bool queued = false;
+#ifndef KORE_HTML5
+		kinc_mutex_lock(&mutex);
+		request_t *previous = NULL;
+		for (request_t *current = queue_first; current != NULL; previous = current, current = current->next) {
+			if (current == request) {
+				if (previous != NULL) {
+					previous->next = current->next;
+				}
+				else {
+					queue_first = current->next;
+				}
+				if (queue_last == current) {
+					queue_last = previous;
+				}
+				queued = true;
+				break;
+			}
+		}
+		// loading or finished, it is freed in the next update
+		if (!queued) {
+			request->texture = NULL;
+		}
+		kinc_mutex_unlock(&mutex);
+#else
+		request->texture = NULL;
+#endif
+		if (queued) {
+			freeRequest(request);
+		}
+		texture->request = NULL;
+	}
+
+	kinc_g4_texture_destroy(&texture->texture);
+}
+
+void kinc_g4_streaming_texture_feedback(kinc_g4_streaming_texture_t *texture, float screen_size, float priority) {
+	// the largest level which is not smaller than the texture on screen
+	int level = 0;
+	float size = (float)(texture->width > texture->height ? texture->width : texture->height);
+	while (level < texture->base_level && size * 0.5f >= screen_size) {
+		size *= 0.5f;
+		++level;
+	}
+
+	if (texture->last_feedback_frame != frame) {
+		texture->last_feedback_frame = frame;
+		texture->wanted_level = level;
+		texture->priority = priority;
+	}
+	else {
+		if (level < texture->wanted_level) {
+			texture->wanted_level = level;
+		}
+		if (priority > texture->priority) {
+			texture->priority = priority;
+		}
+	}
+}
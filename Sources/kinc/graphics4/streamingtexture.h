@@ -0,0 +1,125 @@
+#pragma once
+
+#include <kinc/global.h>
+
+#include <kinc/image.h>
+
+#include "texture.h"
+
+#include <stddef.h>
+
+/*! \file streamingtexture.h
+    \brief Provides textures which only keep the mip-levels on the GPU which are actually needed. Streaming textures are loaded from mip-chained
+   K files, starting with their smallest levels. Finer levels are loaded on a background-thread based on how large the textures are on screen
+   and coarsened again when the textures of a scene need more memory than the budget of the texture-streamer allows.
+
+   A mip-chained K file starts like every K file with the width and height of the largest level as 32 bit little-endian integers, followed by
+   the fourcc "MIPS". Then follow the fourcc of the levels ("LZ4 " for RGBA32 or "LZ4F" for RGBA128 pixels), the number of levels and for
+   every level, starting with the largest, its offset in the file and its LZ4-compressed size, all as 32 bit little-endian integers. Levels
+   halve the size of the previous level, rounded down but at least 1, and the chain has to go down to 1x1. kinc_image_init_from_file loads the
+   largest level of these files.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KINC_G4_STREAMING_TEXTURE_MAX_LEVELS 16
+// the largest width or height of the levels which are always resident
+#define KINC_G4_STREAMING_TEXTURE_BASE_SIZE 64
+
+struct kinc_g4_internal_streaming_request;
+
+typedef struct kinc_g4_streaming_texture {
+	// the texture to render with, it is recreated at a different size when the resident levels change
+	kinc_g4_texture_t texture;
+	char filename[256];
+	// the size of the largest level
+	int width;
+	int height;
+	kinc_image_format_t format;
+	int level_count;
+	uint32_t level_offsets[KINC_G4_STREAMING_TEXTURE_MAX_LEVELS];
+	uint32_t level_sizes[KINC_G4_STREAMING_TEXTURE_MAX_LEVELS];
+	// the coarsest level which is loaded when the texture is initialized and never evicted
+	int base_level;
+	// the largest level which is on the GPU
+	int resident_level;
+	// the largest level the feedback of the current frame asked for and the priority which came with it
+	int wanted_level;
+	float priority;
+	int64_t last_feedback_frame;
+	struct kinc_g4_internal_streaming_request *request;
+	// loads which failed in a row, no further load is requested before retry_frame
+	int failed_requests;
+	int64_t retry_frame;
+} kinc_g4_streaming_texture_t;
+
+typedef struct kinc_g4_texture_streamer_statistics {
+	// the memory used by the resident levels of all streaming textures in bytes
+	size_t resident_bytes;
+	size_t budget;
+	int textures;
+	// loads which were requested and are not yet on the GPU
+	int pending_requests;
+	// loads which were finished, including the ones which coarsened a texture
+	int completed_requests;
+	// the number of times a texture was coarsened to stay within the budget
+	int evictions;
+} kinc_g4_texture_streamer_statistics_t;
+
+/// <summary>
+/// Starts the texture-streamer and its loader-thread. Has to be called before the first streaming texture is initialized.
+/// </summary>
+/// <param name="budget">The memory all streaming textures together may use on the GPU in bytes</param>
+KINC_FUNC void kinc_g4_texture_streamer_init(size_t budget);
+
+/// <summary>
+/// Stops the texture-streamer. All streaming textures have to be destroyed before.
+/// </summary>
+KINC_FUNC void kinc_g4_texture_streamer_destroy(void);
+
+/// <summary>
+/// Changes the memory all streaming textures together may use on the GPU. Textures are coarsened during the next updates when necessary.
+/// </summary>
+/// <param name="budget">The budget in bytes</param>
+KINC_FUNC void kinc_g4_texture_streamer_set_budget(size_t budget);
+
+/// <summary>
+/// Uploads finished loads, decides which levels the textures should have based on the feedback of the current frame and the budget and
+/// requests the necessary loads. Call this once per frame after the feedback was given and before rendering with streaming textures.
+/// </summary>
+KINC_FUNC void kinc_g4_texture_streamer_update(void);
+
+/// <summary>
+/// Returns how much memory the streaming textures use and how many loads are pending.
+/// </summary>
+KINC_FUNC kinc_g4_texture_streamer_statistics_t kinc_g4_texture_streamer_get_statistics(void);
+
+/// <summary>
+/// Initializes a streaming texture from a mip-chained K file and loads all levels which are at most KINC_G4_STREAMING_TEXTURE_BASE_SIZE
+/// pixels large right away.
+/// </summary>
+/// <param name="texture">The texture to initialize</param>
+/// <param name="filename">The mip-chained K file</param>
+/// <returns>Whether the file could be loaded</returns>
+KINC_FUNC bool kinc_g4_streaming_texture_init(kinc_g4_streaming_texture_t *texture, const char *filename);
+
+/// <summary>
+/// Destroys a streaming texture and cancels its pending loads.
+/// </summary>
+KINC_FUNC void kinc_g4_streaming_texture_destroy(kinc_g4_streaming_texture_t *texture);
+
+/// <summary>
+/// Tells the texture-streamer how a texture is used in the current frame. Can be called several times per frame, for example once per object
+/// which uses the texture - the largest screen-size and priority are used. Textures which get no feedback in a frame are coarsened first when
+/// the budget is exceeded.
+/// </summary>
+/// <param name="texture">The texture</param>
+/// <param name="screen_size">The number of pixels the larger side of the texture covers on screen</param>
+/// <param name="priority">Textures with a higher priority keep their levels longer when the budget is exceeded</param>
+KINC_FUNC void kinc_g4_streaming_texture_feedback(kinc_g4_streaming_texture_t *texture, float screen_size, float priority);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,199 @@
+#include "vertexpacking.h"
+
+#include <kinc/math/core.h>
+#include <kinc/simd/float32x4.h>
+#include <kinc/simd/int32x4.h>
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#elif defined(KINC_NEON64)
+#include <arm_neon.h>
+#endif
+
+// Rounds to nearest even and handles denormals, infinity and NaN like the hardware-conversions do.
+uint16_t kinc_g4_float_to_half(float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = (bits >> 16) & 0x8000;
+	bits &= 0x7fffffff;
+
+	uint16_t half;
+	if (bits >= (143u << 23)) {
+		// too large for a half or already infinity/NaN
+		half = bits > (255u << 23) ? 0x7e00 : 0x7c00;
+	}
+	else if (bits < (113u << 23)) {
+		// becomes a denormal or zero, adding 0.5 lets the FPU do the rounding
+		float magnitude;
+		memcpy(&magnitude, &bits, sizeof(magnitude));
+		magnitude += 0.5f;
+		uint32_t rounded;
+		memcpy(&rounded, &magnitude, sizeof(rounded));
+		half = (uint16_t)(rounded - 0x3f000000);
+	}
+	else {
+		uint32_t odd = (bits >> 13) & 1;
+		bits += ((uint32_t)(15 - 127) << 23) + 0xfff + odd;
+		half = (uint16_t)(bits >> 13);
+	}
+	return (uint16_t)(half | sign);
+}
+
+float kinc_g4_half_to_float(uint16_t value) {
+	const uint32_t exponent_mask = 0x7c00u << 13;
+	uint32_t bits = (value & 0x7fffu) << 13;
+	uint32_t exponent = bits & exponent_mask;
+	bits += (uint32_t)(127 - 15) << 23;
+	if (exponent == exponent_mask) {
+		// infinity or NaN
+		bits += (uint32_t)(128 - 16) << 23;
+	}
+	else if (exponent == 0) {
+		// zero or denormal, renormalized by the FPU
+		const uint32_t magic_bits = 113u << 23;
+		float magic;
+		memcpy(&magic, &magic_bits, sizeof(magic));
+		bits += 1u << 23;
+		float renormalized;
+		memcpy(&renormalized, &bits, sizeof(renormalized));
+		renormalized -= magic;
+		memcpy(&bits, &renormalized, sizeof(bits));
+	}
+	bits |= (uint32_t)(value & 0x8000u) << 16;
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void kinc_g4_pack_halfs(uint16_t *destination, const float *source, int count) {
+	int i = 0;
+#if defined(__F16C__)
+	for (; i + 8 <= count; i += 8) {
+		__m256 values = _mm256_loadu_ps(&source[i]);
+		_mm_storeu_si128((__m128i *)&destination[i], _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+	}
+	for (; i + 4 <= count; i += 4) {
+		__m128 values = _mm_loadu_ps(&source[i]);
+		_mm_storel_epi64((__m128i *)&destination[i], _mm_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+	}
+#elif defined(KINC_NEON64)
+	for (; i + 4 <= count; i += 4) {
+		vst1_u16(&destination[i], vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(&source[i]))));
+	}
+#endif
+	for (; i < count; ++i) {
+		destination[i] = kinc_g4_float_to_half(source[i]);
+	}
+}
+
+// Rounds to nearest even like kinc_int32x4_from_float32x4 does, so the SIMD-loops and their scalar tails produce the same values.
+static uint32_t quantize(float value, float min, float max, float scale) {
+	value = value < min ? min : (value > max ? max : value);
+	return (uint32_t)(int32_t)lrintf(value * scale);
+}
+
+uint32_t kinc_g4_pack_byte4_norm(float x, float y, float z, float w) {
+	return (quantize(x, -1.0f, 1.0f, 127.0f) & 0xff) | ((quantize(y, -1.0f, 1.0f, 127.0f) & 0xff) << 8) |
+	       ((quantize(z, -1.0f, 1.0f, 127.0f) & 0xff) << 16) | ((quantize(w, -1.0f, 1.0f, 127.0f) & 0xff) << 24);
+}
+
+uint32_t kinc_g4_pack_byte4_unorm(float x, float y, float z, float w) {
+	return quantize(x, 0.0f, 1.0f, 255.0f) | (quantize(y, 0.0f, 1.0f, 255.0f) << 8) | (quantize(z, 0.0f, 1.0f, 255.0f) << 16) |
+	       (quantize(w, 0.0f, 1.0f, 255.0f) << 24);
+}
+
+uint32_t kinc_g4_pack_uint10_10_10_2(float x, float y, float z, float w) {
+	return quantize(x, 0.0f, 1.0f, 1023.0f) | (quantize(y, 0.0f, 1.0f, 1023.0f) << 10) | (quantize(z, 0.0f, 1.0f, 1023.0f) << 20) |
+	       (quantize(w, 0.0f, 1.0f, 3.0f) << 30);
+}
+
+static float sign_not_zero(float value) {
+	return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+static float absolute(float value) {
+	return value < 0.0f ? -value : value;
+}
+
+void kinc_g4_octahedral_encode(float x, float y, float z, float *u, float *v) {
+	float length = absolute(x) + absolute(y) + absolute(z);
+	// a zero vector has no direction, it is encoded like (0, 0, 1) instead of dividing by zero
+	if (length > 0.0f) {
+		x /= length;
+		y /= length;
+	}
+	if (z < 0.0f) {
+		// the lower hemisphere is folded over the diagonals
+		float folded_x = (1.0f - absolute(y)) * sign_not_zero(x);
+		float folded_y = (1.0f - absolute(x)) * sign_not_zero(y);
+		x = folded_x;
+		y = folded_y;
+	}
+	*u = x;
+	*v = y;
+}
+
+void kinc_g4_octahedral_decode(float u, float v, float *x, float *y, float *z) {
+	float nz = 1.0f - absolute(u) - absolute(v);
+	float t = nz < 0.0f ? -nz : 0.0f;
+	float nx = u + (u >= 0.0f ? -t : t);
+	float ny = v + (v >= 0.0f ? -t : t);
+	float length = kinc_sqrt(nx * nx + ny * ny + nz * nz);
+	float scale = length > 0.0f ? 1.0f / length : 1.0f;
+	*x = nx * scale;
+	*y = ny * scale;
+	*z = nz * scale;
+}
+
+static void store_normal(void *destination, int destination_stride, int index, int32_t u, int32_t v) {
+	int16_t *target = (int16_t *)((uint8_t *)destination + (size_t)index * destination_stride);
+	target[0] = (int16_t)u;
+	target[1] = (int16_t)v;
+}
+
+void kinc_g4_pack_normals_octahedral(void *destination, int destination_stride, const float *normals, int count) {
+	const kinc_float32x4_t zero = kinc_float32x4_load_all(0.0f);
+	const kinc_float32x4_t one = kinc_float32x4_load_all(1.0f);
+	const kinc_float32x4_t minus_one = kinc_float32x4_load_all(-1.0f);
+	const kinc_float32x4_t scale = kinc_float32x4_load_all(32767.0f);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const float *n = &normals[i * 3];
+		kinc_float32x4_t x = kinc_float32x4_load(n[0], n[3], n[6], n[9]);
+		kinc_float32x4_t y = kinc_float32x4_load(n[1], n[4], n[7], n[10]);
+		kinc_float32x4_t z = kinc_float32x4_load(n[2], n[5], n[8], n[11]);
+
+		kinc_float32x4_t length = kinc_float32x4_add(kinc_float32x4_add(kinc_float32x4_abs(x), kinc_float32x4_abs(y)), kinc_float32x4_abs(z));
+		length = kinc_float32x4_sel(one, length, kinc_float32x4_cmpeq(length, zero));
+		x = kinc_float32x4_div(x, length);
+		y = kinc_float32x4_div(y, length);
+
+		kinc_float32x4_t sign_x = kinc_float32x4_sel(one, minus_one, kinc_float32x4_cmpge(x, zero));
+		kinc_float32x4_t sign_y = kinc_float32x4_sel(one, minus_one, kinc_float32x4_cmpge(y, zero));
+		kinc_float32x4_t folded_x = kinc_float32x4_mul(kinc_float32x4_sub(one, kinc_float32x4_abs(y)), sign_x);
+		kinc_float32x4_t folded_y = kinc_float32x4_mul(kinc_float32x4_sub(one, kinc_float32x4_abs(x)), sign_y);
+		kinc_float32x4_mask_t lower = kinc_float32x4_cmplt(z, zero);
+		x = kinc_float32x4_sel(folded_x, x, lower);
+		y = kinc_float32x4_sel(folded_y, y, lower);
+
+		x = kinc_float32x4_min(kinc_float32x4_max(x, minus_one), one);
+		y = kinc_float32x4_min(kinc_float32x4_max(y, minus_one), one);
+		kinc_int32x4_t u = kinc_int32x4_from_float32x4(kinc_float32x4_mul(x, scale));
+		kinc_int32x4_t v = kinc_int32x4_from_float32x4(kinc_float32x4_mul(y, scale));
+		int32_t us[4], vs[4];
+		kinc_int32x4_store_unaligned(us, u);
+		kinc_int32x4_store_unaligned(vs, v);
+		for (int lane = 0; lane < 4; ++lane) {
+			store_normal(destination, destination_stride, i + lane, us[lane], vs[lane]);
+		}
+	}
+	for (; i < count; ++i) {
+		float u, v;
+		kinc_g4_octahedral_encode(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2], &u, &v);
+		store_normal(destination, destination_stride, i, (int32_t)quantize(u, -1.0f, 1.0f, 32767.0f), (int32_t)quantize(v, -1.0f, 1.0f, 32767.0f));
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <kinc/global.h>
+
+#include <stdint.h>
+
+/*! \file vertexpacking.h
+    \brief Converts floats into the compact vertex-formats of kinc_g4_vertex_data_t so vertex-buffers can be filled without hand-written bit-twiddling.
+   Half-floats use F16C or Neon when the compiler targets it, octahedral normals are encoded four at a time using kinc_float32x4.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// <summary>
+/// Converts a float to a 16 bit float, rounding to the nearest value. Values which are too large become infinity.
+/// </summary>
+/// <param name="value">The value to convert</param>
+/// <returns>The bits of the half-float</returns>
+KINC_FUNC uint16_t kinc_g4_float_to_half(float value);
+
+/// <summary>
+/// Converts a 16 bit float to a float.
+/// </summary>
+/// <param name="value">The bits of the half-float</param>
+/// <returns>The converted value</returns>
+KINC_FUNC float kinc_g4_half_to_float(uint16_t value);
+
+/// <summary>
+/// Converts an array of floats to half-floats, for example to fill HALF2 or HALF4 elements.
+/// </summary>
+/// <param name="destination">Receives count half-floats</param>
+/// <param name="source">The floats to convert</param>
+/// <param name="count">The number of values to convert</param>
+KINC_FUNC void kinc_g4_pack_halfs(uint16_t *destination, const float *source, int count);
+
+/// <summary>
+/// Packs four values in [-1, 1] into a BYTE4_NORM element.
+/// </summary>
+/// <returns>The packed element, x in the lowest byte</returns>
+KINC_FUNC uint32_t kinc_g4_pack_byte4_norm(float x, float y, float z, float w);
+
+/// <summary>
+/// Packs four values in [0, 1] into a BYTE4_UNORM element.
+/// </summary>
+/// <returns>The packed element, x in the lowest byte</returns>
+KINC_FUNC uint32_t kinc_g4_pack_byte4_unorm(float x, float y, float z, float w);
+
+/// <summary>
+/// Packs four values in [0, 1] into a UINT10_10_10_2 element. Signed data like tangents can be stored as value * 0.5 + 0.5.
+/// </summary>
+/// <returns>The packed element, x in the lowest bits</returns>
+KINC_FUNC uint32_t kinc_g4_pack_uint10_10_10_2(float x, float y, float z, float w);
+
+/// <summary>
+/// Encodes a normalized direction as two values in [-1, 1] by projecting it onto an octahedron. Decoding it in a shader costs a handful of
+/// instructions and the error is far lower than when quantizing x, y and z separately. A zero vector is encoded like (0, 0, 1).
+/// </summary>
+/// <param name="x">The x-component of the direction</param>
+/// <param name="y">The y-component of the direction</param>
+/// <param name="z">The z-component of the direction</param>
+/// <param name="u">Receives the first encoded value</param>
+/// <param name="v">Receives the second encoded value</param>
+KINC_FUNC void kinc_g4_octahedral_encode(float x, float y, float z, float *u, float *v);
+
+/// <summary>
+/// Decodes a direction which was encoded using kinc_g4_octahedral_encode.
+/// </summary>
+KINC_FUNC void kinc_g4_octahedral_decode(float u, float v, float *x, float *y, float *z);
+
+/// <summary>
+/// Encodes an array of normals into SHORT2_NORM elements which can be written straight into a locked vertex-buffer.
+/// </summary>
+/// <param name="destination">Receives two 16 bit values per normal</param>
+/// <param name="destination_stride">The distance between two encoded normals in bytes, for example the vertex-buffer's stride</param>
+/// <param name="normals">Tightly packed x, y and z components of normalized directions</param>
+/// <param name="count">The number of normals</param>
+KINC_FUNC void kinc_g4_pack_normals_octahedral(void *destination, int destination_stride, const float *normals, int count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -21,7 +21,19 @@ typedef enum kinc_g4_vertex_data {
 	KINC_G4_VERTEX_DATA_FLOAT4X4,
 	KINC_G4_VERTEX_DATA_SHORT2_NORM,
 	KINC_G4_VERTEX_DATA_SHORT4_NORM,
-	KINC_G4_VERTEX_DATA_COLOR
+	KINC_G4_VERTEX_DATA_COLOR,
+	// 16 bit floats, see kinc_g4_pack_halfs
+	KINC_G4_VERTEX_DATA_HALF2,
+	KINC_G4_VERTEX_DATA_HALF4,
+	// signed bytes which are mapped to [-1, 1]
+	KINC_G4_VERTEX_DATA_BYTE4_NORM,
+	// unsigned bytes which are mapped to [0, 1], unlike COLOR always in RGBA-order
+	KINC_G4_VERTEX_DATA_BYTE4_UNORM,
+	// three 10 bit and one 2 bit unsigned values in a 32 bit word (x in the lowest bits), mapped to [0, 1]
+	KINC_G4_VERTEX_DATA_UINT10_10_10_2,
+	// signed 16 bit integers which arrive as integers in the shader (as floats in Direct3D 9), useful for bone-indices
+	KINC_G4_VERTEX_DATA_SHORT2,
+	KINC_G4_VERTEX_DATA_SHORT4
 } kinc_g4_vertex_data_t;
 
 typedef struct kinc_g4_vertex_element {
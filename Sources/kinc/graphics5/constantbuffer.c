@@ -1,5 +1,23 @@
 #include "constantbuffer.h"
 
+#include "pipeline.h"
+
+#include <kinc/error.h>
+#include <kinc/simd/float32x4.h>
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void markDirty(kinc_g5_constant_buffer_t *buffer, int offset, int size) {
+	if (offset < buffer->dirty_start) {
+		buffer->dirty_start = offset;
+	}
+	if (offset + size > buffer->dirty_end) {
+		buffer->dirty_end = offset + size;
+	}
+}
+
 static void setInt(uint8_t *constants, int offset, int value) {
 	int *ints = (int *)(&constants[offset]);
 	ints[0] = value;
@@ -43,70 +61,261 @@ static void setBool(uint8_t *constants, int offset, bool value) {
 	ints[0] = value ? 1 : 0;
 }
 
+// Writes the transpose of value.
 static void setMatrix4(uint8_t *constants, int offset, kinc_matrix4x4_t *value) {
 	float *floats = (float *)(&constants[offset]);
-	for (int y = 0; y < 4; ++y) {
-		for (int x = 0; x < 4; ++x) {
-			floats[x + y * 4] = kinc_matrix4x4_get(value, x, y);
-		}
-	}
+	kinc_float32x4_t a = kinc_float32x4_load_unaligned(&value->m[0]);
+	kinc_float32x4_t b = kinc_float32x4_load_unaligned(&value->m[4]);
+	kinc_float32x4_t c = kinc_float32x4_load_unaligned(&value->m[8]);
+	kinc_float32x4_t d = kinc_float32x4_load_unaligned(&value->m[12]);
+	kinc_float32x4_transpose(&a, &b, &c, &d);
+	kinc_float32x4_store_unaligned(&floats[0], a);
+	kinc_float32x4_store_unaligned(&floats[4], b);
+	kinc_float32x4_store_unaligned(&floats[8], c);
+	kinc_float32x4_store_unaligned(&floats[12], d);
 }
 
+// Writes the transpose of value with every row padded to four floats. The padding after the last row is left alone because HLSL packs
+// following scalars into it.
 static void setMatrix3(uint8_t *constants, int offset, kinc_matrix3x3_t *value) {
 	float *floats = (float *)(&constants[offset]);
-	for (int y = 0; y < 3; ++y) {
-		for (int x = 0; x < 3; ++x) {
-			floats[x + y * 4] = kinc_matrix3x3_get(value, x, y);
-		}
+	kinc_float32x4_t a = kinc_float32x4_load_unaligned(&value->m[0]);
+	kinc_float32x4_t b = kinc_float32x4_load_unaligned(&value->m[3]);
+	// loading four floats at m[6] would read past the end of the matrix
+	kinc_float32x4_t c = kinc_float32x4_load(value->m[6], value->m[7], value->m[8], 0.0f);
+	kinc_float32x4_t d = kinc_float32x4_load_all(0.0f);
+	kinc_float32x4_transpose(&a, &b, &c, &d);
+	kinc_float32x4_store_unaligned(&floats[0], a);
+	kinc_float32x4_store_unaligned(&floats[4], b);
+	floats[8] = kinc_float32x4_get(c, 0);
+	floats[9] = kinc_float32x4_get(c, 1);
+	floats[10] = kinc_float32x4_get(c, 2);
+}
+
+// Writes value with every column starting at a multiple of four floats.
+static void setMatrix3Columns(uint8_t *constants, int offset, kinc_matrix3x3_t *value) {
+	float *floats = (float *)(&constants[offset]);
+	for (int x = 0; x < 3; ++x) {
+		floats[x * 4 + 0] = value->m[x * 3 + 0];
+		floats[x * 4 + 1] = value->m[x * 3 + 1];
+		floats[x * 4 + 2] = value->m[x * 3 + 2];
 	}
 }
 
 void kinc_g5_constant_buffer_set_int(kinc_g5_constant_buffer_t *buffer, int offset, int value) {
 	setInt(buffer->data, offset, value);
+	markDirty(buffer, offset, 4);
 }
 
 void kinc_g5_constant_buffer_set_float(kinc_g5_constant_buffer_t *buffer, int offset, float value) {
 	setFloat(buffer->data, offset, value);
+	markDirty(buffer, offset, 4);
 }
 
 void kinc_g5_constant_buffer_set_float2(kinc_g5_constant_buffer_t *buffer, int offset, float value1, float value2) {
 	setFloat2(buffer->data, offset, value1, value2);
+	markDirty(buffer, offset, 8);
 }
 
 void kinc_g5_constant_buffer_set_float3(kinc_g5_constant_buffer_t *buffer, int offset, float value1, float value2, float value3) {
 	setFloat3(buffer->data, offset, value1, value2, value3);
+	markDirty(buffer, offset, 12);
 }
 
 void kinc_g5_constant_buffer_set_float4(kinc_g5_constant_buffer_t *buffer, int offset, float value1, float value2, float value3, float value4) {
 	setFloat4(buffer->data, offset, value1, value2, value3, value4);
+	markDirty(buffer, offset, 16);
 }
 
 void kinc_g5_constant_buffer_set_floats(kinc_g5_constant_buffer_t *buffer, int offset, float *values, int count) {
 	setFloats(buffer->data, offset, values, count);
+	markDirty(buffer, offset, count * 4);
 }
 
 void kinc_g5_constant_buffer_set_bool(kinc_g5_constant_buffer_t *buffer, int offset, bool value) {
 	setBool(buffer->data, offset, value);
+	markDirty(buffer, offset, 4);
 }
 
 void kinc_g5_constant_buffer_set_matrix4(kinc_g5_constant_buffer_t *buffer, int offset, kinc_matrix4x4_t *value) {
 	if (kinc_g5_transposeMat4) {
-		kinc_matrix4x4_t m = *value;
-		kinc_matrix4x4_transpose(&m);
-		setMatrix4(buffer->data, offset, &m);
+		memcpy(&buffer->data[offset], value->m, sizeof(value->m));
 	}
 	else {
 		setMatrix4(buffer->data, offset, value);
 	}
+	markDirty(buffer, offset, sizeof(value->m));
 }
 
 void kinc_g5_constant_buffer_set_matrix3(kinc_g5_constant_buffer_t *buffer, int offset, kinc_matrix3x3_t *value) {
 	if (kinc_g5_transposeMat3) {
-		kinc_matrix3x3_t m = *value;
-		kinc_matrix3x3_transpose(&m);
-		setMatrix3(buffer->data, offset, &m);
+		setMatrix3Columns(buffer->data, offset, value);
 	}
 	else {
 		setMatrix3(buffer->data, offset, value);
 	}
+	markDirty(buffer, offset, 11 * sizeof(float));
+}
+
+void kinc_g5_constant_buffer_set_matrices4(kinc_g5_constant_buffer_t *buffer, int offset, kinc_matrix4x4_t *values, int count) {
+	if (kinc_g5_transposeMat4) {
+		memcpy(&buffer->data[offset], values, count * sizeof(values->m));
+	}
+	else {
+		for (int i = 0; i < count; ++i) {
+			setMatrix4(buffer->data, offset + i * (int)sizeof(values->m), &values[i]);
+		}
+	}
+	markDirty(buffer, offset, count * sizeof(values->m));
+}
+
+void kinc_g5_constant_buffer_mark_dirty(kinc_g5_constant_buffer_t *buffer, int offset, int size) {
+	markDirty(buffer, offset, size);
+}
+
+void kinc_g5_internal_constant_buffer_reset_dirty(kinc_g5_constant_buffer_t *buffer) {
+	buffer->dirty_start = INT_MAX;
+	buffer->dirty_end = 0;
+}
+
+void kinc_g5_internal_constant_buffer_get_dirty_range(kinc_g5_constant_buffer_t *buffer, int count, int *start, int *end) {
+	if (buffer->dirty_end <= buffer->dirty_start) {
+		*start = 0;
+		*end = count;
+	}
+	else {
+		*start = buffer->dirty_start < 0 ? 0 : buffer->dirty_start;
+		*end = buffer->dirty_end > count ? count : buffer->dirty_end;
+	}
+}
+
+static int elementSize(kinc_g5_constant_type_t type) {
+	switch (type) {
+	case KINC_G5_CONSTANT_TYPE_FLOAT2:
+		return 2 * sizeof(float);
+	case KINC_G5_CONSTANT_TYPE_FLOAT3:
+		return 3 * sizeof(float);
+	case KINC_G5_CONSTANT_TYPE_FLOAT4:
+		return 4 * sizeof(float);
+	case KINC_G5_CONSTANT_TYPE_MATRIX3:
+		return 12 * sizeof(float);
+	case KINC_G5_CONSTANT_TYPE_MATRIX4:
+		return 16 * sizeof(float);
+	default:
+		return 4;
+	}
+}
+
+static int stageOffset(kinc_g5_constant_location_t *location, kinc_g5_shader_type_t stage) {
+#ifdef KORE_G5ONG4
+	return -1;
+#else
+	switch (stage) {
+	case KINC_G5_SHADER_TYPE_VERTEX:
+		return location->impl.vertexOffset;
+	case KINC_G5_SHADER_TYPE_FRAGMENT:
+		return location->impl.fragmentOffset;
+#ifdef KORE_DIRECT3D12
+	case KINC_G5_SHADER_TYPE_GEOMETRY:
+		return location->impl.geometryOffset;
+	case KINC_G5_SHADER_TYPE_TESSELLATION_CONTROL:
+		return location->impl.tessControlOffset;
+	case KINC_G5_SHADER_TYPE_TESSELLATION_EVALUATION:
+		return location->impl.tessEvalOffset;
+#endif
+	default:
+		return -1;
+	}
+#endif
+}
+
+static int compareOffsets(const void *a, const void *b) {
+	return ((const int *)a)[0] - ((const int *)b)[0];
+}
+
+void kinc_g5_constant_layout_init(kinc_g5_constant_layout_t *layout, struct kinc_g5_pipeline *pipeline, kinc_g5_shader_type_t stage,
+                                  const kinc_g5_constant_layout_element_t *elements, int count) {
+	kinc_affirm_message(count <= KINC_G5_CONSTANT_LAYOUT_MAX_ELEMENTS, "Too many elements in constant-layout");
+
+	// pairs of offsets and element-indices, sorted so the struct is written front to back
+	int found[KINC_G5_CONSTANT_LAYOUT_MAX_ELEMENTS][2];
+	int found_count = 0;
+	for (int i = 0; i < count; ++i) {
+		kinc_g5_constant_type_t type = elements[i].type;
+		kinc_affirm_message(elements[i].count <= 1 || type == KINC_G5_CONSTANT_TYPE_FLOAT4 || type == KINC_G5_CONSTANT_TYPE_MATRIX3 ||
+		                        type == KINC_G5_CONSTANT_TYPE_MATRIX4,
+		                    "Constant-arrays are only supported for float4, matrix3 and matrix4");
+		kinc_g5_constant_location_t location = kinc_g5_pipeline_get_constant_location(pipeline, elements[i].name);
+		int offset = stageOffset(&location, stage);
+		if (offset >= 0) {
+			found[found_count][0] = offset;
+			found[found_count][1] = i;
+			++found_count;
+		}
+	}
+	qsort(found, found_count, sizeof(found[0]), compareOffsets);
+
+	layout->count = found_count;
+	layout->start = 0;
+	layout->end = 0;
+	for (int i = 0; i < found_count; ++i) {
+		const kinc_g5_constant_layout_element_t *element = &elements[found[i][1]];
+		int offset = found[i][0];
+		int array_count = element->count > 1 ? element->count : 1;
+		int end = offset + array_count * elementSize(element->type);
+		layout->elements[i] = *element;
+		layout->offsets[i] = offset;
+		if (i == 0 || offset < layout->start) {
+			layout->start = offset;
+		}
+		if (end > layout->end) {
+			layout->end = end;
+		}
+	}
+}
+
+void kinc_g5_constant_buffer_set_struct(kinc_g5_constant_buffer_t *buffer, const kinc_g5_constant_layout_t *layout, const void *data) {
+	const uint8_t *source = (const uint8_t *)data;
+	for (int i = 0; i < layout->count; ++i) {
+		const kinc_g5_constant_layout_element_t *element = &layout->elements[i];
+		const uint8_t *value = &source[element->struct_offset];
+		int offset = layout->offsets[i];
+		int array_count = element->count > 1 ? element->count : 1;
+		switch (element->type) {
+		case KINC_G5_CONSTANT_TYPE_BOOL:
+			setBool(buffer->data, offset, *(const bool *)value);
+			break;
+		case KINC_G5_CONSTANT_TYPE_INT:
+		case KINC_G5_CONSTANT_TYPE_FLOAT:
+		case KINC_G5_CONSTANT_TYPE_FLOAT2:
+		case KINC_G5_CONSTANT_TYPE_FLOAT3:
+		case KINC_G5_CONSTANT_TYPE_FLOAT4:
+			memcpy(&buffer->data[offset], value, array_count * elementSize(element->type));
+			break;
+		case KINC_G5_CONSTANT_TYPE_MATRIX3:
+			for (int j = 0; j < array_count; ++j) {
+				kinc_matrix3x3_t *matrix = &((kinc_matrix3x3_t *)value)[j];
+				if (kinc_g5_transposeMat3) {
+					setMatrix3Columns(buffer->data, offset + j * 12 * sizeof(float), matrix);
+				}
+				else {
+					setMatrix3(buffer->data, offset + j * 12 * sizeof(float), matrix);
+				}
+			}
+			break;
+		case KINC_G5_CONSTANT_TYPE_MATRIX4:
+			if (kinc_g5_transposeMat4) {
+				memcpy(&buffer->data[offset], value, array_count * sizeof(kinc_matrix4x4_t));
+			}
+			else {
+				for (int j = 0; j < array_count; ++j) {
+					setMatrix4(buffer->data, offset + j * sizeof(kinc_matrix4x4_t), &((kinc_matrix4x4_t *)value)[j]);
+				}
+			}
+			break;
+		}
+	}
+	if (layout->count > 0) {
+		markDirty(buffer, layout->start, layout->end - layout->start);
+	}
 }
@@ -7,8 +7,12 @@
 #include <kinc/math/matrix.h>
 #include <kinc/math/vector.h>
 
+#include "shader.h"
+
 /*! \file constantbuffer.h
-    \brief Provides support for managing buffers of constant-data for shaders.
+    \brief Provides support for managing buffers of constant-data for shaders. Constant-layouts look up the offsets of a whole block of
+   constants in a pipeline once so a struct can be written with a single call. The bytes which are written are tracked so unlocking only
+   uploads the modified part of a buffer.
 */
 
 #ifdef __cplusplus
@@ -17,9 +21,49 @@ extern "C" {
 
 typedef struct kinc_g5_constant_buffer {
 	uint8_t *data;
+	// the range of bytes written since the last lock, relative to the start of the lock, empty when dirty_end <= dirty_start
+	int dirty_start;
+	int dirty_end;
 	ConstantBuffer5Impl impl;
 } kinc_g5_constant_buffer_t;
 
+typedef enum kinc_g5_constant_type {
+	KINC_G5_CONSTANT_TYPE_BOOL,
+	KINC_G5_CONSTANT_TYPE_INT,
+	KINC_G5_CONSTANT_TYPE_FLOAT,
+	KINC_G5_CONSTANT_TYPE_FLOAT2,
+	KINC_G5_CONSTANT_TYPE_FLOAT3,
+	KINC_G5_CONSTANT_TYPE_FLOAT4,
+	KINC_G5_CONSTANT_TYPE_MATRIX3,
+	KINC_G5_CONSTANT_TYPE_MATRIX4
+} kinc_g5_constant_type_t;
+
+typedef struct kinc_g5_constant_layout_element {
+	// the name of the constant/uniform in the shader
+	const char *name;
+	kinc_g5_constant_type_t type;
+	// the number of array-elements, 0 or 1 for single values - arrays are only supported for float4, matrix3 and matrix4 which use the same
+	// array-stride on all backends
+	int count;
+	// the offset of the value in the struct which is passed to kinc_g5_constant_buffer_set_struct in bytes, bools are read as bools,
+	// matrices as kinc_matrix3x3_t and kinc_matrix4x4_t
+	int struct_offset;
+} kinc_g5_constant_layout_element_t;
+
+#define KINC_G5_CONSTANT_LAYOUT_MAX_ELEMENTS 32
+
+typedef struct kinc_g5_constant_layout {
+	// the elements which were found in the shader, sorted by their offsets in the constant-buffer
+	kinc_g5_constant_layout_element_t elements[KINC_G5_CONSTANT_LAYOUT_MAX_ELEMENTS];
+	int offsets[KINC_G5_CONSTANT_LAYOUT_MAX_ELEMENTS];
+	int count;
+	// the range of bytes in the constant-buffer which is covered by the elements
+	int start;
+	int end;
+} kinc_g5_constant_layout_t;
+
+struct kinc_g5_pipeline;
+
 /// <summary>
 /// Initializes a constant-buffer.
 /// </summary>
@@ -55,6 +99,15 @@ KINC_FUNC void kinc_g5_constant_buffer_lock(kinc_g5_constant_buffer_t *buffer, i
 /// <param name="buffer">The buffer to unlock</param>
 KINC_FUNC void kinc_g5_constant_buffer_unlock(kinc_g5_constant_buffer_t *buffer);
 
+/// <summary>
+/// Marks bytes as modified which were written to the data of a locked constant-buffer directly instead of using the setters. When nothing
+/// was marked or set since the buffer was locked, unlocking uploads everything that was locked.
+/// </summary>
+/// <param name="buffer">The locked buffer</param>
+/// <param name="offset">The offset of the modified bytes relative to the start of the lock</param>
+/// <param name="size">The number of modified bytes</param>
+KINC_FUNC void kinc_g5_constant_buffer_mark_dirty(kinc_g5_constant_buffer_t *buffer, int offset, int size);
+
 /// <summary>
 /// Figures out the size of the constant-data in the buffer.
 /// </summary>
@@ -132,6 +185,38 @@ KINC_FUNC void kinc_g5_constant_buffer_set_matrix3(kinc_g5_constant_buffer_t *bu
 /// <param name="value">The value to write into the buffer</param>
 KINC_FUNC void kinc_g5_constant_buffer_set_matrix4(kinc_g5_constant_buffer_t *buffer, int offset, kinc_matrix4x4_t *value);
 
+/// <summary>
+/// Assigns an array of 4x4-matrices at an offset in a constant-buffer.
+/// </summary>
+/// <param name="offset">The offset at which to write the data</param>
+/// <param name="values">The matrices to write into the buffer</param>
+/// <param name="count">The number of matrices</param>
+KINC_FUNC void kinc_g5_constant_buffer_set_matrices4(kinc_g5_constant_buffer_t *buffer, int offset, kinc_matrix4x4_t *values, int count);
+
+/// <summary>
+/// Looks up the offsets of a block of constants in one shader-stage of a compiled pipeline. Elements which are not used by that stage are
+/// left out of the layout. On G5onG4 constant-buffers are not supported and layouts stay empty.
+/// </summary>
+/// <param name="layout">The layout to initialize</param>
+/// <param name="pipeline">The pipeline to look up the constants in</param>
+/// <param name="stage">The shader-stage whose constant-buffer the layout describes</param>
+/// <param name="elements">The constants and where they are found in the struct which will be written</param>
+/// <param name="count">The number of elements, at most KINC_G5_CONSTANT_LAYOUT_MAX_ELEMENTS</param>
+KINC_FUNC void kinc_g5_constant_layout_init(kinc_g5_constant_layout_t *layout, struct kinc_g5_pipeline *pipeline, kinc_g5_shader_type_t stage,
+                                            const kinc_g5_constant_layout_element_t *elements, int count);
+
+/// <summary>
+/// Writes all elements of a layout from a struct into a locked constant-buffer, transposing matrices using SIMD where the backend requires it.
+/// </summary>
+/// <param name="buffer">The buffer to write into, locked at offset 0 or using lock_all</param>
+/// <param name="layout">The layout which describes the constants</param>
+/// <param name="data">The struct which contains the values as described by the elements of the layout</param>
+KINC_FUNC void kinc_g5_constant_buffer_set_struct(kinc_g5_constant_buffer_t *buffer, const kinc_g5_constant_layout_t *layout, const void *data);
+
+void kinc_g5_internal_constant_buffer_reset_dirty(kinc_g5_constant_buffer_t *buffer);
+// calculates the range of bytes to upload for a lock of count bytes - the written range or everything when nothing was written
+void kinc_g5_internal_constant_buffer_get_dirty_range(kinc_g5_constant_buffer_t *buffer, int count, int *start, int *end);
+
 KINC_FUNC extern bool kinc_g5_transposeMat3;
 KINC_FUNC extern bool kinc_g5_transposeMat4;
 
@@ -2,6 +2,7 @@
 
 /*! \file raytrace.h
     \brief I still do not own a raytracing-GPU for my PC :(
+   Without KORE_RAYTRACE rays can still be traced on the CPU using kinc/bvh/bvh.h.
 */
 
 #ifdef KORE_RAYTRACE
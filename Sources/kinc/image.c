@@ -14,56 +14,14 @@ int LZ4_decompress_safe(const char *source, char *dest, int compressedSize, int
 #include <kinc/io/filereader.h>
 #include <kinc/log.h>
 #include <kinc/math/core.h>
+#include <kinc/memory.h>
+#include <kinc/profiler.h>
 
 #include <string.h>
 
-#define BUFFER_SIZE 4096 * 4096 * 4
-static uint8_t buffer[BUFFER_SIZE];
-static size_t buffer_offset = 0;
-static uint8_t *last_allocated_pointer = 0;
-
-static void *buffer_malloc(size_t size) {
-	uint8_t *current = &buffer[buffer_offset];
-	buffer_offset += size + sizeof(size_t);
-	if (buffer_offset > BUFFER_SIZE) {
-		kinc_log(KINC_LOG_LEVEL_ERROR, "Not enough memory on image.c Buffer.");
-		return NULL;
-	}
-	*(size_t *)current = size;
-	last_allocated_pointer = current + sizeof(size_t);
-	return current + sizeof(size_t);
-}
-
-static void *buffer_realloc(void *p, size_t size) {
-	if (p == NULL) {
-		return buffer_malloc(size);
-	}
-	uint8_t *old_pointer = (uint8_t *)p;
-	size_t old_size = *(size_t *)(old_pointer - sizeof(size_t));
-	if (size <= old_size) {
-		return old_pointer;
-	}
-	else {
-		if (last_allocated_pointer == old_pointer) {
-			size_t last_size = &buffer[buffer_offset] - old_pointer;
-			size_t size_diff = size - last_size;
-			buffer_offset += size_diff + sizeof(size_t);
-			return old_pointer;
-		}
-		uint8_t *new_pointer = (uint8_t *)buffer_malloc(size);
-		if (new_pointer == NULL) {
-			return NULL;
-		}
-		memcpy(new_pointer, old_pointer, old_size < size ? old_size : size);
-		return new_pointer;
-	}
-}
-
-static void buffer_free(void *p) {}
-
-#define STBI_MALLOC(sz) buffer_malloc(sz)
-#define STBI_REALLOC(p, newsz) buffer_realloc(p, newsz)
-#define STBI_FREE(p) buffer_free(p)
+#define STBI_MALLOC(sz) kinc_memory_allocate(sz, KINC_MEMORY_TAG_IMAGE)
+#define STBI_REALLOC(p, newsz) kinc_memory_reallocate(p, newsz, KINC_MEMORY_TAG_IMAGE)
+#define STBI_FREE(p) kinc_memory_free(p)
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
@@ -131,6 +89,12 @@ static size_t loadImageSize(kinc_image_read_callbacks_t callbacks, void *user_da
 		else if (strcmp(fourcc, "DXT5") == 0) {
 			return width * height; // just an upper bound
 		}
+		else if (strcmp(fourcc, "MIPS") == 0) {
+			char level_fourcc[5];
+			callbacks.read(user_data, level_fourcc, 4);
+			level_fourcc[4] = 0;
+			return width * height * (strcmp(level_fourcc, "LZ4F") == 0 ? 16 : 4);
+		}
 		else {
 			kinc_log(KINC_LOG_LEVEL_ERROR, "Unknown fourcc in .k file.");
 			return 0;
@@ -162,7 +126,6 @@ static size_t loadImageSize(kinc_image_read_callbacks_t callbacks, void *user_da
 
 		int x, y, comp;
 		stbi_info_from_callbacks(&stbi_callbacks, &reader, &x, &y, &comp);
-		buffer_offset = 0;
 		return x * y * 16;
 	}
 	else {
@@ -177,7 +140,6 @@ static size_t loadImageSize(kinc_image_read_callbacks_t callbacks, void *user_da
 
 		int x, y, comp;
 		stbi_info_from_callbacks(&stbi_callbacks, &reader, &x, &y, &comp);
-		buffer_offset = 0;
 		return x * y * 4;
 	}
 }
@@ -202,24 +164,30 @@ static bool loadImage(kinc_image_read_callbacks_t callbacks, void *user_data, co
 			*compression = KINC_IMAGE_COMPRESSION_NONE;
 			*internalFormat = 0;
 			*outputSize = *width * *height * 4;
-			callbacks.read(user_data, buffer, compressedSize);
-			LZ4_decompress_safe((char *)buffer, (char *)output, compressedSize, *outputSize);
+			uint8_t *compressed = (uint8_t *)kinc_memory_allocate(compressedSize, KINC_MEMORY_TAG_IMAGE);
+			callbacks.read(user_data, compressed, compressedSize);
+			LZ4_decompress_safe((char *)compressed, (char *)output, compressedSize, *outputSize);
+			kinc_memory_free(compressed);
 			return true;
 		}
 		else if (strcmp(fourcc, "LZ4F") == 0) {
 			*compression = KINC_IMAGE_COMPRESSION_NONE;
 			*internalFormat = 0;
 			*outputSize = *width * *height * 16;
-			callbacks.read(user_data, buffer, compressedSize);
-			LZ4_decompress_safe((char *)buffer, (char *)output, compressedSize, *outputSize);
+			uint8_t *compressed = (uint8_t *)kinc_memory_allocate(compressedSize, KINC_MEMORY_TAG_IMAGE);
+			callbacks.read(user_data, compressed, compressedSize);
+			LZ4_decompress_safe((char *)compressed, (char *)output, compressedSize, *outputSize);
+			kinc_memory_free(compressed);
 			*format = KINC_IMAGE_FORMAT_RGBA128;
 			return true;
 		}
 		else if (strcmp(fourcc, "ASTC") == 0) {
 			*compression = KINC_IMAGE_COMPRESSION_ASTC;
 			*outputSize = *width * *height * 4;
-			callbacks.read(user_data, buffer, compressedSize);
-			*outputSize = LZ4_decompress_safe((char *)buffer, (char *)output, compressedSize, *outputSize);
+			uint8_t *compressed = (uint8_t *)kinc_memory_allocate(compressedSize, KINC_MEMORY_TAG_IMAGE);
+			callbacks.read(user_data, compressed, compressedSize);
+			*outputSize = LZ4_decompress_safe((char *)compressed, (char *)output, compressedSize, *outputSize);
+			kinc_memory_free(compressed);
 
 			uint8_t blockdim_x = 6;
 			uint8_t blockdim_y = 6;
@@ -260,11 +228,37 @@ static bool loadImage(kinc_image_read_callbacks_t callbacks, void *user_data, co
 		else if (strcmp(fourcc, "DXT5") == 0) {
 			*compression = KINC_IMAGE_COMPRESSION_DXT5;
 			*outputSize = *width * *height;
-			callbacks.read(user_data, buffer, compressedSize);
-			*outputSize = LZ4_decompress_safe((char *)(data + 12), (char *)output, compressedSize, *outputSize);
+			uint8_t *compressed = (uint8_t *)kinc_memory_allocate(compressedSize, KINC_MEMORY_TAG_IMAGE);
+			callbacks.read(user_data, compressed, compressedSize);
+			*outputSize = LZ4_decompress_safe((char *)compressed, (char *)output, compressedSize, *outputSize);
+			kinc_memory_free(compressed);
 			*internalFormat = 0;
 			return true;
 		}
+		else if (strcmp(fourcc, "MIPS") == 0) {
+			// a mip-chain as used by kinc_g4_streaming_texture, only the largest level is loaded
+			char level_fourcc[5];
+			callbacks.read(user_data, level_fourcc, 4);
+			level_fourcc[4] = 0;
+			callbacks.read(user_data, data, 4); // level-count
+			callbacks.read(user_data, data, 4);
+			int offset = kinc_read_s32le(data);
+			callbacks.read(user_data, data, 4);
+			int levelSize = kinc_read_s32le(data);
+			bool hdr = strcmp(level_fourcc, "LZ4F") == 0;
+			*compression = KINC_IMAGE_COMPRESSION_NONE;
+			*internalFormat = 0;
+			*outputSize = *width * *height * (hdr ? 16 : 4);
+			callbacks.seek(user_data, offset);
+			uint8_t *compressed = (uint8_t *)kinc_memory_allocate(levelSize, KINC_MEMORY_TAG_IMAGE);
+			callbacks.read(user_data, compressed, levelSize);
+			LZ4_decompress_safe((char *)compressed, (char *)output, levelSize, *outputSize);
+			kinc_memory_free(compressed);
+			if (hdr) {
+				*format = KINC_IMAGE_FORMAT_RGBA128;
+			}
+			return true;
+		}
 		else {
 			kinc_log(KINC_LOG_LEVEL_ERROR, "Unknown fourcc in .k file.");
 			return false;
@@ -340,7 +334,7 @@ static bool loadImage(kinc_image_read_callbacks_t callbacks, void *user_data, co
 		*outputSize = *width * *height * 16;
 		memcpy(output, uncompressed, *outputSize);
 		*format = KINC_IMAGE_FORMAT_RGBA128;
-		buffer_offset = 0;
+		stbi_image_free(uncompressed);
 		return true;
 	}
 	else {
@@ -378,7 +372,7 @@ static bool loadImage(kinc_image_read_callbacks_t callbacks, void *user_data, co
 			}
 		}
 		*outputSize = *width * *height * 4;
-		buffer_offset = 0;
+		stbi_image_free(uncompressed);
 		return true;
 	}
 }
@@ -517,7 +511,9 @@ size_t kinc_image_size_from_encoded_bytes(void *data, size_t data_size, const ch
 
 size_t kinc_image_init_from_callbacks(kinc_image_t *image, void *memory, kinc_image_read_callbacks_t callbacks, void *user_data, const char *filename) {
 	int dataSize;
+	KINC_PROFILER_BEGIN("Image decode");
 	loadImage(callbacks, user_data, filename, memory, &dataSize, &image->width, &image->height, &image->compression, &image->format, &image->internal_format);
+	KINC_PROFILER_END();
 	image->data = memory;
 	return dataSize;
 }
@@ -532,7 +528,9 @@ size_t kinc_image_init_from_file(kinc_image_t *image, void *memory, const char *
 		callbacks.seek = seek_callback;
 
 		int dataSize;
+		KINC_PROFILER_BEGIN("Image decode");
 		loadImage(callbacks, &reader, filename, memory, &dataSize, &image->width, &image->height, &image->compression, &image->format, &image->internal_format);
+		KINC_PROFILER_END();
 		kinc_file_reader_close(&reader);
 		image->data = memory;
 		image->data_size = dataSize;
@@ -555,7 +553,9 @@ size_t kinc_image_init_from_encoded_bytes(kinc_image_t *image, void *memory, voi
 	image_memory.offset = 0;
 
 	int dataSize;
+	KINC_PROFILER_BEGIN("Image decode");
 	loadImage(callbacks, &image_memory, format, memory, &dataSize, &image->width, &image->height, &image->compression, &image->format, &image->internal_format);
+	KINC_PROFILER_END();
 	image->data = memory;
 	image->data_size = dataSize;
 	image->depth = 1;
@@ -1,18 +1,57 @@
 #include "gamepad.h"
+#include "queue.h"
 
 #include <memory.h>
 
 void (*kinc_gamepad_axis_callback)(int /*gamepad*/, int /*axis*/, float /*value*/) = NULL;
 void (*kinc_gamepad_button_callback)(int /*gamepad*/, int /*button*/, float /*value*/) = NULL;
 
+static kinc_ticks_t event_timestamp = 0;
+
 void kinc_internal_gamepad_trigger_axis(int gamepad, int axis, float value) {
+	kinc_internal_gamepad_trigger_axis_at(gamepad, axis, value, kinc_timestamp());
+}
+
+void kinc_internal_gamepad_trigger_button(int gamepad, int button, float value) {
+	kinc_internal_gamepad_trigger_button_at(gamepad, button, value, kinc_timestamp());
+}
+
+void kinc_internal_gamepad_trigger_axis_at(int gamepad, int axis, float value, kinc_ticks_t timestamp) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_GAMEPAD_AXIS;
+		event.data.gamepad_axis.gamepad = gamepad;
+		event.data.gamepad_axis.axis = axis;
+		event.data.gamepad_axis.value = value;
+		kinc_internal_input_queue_push_at(&event, timestamp);
+		return;
+	}
 	if (kinc_gamepad_axis_callback != NULL) {
+		event_timestamp = timestamp;
 		kinc_gamepad_axis_callback(gamepad, axis, value);
 	}
 }
 
-void kinc_internal_gamepad_trigger_button(int gamepad, int button, float value) {
+void kinc_internal_gamepad_trigger_button_at(int gamepad, int button, float value, kinc_ticks_t timestamp) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_GAMEPAD_BUTTON;
+		event.data.gamepad_button.gamepad = gamepad;
+		event.data.gamepad_button.button = button;
+		event.data.gamepad_button.value = value;
+		kinc_internal_input_queue_push_at(&event, timestamp);
+		return;
+	}
 	if (kinc_gamepad_button_callback != NULL) {
+		event_timestamp = timestamp;
 		kinc_gamepad_button_callback(gamepad, button, value);
 	}
 }
+
+void kinc_internal_gamepad_set_event_timestamp(kinc_ticks_t timestamp) {
+	event_timestamp = timestamp;
+}
+
+kinc_ticks_t kinc_gamepad_event_timestamp(void) {
+	return event_timestamp;
+}
@@ -2,6 +2,8 @@
 
 #include <kinc/global.h>
 
+#include <kinc/system.h>
+
 /*! \file gamepad.h
     \brief Provides gamepad-support.
 */
@@ -49,8 +51,17 @@ KINC_FUNC bool kinc_gamepad_connected(int gamepad);
 /// <param name="right">Rumble-strength for the right motor between 0 and 1</param>
 KINC_FUNC void kinc_gamepad_rumble(int gamepad, float left, float right);
 
+/// <summary>
+/// Returns when the input which is currently passed to kinc_gamepad_axis_callback or kinc_gamepad_button_callback happened, comparable to
+/// kinc_timestamp. Systems which do not report when the input happened return when Kinc received it.
+/// </summary>
+KINC_FUNC kinc_ticks_t kinc_gamepad_event_timestamp(void);
+
 void kinc_internal_gamepad_trigger_axis(int gamepad, int axis, float value);
 void kinc_internal_gamepad_trigger_button(int gamepad, int button, float value);
+void kinc_internal_gamepad_trigger_axis_at(int gamepad, int axis, float value, kinc_ticks_t timestamp);
+void kinc_internal_gamepad_trigger_button_at(int gamepad, int button, float value, kinc_ticks_t timestamp);
+void kinc_internal_gamepad_set_event_timestamp(kinc_ticks_t timestamp);
 
 #ifdef __cplusplus
 }
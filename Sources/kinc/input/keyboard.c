@@ -1,4 +1,5 @@
 #include "keyboard.h"
+#include "queue.h"
 
 #include <memory.h>
 
@@ -7,18 +8,39 @@ void (*kinc_keyboard_key_up_callback)(int /*key_code*/) = NULL;
 void (*kinc_keyboard_key_press_callback)(unsigned /*character*/) = NULL;
 
 void kinc_internal_keyboard_trigger_key_down(int key_code) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_KEY_DOWN;
+		event.data.key.key_code = key_code;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_keyboard_key_down_callback != NULL) {
 		kinc_keyboard_key_down_callback(key_code);
 	}
 }
 
 void kinc_internal_keyboard_trigger_key_up(int key_code) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_KEY_UP;
+		event.data.key.key_code = key_code;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_keyboard_key_up_callback != NULL) {
 		kinc_keyboard_key_up_callback(key_code);
 	}
 }
 
 void kinc_internal_keyboard_trigger_key_press(unsigned character) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_KEY_PRESS;
+		event.data.key_press.character = character;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_keyboard_key_press_callback != NULL) {
 		kinc_keyboard_key_press_callback(character);
 	}
@@ -1,4 +1,5 @@
 #include "mouse.h"
+#include "queue.h"
 
 #include <kinc/window.h>
 
@@ -12,12 +13,30 @@ void (*kinc_mouse_enter_window_callback)(int /*window*/) = NULL;
 void (*kinc_mouse_leave_window_callback)(int /*window*/) = NULL;
 
 void kinc_internal_mouse_trigger_release(int window, int button, int x, int y) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_MOUSE_RELEASE;
+		event.data.mouse_button.window = window;
+		event.data.mouse_button.button = button;
+		event.data.mouse_button.x = x;
+		event.data.mouse_button.y = y;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_mouse_release_callback != NULL) {
 		kinc_mouse_release_callback(window, button, x, y);
 	}
 }
 
 void kinc_internal_mouse_trigger_scroll(int window, int delta) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_MOUSE_SCROLL;
+		event.data.mouse_scroll.window = window;
+		event.data.mouse_scroll.delta = delta;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_mouse_scroll_callback != NULL) {
 		kinc_mouse_scroll_callback(window, delta);
 	}
@@ -60,6 +79,16 @@ static int lastY = 0;
 void kinc_internal_mouse_trigger_press(int window, int button, int x, int y) {
 	lastX = x;
 	lastY = y;
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_MOUSE_PRESS;
+		event.data.mouse_button.window = window;
+		event.data.mouse_button.button = button;
+		event.data.mouse_button.x = x;
+		event.data.mouse_button.y = y;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_mouse_press_callback != NULL) {
 		kinc_mouse_press_callback(window, button, x, y);
 	}
@@ -85,6 +114,17 @@ void kinc_internal_mouse_trigger_move(int window, int x, int y) {
 
 	lastX = x;
 	lastY = y;
+	if (kinc_internal_input_queue_active && (movementX != 0 || movementY != 0)) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_MOUSE_MOVE;
+		event.data.mouse_move.window = window;
+		event.data.mouse_move.x = x;
+		event.data.mouse_move.y = y;
+		event.data.mouse_move.movement_x = movementX;
+		event.data.mouse_move.movement_y = movementY;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_mouse_move_callback != NULL && (movementX != 0 || movementY != 0)) {
 		kinc_mouse_move_callback(window, x, y, movementX, movementY);
 	}
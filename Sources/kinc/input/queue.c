@@ -0,0 +1,369 @@
+#include "queue.h"
+
+#include "gamepad.h"
+#include "keyboard.h"
+#include "mouse.h"
+#include "surface.h"
+
+#include <kinc/threads/mutex.h>
+
+#include <string.h>
+
+// how far back a motion-event looks for an event to merge into
+#define COALESCE_DISTANCE 32
+
+bool kinc_internal_input_queue_active = false;
+
+static kinc_mutex_t mutex;
+static volatile bool mutex_initialized = false;
+static int coalescing = KINC_INPUT_COALESCE_ALL;
+
+// written by the platform while the frame runs
+static kinc_input_event_t pending_events[KINC_INPUT_QUEUE_SIZE];
+static int pending_count = 0;
+static int pending_dropped = 0;
+static kinc_input_state_t pending_state;
+
+// read by the application
+static kinc_input_event_t frame_events[KINC_INPUT_QUEUE_SIZE];
+static int frame_count = 0;
+static int frame_dropped = 0;
+static kinc_input_state_t frame_state;
+
+void kinc_input_queue_enable(bool enabled) {
+	if (!mutex_initialized) {
+		kinc_mutex_init(&mutex);
+		mutex_initialized = true;
+	}
+	kinc_mutex_lock(&mutex);
+	if (enabled && !kinc_internal_input_queue_active) {
+		pending_count = 0;
+		pending_dropped = 0;
+		frame_count = 0;
+		frame_dropped = 0;
+		memset(&pending_state, 0, sizeof(pending_state));
+		memset(&frame_state, 0, sizeof(frame_state));
+	}
+	kinc_internal_input_queue_active = enabled;
+	kinc_mutex_unlock(&mutex);
+}
+
+bool kinc_input_queue_enabled(void) {
+	return kinc_internal_input_queue_active;
+}
+
+void kinc_input_queue_set_coalescing(int flags) {
+	coalescing = flags;
+}
+
+static void set_bit(uint32_t *bits, int index, bool value) {
+	if (index < 0 || index >= 256) {
+		return;
+	}
+	if (value) {
+		bits[index >> 5] |= 1u << (index & 31);
+	}
+	else {
+		bits[index >> 5] &= ~(1u << (index & 31));
+	}
+}
+
+static bool get_bit(const uint32_t *bits, int index) {
+	if (index < 0 || index >= 256) {
+		return false;
+	}
+	return (bits[index >> 5] & (1u << (index & 31))) != 0;
+}
+
+static void update_state(kinc_input_event_t *event) {
+	kinc_input_state_t *state = &pending_state;
+	switch (event->type) {
+	case KINC_INPUT_EVENT_KEY_DOWN:
+		set_bit(state->keys_down, event->data.key.key_code, true);
+		set_bit(state->keys_pressed, event->data.key.key_code, true);
+		break;
+	case KINC_INPUT_EVENT_KEY_UP:
+		set_bit(state->keys_down, event->data.key.key_code, false);
+		set_bit(state->keys_released, event->data.key.key_code, true);
+		break;
+	case KINC_INPUT_EVENT_MOUSE_PRESS:
+	case KINC_INPUT_EVENT_MOUSE_RELEASE:
+		if (event->data.mouse_button.button >= 0 && event->data.mouse_button.button < 32) {
+			if (event->type == KINC_INPUT_EVENT_MOUSE_PRESS) {
+				state->mouse_buttons_down |= 1u << event->data.mouse_button.button;
+			}
+			else {
+				state->mouse_buttons_down &= ~(1u << event->data.mouse_button.button);
+			}
+		}
+		state->mouse_window = event->data.mouse_button.window;
+		state->mouse_x = event->data.mouse_button.x;
+		state->mouse_y = event->data.mouse_button.y;
+		break;
+	case KINC_INPUT_EVENT_MOUSE_MOVE:
+		state->mouse_window = event->data.mouse_move.window;
+		state->mouse_x = event->data.mouse_move.x;
+		state->mouse_y = event->data.mouse_move.y;
+		state->mouse_movement_x += event->data.mouse_move.movement_x;
+		state->mouse_movement_y += event->data.mouse_move.movement_y;
+		break;
+	case KINC_INPUT_EVENT_MOUSE_SCROLL:
+		state->mouse_scroll += event->data.mouse_scroll.delta;
+		break;
+	case KINC_INPUT_EVENT_GAMEPAD_AXIS:
+		if (event->data.gamepad_axis.gamepad >= 0 && event->data.gamepad_axis.gamepad < KINC_INPUT_QUEUE_GAMEPADS &&
+		    event->data.gamepad_axis.axis >= 0 && event->data.gamepad_axis.axis < KINC_INPUT_QUEUE_GAMEPAD_AXES) {
+			state->gamepad_axes[event->data.gamepad_axis.gamepad][event->data.gamepad_axis.axis] = event->data.gamepad_axis.value;
+		}
+		break;
+	case KINC_INPUT_EVENT_GAMEPAD_BUTTON:
+		if (event->data.gamepad_button.gamepad >= 0 && event->data.gamepad_button.gamepad < KINC_INPUT_QUEUE_GAMEPADS &&
+		    event->data.gamepad_button.button >= 0 && event->data.gamepad_button.button < KINC_INPUT_QUEUE_GAMEPAD_BUTTONS) {
+			state->gamepad_buttons[event->data.gamepad_button.gamepad][event->data.gamepad_button.button] = event->data.gamepad_button.value;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+// Returns the event which a motion-event can be merged into or NULL. Searching stops at events of the same device which have to stay in order.
+static kinc_input_event_t *find_mergeable(kinc_input_event_t *event) {
+	int end = pending_count > COALESCE_DISTANCE ? pending_count - COALESCE_DISTANCE : 0;
+	for (int i = pending_count - 1; i >= end; --i) {
+		kinc_input_event_t *other = &pending_events[i];
+		switch (event->type) {
+		case KINC_INPUT_EVENT_MOUSE_MOVE:
+			if (other->type == KINC_INPUT_EVENT_MOUSE_MOVE) {
+				return other->data.mouse_move.window == event->data.mouse_move.window ? other : NULL;
+			}
+			if (other->type >= KINC_INPUT_EVENT_MOUSE_PRESS && other->type <= KINC_INPUT_EVENT_MOUSE_SCROLL) {
+				return NULL;
+			}
+			break;
+		case KINC_INPUT_EVENT_GAMEPAD_AXIS:
+			if (other->type == KINC_INPUT_EVENT_GAMEPAD_AXIS && other->data.gamepad_axis.gamepad == event->data.gamepad_axis.gamepad &&
+			    other->data.gamepad_axis.axis == event->data.gamepad_axis.axis) {
+				return other;
+			}
+			if (other->type == KINC_INPUT_EVENT_GAMEPAD_BUTTON && other->data.gamepad_button.gamepad == event->data.gamepad_axis.gamepad) {
+				return NULL;
+			}
+			break;
+		case KINC_INPUT_EVENT_TOUCH_MOVE:
+			if (other->type >= KINC_INPUT_EVENT_TOUCH_START && other->type <= KINC_INPUT_EVENT_TOUCH_END &&
+			    other->data.touch.index == event->data.touch.index) {
+				return other->type == KINC_INPUT_EVENT_TOUCH_MOVE ? other : NULL;
+			}
+			break;
+		default:
+			return NULL;
+		}
+	}
+	return NULL;
+}
+
+static bool coalesces(kinc_input_event_type_t type) {
+	switch (type) {
+	case KINC_INPUT_EVENT_MOUSE_MOVE:
+		return (coalescing & KINC_INPUT_COALESCE_MOUSE_MOTION) != 0;
+	case KINC_INPUT_EVENT_GAMEPAD_AXIS:
+		return (coalescing & KINC_INPUT_COALESCE_GAMEPAD_AXES) != 0;
+	case KINC_INPUT_EVENT_TOUCH_MOVE:
+		return (coalescing & KINC_INPUT_COALESCE_TOUCH_MOTION) != 0;
+	default:
+		return false;
+	}
+}
+
+void kinc_internal_input_queue_push(kinc_input_event_t *event) {
+	kinc_internal_input_queue_push_at(event, kinc_timestamp());
+}
+
+static void push_locked(kinc_input_event_t *event, kinc_ticks_t timestamp) {
+	event->timestamp = timestamp;
+	event->count = 1;
+	update_state(event);
+	kinc_input_event_t *merged = coalesces(event->type) ? find_mergeable(event) : NULL;
+	if (merged != NULL) {
+		merged->timestamp = event->timestamp;
+		merged->count += 1;
+		if (event->type == KINC_INPUT_EVENT_MOUSE_MOVE) {
+			merged->data.mouse_move.x = event->data.mouse_move.x;
+			merged->data.mouse_move.y = event->data.mouse_move.y;
+			merged->data.mouse_move.movement_x += event->data.mouse_move.movement_x;
+			merged->data.mouse_move.movement_y += event->data.mouse_move.movement_y;
+		}
+		else {
+			merged->data = event->data;
+		}
+	}
+	else if (pending_count < KINC_INPUT_QUEUE_SIZE) {
+		pending_events[pending_count++] = *event;
+	}
+	else {
+		++pending_dropped;
+	}
+}
+
+void kinc_internal_input_queue_push_at(kinc_input_event_t *event, kinc_ticks_t timestamp) {
+	kinc_mutex_lock(&mutex);
+	push_locked(event, timestamp);
+	kinc_mutex_unlock(&mutex);
+}
+
+bool kinc_internal_input_queue_try_push_at(kinc_input_event_t *event, kinc_ticks_t timestamp) {
+	// the queue was never enabled
+	if (!mutex_initialized) {
+		return false;
+	}
+	kinc_mutex_lock(&mutex);
+	bool active = kinc_internal_input_queue_active;
+	if (active) {
+		push_locked(event, timestamp);
+	}
+	kinc_mutex_unlock(&mutex);
+	return active;
+}
+
+static void dispatch(kinc_input_event_t *event) {
+	switch (event->type) {
+	case KINC_INPUT_EVENT_KEY_DOWN:
+		if (kinc_keyboard_key_down_callback != NULL) {
+			kinc_keyboard_key_down_callback(event->data.key.key_code);
+		}
+		break;
+	case KINC_INPUT_EVENT_KEY_UP:
+		if (kinc_keyboard_key_up_callback != NULL) {
+			kinc_keyboard_key_up_callback(event->data.key.key_code);
+		}
+		break;
+	case KINC_INPUT_EVENT_KEY_PRESS:
+		if (kinc_keyboard_key_press_callback != NULL) {
+			kinc_keyboard_key_press_callback(event->data.key_press.character);
+		}
+		break;
+	case KINC_INPUT_EVENT_MOUSE_PRESS:
+		if (kinc_mouse_press_callback != NULL) {
+			kinc_mouse_press_callback(event->data.mouse_button.window, event->data.mouse_button.button, event->data.mouse_button.x,
+			                          event->data.mouse_button.y);
+		}
+		break;
+	case KINC_INPUT_EVENT_MOUSE_RELEASE:
+		if (kinc_mouse_release_callback != NULL) {
+			kinc_mouse_release_callback(event->data.mouse_button.window, event->data.mouse_button.button, event->data.mouse_button.x,
+			                            event->data.mouse_button.y);
+		}
+		break;
+	case KINC_INPUT_EVENT_MOUSE_MOVE:
+		if (kinc_mouse_move_callback != NULL) {
+			kinc_mouse_move_callback(event->data.mouse_move.window, event->data.mouse_move.x, event->data.mouse_move.y, event->data.mouse_move.movement_x,
+			                         event->data.mouse_move.movement_y);
+		}
+		break;
+	case KINC_INPUT_EVENT_MOUSE_SCROLL:
+		if (kinc_mouse_scroll_callback != NULL) {
+			kinc_mouse_scroll_callback(event->data.mouse_scroll.window, event->data.mouse_scroll.delta);
+		}
+		break;
+	case KINC_INPUT_EVENT_GAMEPAD_AXIS:
+		if (kinc_gamepad_axis_callback != NULL) {
+			kinc_internal_gamepad_set_event_timestamp(event->timestamp);
+			kinc_gamepad_axis_callback(event->data.gamepad_axis.gamepad, event->data.gamepad_axis.axis, event->data.gamepad_axis.value);
+		}
+		break;
+	case KINC_INPUT_EVENT_GAMEPAD_BUTTON:
+		if (kinc_gamepad_button_callback != NULL) {
+			kinc_internal_gamepad_set_event_timestamp(event->timestamp);
+			kinc_gamepad_button_callback(event->data.gamepad_button.gamepad, event->data.gamepad_button.button, event->data.gamepad_button.value);
+		}
+		break;
+	case KINC_INPUT_EVENT_TOUCH_START:
+		if (kinc_surface_touch_start_callback != NULL) {
+			kinc_surface_touch_start_callback(event->data.touch.index, event->data.touch.x, event->data.touch.y);
+		}
+		break;
+	case KINC_INPUT_EVENT_TOUCH_MOVE:
+		if (kinc_surface_move_callback != NULL) {
+			kinc_surface_move_callback(event->data.touch.index, event->data.touch.x, event->data.touch.y);
+		}
+		break;
+	case KINC_INPUT_EVENT_TOUCH_END:
+		if (kinc_surface_touch_end_callback != NULL) {
+			kinc_surface_touch_end_callback(event->data.touch.index, event->data.touch.x, event->data.touch.y);
+		}
+		break;
+	}
+}
+
+void kinc_internal_input_queue_frame(void) {
+	kinc_mutex_lock(&mutex);
+	memcpy(frame_events, pending_events, pending_count * sizeof(kinc_input_event_t));
+	frame_count = pending_count;
+	frame_dropped = pending_dropped;
+	frame_state = pending_state;
+	frame_state.timestamp = kinc_timestamp();
+	pending_count = 0;
+	pending_dropped = 0;
+	memset(pending_state.keys_pressed, 0, sizeof(pending_state.keys_pressed));
+	memset(pending_state.keys_released, 0, sizeof(pending_state.keys_released));
+	pending_state.mouse_movement_x = 0;
+	pending_state.mouse_movement_y = 0;
+	pending_state.mouse_scroll = 0;
+	kinc_mutex_unlock(&mutex);
+
+	// only the main thread writes frame_events so no lock is needed to read them here
+	for (int i = 0; i < frame_count; ++i) {
+		dispatch(&frame_events[i]);
+	}
+}
+
+int kinc_input_queue_count(void) {
+	return frame_count;
+}
+
+int kinc_input_queue_events(kinc_input_event_t *events, int first, int max_events) {
+	if (!mutex_initialized) {
+		return 0;
+	}
+	kinc_mutex_lock(&mutex);
+	int count = frame_count - first;
+	if (count > max_events) {
+		count = max_events;
+	}
+	if (count > 0) {
+		memcpy(events, &frame_events[first], count * sizeof(kinc_input_event_t));
+	}
+	kinc_mutex_unlock(&mutex);
+	return count > 0 ? count : 0;
+}
+
+int kinc_input_queue_dropped(void) {
+	return frame_dropped;
+}
+
+void kinc_input_queue_state(kinc_input_state_t *state) {
+	if (!mutex_initialized) {
+		memset(state, 0, sizeof(*state));
+		return;
+	}
+	kinc_mutex_lock(&mutex);
+	*state = frame_state;
+	kinc_mutex_unlock(&mutex);
+}
+
+bool kinc_input_state_key_down(const kinc_input_state_t *state, int key_code) {
+	return get_bit(state->keys_down, key_code);
+}
+
+bool kinc_input_state_key_pressed(const kinc_input_state_t *state, int key_code) {
+	return get_bit(state->keys_pressed, key_code);
+}
+
+bool kinc_input_state_key_released(const kinc_input_state_t *state, int key_code) {
+	return get_bit(state->keys_released, key_code);
+}
+
+bool kinc_input_state_mouse_button_down(const kinc_input_state_t *state, int button) {
+	return button >= 0 && button < 32 && (state->mouse_buttons_down & (1u << button)) != 0;
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <kinc/global.h>
+
+#include <kinc/system.h>
+
+#include <stdint.h>
+
+/*! \file queue.h
+    \brief Provides an optional queued input-mode. While it is enabled, keyboard-, mouse-, gamepad- and touch-input is collected into a timestamped event
+   buffer instead of being passed to the callbacks right away. At the beginning of every frame the buffer of the previous frame becomes readable and its
+   events are passed to the callbacks in one batch. Consecutive motion-events are merged, so high polling-rates do not flood the application. Events
+   and state-snapshots can be read from any thread.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// <summary>
+/// Maximum number of events per frame, further events only update the state-snapshot
+/// </summary>
+#define KINC_INPUT_QUEUE_SIZE 1024
+
+#define KINC_INPUT_QUEUE_GAMEPADS 4
+#define KINC_INPUT_QUEUE_GAMEPAD_AXES 16
+#define KINC_INPUT_QUEUE_GAMEPAD_BUTTONS 32
+
+#define KINC_INPUT_COALESCE_NONE 0
+#define KINC_INPUT_COALESCE_MOUSE_MOTION 1
+#define KINC_INPUT_COALESCE_GAMEPAD_AXES 2
+#define KINC_INPUT_COALESCE_TOUCH_MOTION 4
+#define KINC_INPUT_COALESCE_ALL 7
+
+typedef enum {
+	KINC_INPUT_EVENT_KEY_DOWN,
+	KINC_INPUT_EVENT_KEY_UP,
+	KINC_INPUT_EVENT_KEY_PRESS,
+	KINC_INPUT_EVENT_MOUSE_PRESS,
+	KINC_INPUT_EVENT_MOUSE_RELEASE,
+	KINC_INPUT_EVENT_MOUSE_MOVE,
+	KINC_INPUT_EVENT_MOUSE_SCROLL,
+	KINC_INPUT_EVENT_GAMEPAD_AXIS,
+	KINC_INPUT_EVENT_GAMEPAD_BUTTON,
+	KINC_INPUT_EVENT_TOUCH_START,
+	KINC_INPUT_EVENT_TOUCH_MOVE,
+	KINC_INPUT_EVENT_TOUCH_END
+} kinc_input_event_type_t;
+
+typedef struct kinc_input_event {
+	kinc_input_event_type_t type;
+	// when the (last merged) event happened or, when the system does not report that, was received - comparable to kinc_timestamp
+	kinc_ticks_t timestamp;
+	// the number of events which were merged into this one
+	int count;
+	union {
+		struct {
+			int key_code;
+		} key;
+		struct {
+			unsigned character;
+		} key_press;
+		struct {
+			int window;
+			int button;
+			int x;
+			int y;
+		} mouse_button;
+		struct {
+			int window;
+			int x;
+			int y;
+			int movement_x;
+			int movement_y;
+		} mouse_move;
+		struct {
+			int window;
+			int delta;
+		} mouse_scroll;
+		struct {
+			int gamepad;
+			int axis;
+			float value;
+		} gamepad_axis;
+		struct {
+			int gamepad;
+			int button;
+			float value;
+		} gamepad_button;
+		struct {
+			int index;
+			int x;
+			int y;
+		} touch;
+	} data;
+} kinc_input_event_t;
+
+typedef struct kinc_input_state {
+	// one bit per key code, see kinc_input_state_key_down
+	uint32_t keys_down[8];
+	uint32_t keys_pressed[8];
+	uint32_t keys_released[8];
+	// one bit per mouse button
+	uint32_t mouse_buttons_down;
+	int mouse_window;
+	int mouse_x;
+	int mouse_y;
+	// accumulated over the frame
+	int mouse_movement_x;
+	int mouse_movement_y;
+	int mouse_scroll;
+	float gamepad_axes[KINC_INPUT_QUEUE_GAMEPADS][KINC_INPUT_QUEUE_GAMEPAD_AXES];
+	float gamepad_buttons[KINC_INPUT_QUEUE_GAMEPADS][KINC_INPUT_QUEUE_GAMEPAD_BUTTONS];
+	// when the frame which the state belongs to started
+	kinc_ticks_t timestamp;
+} kinc_input_state_t;
+
+/// <summary>
+/// Enables or disables the queued input-mode. Pen-, acceleration- and rotation-input and window enter/leave-events always use the callbacks directly.
+/// </summary>
+KINC_FUNC void kinc_input_queue_enable(bool enabled);
+
+/// <summary>
+/// Returns whether the queued input-mode is enabled.
+/// </summary>
+KINC_FUNC bool kinc_input_queue_enabled(void);
+
+/// <summary>
+/// Selects which kinds of motion-events are merged. Mouse-movements are summed up, axis- and touch-values keep the latest value. Button-events are
+/// never merged and motion-events are never merged across button-events of the same device, so the order of clicks and movements is kept.
+/// </summary>
+/// <param name="flags">A combination of the KINC_INPUT_COALESCE-flags, KINC_INPUT_COALESCE_ALL by default</param>
+KINC_FUNC void kinc_input_queue_set_coalescing(int flags);
+
+/// <summary>
+/// Returns the number of events of the current frame.
+/// </summary>
+KINC_FUNC int kinc_input_queue_count(void);
+
+/// <summary>
+/// Copies events of the current frame.
+/// </summary>
+/// <param name="events">Receives the events</param>
+/// <param name="first">The index of the first event to copy</param>
+/// <param name="max_events">The number of entries in events</param>
+/// <returns>The number of events which were copied</returns>
+KINC_FUNC int kinc_input_queue_events(kinc_input_event_t *events, int first, int max_events);
+
+/// <summary>
+/// Returns the number of events which did not fit into the buffer of the current frame.
+/// </summary>
+KINC_FUNC int kinc_input_queue_dropped(void);
+
+/// <summary>
+/// Copies the input-state at the end of the current frame's events.
+/// </summary>
+KINC_FUNC void kinc_input_queue_state(kinc_input_state_t *state);
+
+/// <summary>
+/// Returns whether a key is held down.
+/// </summary>
+KINC_FUNC bool kinc_input_state_key_down(const kinc_input_state_t *state, int key_code);
+
+/// <summary>
+/// Returns whether a key went down during the frame, which is also true for keys which were released again in the same frame.
+/// </summary>
+KINC_FUNC bool kinc_input_state_key_pressed(const kinc_input_state_t *state, int key_code);
+
+/// <summary>
+/// Returns whether a key was released during the frame.
+/// </summary>
+KINC_FUNC bool kinc_input_state_key_released(const kinc_input_state_t *state, int key_code);
+
+/// <summary>
+/// Returns whether a mouse-button is held down.
+/// </summary>
+KINC_FUNC bool kinc_input_state_mouse_button_down(const kinc_input_state_t *state, int button);
+
+KINC_FUNC extern bool kinc_internal_input_queue_active;
+
+void kinc_internal_input_queue_push(kinc_input_event_t *event);
+// for events which report when they happened themselves, the timestamp has to be comparable to kinc_timestamp
+void kinc_internal_input_queue_push_at(kinc_input_event_t *event, kinc_ticks_t timestamp);
+// for threads other than the main thread, checks whether the queue is active under the queue's lock and only pushes if it is
+bool kinc_internal_input_queue_try_push_at(kinc_input_event_t *event, kinc_ticks_t timestamp);
+void kinc_internal_input_queue_frame(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,5 @@
 #include "surface.h"
+#include "queue.h"
 
 #include <memory.h>
 
@@ -7,18 +8,45 @@ void (*kinc_surface_move_callback)(int /*index*/, int /*x*/, int /*y*/) = NULL;
 void (*kinc_surface_touch_end_callback)(int /*index*/, int /*x*/, int /*y*/) = NULL;
 
 void kinc_internal_surface_trigger_touch_start(int index, int x, int y) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_TOUCH_START;
+		event.data.touch.index = index;
+		event.data.touch.x = x;
+		event.data.touch.y = y;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_surface_touch_start_callback != NULL) {
 		kinc_surface_touch_start_callback(index, x, y);
 	}
 }
 
 void kinc_internal_surface_trigger_move(int index, int x, int y) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_TOUCH_MOVE;
+		event.data.touch.index = index;
+		event.data.touch.x = x;
+		event.data.touch.y = y;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_surface_move_callback != NULL) {
 		kinc_surface_move_callback(index, x, y);
 	}
 }
 
 void kinc_internal_surface_trigger_touch_end(int index, int x, int y) {
+	if (kinc_internal_input_queue_active) {
+		kinc_input_event_t event;
+		event.type = KINC_INPUT_EVENT_TOUCH_END;
+		event.data.touch.index = index;
+		event.data.touch.x = x;
+		event.data.touch.y = y;
+		kinc_internal_input_queue_push(&event);
+		return;
+	}
 	if (kinc_surface_touch_end_callback != NULL) {
 		kinc_surface_touch_end_callback(index, x, y);
 	}
@@ -1,5 +1,6 @@
 #include "filereader.h"
 
+#include <kinc/profiler.h>
 #include <kinc/system.h>
 
 #ifdef KORE_ANDROID
@@ -219,18 +220,21 @@ bool kinc_file_reader_open(kinc_file_reader_t *reader, const char *filename, int
 #endif
 
 int kinc_file_reader_read(kinc_file_reader_t *reader, void *data, size_t size) {
+	KINC_PROFILER_BEGIN("File read");
+	int read;
 #ifdef KORE_ANDROID
 	if (reader->file != nullptr) {
-		return static_cast<int>(fread(data, 1, size, reader->file));
+		read = static_cast<int>(fread(data, 1, size, reader->file));
 	}
 	else {
-		int read = AAsset_read(reader->asset, data, size);
+		read = AAsset_read(reader->asset, data, size);
 		reader->pos += read;
-		return read;
 	}
 #else
-	return static_cast<int>(fread(data, 1, size, (FILE *)reader->file));
+	read = static_cast<int>(fread(data, 1, size, (FILE *)reader->file));
 #endif
+	KINC_PROFILER_END();
+	return read;
 }
 
 void kinc_file_reader_seek(kinc_file_reader_t *reader, int pos) {
@@ -1,9 +1,20 @@
 #include "log.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <kinc/io/filewriter.h>
+#include <kinc/memory.h>
 #include <kinc/system.h>
+#include <kinc/threads/mutex.h>
+
+#ifndef KORE_HTML5
+#define ASYNC_LOGGING
+#include <kinc/threads/atomic.h>
+#include <kinc/threads/event.h>
+#include <kinc/threads/thread.h>
+#endif
 
 #ifdef KORE_MICROSOFT
 #include <Windows.h>
@@ -14,16 +25,308 @@
 #include <android/log.h>
 #endif
 
+static kinc_log_level_t minimum_levels[KINC_LOG_CHANNEL_COUNT];
+
+static kinc_file_writer_t binary_file;
+static kinc_mutex_t binary_mutex;
+static bool binary_mutex_initialized = false;
+static volatile bool binary_open = false;
+
 void kinc_log(kinc_log_level_t level, const char *format, ...) {
 	va_list args;
 	va_start(args, format);
-	kinc_log_args(level, format, args);
+	kinc_log_channel_args(0, level, format, args);
 	va_end(args);
 }
 
+void kinc_log_args(kinc_log_level_t level, const char *format, va_list args) {
+	kinc_log_channel_args(0, level, format, args);
+}
+
+void kinc_log_channel(int channel, kinc_log_level_t level, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	kinc_log_channel_args(channel, level, format, args);
+	va_end(args);
+}
+
+void kinc_log_set_minimum_level(int channel, kinc_log_level_t minimum_level) {
+	if (channel < 0) {
+		for (int i = 0; i < KINC_LOG_CHANNEL_COUNT; ++i) {
+			minimum_levels[i] = minimum_level;
+		}
+	}
+	else if (channel < KINC_LOG_CHANNEL_COUNT) {
+		minimum_levels[channel] = minimum_level;
+	}
+}
+
+bool kinc_log_enabled(int channel, kinc_log_level_t level) {
+	return channel >= 0 && channel < KINC_LOG_CHANNEL_COUNT && level >= minimum_levels[channel];
+}
+
+static void write_binary(kinc_log_level_t level, int channel, kinc_ticks_t timestamp, const char *message) {
+	kinc_mutex_lock(&binary_mutex);
+	if (binary_open) {
+		size_t length = strlen(message);
+		uint8_t header[12];
+		memcpy(&header[0], &timestamp, 8);
+		header[8] = (uint8_t)level;
+		header[9] = (uint8_t)channel;
+		uint16_t length16 = length > 0xffff ? 0xffff : (uint16_t)length;
+		memcpy(&header[10], &length16, 2);
+		kinc_file_writer_write(&binary_file, header, sizeof(header));
+		kinc_file_writer_write(&binary_file, (void *)message, length16);
+	}
+	kinc_mutex_unlock(&binary_mutex);
+}
+
+bool kinc_log_open_binary(const char *filepath) {
+	if (!binary_mutex_initialized) {
+		kinc_mutex_init(&binary_mutex);
+		binary_mutex_initialized = true;
+	}
+	kinc_log_close_binary();
+	kinc_mutex_lock(&binary_mutex);
+	binary_open = kinc_file_writer_open(&binary_file, filepath);
+	if (binary_open) {
+		uint32_t version = 1;
+		double frequency = kinc_frequency();
+		kinc_file_writer_write(&binary_file, "KLOG", 4);
+		kinc_file_writer_write(&binary_file, &version, sizeof(version));
+		kinc_file_writer_write(&binary_file, &frequency, sizeof(frequency));
+	}
+	kinc_mutex_unlock(&binary_mutex);
+	return binary_open;
+}
+
+void kinc_log_close_binary(void) {
+	if (!binary_open) {
+		return;
+	}
+	kinc_log_flush();
+	kinc_mutex_lock(&binary_mutex);
+	binary_open = false;
+	kinc_file_writer_close(&binary_file);
+	kinc_mutex_unlock(&binary_mutex);
+}
+
+// Writes an already formatted message, used by the asynchronous writer thread.
+static void write_message(kinc_log_level_t level, const char *message) {
+#ifdef KORE_MICROSOFT
+	wchar_t buffer[KINC_LOG_ASYNC_MESSAGE_SIZE + 2];
+	MultiByteToWideChar(CP_UTF8, 0, message, -1, buffer, KINC_LOG_ASYNC_MESSAGE_SIZE);
+	buffer[KINC_LOG_ASYNC_MESSAGE_SIZE - 1] = 0;
+	wcscat(buffer, L"\r\n");
+	OutputDebugString(buffer);
+#ifdef KORE_WINDOWS
+	DWORD written;
+	WriteConsole(GetStdHandle(level == KINC_LOG_LEVEL_INFO ? STD_OUTPUT_HANDLE : STD_ERROR_HANDLE), buffer, (DWORD)wcslen(buffer), &written, NULL);
+#endif
+#elif defined(KORE_ANDROID)
+	switch (level) {
+	case KINC_LOG_LEVEL_INFO:
+		__android_log_write(ANDROID_LOG_INFO, "Kinc", message);
+		break;
+	case KINC_LOG_LEVEL_WARNING:
+		__android_log_write(ANDROID_LOG_WARN, "Kinc", message);
+		break;
+	case KINC_LOG_LEVEL_ERROR:
+		__android_log_write(ANDROID_LOG_ERROR, "Kinc", message);
+		break;
+	}
+#else
+	fprintf(level == KINC_LOG_LEVEL_INFO ? stdout : stderr, "%s\n", message);
+#endif
+}
+
+#ifdef ASYNC_LOGGING
+
+// Bounded multi-producer queue after Dmitry Vyukov. Every slot carries a sequence number which tells producers and the consumer whose turn it is,
+// so a producer only ever touches its own slot and never waits for other producers.
+// The compare-exchanges double as the required memory barriers.
+
+typedef struct {
+	volatile int32_t sequence;
+	kinc_log_level_t level;
+	int channel;
+	kinc_ticks_t timestamp;
+	char message[KINC_LOG_ASYNC_MESSAGE_SIZE];
+} log_record;
+
+static log_record *records = NULL;
+static uint32_t records_mask = 0;
+static volatile int32_t enqueue_position = 0;
+static volatile int32_t dequeue_position = 0;
+static volatile int32_t dropped = 0;
+static int32_t reported_dropped = 0;
+
+static volatile bool async_running = false;
+static volatile int32_t async_producers = 0;
+static kinc_thread_t writer_thread;
+static kinc_event_t writer_event;
+
+static bool push(int channel, kinc_log_level_t level, const char *format, va_list args) {
+	for (;;) {
+		int32_t position = enqueue_position;
+		log_record *record = &records[(uint32_t)position & records_mask];
+		int32_t difference = (int32_t)((uint32_t)record->sequence - (uint32_t)position);
+		if (difference == 0) {
+			if (KINC_ATOMIC_COMPARE_EXCHANGE(&enqueue_position, position, (int32_t)((uint32_t)position + 1))) {
+				record->level = level;
+				record->channel = channel;
+				record->timestamp = kinc_timestamp();
+				vsnprintf(record->message, KINC_LOG_ASYNC_MESSAGE_SIZE, format, args);
+				KINC_ATOMIC_COMPARE_EXCHANGE(&record->sequence, position, (int32_t)((uint32_t)position + 1));
+				return true;
+			}
+		}
+		else if (difference < 0) {
+			KINC_ATOMIC_INCREMENT(&dropped);
+			return false;
+		}
+	}
+}
+
+static bool pop_and_write(void) {
+	int32_t position = dequeue_position;
+	log_record *record = &records[(uint32_t)position & records_mask];
+	int32_t ready = (int32_t)((uint32_t)position + 1);
+	if (!KINC_ATOMIC_COMPARE_EXCHANGE(&record->sequence, ready, ready)) {
+		return false;
+	}
+	write_message(record->level, record->message);
+	if (binary_open) {
+		write_binary(record->level, record->channel, record->timestamp, record->message);
+	}
+	KINC_ATOMIC_COMPARE_EXCHANGE(&record->sequence, ready, (int32_t)((uint32_t)position + records_mask + 1));
+	KINC_ATOMIC_COMPARE_EXCHANGE(&dequeue_position, position, ready);
+	return true;
+}
+
+static void drain(void) {
+	while (pop_and_write()) {
+	}
+	int32_t current_dropped = dropped;
+	if (current_dropped != reported_dropped) {
+		char message[64];
+		snprintf(message, sizeof(message), "%i log messages were dropped.", (int)(current_dropped - reported_dropped));
+		write_message(KINC_LOG_LEVEL_WARNING, message);
+		reported_dropped = current_dropped;
+	}
+	fflush(stdout);
+}
+
+static void writer(void *param) {
+	while (async_running) {
+		drain();
+		kinc_event_try_to_wait(&writer_event, 0.01);
+	}
+	drain();
+}
+
+bool kinc_log_async_start(int capacity) {
+	if (async_running) {
+		return true;
+	}
+	uint32_t size = 2;
+	while (size < (uint32_t)capacity && size < 0x40000000) {
+		size *= 2;
+	}
+	records = (log_record *)kinc_memory_allocate(size * sizeof(log_record), KINC_MEMORY_TAG_GENERAL);
+	if (records == NULL) {
+		return false;
+	}
+	for (uint32_t i = 0; i < size; ++i) {
+		records[i].sequence = (int32_t)i;
+	}
+	records_mask = size - 1;
+	enqueue_position = 0;
+	dequeue_position = 0;
+	kinc_event_init(&writer_event, true);
+	async_running = true;
+	kinc_thread_init(&writer_thread, writer, NULL);
+	return true;
+}
+
+void kinc_log_async_stop(void) {
+	if (!async_running) {
+		return;
+	}
+	async_running = false;
+	// producers which saw async_running before it was cleared still write into the ring,
+	// the compare-exchange also orders the store above before reading the counter
+	while (!KINC_ATOMIC_COMPARE_EXCHANGE(&async_producers, 0, 0)) {
+		kinc_thread_sleep(1);
+	}
+	kinc_event_signal(&writer_event);
+	kinc_thread_wait_and_destroy(&writer_thread);
+	kinc_event_destroy(&writer_event);
+	kinc_memory_free(records);
+	records = NULL;
+}
+
+void kinc_log_flush(void) {
+	if (async_running) {
+		int32_t target = enqueue_position;
+		kinc_event_signal(&writer_event);
+		while ((int32_t)((uint32_t)dequeue_position - (uint32_t)target) < 0 && async_running) {
+			kinc_thread_sleep(1);
+		}
+	}
+	fflush(stdout);
+}
+
+int kinc_log_dropped_count(void) {
+	return dropped;
+}
+
+#else
+
+bool kinc_log_async_start(int capacity) {
+	return false;
+}
+
+void kinc_log_async_stop(void) {}
+
+void kinc_log_flush(void) {
+	fflush(stdout);
+}
+
+int kinc_log_dropped_count(void) {
+	return 0;
+}
+
+#endif
+
 #define UTF8
 
-void kinc_log_args(kinc_log_level_t level, const char *format, va_list args) {
+void kinc_log_channel_args(int channel, kinc_log_level_t level, const char *format, va_list args) {
+	if (!kinc_log_enabled(channel, level)) {
+		return;
+	}
+
+#ifdef ASYNC_LOGGING
+	if (async_running) {
+		KINC_ATOMIC_INCREMENT(&async_producers);
+		if (async_running) {
+			push(channel, level, format, args);
+			KINC_ATOMIC_DECREMENT(&async_producers);
+			return;
+		}
+		KINC_ATOMIC_DECREMENT(&async_producers);
+	}
+#endif
+
+	if (binary_open) {
+		char message[4096];
+		va_list binary_args;
+		va_copy(binary_args, args);
+		vsnprintf(message, sizeof(message), format, binary_args);
+		va_end(binary_args);
+		write_binary(level, channel, kinc_timestamp(), message);
+	}
+
 #ifdef KORE_MICROSOFT
 #ifdef UTF8
 	wchar_t buffer[4096];
@@ -46,7 +349,10 @@ void kinc_log_args(kinc_log_level_t level, const char *format, va_list args) {
 #endif
 #else
 	char buffer[4096];
-	vsnprintf(buffer, 4090, format, args);
+	va_list print_args;
+	va_copy(print_args, args);
+	vsnprintf(buffer, 4090, format, print_args);
+	va_end(print_args);
 	strcat(buffer, "\n");
 	fprintf(level == KINC_LOG_LEVEL_INFO ? stdout : stderr, "%s", buffer);
 #endif
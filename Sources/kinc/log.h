@@ -54,6 +54,78 @@ KINC_FUNC void kinc_log(kinc_log_level_t log_level, const char *format, ...);
 /// <param name="args">The parameter is equivalent to the second vprintf parameter.</param>
 KINC_FUNC void kinc_log_args(kinc_log_level_t log_level, const char *format, va_list args);
 
+#define KINC_LOG_CHANNEL_COUNT 32
+
+/// <summary>
+/// Maximum length of a message in asynchronous mode including the terminating zero, longer messages are cut off
+/// </summary>
+#define KINC_LOG_ASYNC_MESSAGE_SIZE 256
+
+/// <summary>
+/// Logs to a channel. kinc_log and kinc_log_args log to channel 0.
+/// </summary>
+/// <param name="channel">A channel between 0 and KINC_LOG_CHANNEL_COUNT - 1 which can be filtered independently</param>
+/// <param name="log_level">See kinc_log</param>
+/// <param name="format">The parameter is equivalent to the first printf parameter.</param>
+/// <param name="...">The parameter is equivalent to the second printf parameter.</param>
+KINC_FUNC void kinc_log_channel(int channel, kinc_log_level_t log_level, const char *format, ...);
+
+/// <summary>
+/// Equivalent to kinc_log_channel but uses a va_list parameter
+/// </summary>
+KINC_FUNC void kinc_log_channel_args(int channel, kinc_log_level_t log_level, const char *format, va_list args);
+
+/// <summary>
+/// Drops all messages of a channel which are below the given level. All levels are logged by default.
+/// </summary>
+/// <param name="channel">The channel to filter or -1 for all channels</param>
+/// <param name="minimum_level">The lowest level that will still be logged</param>
+KINC_FUNC void kinc_log_set_minimum_level(int channel, kinc_log_level_t minimum_level);
+
+/// <summary>
+/// Checks whether a message would pass the filter which can be used to skip preparing expensive log parameters.
+/// </summary>
+KINC_FUNC bool kinc_log_enabled(int channel, kinc_log_level_t log_level);
+
+/// <summary>
+/// Switches to asynchronous logging. Messages are formatted by the calling thread into a lock-free ring buffer and written out by a background thread,
+/// so logging does not block on console or file I/O and does not do system calls. Messages which do not fit into the ring are dropped and counted.
+/// Not supported on targets without threads.
+/// </summary>
+/// <param name="capacity">The number of messages the ring can hold, rounded up to a power of two</param>
+/// <returns>Whether asynchronous logging is active</returns>
+KINC_FUNC bool kinc_log_async_start(int capacity);
+
+/// <summary>
+/// Writes all pending messages and switches back to synchronous logging. Other threads may keep logging, their messages are written synchronously
+/// once this returns.
+/// </summary>
+KINC_FUNC void kinc_log_async_stop(void);
+
+/// <summary>
+/// Blocks until all messages which were logged before the call have been written.
+/// </summary>
+KINC_FUNC void kinc_log_flush(void);
+
+/// <summary>
+/// Returns the number of messages which were dropped because the asynchronous ring was full.
+/// </summary>
+KINC_FUNC int kinc_log_dropped_count(void);
+
+/// <summary>
+/// Additionally writes all messages to a compact binary file in the save directory. The file starts with the four bytes "KLOG", a uint32 version (1)
+/// and a double holding kinc_frequency(). Every record is a uint64 kinc_timestamp(), a uint8 level, a uint8 channel, a uint16 length and the
+/// message bytes without a terminating zero, everything in native byte order.
+/// </summary>
+/// <param name="filepath">A path relative to the save directory</param>
+/// <returns>Whether the file could be opened</returns>
+KINC_FUNC bool kinc_log_open_binary(const char *filepath);
+
+/// <summary>
+/// Closes the binary log file.
+/// </summary>
+KINC_FUNC void kinc_log_close_binary(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,6 @@
 #include <kinc/math/core.h>
 #include <kinc/math/matrix.h>
+#include <kinc/simd/float32x4.h>
 
 #include <memory.h>
 
@@ -12,13 +13,17 @@ void kinc_matrix3x3_set(kinc_matrix3x3_t *matrix, int x, int y, float value) {
 }
 
 void kinc_matrix3x3_transpose(kinc_matrix3x3_t *matrix) {
-	kinc_matrix3x3_t transposed;
-	for (int y = 0; y < 3; ++y) {
-		for (int x = 0; x < 3; ++x) {
-			kinc_matrix3x3_set(&transposed, x, y, kinc_matrix3x3_get(matrix, y, x));
-		}
-	}
-	memcpy(matrix->m, transposed.m, sizeof(transposed.m));
+	float *m = matrix->m;
+	float t;
+	t = m[1];
+	m[1] = m[3];
+	m[3] = t;
+	t = m[2];
+	m[2] = m[6];
+	m[6] = t;
+	t = m[5];
+	m[5] = m[7];
+	m[7] = t;
 }
 
 kinc_matrix3x3_t kinc_matrix3x3_identity(void) {
@@ -70,39 +75,30 @@ kinc_matrix3x3_t kinc_matrix3x3_translation(float x, float y) {
 	return m;
 }
 
+// Three-element columns do not map to 128 bit registers without padding so the 3x3 functions
+// are simply unrolled.
+
 kinc_matrix3x3_t kinc_matrix3x3_multiply(kinc_matrix3x3_t *a, kinc_matrix3x3_t *b) {
+	const float *am = a->m;
+	const float *bm = b->m;
 	kinc_matrix3x3_t result;
 	for (unsigned x = 0; x < 3; ++x) {
-		for (unsigned y = 0; y < 3; ++y) {
-			float t = kinc_matrix3x3_get(a, 0, y) * kinc_matrix3x3_get(b, x, 0);
-			for (unsigned i = 1; i < 3; ++i) {
-				t += kinc_matrix3x3_get(a, i, y) * kinc_matrix3x3_get(b, x, i);
-			}
-			kinc_matrix3x3_set(&result, x, y, t);
-		}
+		float b0 = bm[x * 3 + 0];
+		float b1 = bm[x * 3 + 1];
+		float b2 = bm[x * 3 + 2];
+		result.m[x * 3 + 0] = am[0] * b0 + am[3] * b1 + am[6] * b2;
+		result.m[x * 3 + 1] = am[1] * b0 + am[4] * b1 + am[7] * b2;
+		result.m[x * 3 + 2] = am[2] * b0 + am[5] * b1 + am[8] * b2;
 	}
 	return result;
 }
 
-static float vector3_get(kinc_vector3_t vec, int index) {
-	float *values = (float *)&vec;
-	return values[index];
-}
-
-static void vector3_set(kinc_vector3_t *vec, int index, float value) {
-	float *values = (float *)vec;
-	values[index] = value;
-}
-
 kinc_vector3_t kinc_matrix3x3_multiply_vector(kinc_matrix3x3_t *a, kinc_vector3_t b) {
+	const float *m = a->m;
 	kinc_vector3_t product;
-	for (unsigned y = 0; y < 3; ++y) {
-		float t = 0;
-		for (unsigned x = 0; x < 3; ++x) {
-			t += kinc_matrix3x3_get(a, x, y) * vector3_get(b, x);
-		}
-		vector3_set(&product, y, t);
-	}
+	product.x = m[0] * b.x + m[3] * b.y + m[6] * b.z;
+	product.y = m[1] * b.x + m[4] * b.y + m[7] * b.z;
+	product.z = m[2] * b.x + m[5] * b.y + m[8] * b.z;
 	return product;
 }
 
@@ -115,28 +111,90 @@ void kinc_matrix4x4_set(kinc_matrix4x4_t *matrix, int x, int y, float value) {
 }
 
 void kinc_matrix4x4_transpose(kinc_matrix4x4_t *matrix) {
-	kinc_matrix4x4_t transposed;
-	for (int y = 0; y < 4; ++y) {
-		for (int x = 0; x < 4; ++x) {
-			kinc_matrix4x4_set(&transposed, x, y, kinc_matrix4x4_get(matrix, y, x));
-		}
+	kinc_float32x4_t a = kinc_float32x4_load_unaligned(&matrix->m[0]);
+	kinc_float32x4_t b = kinc_float32x4_load_unaligned(&matrix->m[4]);
+	kinc_float32x4_t c = kinc_float32x4_load_unaligned(&matrix->m[8]);
+	kinc_float32x4_t d = kinc_float32x4_load_unaligned(&matrix->m[12]);
+	kinc_float32x4_transpose(&a, &b, &c, &d);
+	kinc_float32x4_store_unaligned(&matrix->m[0], a);
+	kinc_float32x4_store_unaligned(&matrix->m[4], b);
+	kinc_float32x4_store_unaligned(&matrix->m[8], c);
+	kinc_float32x4_store_unaligned(&matrix->m[12], d);
+}
+
+// Matrices are stored column by column, so every column of the result is a linear combination
+// of the columns of a, weighted by the elements of the corresponding column of b.
+static void multiply(const float *a, const float *b, float *result) {
+	kinc_float32x4_t a0 = kinc_float32x4_load_unaligned(&a[0]);
+	kinc_float32x4_t a1 = kinc_float32x4_load_unaligned(&a[4]);
+	kinc_float32x4_t a2 = kinc_float32x4_load_unaligned(&a[8]);
+	kinc_float32x4_t a3 = kinc_float32x4_load_unaligned(&a[12]);
+	kinc_float32x4_t columns[4];
+	for (int x = 0; x < 4; ++x) {
+		kinc_float32x4_t column = kinc_float32x4_mul(a0, kinc_float32x4_load_all(b[x * 4 + 0]));
+		column = kinc_float32x4_add(column, kinc_float32x4_mul(a1, kinc_float32x4_load_all(b[x * 4 + 1])));
+		column = kinc_float32x4_add(column, kinc_float32x4_mul(a2, kinc_float32x4_load_all(b[x * 4 + 2])));
+		column = kinc_float32x4_add(column, kinc_float32x4_mul(a3, kinc_float32x4_load_all(b[x * 4 + 3])));
+		columns[x] = column;
+	}
+	for (int x = 0; x < 4; ++x) {
+		kinc_float32x4_store_unaligned(&result[x * 4], columns[x]);
 	}
-	memcpy(matrix->m, transposed.m, sizeof(transposed.m));
 }
 
-#ifdef __clang__
-#pragma clang diagnostic ignored "-Wconditional-uninitialized"
-#endif
-
 kinc_matrix4x4_t kinc_matrix4x4_multiply(kinc_matrix4x4_t *a, kinc_matrix4x4_t *b) {
 	kinc_matrix4x4_t result;
-	for (unsigned x = 0; x < 4; ++x)
-		for (unsigned y = 0; y < 4; ++y) {
-			float t = kinc_matrix4x4_get(a, 0, y) * kinc_matrix4x4_get(b, x, 0);
-			for (unsigned i = 1; i < 4; ++i) {
-				t += kinc_matrix4x4_get(a, i, y) * kinc_matrix4x4_get(b, x, i);
-			}
-			kinc_matrix4x4_set(&result, x, y, t);
-		}
+	multiply(a->m, b->m, result.m);
+	return result;
+}
+
+kinc_vector4_t kinc_matrix4x4_multiply_vector(kinc_matrix4x4_t *a, kinc_vector4_t b) {
+	kinc_vector4_t result;
+	kinc_matrix4x4_multiply_vectors(a, &b, &result, 1);
 	return result;
 }
+
+void kinc_matrix4x4_multiply_matrices(kinc_matrix4x4_t *a, const kinc_matrix4x4_t *b, kinc_matrix4x4_t *results, int count) {
+	for (int i = 0; i < count; ++i) {
+		multiply(a->m, b[i].m, results[i].m);
+	}
+}
+
+void kinc_matrix4x4_multiply_matrix_pairs(const kinc_matrix4x4_t *a, const kinc_matrix4x4_t *b, kinc_matrix4x4_t *results, int count) {
+	for (int i = 0; i < count; ++i) {
+		multiply(a[i].m, b[i].m, results[i].m);
+	}
+}
+
+void kinc_matrix4x4_multiply_vectors(kinc_matrix4x4_t *a, const kinc_vector4_t *vectors, kinc_vector4_t *results, int count) {
+	kinc_float32x4_t a0 = kinc_float32x4_load_unaligned(&a->m[0]);
+	kinc_float32x4_t a1 = kinc_float32x4_load_unaligned(&a->m[4]);
+	kinc_float32x4_t a2 = kinc_float32x4_load_unaligned(&a->m[8]);
+	kinc_float32x4_t a3 = kinc_float32x4_load_unaligned(&a->m[12]);
+	for (int i = 0; i < count; ++i) {
+		kinc_vector4_t v = vectors[i];
+		kinc_float32x4_t result = kinc_float32x4_mul(a0, kinc_float32x4_load_all(v.x));
+		result = kinc_float32x4_add(result, kinc_float32x4_mul(a1, kinc_float32x4_load_all(v.y)));
+		result = kinc_float32x4_add(result, kinc_float32x4_mul(a2, kinc_float32x4_load_all(v.z)));
+		result = kinc_float32x4_add(result, kinc_float32x4_mul(a3, kinc_float32x4_load_all(v.w)));
+		kinc_float32x4_store_unaligned(&results[i].x, result);
+	}
+}
+
+void kinc_matrix4x4_multiply_points(kinc_matrix4x4_t *a, const kinc_vector3_t *points, kinc_vector3_t *results, int count) {
+	kinc_float32x4_t a0 = kinc_float32x4_load_unaligned(&a->m[0]);
+	kinc_float32x4_t a1 = kinc_float32x4_load_unaligned(&a->m[4]);
+	kinc_float32x4_t a2 = kinc_float32x4_load_unaligned(&a->m[8]);
+	kinc_float32x4_t a3 = kinc_float32x4_load_unaligned(&a->m[12]);
+	for (int i = 0; i < count; ++i) {
+		kinc_vector3_t p = points[i];
+		kinc_float32x4_t result = kinc_float32x4_add(a3, kinc_float32x4_mul(a0, kinc_float32x4_load_all(p.x)));
+		result = kinc_float32x4_add(result, kinc_float32x4_mul(a1, kinc_float32x4_load_all(p.y)));
+		result = kinc_float32x4_add(result, kinc_float32x4_mul(a2, kinc_float32x4_load_all(p.z)));
+		float values[4];
+		kinc_float32x4_store_unaligned(values, result);
+		results[i].x = values[0];
+		results[i].y = values[1];
+		results[i].z = values[2];
+	}
+}
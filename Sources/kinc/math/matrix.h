@@ -35,6 +35,27 @@ KINC_FUNC float kinc_matrix4x4_get(kinc_matrix4x4_t *matrix, int x, int y);
 KINC_FUNC void kinc_matrix4x4_set(kinc_matrix4x4_t *matrix, int x, int y, float value);
 KINC_FUNC void kinc_matrix4x4_transpose(kinc_matrix4x4_t *matrix);
 KINC_FUNC kinc_matrix4x4_t kinc_matrix4x4_multiply(kinc_matrix4x4_t *a, kinc_matrix4x4_t *b);
+KINC_FUNC kinc_vector4_t kinc_matrix4x4_multiply_vector(kinc_matrix4x4_t *a, kinc_vector4_t b);
+
+/// <summary>
+/// Multiplies a with every matrix in b, writing a * b[i] to results[i]. results may alias b.
+/// </summary>
+KINC_FUNC void kinc_matrix4x4_multiply_matrices(kinc_matrix4x4_t *a, const kinc_matrix4x4_t *b, kinc_matrix4x4_t *results, int count);
+
+/// <summary>
+/// Multiplies two arrays of matrices pairwise, writing a[i] * b[i] to results[i]. results may alias a or b.
+/// </summary>
+KINC_FUNC void kinc_matrix4x4_multiply_matrix_pairs(const kinc_matrix4x4_t *a, const kinc_matrix4x4_t *b, kinc_matrix4x4_t *results, int count);
+
+/// <summary>
+/// Transforms an array of vectors by a. results may alias vectors.
+/// </summary>
+KINC_FUNC void kinc_matrix4x4_multiply_vectors(kinc_matrix4x4_t *a, const kinc_vector4_t *vectors, kinc_vector4_t *results, int count);
+
+/// <summary>
+/// Transforms an array of points by a, treating their w-component as 1 and without a perspective divide. results may alias points.
+/// </summary>
+KINC_FUNC void kinc_matrix4x4_multiply_points(kinc_matrix4x4_t *a, const kinc_vector3_t *points, kinc_vector3_t *results, int count);
 
 #ifdef __cplusplus
 }
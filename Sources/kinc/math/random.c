@@ -1,40 +1,319 @@
 #include "random.h"
 
+#include <kinc/memory.h>
+#include <kinc/simd/float32x4.h>
+#include <kinc/simd/int32x4.h>
+#include <kinc/system.h>
+#include <kinc/threads/atomic.h>
+#include <kinc/threads/threadlocal.h>
+
 // MT19937
 
-static int MT[624];
-static int index = 0;
+#define MT_SIZE 624
+#define MT_OFFSET 397
+
+static uint32_t MT[MT_SIZE];
+// MT_SIZE + 1 marks a generator which was never seeded
+static int index = MT_SIZE + 1;
+static uint64_t thread_seed = 5489;
+
+static inline void twist(int i, int next, int offset) {
+	uint32_t y = (MT[i] & 0x80000000) | (MT[next] & 0x7fffffff);
+	MT[i] = MT[offset] ^ (y >> 1) ^ ((y & 1) != 0 ? 0x9908b0df : 0);
+}
 
-static void generateNumbers() {
-	for (int i = 0; i < 624; ++i) {
-		int y = (MT[i] & 1) + (MT[(i + 1) % 624]) & 0x7fffffff;
-		MT[i] = MT[(i + 397) % 624] ^ (y >> 1);
-		if ((y % 2) != 0) MT[i] = MT[i] ^ 0x9908b0df;
+static void generateNumbers(void) {
+	int i = 0;
+	for (; i < MT_SIZE - MT_OFFSET; ++i) {
+		twist(i, i + 1, i + MT_OFFSET);
+	}
+	for (; i < MT_SIZE - 1; ++i) {
+		twist(i, i + 1, i + MT_OFFSET - MT_SIZE);
 	}
+	twist(MT_SIZE - 1, 0, MT_OFFSET - 1);
 }
 
 void kinc_random_init(int seed) {
-	MT[0] = seed;
-	for (int i = 1; i < 624; ++i) MT[i] = 0x6c078965 * (MT[i - 1] ^ (MT[i - 1] >> 30)) + i;
+	MT[0] = (uint32_t)seed;
+	for (uint32_t i = 1; i < MT_SIZE; ++i) {
+		MT[i] = 0x6c078965 * (MT[i - 1] ^ (MT[i - 1] >> 30)) + i;
+	}
+	index = MT_SIZE;
+	thread_seed = (uint32_t)seed;
 }
 
-int kinc_random_get() {
-	if (index == 0) generateNumbers();
+static uint32_t mt_get(void) {
+	if (index >= MT_SIZE) {
+		if (index > MT_SIZE) {
+			kinc_random_init(5489);
+		}
+		generateNumbers();
+		index = 0;
+	}
 
-	int y = MT[index];
+	uint32_t y = MT[index++];
 	y = y ^ (y >> 11);
-	y = y ^ ((y << 7) & (0x9d2c5680));
-	y = y ^ ((y << 15) & (0xefc60000));
+	y = y ^ ((y << 7) & 0x9d2c5680);
+	y = y ^ ((y << 15) & 0xefc60000);
 	y = y ^ (y >> 18);
-
-	index = (index + 1) % 624;
 	return y;
 }
 
+int kinc_random_get(void) {
+	return (int)mt_get();
+}
+
 int kinc_random_get_max(int max) {
-	return kinc_random_get() % (max + 1);
+	return kinc_random_get_in(0, max);
 }
 
 int kinc_random_get_in(int min, int max) {
-	return kinc_random_get() % (max + 1 - min) + min;
+	uint32_t range = (uint32_t)max - (uint32_t)min + 1;
+	if (range == 0) {
+		return (int)mt_get();
+	}
+	// Lemire's multiply-shift, rejecting the few values which would introduce a bias
+	uint64_t m = (uint64_t)mt_get() * range;
+	if ((uint32_t)m < range) {
+		uint32_t threshold = (0 - range) % range;
+		while ((uint32_t)m < threshold) {
+			m = (uint64_t)mt_get() * range;
+		}
+	}
+	return (int)((uint32_t)min + (uint32_t)(m >> 32));
+}
+
+// xoshiro256**, see https://prng.di.unimi.it
+
+static inline uint64_t rotl64(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t splitmix64(uint64_t *x) {
+	uint64_t z = (*x += 0x9e3779b97f4a7c15);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+static inline uint64_t next(kinc_random_state_t *state) {
+	uint64_t *s = state->s;
+	uint64_t result = rotl64(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl64(s[3], 45);
+	return result;
+}
+
+static inline float to_float(uint32_t value) {
+	// 24 bits fit exactly into a float's mantissa
+	return (value >> 8) * (1.0f / 16777216.0f);
+}
+
+void kinc_random_state_init(kinc_random_state_t *state, uint64_t seed) {
+	// splitmix64 never produces four zeros in a row so the state can not end up all zero
+	for (int i = 0; i < 4; ++i) {
+		state->s[i] = splitmix64(&seed);
+	}
+}
+
+static kinc_thread_local_t thread_state;
+
+#ifdef KORE_HTML5
+static bool thread_state_ready = false;
+
+static void initThreadStateSlot(void) {
+	if (!thread_state_ready) {
+		kinc_thread_local_init(&thread_state);
+		thread_state_ready = true;
+	}
+}
+#else
+// 0: not initialized, 1: being initialized by some thread, 2: ready
+static volatile int32_t thread_state_slot = 0;
+
+static void initThreadStateSlot(void) {
+	if (thread_state_slot == 2) {
+		return;
+	}
+	if (KINC_ATOMIC_COMPARE_EXCHANGE(&thread_state_slot, 0, 1)) {
+		kinc_thread_local_init(&thread_state);
+		KINC_ATOMIC_COMPARE_EXCHANGE(&thread_state_slot, 1, 2);
+	}
+	else {
+		while (thread_state_slot != 2) {
+		}
+	}
+}
+#endif
+
+kinc_random_state_t *kinc_random_thread_state(void) {
+	initThreadStateSlot();
+	kinc_random_state_t *state = (kinc_random_state_t *)kinc_thread_local_get(&thread_state);
+	if (state == NULL) {
+		state = (kinc_random_state_t *)kinc_memory_allocate(sizeof(kinc_random_state_t), KINC_MEMORY_TAG_GENERAL);
+		uint64_t address = (uint64_t)(uintptr_t)state;
+		uint64_t time = (uint64_t)kinc_timestamp();
+		kinc_random_state_init(state, thread_seed ^ splitmix64(&address) ^ splitmix64(&time));
+		kinc_thread_local_set(&thread_state, state);
+	}
+	return state;
+}
+
+void kinc_random_state_jump(kinc_random_state_t *state) {
+	static const uint64_t jump[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+	uint64_t s[4] = {0, 0, 0, 0};
+	for (int i = 0; i < 4; ++i) {
+		for (int b = 0; b < 64; ++b) {
+			if (jump[i] & ((uint64_t)1 << b)) {
+				for (int j = 0; j < 4; ++j) {
+					s[j] ^= state->s[j];
+				}
+			}
+			next(state);
+		}
+	}
+	for (int i = 0; i < 4; ++i) {
+		state->s[i] = s[i];
+	}
+}
+
+uint64_t kinc_random_state_get_uint64(kinc_random_state_t *state) {
+	return next(state);
+}
+
+uint32_t kinc_random_state_get_uint32(kinc_random_state_t *state) {
+	return (uint32_t)(next(state) >> 32);
+}
+
+static inline uint32_t below(kinc_random_state_t *state, uint32_t random, uint32_t bound) {
+	uint64_t m = (uint64_t)random * bound;
+	if ((uint32_t)m < bound) {
+		uint32_t threshold = (0 - bound) % bound;
+		while ((uint32_t)m < threshold) {
+			m = (uint64_t)(uint32_t)(next(state) >> 32) * bound;
+		}
+	}
+	return (uint32_t)(m >> 32);
+}
+
+uint32_t kinc_random_state_get_below(kinc_random_state_t *state, uint32_t bound) {
+	return below(state, (uint32_t)(next(state) >> 32), bound);
+}
+
+int kinc_random_state_get_in(kinc_random_state_t *state, int min, int max) {
+	uint32_t range = (uint32_t)max - (uint32_t)min + 1;
+	if (range == 0) {
+		return (int)kinc_random_state_get_uint32(state);
+	}
+	return (int)((uint32_t)min + kinc_random_state_get_below(state, range));
+}
+
+float kinc_random_state_get_float(kinc_random_state_t *state) {
+	return to_float((uint32_t)(next(state) >> 32));
+}
+
+float kinc_random_state_get_float_in(kinc_random_state_t *state, float min, float max) {
+	return min + (max - min) * kinc_random_state_get_float(state);
+}
+
+// The bulk functions use both halves of every 64bit result.
+
+void kinc_random_state_fill_uint32(kinc_random_state_t *state, uint32_t *values, size_t count) {
+	size_t i = 0;
+	for (; i + 1 < count; i += 2) {
+		uint64_t value = next(state);
+		values[i] = (uint32_t)(value >> 32);
+		values[i + 1] = (uint32_t)value;
+	}
+	if (i < count) {
+		values[i] = (uint32_t)(next(state) >> 32);
+	}
+}
+
+void kinc_random_state_fill_in(kinc_random_state_t *state, int *values, size_t count, int min, int max) {
+	uint32_t range = (uint32_t)max - (uint32_t)min + 1;
+	if (range == 0) {
+		kinc_random_state_fill_uint32(state, (uint32_t *)values, count);
+		return;
+	}
+	size_t i = 0;
+	for (; i + 1 < count; i += 2) {
+		uint64_t value = next(state);
+		values[i] = (int)((uint32_t)min + below(state, (uint32_t)(value >> 32), range));
+		values[i + 1] = (int)((uint32_t)min + below(state, (uint32_t)value, range));
+	}
+	if (i < count) {
+		values[i] = kinc_random_state_get_in(state, min, max);
+	}
+}
+
+// Below this count seeding the SIMD lanes costs more than it saves.
+#define SIMD_FILL_THRESHOLD 64
+
+static size_t fill_float_simd(kinc_random_state_t *state, float *values, size_t count) {
+	// four independent xoshiro128+ generators, one per lane - their high bits are of full quality which is all that to_float uses
+	int32_t seeds[16];
+	kinc_random_state_fill_uint32(state, (uint32_t *)seeds, 16);
+	seeds[0] |= 1;
+	seeds[1] |= 1;
+	seeds[2] |= 1;
+	seeds[3] |= 1;
+	kinc_int32x4_t s0 = kinc_int32x4_load_unaligned(&seeds[0]);
+	kinc_int32x4_t s1 = kinc_int32x4_load_unaligned(&seeds[4]);
+	kinc_int32x4_t s2 = kinc_int32x4_load_unaligned(&seeds[8]);
+	kinc_int32x4_t s3 = kinc_int32x4_load_unaligned(&seeds[12]);
+	kinc_float32x4_t scale = kinc_float32x4_load_all(1.0f / 16777216.0f);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		kinc_int32x4_t result = kinc_int32x4_add(s0, s3);
+		kinc_int32x4_t t = kinc_int32x4_shift_left(s1, 9);
+		s2 = kinc_int32x4_xor(s2, s0);
+		s3 = kinc_int32x4_xor(s3, s1);
+		s1 = kinc_int32x4_xor(s1, s2);
+		s0 = kinc_int32x4_xor(s0, s3);
+		s2 = kinc_int32x4_xor(s2, t);
+		s3 = kinc_int32x4_or(kinc_int32x4_shift_left(s3, 11), kinc_int32x4_shift_right_logical(s3, 21));
+
+		kinc_float32x4_t value = kinc_int32x4_to_float32x4(kinc_int32x4_shift_right_logical(result, 8));
+		kinc_float32x4_store_unaligned(&values[i], kinc_float32x4_mul(value, scale));
+	}
+	return i;
+}
+
+void kinc_random_state_fill_float(kinc_random_state_t *state, float *values, size_t count) {
+	size_t i = 0;
+	if (count >= SIMD_FILL_THRESHOLD) {
+		i = fill_float_simd(state, values, count);
+	}
+	for (; i + 1 < count; i += 2) {
+		uint64_t value = next(state);
+		values[i] = to_float((uint32_t)(value >> 32));
+		values[i + 1] = to_float((uint32_t)value);
+	}
+	if (i < count) {
+		values[i] = kinc_random_state_get_float(state);
+	}
+}
+
+void kinc_random_state_fill_float_in(kinc_random_state_t *state, float *values, size_t count, float min, float max) {
+	kinc_random_state_fill_float(state, values, count);
+	float range = max - min;
+	size_t i = 0;
+	if (count >= 4) {
+		kinc_float32x4_t offset = kinc_float32x4_load_all(min);
+		kinc_float32x4_t scale = kinc_float32x4_load_all(range);
+		for (; i + 4 <= count; i += 4) {
+			kinc_float32x4_t value = kinc_float32x4_load_unaligned(&values[i]);
+			kinc_float32x4_store_unaligned(&values[i], kinc_float32x4_add(offset, kinc_float32x4_mul(value, scale)));
+		}
+	}
+	for (; i < count; ++i) {
+		values[i] = min + range * values[i];
+	}
 }
@@ -2,14 +2,22 @@
 
 #include <kinc/global.h>
 
+#include <stddef.h>
+#include <stdint.h>
+
 /*! \file random.h
-    \brief Generates values which are kind of random.
+    \brief Generates values which are kind of random. The kinc_random_get-functions share one global generator and must only be used from a single thread.
+   The kinc_random_state-functions operate on explicit generator states (xoshiro256**) and kinc_random_thread_state provides one such state per thread.
 */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef struct kinc_random_state {
+	uint64_t s[4];
+} kinc_random_state_t;
+
 /// <summary>
 /// Initialize the randomizer.
 /// </summary>
@@ -34,6 +42,85 @@ KINC_FUNC int kinc_random_get_max(int max);
 /// <returns>A random value</returns>
 KINC_FUNC int kinc_random_get_in(int min, int max);
 
+/// <summary>
+/// Initializes a generator state. Equal seeds produce equal sequences.
+/// </summary>
+/// <param name="state">The state to initialize</param>
+/// <param name="seed">Any value, zero included</param>
+KINC_FUNC void kinc_random_state_init(kinc_random_state_t *state, uint64_t seed);
+
+/// <summary>
+/// Returns the generator state of the calling thread. Every thread gets its own state which is seeded on first use from the seed which was last passed
+/// to kinc_random_init, mixed with a per-thread value so that threads do not produce the same sequences. The state is allocated on first use and
+/// is not freed when the thread ends.
+/// </summary>
+/// <returns>The state of the calling thread</returns>
+KINC_FUNC kinc_random_state_t *kinc_random_thread_state(void);
+
+/// <summary>
+/// Advances the state as if kinc_random_state_get_uint64 was called 2^128 times. Can be used to derive non-overlapping sequences for worker threads
+/// from a single seed.
+/// </summary>
+/// <param name="state">The state to advance</param>
+KINC_FUNC void kinc_random_state_jump(kinc_random_state_t *state);
+
+/// <summary>
+/// Returns 64 random bits.
+/// </summary>
+/// <returns>A random value</returns>
+KINC_FUNC uint64_t kinc_random_state_get_uint64(kinc_random_state_t *state);
+
+/// <summary>
+/// Returns 32 random bits.
+/// </summary>
+/// <returns>A random value</returns>
+KINC_FUNC uint32_t kinc_random_state_get_uint32(kinc_random_state_t *state);
+
+/// <summary>
+/// Returns a value between 0 (inclusive) and bound (exclusive) without modulo bias. Returns 0 if bound is 0.
+/// </summary>
+/// <returns>A random value</returns>
+KINC_FUNC uint32_t kinc_random_state_get_below(kinc_random_state_t *state, uint32_t bound);
+
+/// <summary>
+/// Returns a value between min and max (both inclusive) without modulo bias.
+/// </summary>
+/// <returns>A random value</returns>
+KINC_FUNC int kinc_random_state_get_in(kinc_random_state_t *state, int min, int max);
+
+/// <summary>
+/// Returns a value between 0 (inclusive) and 1 (exclusive).
+/// </summary>
+/// <returns>A random value</returns>
+KINC_FUNC float kinc_random_state_get_float(kinc_random_state_t *state);
+
+/// <summary>
+/// Returns a value between min (inclusive) and max (exclusive).
+/// </summary>
+/// <returns>A random value</returns>
+KINC_FUNC float kinc_random_state_get_float_in(kinc_random_state_t *state, float min, float max);
+
+/// <summary>
+/// Fills an array with random bits.
+/// </summary>
+KINC_FUNC void kinc_random_state_fill_uint32(kinc_random_state_t *state, uint32_t *values, size_t count);
+
+/// <summary>
+/// Fills an array with values between min and max (both inclusive) without modulo bias.
+/// </summary>
+KINC_FUNC void kinc_random_state_fill_in(kinc_random_state_t *state, int *values, size_t count, int min, int max);
+
+/// <summary>
+/// Fills an array with values between 0 (inclusive) and 1 (exclusive). Large arrays are filled using four SIMD lanes of xoshiro128+ which are seeded from
+/// the state, so the values differ from what repeated kinc_random_state_get_float calls would return.
+/// </summary>
+KINC_FUNC void kinc_random_state_fill_float(kinc_random_state_t *state, float *values, size_t count);
+
+/// <summary>
+/// Fills an array with values between min (inclusive) and max (exclusive).
+/// </summary>
+KINC_FUNC void kinc_random_state_fill_float_in(kinc_random_state_t *state, float *values, size_t count, float min, float max);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,291 @@
+#include "memory.h"
+
+#include <kinc/error.h>
+#include <kinc/log.h>
+#include <kinc/threads/atomic.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MAGIC 0x4b4d454d
+
+// put in front of every allocation to find the size and the tag again when it is freed
+typedef struct header {
+	size_t size;
+	uint32_t tag;
+	uint32_t magic;
+#ifdef KINC_MEMORY_TRACKING
+	struct header *previous;
+	struct header *next;
+	uint64_t number;
+#endif
+} header_t;
+
+// keeps the memory behind the header aligned like the memory the allocator returns
+#define HEADER_SIZE ((sizeof(header_t) + 15) & ~(size_t)15)
+
+static void *defaultAllocate(size_t size, kinc_memory_tag_t tag, void *user_data) {
+	return malloc(size);
+}
+
+static void *defaultReallocate(void *memory, size_t old_size, size_t new_size, kinc_memory_tag_t tag, void *user_data) {
+	return realloc(memory, new_size);
+}
+
+static void defaultFree(void *memory, size_t size, kinc_memory_tag_t tag, void *user_data) {
+	free(memory);
+}
+
+static kinc_memory_allocator_t allocator = {defaultAllocate, defaultReallocate, defaultFree, NULL};
+
+// every counter is updated atomically on its own so allocations on different threads do not wait for each other
+typedef struct counters {
+	volatile int64_t live_bytes;
+	volatile int64_t live_allocations;
+	volatile int64_t peak_bytes;
+	volatile int64_t total_allocations;
+} counters_t;
+
+static counters_t statistics[KINC_MEMORY_TAG_COUNT];
+
+#ifdef KORE_HTML5
+static int64_t loadCounter(volatile int64_t *counter) {
+	return *counter;
+}
+
+static int64_t addToCounter(volatile int64_t *counter, int64_t value) {
+	*counter += value;
+	return *counter;
+}
+
+static void raiseCounter(volatile int64_t *counter, int64_t value) {
+	if (value > *counter) {
+		*counter = value;
+	}
+}
+#else
+// a plain read could tear on 32 bit platforms
+static int64_t loadCounter(volatile int64_t *counter) {
+	int64_t value;
+	do {
+		value = *counter;
+	} while (!KINC_ATOMIC_COMPARE_EXCHANGE_64(counter, value, value));
+	return value;
+}
+
+// returns the new value
+static int64_t addToCounter(volatile int64_t *counter, int64_t value) {
+	int64_t old_value;
+	do {
+		old_value = *counter;
+	} while (!KINC_ATOMIC_COMPARE_EXCHANGE_64(counter, old_value, old_value + value));
+	return old_value + value;
+}
+
+static void raiseCounter(volatile int64_t *counter, int64_t value) {
+	int64_t old_value;
+	do {
+		old_value = *counter;
+		if (old_value >= value) {
+			return;
+		}
+	} while (!KINC_ATOMIC_COMPARE_EXCHANGE_64(counter, old_value, value));
+}
+#endif
+
+#ifdef KINC_MEMORY_TRACKING
+static header_t *live = NULL;
+
+#ifdef KORE_HTML5
+static void lockLive(void) {}
+static void unlockLive(void) {}
+#else
+static volatile int32_t live_lock = 0;
+
+static void lockLive(void) {
+	while (!KINC_ATOMIC_COMPARE_EXCHANGE(&live_lock, 0, 1)) {
+	}
+}
+
+static void unlockLive(void) {
+	KINC_ATOMIC_COMPARE_EXCHANGE(&live_lock, 1, 0);
+}
+#endif
+#endif
+
+static void addAllocation(header_t *header) {
+	counters_t *counters = &statistics[header->tag];
+	raiseCounter(&counters->peak_bytes, addToCounter(&counters->live_bytes, (int64_t)header->size));
+	addToCounter(&counters->live_allocations, 1);
+	addToCounter(&counters->total_allocations, 1);
+#ifdef KINC_MEMORY_TRACKING
+	lockLive();
+	static uint64_t next_number = 0;
+	header->number = next_number++;
+	header->previous = NULL;
+	header->next = live;
+	if (live != NULL) {
+		live->previous = header;
+	}
+	live = header;
+	unlockLive();
+#endif
+}
+
+static void removeAllocation(header_t *header) {
+	counters_t *counters = &statistics[header->tag];
+	addToCounter(&counters->live_bytes, -(int64_t)header->size);
+	addToCounter(&counters->live_allocations, -1);
+#ifdef KINC_MEMORY_TRACKING
+	lockLive();
+	if (header->previous != NULL) {
+		header->previous->next = header->next;
+	}
+	else {
+		live = header->next;
+	}
+	if (header->next != NULL) {
+		header->next->previous = header->previous;
+	}
+	unlockLive();
+#endif
+}
+
+static header_t *getHeader(void *memory) {
+	header_t *header = (header_t *)((uint8_t *)memory - HEADER_SIZE);
+	kinc_affirm_message(header->magic == MAGIC, "Memory was not allocated by kinc_memory_allocate or was already freed.");
+	return header;
+}
+
+void kinc_memory_set_allocator(const kinc_memory_allocator_t *new_allocator) {
+	kinc_affirm_message(kinc_memory_get_statistics(KINC_MEMORY_TAG_COUNT).live_allocations == 0,
+	                    "The allocator has to be set before the first allocation, memory would be freed by an allocator which did not allocate it.");
+	if (new_allocator == NULL) {
+		allocator.allocate = defaultAllocate;
+		allocator.reallocate = defaultReallocate;
+		allocator.free = defaultFree;
+		allocator.user_data = NULL;
+	}
+	else {
+		allocator = *new_allocator;
+	}
+}
+
+void *kinc_memory_allocate(size_t size, kinc_memory_tag_t tag) {
+	header_t *header = (header_t *)allocator.allocate(HEADER_SIZE + size, tag, allocator.user_data);
+	if (header == NULL) {
+		kinc_log(KINC_LOG_LEVEL_ERROR, "Could not allocate %zu bytes for %s.", size, kinc_memory_tag_name(tag));
+		return NULL;
+	}
+	header->size = size;
+	header->tag = (uint32_t)tag;
+	header->magic = MAGIC;
+	addAllocation(header);
+	return (uint8_t *)header + HEADER_SIZE;
+}
+
+void *kinc_memory_allocate_zeroed(size_t size, kinc_memory_tag_t tag) {
+	void *memory = kinc_memory_allocate(size, tag);
+	if (memory != NULL) {
+		memset(memory, 0, size);
+	}
+	return memory;
+}
+
+void *kinc_memory_reallocate(void *memory, size_t size, kinc_memory_tag_t tag) {
+	if (memory == NULL) {
+		return kinc_memory_allocate(size, tag);
+	}
+	header_t *header = getHeader(memory);
+	kinc_memory_tag_t old_tag = (kinc_memory_tag_t)header->tag;
+	size_t old_size = header->size;
+
+	if (allocator.reallocate == NULL) {
+		void *new_memory = kinc_memory_allocate(size, old_tag);
+		if (new_memory == NULL) {
+			return NULL;
+		}
+		memcpy(new_memory, memory, old_size < size ? old_size : size);
+		kinc_memory_free(memory);
+		return new_memory;
+	}
+
+	// the header moves with the memory so it has to be unlinked before and linked again afterwards
+	removeAllocation(header);
+	header_t *new_header = (header_t *)allocator.reallocate(header, HEADER_SIZE + old_size, HEADER_SIZE + size, old_tag, allocator.user_data);
+	if (new_header == NULL) {
+		addAllocation(header);
+		kinc_log(KINC_LOG_LEVEL_ERROR, "Could not reallocate %zu bytes for %s.", size, kinc_memory_tag_name(old_tag));
+		return NULL;
+	}
+	new_header->size = size;
+	addAllocation(new_header);
+	return (uint8_t *)new_header + HEADER_SIZE;
+}
+
+void kinc_memory_free(void *memory) {
+	if (memory == NULL) {
+		return;
+	}
+	header_t *header = getHeader(memory);
+	removeAllocation(header);
+	header->magic = 0;
+	allocator.free(header, HEADER_SIZE + header->size, (kinc_memory_tag_t)header->tag, allocator.user_data);
+}
+
+kinc_memory_statistics_t kinc_memory_get_statistics(kinc_memory_tag_t tag) {
+	kinc_memory_statistics_t result;
+	memset(&result, 0, sizeof(result));
+	int first = tag == KINC_MEMORY_TAG_COUNT ? 0 : (int)tag;
+	int last = tag == KINC_MEMORY_TAG_COUNT ? KINC_MEMORY_TAG_COUNT - 1 : (int)tag;
+	for (int i = first; i <= last; ++i) {
+		result.live_bytes += (size_t)loadCounter(&statistics[i].live_bytes);
+		result.live_allocations += (size_t)loadCounter(&statistics[i].live_allocations);
+		result.peak_bytes += (size_t)loadCounter(&statistics[i].peak_bytes);
+		result.total_allocations += (uint64_t)loadCounter(&statistics[i].total_allocations);
+	}
+	return result;
+}
+
+const char *kinc_memory_tag_name(kinc_memory_tag_t tag) {
+	switch (tag) {
+	case KINC_MEMORY_TAG_GENERAL:
+		return "general";
+	case KINC_MEMORY_TAG_IMAGE:
+		return "image";
+	case KINC_MEMORY_TAG_AUDIO:
+		return "audio";
+	case KINC_MEMORY_TAG_GRAPHICS:
+		return "graphics";
+	case KINC_MEMORY_TAG_NETWORK:
+		return "network";
+	case KINC_MEMORY_TAG_IO:
+		return "io";
+	default:
+		return "unknown";
+	}
+}
+
+size_t kinc_memory_report_leaks(void) {
+	size_t leaks = 0;
+	for (int i = 0; i < KINC_MEMORY_TAG_COUNT; ++i) {
+		kinc_memory_statistics_t stats = kinc_memory_get_statistics((kinc_memory_tag_t)i);
+		if (stats.live_allocations > 0) {
+			kinc_log(KINC_LOG_LEVEL_WARNING, "%s: %zu allocations with %zu bytes are still alive.", kinc_memory_tag_name((kinc_memory_tag_t)i),
+			         stats.live_allocations, stats.live_bytes);
+			leaks += stats.live_allocations;
+		}
+	}
+#ifdef KINC_MEMORY_TRACKING
+	lockLive();
+	for (header_t *header = live; header != NULL; header = header->next) {
+		kinc_log(KINC_LOG_LEVEL_WARNING, "Allocation %llu at %p: %zu bytes for %s.", (unsigned long long)header->number,
+		         (void *)((uint8_t *)header + HEADER_SIZE), header->size, kinc_memory_tag_name((kinc_memory_tag_t)header->tag));
+	}
+	unlockLive();
+#endif
+	if (leaks == 0) {
+		kinc_log(KINC_LOG_LEVEL_INFO, "No memory leaks.");
+	}
+	return leaks;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <kinc/global.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*! \file memory.h
+    \brief Provides the allocation-functions all of Kinc and Kore allocate with. They can be routed to the allocators of an engine by setting an
+   allocator before Kinc is started and keep live statistics per subsystem, which are also used to report leaks. When KINC_MEMORY_TRACKING is
+   defined every live allocation is tracked individually so leak-reports can list them - use it in debug-builds only, it adds a lock to every
+   allocation and free. Without it the statistics are kept in atomic counters and no lock is taken.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum kinc_memory_tag {
+	KINC_MEMORY_TAG_GENERAL,
+	KINC_MEMORY_TAG_IMAGE,
+	KINC_MEMORY_TAG_AUDIO,
+	KINC_MEMORY_TAG_GRAPHICS,
+	KINC_MEMORY_TAG_NETWORK,
+	KINC_MEMORY_TAG_IO,
+	KINC_MEMORY_TAG_COUNT
+} kinc_memory_tag_t;
+
+typedef struct kinc_memory_allocator {
+	// has to return memory which is aligned at least like memory returned by malloc
+	void *(*allocate)(size_t size, kinc_memory_tag_t tag, void *user_data);
+	// optional, when it is NULL reallocations allocate new memory, copy and free the old memory
+	void *(*reallocate)(void *memory, size_t old_size, size_t new_size, kinc_memory_tag_t tag, void *user_data);
+	void (*free)(void *memory, size_t size, kinc_memory_tag_t tag, void *user_data);
+	void *user_data;
+} kinc_memory_allocator_t;
+
+typedef struct kinc_memory_statistics {
+	// the memory which is currently allocated in bytes, not counting the bookkeeping of the allocator
+	size_t live_bytes;
+	size_t live_allocations;
+	size_t peak_bytes;
+	// all allocations since the start including the ones which were freed
+	uint64_t total_allocations;
+} kinc_memory_statistics_t;
+
+/// <summary>
+/// Routes all allocations of Kinc and Kore to a different allocator. Has to be called before the first allocation, which means before
+/// kinc_init and before any static initializers which create Kore-objects.
+/// </summary>
+/// <param name="allocator">The new allocator, it is copied - pass NULL to go back to malloc and free</param>
+KINC_FUNC void kinc_memory_set_allocator(const kinc_memory_allocator_t *allocator);
+
+/// <summary>
+/// Allocates memory and counts it for a subsystem.
+/// </summary>
+/// <param name="size">The size of the memory in bytes</param>
+/// <param name="tag">The subsystem which uses the memory</param>
+/// <returns>The memory or NULL when the allocator is out of memory</returns>
+KINC_FUNC void *kinc_memory_allocate(size_t size, kinc_memory_tag_t tag);
+
+/// <summary>
+/// Allocates memory which is set to zero and counts it for a subsystem.
+/// </summary>
+/// <param name="size">The size of the memory in bytes</param>
+/// <param name="tag">The subsystem which uses the memory</param>
+/// <returns>The memory or NULL when the allocator is out of memory</returns>
+KINC_FUNC void *kinc_memory_allocate_zeroed(size_t size, kinc_memory_tag_t tag);
+
+/// <summary>
+/// Changes the size of memory like realloc. The memory keeps the tag it was allocated with unless memory is NULL.
+/// </summary>
+/// <param name="memory">Memory which was allocated by kinc_memory_allocate or NULL</param>
+/// <param name="size">The new size in bytes</param>
+/// <param name="tag">The subsystem which uses the memory when memory is NULL</param>
+/// <returns>The resized memory or NULL when the allocator is out of memory - the old memory stays valid in that case</returns>
+KINC_FUNC void *kinc_memory_reallocate(void *memory, size_t size, kinc_memory_tag_t tag);
+
+/// <summary>
+/// Frees memory which was allocated by kinc_memory_allocate, kinc_memory_allocate_zeroed or kinc_memory_reallocate. Does nothing for NULL.
+/// </summary>
+KINC_FUNC void kinc_memory_free(void *memory);
+
+/// <summary>
+/// Returns how much memory a subsystem uses.
+/// </summary>
+/// <param name="tag">The subsystem or KINC_MEMORY_TAG_COUNT for the sum of all subsystems, in which case peak_bytes is the sum of their peaks</param>
+/// <remarks>
+/// The counters are read one after another, while other threads allocate they can be from slightly different moments.
+/// </remarks>
+KINC_FUNC kinc_memory_statistics_t kinc_memory_get_statistics(kinc_memory_tag_t tag);
+
+/// <summary>
+/// Returns a readable name for a subsystem.
+/// </summary>
+KINC_FUNC const char *kinc_memory_tag_name(kinc_memory_tag_t tag);
+
+/// <summary>
+/// Logs the memory which is still allocated per subsystem and, when KINC_MEMORY_TRACKING is defined, every single allocation with its size
+/// and its number. Call it after everything was destroyed to find leaks.
+/// </summary>
+/// <returns>The number of allocations which are still alive</returns>
+KINC_FUNC size_t kinc_memory_report_leaks(void);
+
+#ifdef __cplusplus
+}
+#endif
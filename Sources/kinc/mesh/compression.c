@@ -0,0 +1,171 @@
+#include "compression.h"
+
+#include <kinc/graphics4/vertexpacking.h>
+#include <kinc/simd/float32x4.h>
+#include <kinc/simd/int32x4.h>
+
+#include <string.h>
+
+#define INDEX_CODEC_VERSION 1
+
+// Every index is stored as one varint. 0 stands for the next vertex which was not used before, which after vertex fetch-optimization is
+// what most new vertices are, everything else is the zigzag-encoded difference to the previous index plus one.
+
+size_t kinc_mesh_encode_index_buffer_bound(int index_count) {
+	// a 32 bit value needs up to five bytes as a varint
+	return 1 + (size_t)index_count * 5;
+}
+
+static size_t write_varint(uint8_t *buffer, size_t position, size_t buffer_size, uint32_t value) {
+	do {
+		if (position >= buffer_size) {
+			return 0;
+		}
+		uint8_t byte = value & 0x7f;
+		value >>= 7;
+		buffer[position++] = value != 0 ? (byte | 0x80) : byte;
+	} while (value != 0);
+	return position;
+}
+
+size_t kinc_mesh_encode_index_buffer(uint8_t *buffer, size_t buffer_size, const int *indices, int index_count) {
+	if (buffer_size < 1) {
+		return 0;
+	}
+	size_t position = 0;
+	buffer[position++] = INDEX_CODEC_VERSION;
+
+	int next = 0;
+	int previous = 0;
+	for (int i = 0; i < index_count; ++i) {
+		int index = indices[i];
+		uint32_t code;
+		if (index == next) {
+			code = 0;
+			++next;
+		}
+		else {
+			int32_t difference = (int32_t)((uint32_t)index - (uint32_t)previous);
+			code = (((uint32_t)difference << 1) ^ (uint32_t)(difference >> 31)) + 1;
+			if (index >= next) {
+				next = index + 1;
+			}
+		}
+		position = write_varint(buffer, position, buffer_size, code);
+		if (position == 0) {
+			return 0;
+		}
+		previous = index;
+	}
+	return position;
+}
+
+bool kinc_mesh_decode_index_buffer(int *destination, int index_count, const uint8_t *buffer, size_t buffer_size) {
+	if (buffer_size < 1 || buffer[0] != INDEX_CODEC_VERSION) {
+		return false;
+	}
+	size_t position = 1;
+
+	int next = 0;
+	int previous = 0;
+	for (int i = 0; i < index_count; ++i) {
+		uint32_t code = 0;
+		for (int shift = 0;; shift += 7) {
+			if (position >= buffer_size || shift > 28) {
+				return false;
+			}
+			uint8_t byte = buffer[position++];
+			code |= (uint32_t)(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0) {
+				break;
+			}
+		}
+
+		int index;
+		if (code == 0) {
+			index = next;
+		}
+		else {
+			code -= 1;
+			int32_t difference = (int32_t)((code >> 1) ^ (0u - (code & 1)));
+			index = (int)((uint32_t)previous + (uint32_t)difference);
+			if (index < 0) {
+				return false;
+			}
+		}
+		if (index >= next) {
+			next = index + 1;
+		}
+		destination[i] = index;
+		previous = index;
+	}
+	return position == buffer_size;
+}
+
+static const float *get_element(const float *elements, int stride, int index) {
+	return (const float *)((const uint8_t *)elements + (size_t)index * stride);
+}
+
+void kinc_mesh_quantize_positions(void *destination, int destination_stride, const float *positions, int position_stride, int count, float *offset,
+                                  float *scale) {
+	float min[3] = {0.0f, 0.0f, 0.0f};
+	float max[3] = {0.0f, 0.0f, 0.0f};
+	for (int i = 0; i < count; ++i) {
+		const float *position = get_element(positions, position_stride, i);
+		for (int axis = 0; axis < 3; ++axis) {
+			if (i == 0 || position[axis] < min[axis]) {
+				min[axis] = position[axis];
+			}
+			if (i == 0 || position[axis] > max[axis]) {
+				max[axis] = position[axis];
+			}
+		}
+	}
+
+	float inverse_scale[3];
+	for (int axis = 0; axis < 3; ++axis) {
+		offset[axis] = (min[axis] + max[axis]) * 0.5f;
+		scale[axis] = (max[axis] - min[axis]) * 0.5f;
+		inverse_scale[axis] = scale[axis] > 0.0f ? 32767.0f / scale[axis] : 0.0f;
+	}
+
+	// w has no offset and is multiplied into 32767 directly
+	const kinc_float32x4_t center = kinc_float32x4_load(offset[0], offset[1], offset[2], 0.0f);
+	const kinc_float32x4_t factor = kinc_float32x4_load(inverse_scale[0], inverse_scale[1], inverse_scale[2], 32767.0f);
+	const kinc_float32x4_t low = kinc_float32x4_load_all(-32767.0f);
+	const kinc_float32x4_t high = kinc_float32x4_load_all(32767.0f);
+	for (int i = 0; i < count; ++i) {
+		const float *position = get_element(positions, position_stride, i);
+		kinc_float32x4_t value = kinc_float32x4_load(position[0], position[1], position[2], 1.0f);
+		value = kinc_float32x4_mul(kinc_float32x4_sub(value, center), factor);
+		value = kinc_float32x4_min(kinc_float32x4_max(value, low), high);
+		int32_t quantized[4];
+		kinc_int32x4_store_unaligned(quantized, kinc_int32x4_from_float32x4(value));
+
+		int16_t *target = (int16_t *)((uint8_t *)destination + (size_t)i * destination_stride);
+		for (int component = 0; component < 4; ++component) {
+			target[component] = (int16_t)quantized[component];
+		}
+	}
+}
+
+void kinc_mesh_quantize_texcoords(void *destination, int destination_stride, const float *texcoords, int texcoord_stride, int count) {
+	// gathered into blocks so kinc_g4_pack_halfs can use its vectorized conversions
+	enum { BLOCK_SIZE = 128 };
+	float block[BLOCK_SIZE * 2];
+	uint16_t halfs[BLOCK_SIZE * 2];
+	for (int start = 0; start < count; start += BLOCK_SIZE) {
+		int block_count = count - start < BLOCK_SIZE ? count - start : BLOCK_SIZE;
+		for (int i = 0; i < block_count; ++i) {
+			const float *texcoord = get_element(texcoords, texcoord_stride, start + i);
+			block[i * 2 + 0] = texcoord[0];
+			block[i * 2 + 1] = texcoord[1];
+		}
+		kinc_g4_pack_halfs(halfs, block, block_count * 2);
+		for (int i = 0; i < block_count; ++i) {
+			uint16_t *target = (uint16_t *)((uint8_t *)destination + (size_t)(start + i) * destination_stride);
+			target[0] = halfs[i * 2 + 0];
+			target[1] = halfs[i * 2 + 1];
+		}
+	}
+}
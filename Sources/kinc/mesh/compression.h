@@ -0,0 +1,74 @@
+#pragma once
+
+#include <kinc/global.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*! \file compression.h
+    \brief Shrinks meshes for storage and for the GPU. Index-buffers are compressed losslessly into a byte-stream, vertex-attributes are
+   quantized into the compact kinc_g4_vertex_data_t formats.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// <summary>
+/// Returns the maximum number of bytes kinc_mesh_encode_index_buffer can write.
+/// </summary>
+/// <param name="index_count">The number of indices</param>
+/// <returns>The maximum size of the encoded data</returns>
+KINC_FUNC size_t kinc_mesh_encode_index_buffer_bound(int index_count);
+
+/// <summary>
+/// Compresses a triangle-list. Indices are stored as small differences so the result is best after the triangles and vertices were optimized
+/// using kinc/mesh/optimization.h, typically around a byte per index.
+/// </summary>
+/// <param name="buffer">Receives the encoded data</param>
+/// <param name="buffer_size">The size of buffer, kinc_mesh_encode_index_buffer_bound is always large enough</param>
+/// <param name="indices">The indices to encode</param>
+/// <param name="index_count">The number of indices</param>
+/// <returns>The number of bytes written or 0 if the buffer was too small</returns>
+KINC_FUNC size_t kinc_mesh_encode_index_buffer(uint8_t *buffer, size_t buffer_size, const int *indices, int index_count);
+
+/// <summary>
+/// Decompresses a triangle-list which was compressed using kinc_mesh_encode_index_buffer, for example straight into the result of
+/// kinc_g4_index_buffer_lock.
+/// </summary>
+/// <param name="destination">Receives index_count indices</param>
+/// <param name="index_count">The number of indices which were encoded</param>
+/// <param name="buffer">The encoded data</param>
+/// <param name="buffer_size">The size of the encoded data</param>
+/// <returns>Whether the data was valid</returns>
+KINC_FUNC bool kinc_mesh_decode_index_buffer(int *destination, int index_count, const uint8_t *buffer, size_t buffer_size);
+
+/// <summary>
+/// Quantizes positions into SHORT4_NORM elements relative to their bounding box. The shader reconstructs a position as
+/// value.xyz * scale + offset, which can also be folded into the model-matrix. w is set to 1.
+/// </summary>
+/// <param name="destination">Receives four 16 bit values per position</param>
+/// <param name="destination_stride">The distance between two quantized positions in bytes, for example the vertex-buffer's stride</param>
+/// <param name="positions">The x, y and z components of the positions</param>
+/// <param name="position_stride">The distance between two positions in bytes</param>
+/// <param name="count">The number of positions</param>
+/// <param name="offset">Receives the three components of the center of the bounding box</param>
+/// <param name="scale">Receives the three half-extents of the bounding box</param>
+KINC_FUNC void kinc_mesh_quantize_positions(void *destination, int destination_stride, const float *positions, int position_stride, int count, float *offset,
+                                            float *scale);
+
+/// <summary>
+/// Converts texture-coordinates into HALF2 elements. Half-floats keep at least 10 bits of precision for coordinates up to 2 which is enough for
+/// textures up to 1024 texels in size, larger textures or heavily tiled coordinates may need FLOAT2.
+/// </summary>
+/// <param name="destination">Receives two half-floats per coordinate</param>
+/// <param name="destination_stride">The distance between two converted coordinates in bytes</param>
+/// <param name="texcoords">The u and v components of the texture-coordinates</param>
+/// <param name="texcoord_stride">The distance between two texture-coordinates in bytes</param>
+/// <param name="count">The number of texture-coordinates</param>
+KINC_FUNC void kinc_mesh_quantize_texcoords(void *destination, int destination_stride, const float *texcoords, int texcoord_stride, int count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,381 @@
+#include "optimization.h"
+
+#include <kinc/math/core.h>
+#include <kinc/memory.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Simulates a FIFO-cache by stamping every vertex with the time it was inserted.
+typedef struct cache {
+	int *timestamps;
+	int time;
+	int size;
+} cache_t;
+
+static void cache_init(cache_t *cache, int vertex_count, int cache_size) {
+	cache->timestamps = (int *)kinc_memory_allocate_zeroed((vertex_count > 0 ? vertex_count : 1) * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+	cache->size = cache_size;
+	cache->time = cache_size + 1;
+}
+
+static void cache_destroy(cache_t *cache) {
+	kinc_memory_free(cache->timestamps);
+}
+
+static void cache_clear(cache_t *cache) {
+	cache->time += cache->size + 1;
+}
+
+static bool cache_contains(cache_t *cache, int vertex) {
+	return cache->time - cache->timestamps[vertex] <= cache->size;
+}
+
+// returns the number of misses
+static int cache_touch(cache_t *cache, int vertex) {
+	if (cache_contains(cache, vertex)) {
+		return 0;
+	}
+	cache->timestamps[vertex] = cache->time++;
+	return 1;
+}
+
+static int cache_touch_triangle(cache_t *cache, const int *triangle) {
+	return cache_touch(cache, triangle[0]) + cache_touch(cache, triangle[1]) + cache_touch(cache, triangle[2]);
+}
+
+kinc_mesh_vertex_cache_statistics_t kinc_mesh_analyze_vertex_cache(const int *indices, int index_count, int vertex_count, int cache_size) {
+	kinc_mesh_vertex_cache_statistics_t statistics;
+	cache_t cache;
+	cache_init(&cache, vertex_count, cache_size);
+	int transformed = 0;
+	for (int i = 0; i < index_count; ++i) {
+		transformed += cache_touch(&cache, indices[i]);
+	}
+	cache_destroy(&cache);
+
+	statistics.vertices_transformed = transformed;
+	statistics.acmr = index_count >= 3 ? (float)transformed / (float)(index_count / 3) : 0.0f;
+	statistics.atvr = vertex_count > 0 ? (float)transformed / (float)vertex_count : 0.0f;
+	return statistics;
+}
+
+// The triangles which use each vertex, the ones of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1] - 1].
+typedef struct adjacency {
+	int *offsets;
+	int *triangles;
+} adjacency_t;
+
+static void adjacency_init(adjacency_t *adjacency, const int *indices, int index_count, int vertex_count) {
+	adjacency->offsets = (int *)kinc_memory_allocate_zeroed((vertex_count + 1) * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+	adjacency->triangles = (int *)kinc_memory_allocate((index_count > 0 ? index_count : 1) * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+
+	for (int i = 0; i < index_count; ++i) {
+		adjacency->offsets[indices[i] + 1] += 1;
+	}
+	for (int v = 0; v < vertex_count; ++v) {
+		adjacency->offsets[v + 1] += adjacency->offsets[v];
+	}
+	// offsets[v] is used as the insertion-point and ends up at the start of v + 1, shifting it back afterwards restores the starts
+	for (int i = 0; i < index_count; ++i) {
+		adjacency->triangles[adjacency->offsets[indices[i]]++] = i / 3;
+	}
+	for (int v = vertex_count; v > 0; --v) {
+		adjacency->offsets[v] = adjacency->offsets[v - 1];
+	}
+	adjacency->offsets[0] = 0;
+}
+
+static void adjacency_destroy(adjacency_t *adjacency) {
+	kinc_memory_free(adjacency->offsets);
+	kinc_memory_free(adjacency->triangles);
+}
+
+static int *copy_if_aliased(int *destination, const int *indices, int index_count) {
+	if (destination != indices) {
+		return NULL;
+	}
+	int *copy = (int *)kinc_memory_allocate(index_count * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+	memcpy(copy, indices, index_count * sizeof(int));
+	return copy;
+}
+
+void kinc_mesh_optimize_vertex_cache(int *destination, const int *indices, int index_count, int vertex_count, int cache_size) {
+	int triangle_count = index_count / 3;
+	if (triangle_count == 0) {
+		memmove(destination, indices, index_count * sizeof(int));
+		return;
+	}
+
+	int *copy = copy_if_aliased(destination, indices, index_count);
+	if (copy != NULL) {
+		indices = copy;
+	}
+
+	adjacency_t adjacency;
+	adjacency_init(&adjacency, indices, triangle_count * 3, vertex_count);
+
+	// the number of triangles using a vertex which were not emitted yet
+	int *live = (int *)kinc_memory_allocate(vertex_count * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+	for (int v = 0; v < vertex_count; ++v) {
+		live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+	}
+	bool *emitted = (bool *)kinc_memory_allocate_zeroed(triangle_count * sizeof(bool), KINC_MEMORY_TAG_GRAPHICS);
+	// every emitted vertex is pushed once so the stack can not grow beyond the number of indices
+	int *dead_end = (int *)kinc_memory_allocate(triangle_count * 3 * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+	int dead_end_top = 0;
+	cache_t cache;
+	cache_init(&cache, vertex_count, cache_size);
+
+	int output = 0;
+	int cursor = 0;
+	while (cursor < vertex_count && live[cursor] == 0) {
+		++cursor;
+	}
+	int fan = cursor < vertex_count ? cursor : -1;
+
+	while (fan >= 0) {
+		int candidates_start = dead_end_top;
+
+		for (int i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1]; ++i) {
+			int triangle = adjacency.triangles[i];
+			if (emitted[triangle]) {
+				continue;
+			}
+			for (int corner = 0; corner < 3; ++corner) {
+				int vertex = indices[triangle * 3 + corner];
+				destination[output++] = vertex;
+				dead_end[dead_end_top++] = vertex;
+				live[vertex] -= 1;
+				cache_touch(&cache, vertex);
+			}
+			emitted[triangle] = true;
+		}
+
+		// prefer the oldest vertex of the 1-ring which will still be cached after emitting all of its remaining triangles
+		fan = -1;
+		int best_priority = -1;
+		for (int i = candidates_start; i < dead_end_top; ++i) {
+			int vertex = dead_end[i];
+			if (live[vertex] == 0) {
+				continue;
+			}
+			int priority = 0;
+			int age = cache.time - cache.timestamps[vertex];
+			if (age + 2 * live[vertex] <= cache_size) {
+				priority = age;
+			}
+			if (priority > best_priority) {
+				best_priority = priority;
+				fan = vertex;
+			}
+		}
+
+		if (fan < 0) {
+			while (dead_end_top > 0) {
+				int vertex = dead_end[--dead_end_top];
+				if (live[vertex] > 0) {
+					fan = vertex;
+					break;
+				}
+			}
+		}
+
+		if (fan < 0) {
+			while (cursor < vertex_count && live[cursor] == 0) {
+				++cursor;
+			}
+			if (cursor < vertex_count) {
+				fan = cursor;
+			}
+		}
+	}
+
+	// a trailing partial triangle is kept as it is
+	for (int i = triangle_count * 3; i < index_count; ++i) {
+		destination[output++] = indices[i];
+	}
+
+	cache_destroy(&cache);
+	kinc_memory_free(dead_end);
+	kinc_memory_free(emitted);
+	kinc_memory_free(live);
+	adjacency_destroy(&adjacency);
+	kinc_memory_free(copy);
+}
+
+typedef struct cluster_key {
+	float key;
+	int cluster;
+} cluster_key_t;
+
+static int compare_cluster_keys(const void *a, const void *b) {
+	const cluster_key_t *key_a = (const cluster_key_t *)a;
+	const cluster_key_t *key_b = (const cluster_key_t *)b;
+	if (key_a->key != key_b->key) {
+		return key_a->key > key_b->key ? -1 : 1;
+	}
+	return key_a->cluster - key_b->cluster;
+}
+
+static const float *get_position(const float *positions, int position_stride, int vertex) {
+	return (const float *)((const uint8_t *)positions + (size_t)vertex * position_stride);
+}
+
+void kinc_mesh_optimize_overdraw(int *destination, const int *indices, int index_count, const float *positions, int position_stride, int vertex_count,
+                                 float threshold) {
+	int triangle_count = index_count / 3;
+	if (triangle_count < 2) {
+		memmove(destination, indices, index_count * sizeof(int));
+		return;
+	}
+
+	int *copy = copy_if_aliased(destination, indices, index_count);
+	if (copy != NULL) {
+		indices = copy;
+	}
+
+	cache_t cache;
+	cache_init(&cache, vertex_count, KINC_MESH_DEFAULT_CACHE_SIZE);
+
+	// hard boundaries are the triangles which miss the cache completely, reordering there does not cost anything
+	int *hard = (int *)kinc_memory_allocate((triangle_count + 1) * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+	int hard_count = 0;
+	for (int triangle = 0; triangle < triangle_count; ++triangle) {
+		if (cache_touch_triangle(&cache, &indices[triangle * 3]) == 3 || triangle == 0) {
+			hard[hard_count++] = triangle;
+		}
+	}
+	hard[hard_count] = triangle_count;
+
+	// soft boundaries split the hard clusters further wherever the part so far is almost as cache-efficient as the whole cluster
+	int *clusters = (int *)kinc_memory_allocate((triangle_count + 1) * sizeof(int), KINC_MEMORY_TAG_GRAPHICS);
+	int cluster_count = 0;
+	for (int i = 0; i < hard_count; ++i) {
+		int start = hard[i];
+		int end = hard[i + 1];
+
+		cache_clear(&cache);
+		int cluster_misses = 0;
+		for (int triangle = start; triangle < end; ++triangle) {
+			cluster_misses += cache_touch_triangle(&cache, &indices[triangle * 3]);
+		}
+		float limit = (float)cluster_misses / (float)(end - start) * threshold;
+
+		cache_clear(&cache);
+		clusters[cluster_count++] = start;
+		int cluster_start = start;
+		int misses = 0;
+		for (int triangle = start; triangle < end - 1; ++triangle) {
+			misses += cache_touch_triangle(&cache, &indices[triangle * 3]);
+			if ((float)misses / (float)(triangle + 1 - cluster_start) <= limit) {
+				clusters[cluster_count++] = triangle + 1;
+				cluster_start = triangle + 1;
+				misses = 0;
+				cache_clear(&cache);
+			}
+		}
+	}
+	clusters[cluster_count] = triangle_count;
+	cache_destroy(&cache);
+	kinc_memory_free(hard);
+
+	// area-weighted centroids and normals of the clusters
+	float *centroids = (float *)kinc_memory_allocate_zeroed(cluster_count * 3 * sizeof(float), KINC_MEMORY_TAG_GRAPHICS);
+	float *normals = (float *)kinc_memory_allocate_zeroed(cluster_count * 3 * sizeof(float), KINC_MEMORY_TAG_GRAPHICS);
+	float mesh_center[3] = {0.0f, 0.0f, 0.0f};
+	float mesh_area = 0.0f;
+	for (int cluster = 0; cluster < cluster_count; ++cluster) {
+		float cluster_area = 0.0f;
+		for (int triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle) {
+			const float *a = get_position(positions, position_stride, indices[triangle * 3 + 0]);
+			const float *b = get_position(positions, position_stride, indices[triangle * 3 + 1]);
+			const float *c = get_position(positions, position_stride, indices[triangle * 3 + 2]);
+			float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+			float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+			float normal[3] = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0]};
+			float area = kinc_sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			for (int axis = 0; axis < 3; ++axis) {
+				centroids[cluster * 3 + axis] += (a[axis] + b[axis] + c[axis]) * (area / 3.0f);
+				normals[cluster * 3 + axis] += normal[axis];
+			}
+			cluster_area += area;
+		}
+		for (int axis = 0; axis < 3; ++axis) {
+			mesh_center[axis] += centroids[cluster * 3 + axis];
+		}
+		if (cluster_area > 0.0f) {
+			for (int axis = 0; axis < 3; ++axis) {
+				centroids[cluster * 3 + axis] /= cluster_area;
+			}
+		}
+		mesh_area += cluster_area;
+	}
+	if (mesh_area > 0.0f) {
+		for (int axis = 0; axis < 3; ++axis) {
+			mesh_center[axis] /= mesh_area;
+		}
+	}
+
+	// clusters which face away from the center are likely in front of the others
+	cluster_key_t *keys = (cluster_key_t *)kinc_memory_allocate(cluster_count * sizeof(cluster_key_t), KINC_MEMORY_TAG_GRAPHICS);
+	for (int cluster = 0; cluster < cluster_count; ++cluster) {
+		const float *normal = &normals[cluster * 3];
+		float length = kinc_sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		float key = 0.0f;
+		if (length > 0.0f) {
+			for (int axis = 0; axis < 3; ++axis) {
+				key += (centroids[cluster * 3 + axis] - mesh_center[axis]) * normal[axis];
+			}
+			key /= length;
+		}
+		keys[cluster].key = key;
+		keys[cluster].cluster = cluster;
+	}
+	qsort(keys, cluster_count, sizeof(cluster_key_t), compare_cluster_keys);
+
+	int output = 0;
+	for (int i = 0; i < cluster_count; ++i) {
+		int cluster = keys[i].cluster;
+		int count = (clusters[cluster + 1] - clusters[cluster]) * 3;
+		memcpy(&destination[output], &indices[clusters[cluster] * 3], count * sizeof(int));
+		output += count;
+	}
+	for (int i = triangle_count * 3; i < index_count; ++i) {
+		destination[output++] = indices[i];
+	}
+
+	kinc_memory_free(keys);
+	kinc_memory_free(normals);
+	kinc_memory_free(centroids);
+	kinc_memory_free(clusters);
+	kinc_memory_free(copy);
+}
+
+int kinc_mesh_optimize_vertex_fetch_remap(int *remap, const int *indices, int index_count, int vertex_count) {
+	for (int v = 0; v < vertex_count; ++v) {
+		remap[v] = -1;
+	}
+	int next = 0;
+	for (int i = 0; i < index_count; ++i) {
+		if (remap[indices[i]] < 0) {
+			remap[indices[i]] = next++;
+		}
+	}
+	return next;
+}
+
+void kinc_mesh_remap_index_buffer(int *destination, const int *indices, int index_count, const int *remap) {
+	for (int i = 0; i < index_count; ++i) {
+		destination[i] = remap[indices[i]];
+	}
+}
+
+void kinc_mesh_remap_vertex_buffer(void *destination, const void *vertices, int vertex_count, int vertex_size, const int *remap) {
+	for (int v = 0; v < vertex_count; ++v) {
+		if (remap[v] >= 0) {
+			memcpy((uint8_t *)destination + (size_t)remap[v] * vertex_size, (const uint8_t *)vertices + (size_t)v * vertex_size, vertex_size);
+		}
+	}
+}
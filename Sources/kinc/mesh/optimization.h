@@ -0,0 +1,96 @@
+#pragma once
+
+#include <kinc/global.h>
+
+/*! \file optimization.h
+    \brief Reorders triangle-lists and vertices so the GPU transforms and fetches fewer vertices and shades fewer hidden pixels.
+   All functions run in linear time (plus sorting the clusters in kinc_mesh_optimize_overdraw) and are meant to be used while loading a mesh,
+   before the data is written into a kinc_g4_vertex_buffer and kinc_g4_index_buffer. A typical sequence is kinc_mesh_optimize_vertex_cache,
+   kinc_mesh_optimize_overdraw and then kinc_mesh_optimize_vertex_fetch_remap followed by the two remap-functions.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// a conservative size for the post-transform cache of current GPUs
+#define KINC_MESH_DEFAULT_CACHE_SIZE 16
+
+typedef struct kinc_mesh_vertex_cache_statistics {
+	// vertex shader invocations of a simulated FIFO cache
+	int vertices_transformed;
+	// average cache miss ratio, transformed vertices per triangle - 0.5 is the optimum for large grids, 3 the worst case
+	float acmr;
+	// average transform to vertex ratio, transformed vertices per vertex - 1 is the optimum
+	float atvr;
+} kinc_mesh_vertex_cache_statistics_t;
+
+/// <summary>
+/// Simulates a FIFO post-transform cache to measure how well a triangle-list makes use of it. Comparing the results before and after
+/// kinc_mesh_optimize_vertex_cache shows how many vertex shader invocations were saved.
+/// </summary>
+/// <param name="indices">The triangle-list</param>
+/// <param name="index_count">The number of indices</param>
+/// <param name="vertex_count">The number of vertices the indices refer to</param>
+/// <param name="cache_size">The number of vertices in the simulated cache</param>
+/// <returns>The statistics of the simulation</returns>
+KINC_FUNC kinc_mesh_vertex_cache_statistics_t kinc_mesh_analyze_vertex_cache(const int *indices, int index_count, int vertex_count, int cache_size);
+
+/// <summary>
+/// Reorders the triangles of a triangle-list for the post-transform cache using Tipsify (Sander et al. 2007). The orientation of the triangles
+/// is preserved.
+/// </summary>
+/// <param name="destination">Receives the reordered triangle-list, can be the same as indices</param>
+/// <param name="indices">The triangle-list</param>
+/// <param name="index_count">The number of indices</param>
+/// <param name="vertex_count">The number of vertices the indices refer to</param>
+/// <param name="cache_size">The size of the cache to optimize for, usually KINC_MESH_DEFAULT_CACHE_SIZE</param>
+KINC_FUNC void kinc_mesh_optimize_vertex_cache(int *destination, const int *indices, int index_count, int vertex_count, int cache_size);
+
+/// <summary>
+/// Reorders clusters of a cache-optimized triangle-list so triangles which likely occlude others are drawn first. Clusters are split where
+/// that costs little cache-efficiency and sorted by how much they face outwards from the center of the mesh.
+/// </summary>
+/// <param name="destination">Receives the reordered triangle-list, can be the same as indices</param>
+/// <param name="indices">A triangle-list which was optimized using kinc_mesh_optimize_vertex_cache</param>
+/// <param name="index_count">The number of indices</param>
+/// <param name="positions">The x, y and z components of the vertex-positions</param>
+/// <param name="position_stride">The distance between two positions in bytes</param>
+/// <param name="vertex_count">The number of vertices</param>
+/// <param name="threshold">How much worse the cache miss ratio of a cluster may get by splitting it, 1.05 is a good start</param>
+KINC_FUNC void kinc_mesh_optimize_overdraw(int *destination, const int *indices, int index_count, const float *positions, int position_stride, int vertex_count,
+                                           float threshold);
+
+/// <summary>
+/// Calculates a vertex-order which follows the order in which the triangle-list uses the vertices, so vertex-fetches hit memory sequentially.
+/// Vertices which are not referenced are dropped.
+/// </summary>
+/// <param name="remap">Receives the new position of every vertex or -1 for unused vertices, vertex_count entries</param>
+/// <param name="indices">The triangle-list</param>
+/// <param name="index_count">The number of indices</param>
+/// <param name="vertex_count">The number of vertices</param>
+/// <returns>The number of vertices which remain</returns>
+KINC_FUNC int kinc_mesh_optimize_vertex_fetch_remap(int *remap, const int *indices, int index_count, int vertex_count);
+
+/// <summary>
+/// Applies a remap-table to a triangle-list.
+/// </summary>
+/// <param name="destination">Receives the remapped indices, can be the same as indices</param>
+/// <param name="indices">The triangle-list</param>
+/// <param name="index_count">The number of indices</param>
+/// <param name="remap">A table calculated by kinc_mesh_optimize_vertex_fetch_remap</param>
+KINC_FUNC void kinc_mesh_remap_index_buffer(int *destination, const int *indices, int index_count, const int *remap);
+
+/// <summary>
+/// Applies a remap-table to vertex-data. Call it once per vertex-stream.
+/// </summary>
+/// <param name="destination">Receives the reordered vertices, must not overlap vertices</param>
+/// <param name="vertices">The vertex-data</param>
+/// <param name="vertex_count">The number of vertices in vertices</param>
+/// <param name="vertex_size">The size of one vertex in bytes</param>
+/// <param name="remap">A table calculated by kinc_mesh_optimize_vertex_fetch_remap</param>
+KINC_FUNC void kinc_mesh_remap_vertex_buffer(void *destination, const void *vertices, int vertex_count, int vertex_size, const int *remap);
+
+#ifdef __cplusplus
+}
+#endif
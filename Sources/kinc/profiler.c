@@ -0,0 +1,354 @@
+#include "profiler.h"
+
+#include <kinc/io/filewriter.h>
+#include <kinc/memory.h>
+#include <kinc/system.h>
+#include <kinc/threads/mutex.h>
+#include <kinc/threads/threadlocal.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_DEPTH 64
+// size of the per-thread zone statistics table, has to be a power of two
+#define MAX_ZONES 256
+
+enum { EVENT_BEGIN, EVENT_END, EVENT_COUNTER, EVENT_FRAME };
+
+typedef struct {
+	kinc_ticks_t time;
+	const char *name;
+	double value;
+	int type;
+} profiler_event;
+
+typedef struct {
+	const char *name;
+	int calls;
+	kinc_ticks_t total;
+	kinc_ticks_t max;
+} zone_stats;
+
+// Only the owning thread writes into its buffer. Readers (export and summary) tolerate partially updated entries.
+typedef struct {
+	profiler_event events[KINC_PROFILER_EVENTS_PER_THREAD];
+	volatile uint32_t event_count;
+	const char *stack_names[MAX_DEPTH];
+	kinc_ticks_t stack_starts[MAX_DEPTH];
+	int depth;
+	int epoch;
+	zone_stats zones[MAX_ZONES];
+	volatile int summary_epoch;
+	const char *name;
+	int id;
+} thread_buffer;
+
+bool kinc_internal_profiler_enabled = false;
+
+static thread_buffer *buffers[KINC_PROFILER_MAX_THREADS];
+static int buffer_count = 0;
+static kinc_mutex_t mutex;
+static bool mutex_initialized = false;
+static volatile int epoch = 0;
+static volatile int summary_epoch = 0;
+static kinc_ticks_t start_time = 0;
+
+// holds the thread's buffer or &registration_failed
+static kinc_thread_local_t current_buffer;
+static char registration_failed;
+
+static thread_buffer *get_buffer(void) {
+	void *current = kinc_thread_local_get(&current_buffer);
+	if (current == &registration_failed) {
+		return NULL;
+	}
+	thread_buffer *buffer = (thread_buffer *)current;
+	if (buffer == NULL) {
+		kinc_mutex_lock(&mutex);
+		if (buffer_count < KINC_PROFILER_MAX_THREADS) {
+			buffer = (thread_buffer *)kinc_memory_allocate_zeroed(sizeof(thread_buffer), KINC_MEMORY_TAG_GENERAL);
+		}
+		if (buffer != NULL) {
+			buffer->id = buffer_count;
+			buffer->epoch = epoch;
+			buffer->summary_epoch = summary_epoch;
+			buffers[buffer_count++] = buffer;
+		}
+		kinc_mutex_unlock(&mutex);
+		if (buffer == NULL) {
+			kinc_thread_local_set(&current_buffer, &registration_failed);
+			return NULL;
+		}
+		kinc_thread_local_set(&current_buffer, buffer);
+	}
+	if (buffer->epoch != epoch) {
+		// zones which were open when the profiler was last disabled will never be closed
+		buffer->epoch = epoch;
+		buffer->depth = 0;
+	}
+	return buffer;
+}
+
+static inline void push(thread_buffer *buffer, int type, const char *name, double value, kinc_ticks_t time) {
+	profiler_event *event = &buffer->events[buffer->event_count & (KINC_PROFILER_EVENTS_PER_THREAD - 1)];
+	event->time = time;
+	event->name = name;
+	event->value = value;
+	event->type = type;
+	buffer->event_count = buffer->event_count + 1;
+}
+
+static void add_zone_stats(thread_buffer *buffer, const char *name, kinc_ticks_t duration) {
+	if (buffer->summary_epoch != summary_epoch) {
+		memset(buffer->zones, 0, sizeof(buffer->zones));
+		buffer->summary_epoch = summary_epoch;
+	}
+	uint32_t index = (uint32_t)(((uintptr_t)name >> 3) * 2654435761u);
+	for (int i = 0; i < MAX_ZONES; ++i) {
+		zone_stats *zone = &buffer->zones[(index + i) & (MAX_ZONES - 1)];
+		if (zone->name == NULL) {
+			zone->max = duration;
+			zone->total = duration;
+			zone->calls = 1;
+			zone->name = name;
+			return;
+		}
+		if (zone->name == name) {
+			zone->calls += 1;
+			zone->total += duration;
+			if (duration > zone->max) {
+				zone->max = duration;
+			}
+			return;
+		}
+	}
+}
+
+void kinc_profiler_enable(bool enabled) {
+	if (!mutex_initialized) {
+		kinc_mutex_init(&mutex);
+		kinc_thread_local_init(&current_buffer);
+		mutex_initialized = true;
+	}
+	if (enabled && !kinc_internal_profiler_enabled) {
+		if (start_time == 0) {
+			start_time = kinc_timestamp();
+		}
+		++epoch;
+	}
+	kinc_internal_profiler_enabled = enabled;
+}
+
+void kinc_profiler_begin(const char *name) {
+	if (!kinc_internal_profiler_enabled) {
+		return;
+	}
+	thread_buffer *buffer = get_buffer();
+	if (buffer == NULL) {
+		return;
+	}
+	kinc_ticks_t time = kinc_timestamp();
+	if (buffer->depth < MAX_DEPTH) {
+		buffer->stack_names[buffer->depth] = name;
+		buffer->stack_starts[buffer->depth] = time;
+		push(buffer, EVENT_BEGIN, name, 0, time);
+	}
+	++buffer->depth;
+}
+
+void kinc_profiler_end(void) {
+	if (!kinc_internal_profiler_enabled) {
+		return;
+	}
+	thread_buffer *buffer = get_buffer();
+	if (buffer == NULL || buffer->depth == 0) {
+		return;
+	}
+	--buffer->depth;
+	if (buffer->depth < MAX_DEPTH) {
+		kinc_ticks_t time = kinc_timestamp();
+		const char *name = buffer->stack_names[buffer->depth];
+		push(buffer, EVENT_END, name, 0, time);
+		add_zone_stats(buffer, name, time - buffer->stack_starts[buffer->depth]);
+	}
+}
+
+void kinc_profiler_counter(const char *name, double value) {
+	if (!kinc_internal_profiler_enabled) {
+		return;
+	}
+	thread_buffer *buffer = get_buffer();
+	if (buffer != NULL) {
+		push(buffer, EVENT_COUNTER, name, value, kinc_timestamp());
+	}
+}
+
+void kinc_profiler_frame(void) {
+	if (!kinc_internal_profiler_enabled) {
+		return;
+	}
+	thread_buffer *buffer = get_buffer();
+	if (buffer != NULL) {
+		push(buffer, EVENT_FRAME, "Frame", 0, kinc_timestamp());
+	}
+}
+
+void kinc_profiler_set_thread_name(const char *name) {
+	if (!kinc_internal_profiler_enabled) {
+		return;
+	}
+	thread_buffer *buffer = get_buffer();
+	if (buffer != NULL) {
+		buffer->name = name;
+	}
+}
+
+int kinc_profiler_summary(kinc_profiler_zone_summary_t *zones, int max_zones) {
+	if (!mutex_initialized) {
+		return 0;
+	}
+	double frequency = kinc_frequency();
+	int count = 0;
+	kinc_mutex_lock(&mutex);
+	for (int b = 0; b < buffer_count; ++b) {
+		thread_buffer *buffer = buffers[b];
+		if (buffer->summary_epoch != summary_epoch) {
+			continue;
+		}
+		for (int z = 0; z < MAX_ZONES; ++z) {
+			zone_stats stats = buffer->zones[z];
+			if (stats.name == NULL || stats.calls == 0) {
+				continue;
+			}
+			int index = 0;
+			while (index < count && strcmp(zones[index].name, stats.name) != 0) {
+				++index;
+			}
+			if (index == count) {
+				if (count == max_zones) {
+					continue;
+				}
+				zones[index].name = stats.name;
+				zones[index].calls = 0;
+				zones[index].total_seconds = 0;
+				zones[index].max_seconds = 0;
+				++count;
+			}
+			double max = stats.max / frequency;
+			zones[index].calls += stats.calls;
+			zones[index].total_seconds += stats.total / frequency;
+			if (max > zones[index].max_seconds) {
+				zones[index].max_seconds = max;
+			}
+		}
+	}
+	kinc_mutex_unlock(&mutex);
+	return count;
+}
+
+void kinc_profiler_summary_reset(void) {
+	++summary_epoch;
+}
+
+typedef struct {
+	kinc_file_writer_t file;
+	char data[4096];
+	size_t size;
+} trace_writer;
+
+static void flush(trace_writer *writer) {
+	kinc_file_writer_write(&writer->file, writer->data, (int)writer->size);
+	writer->size = 0;
+}
+
+static void write_text(trace_writer *writer, const char *text) {
+	for (; *text != 0; ++text) {
+		if (writer->size == sizeof(writer->data)) {
+			flush(writer);
+		}
+		writer->data[writer->size++] = *text;
+	}
+}
+
+static void write_escaped(trace_writer *writer, const char *text) {
+	char escaped[8];
+	for (; *text != 0; ++text) {
+		if (*text == '"' || *text == '\\') {
+			escaped[0] = '\\';
+			escaped[1] = *text;
+			escaped[2] = 0;
+		}
+		else if ((unsigned char)*text < 0x20) {
+			snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)*text);
+		}
+		else {
+			escaped[0] = *text;
+			escaped[1] = 0;
+		}
+		write_text(writer, escaped);
+	}
+}
+
+bool kinc_profiler_export_chrome_trace(const char *filepath) {
+	if (!mutex_initialized) {
+		return false;
+	}
+	trace_writer *writer = (trace_writer *)kinc_memory_allocate(sizeof(trace_writer), KINC_MEMORY_TAG_GENERAL);
+	if (writer == NULL) {
+		return false;
+	}
+	if (!kinc_file_writer_open(&writer->file, filepath)) {
+		kinc_memory_free(writer);
+		return false;
+	}
+	writer->size = 0;
+
+	double scale = 1000000.0 / kinc_frequency();
+	char text[256];
+	bool first = true;
+	write_text(writer, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	kinc_mutex_lock(&mutex);
+	for (int b = 0; b < buffer_count; ++b) {
+		thread_buffer *buffer = buffers[b];
+		if (buffer->name != NULL) {
+			snprintf(text, sizeof(text), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"", first ? "" : ",\n", buffer->id);
+			write_text(writer, text);
+			write_escaped(writer, buffer->name);
+			write_text(writer, "\"}}");
+			first = false;
+		}
+		uint32_t end = buffer->event_count;
+		uint32_t begin = end > KINC_PROFILER_EVENTS_PER_THREAD ? end - KINC_PROFILER_EVENTS_PER_THREAD : 0;
+		for (uint32_t i = begin; i != end; ++i) {
+			profiler_event *event = &buffer->events[i & (KINC_PROFILER_EVENTS_PER_THREAD - 1)];
+			double timestamp = (double)(int64_t)(event->time - start_time) * scale;
+			write_text(writer, first ? "{\"name\":\"" : ",\n{\"name\":\"");
+			write_escaped(writer, event->name);
+			switch (event->type) {
+			case EVENT_BEGIN:
+				snprintf(text, sizeof(text), "\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%i}", timestamp, buffer->id);
+				break;
+			case EVENT_END:
+				snprintf(text, sizeof(text), "\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%i}", timestamp, buffer->id);
+				break;
+			case EVENT_COUNTER:
+				snprintf(text, sizeof(text), "\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%i,\"args\":{\"value\":%g}}", timestamp, buffer->id, event->value);
+				break;
+			default:
+				snprintf(text, sizeof(text), "\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":%i}", timestamp, buffer->id);
+				break;
+			}
+			write_text(writer, text);
+			first = false;
+		}
+	}
+	kinc_mutex_unlock(&mutex);
+
+	write_text(writer, "\n]}\n");
+	flush(writer);
+	kinc_file_writer_close(&writer->file);
+	kinc_memory_free(writer);
+	return true;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <kinc/global.h>
+
+/*! \file profiler.h
+    \brief Provides a lightweight CPU profiler. Zones, counters and frame markers are recorded into per-thread buffers without any locking and can be
+   exported as a Chrome trace (chrome://tracing or https://ui.perfetto.dev) or summarized at runtime. Use the KINC_PROFILER_-macros - they only cost a
+   branch while the profiler is disabled and compile to nothing when KINC_NO_PROFILER is defined.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// <summary>
+/// The number of events which are kept per thread, older events are overwritten
+/// </summary>
+#define KINC_PROFILER_EVENTS_PER_THREAD (64 * 1024)
+
+/// <summary>
+/// Maximum number of threads which can be recorded
+/// </summary>
+#define KINC_PROFILER_MAX_THREADS 64
+
+typedef struct kinc_profiler_zone_summary {
+	const char *name;
+	int calls;
+	double total_seconds;
+	double max_seconds;
+} kinc_profiler_zone_summary_t;
+
+KINC_FUNC extern bool kinc_internal_profiler_enabled;
+
+/// <summary>
+/// Starts or stops recording.
+/// </summary>
+KINC_FUNC void kinc_profiler_enable(bool enabled);
+
+/// <summary>
+/// Opens a zone on the calling thread. Zones nest and have to be closed using kinc_profiler_end on the same thread.
+/// </summary>
+/// <param name="name">The zone's name - the pointer is stored, so it has to stay valid (ideally a string literal)</param>
+KINC_FUNC void kinc_profiler_begin(const char *name);
+
+/// <summary>
+/// Closes the zone which was opened last on the calling thread.
+/// </summary>
+KINC_FUNC void kinc_profiler_end(void);
+
+/// <summary>
+/// Records the current value of a counter.
+/// </summary>
+/// <param name="name">The counter's name - the pointer is stored, so it has to stay valid (ideally a string literal)</param>
+/// <param name="value">The value to record</param>
+KINC_FUNC void kinc_profiler_counter(const char *name, double value);
+
+/// <summary>
+/// Marks the start of a new frame. Kinc calls this itself at the beginning of every frame.
+/// </summary>
+KINC_FUNC void kinc_profiler_frame(void);
+
+/// <summary>
+/// Names the calling thread in exported traces.
+/// </summary>
+/// <param name="name">The thread's name - the pointer is stored, so it has to stay valid</param>
+KINC_FUNC void kinc_profiler_set_thread_name(const char *name);
+
+/// <summary>
+/// Gathers the zones which were closed since the last kinc_profiler_summary_reset, merged by name across all threads. Can be called while recording.
+/// </summary>
+/// <param name="zones">Receives the zones</param>
+/// <param name="max_zones">The number of entries in zones</param>
+/// <returns>The number of zones which were written</returns>
+KINC_FUNC int kinc_profiler_summary(kinc_profiler_zone_summary_t *zones, int max_zones);
+
+/// <summary>
+/// Clears the statistics which are returned by kinc_profiler_summary.
+/// </summary>
+KINC_FUNC void kinc_profiler_summary_reset(void);
+
+/// <summary>
+/// Writes all recorded events in the Chrome trace event JSON format. Disable the profiler before exporting to get a consistent snapshot.
+/// </summary>
+/// <param name="filepath">A path relative to the save directory</param>
+/// <returns>Whether the file could be written</returns>
+KINC_FUNC bool kinc_profiler_export_chrome_trace(const char *filepath);
+
+#ifdef KINC_NO_PROFILER
+#define KINC_PROFILER_BEGIN(name)
+#define KINC_PROFILER_END()
+#define KINC_PROFILER_COUNTER(name, value)
+#define KINC_PROFILER_FRAME()
+#else
+#define KINC_PROFILER_BEGIN(name)                                                                                                                              \
+	do {                                                                                                                                                       \
+		if (kinc_internal_profiler_enabled) kinc_profiler_begin(name);                                                                                         \
+	} while (0)
+#define KINC_PROFILER_END()                                                                                                                                    \
+	do {                                                                                                                                                       \
+		if (kinc_internal_profiler_enabled) kinc_profiler_end();                                                                                               \
+	} while (0)
+#define KINC_PROFILER_COUNTER(name, value)                                                                                                                     \
+	do {                                                                                                                                                       \
+		if (kinc_internal_profiler_enabled) kinc_profiler_counter(name, value);                                                                                \
+	} while (0)
+#define KINC_PROFILER_FRAME()                                                                                                                                  \
+	do {                                                                                                                                                       \
+		if (kinc_internal_profiler_enabled) kinc_profiler_frame();                                                                                             \
+	} while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
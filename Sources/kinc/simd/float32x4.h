@@ -1,6 +1,6 @@
 #pragma once
 
-#include <kinc/global.h>
+#include "types.h"
 
 /*! \file float32x4.h
     \brief Provides 128bit four-element floating point SIMD operations which are mapped to equivalent SSE or Neon operations.
@@ -10,21 +10,22 @@
 extern "C" {
 #endif
 
-#if defined(__SSE__) || _M_IX86_FP == 2 || _M_IX86_FP == 1 || defined(KORE_WINDOWS) || (defined(KORE_MACOS) && __x86_64)
+#if defined(KINC_SSE)
 
 #include <xmmintrin.h>
 
 typedef __m128 kinc_float32x4_t;
+typedef __m128 kinc_float32x4_mask_t;
 
-inline kinc_float32x4_t kinc_float32x4_load(float a, float b, float c, float d) {
+static inline kinc_float32x4_t kinc_float32x4_load(float a, float b, float c, float d) {
 	return _mm_set_ps(d, c, b, a);
 }
 
-inline kinc_float32x4_t kinc_float32x4_load_all(float t) {
+static inline kinc_float32x4_t kinc_float32x4_load_all(float t) {
 	return _mm_set_ps1(t);
 }
 
-inline float kinc_float32x4_get(kinc_float32x4_t t, int index) {
+static inline float kinc_float32x4_get(kinc_float32x4_t t, int index) {
 	union {
 		__m128 value;
 		float elements[4];
@@ -33,72 +34,131 @@ inline float kinc_float32x4_get(kinc_float32x4_t t, int index) {
 	return converter.elements[index];
 }
 
-inline kinc_float32x4_t kinc_float32x4_abs(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_abs(kinc_float32x4_t t) {
 	__m128 mask = _mm_set_ps1(-0.f);
 	return _mm_andnot_ps(mask, t);
 }
 
-inline kinc_float32x4_t kinc_float32x4_add(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_add(kinc_float32x4_t a, kinc_float32x4_t b) {
 	return _mm_add_ps(a, b);
 }
 
-inline kinc_float32x4_t kinc_float32x4_div(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_div(kinc_float32x4_t a, kinc_float32x4_t b) {
 	return _mm_div_ps(a, b);
 }
 
-inline kinc_float32x4_t kinc_float32x4_mul(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_mul(kinc_float32x4_t a, kinc_float32x4_t b) {
 	return _mm_mul_ps(a, b);
 }
 
-inline kinc_float32x4_t kinc_float32x4_neg(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_neg(kinc_float32x4_t t) {
 	__m128 negative = _mm_set_ps1(-1.0f);
 	return _mm_mul_ps(t, negative);
 }
 
-inline kinc_float32x4_t kinc_float32x4_reciprocal_approximation(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_reciprocal_approximation(kinc_float32x4_t t) {
 	return _mm_rcp_ps(t);
 }
 
-inline kinc_float32x4_t kinc_float32x4_reciprocal_sqrt_approximation(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_reciprocal_sqrt_approximation(kinc_float32x4_t t) {
 	return _mm_rsqrt_ps(t);
 }
 
-inline kinc_float32x4_t kinc_float32x4_sub(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_sub(kinc_float32x4_t a, kinc_float32x4_t b) {
 	return _mm_sub_ps(a, b);
 }
 
-inline kinc_float32x4_t kinc_float32x4_sqrt(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_sqrt(kinc_float32x4_t t) {
 	return _mm_sqrt_ps(t);
 }
 
-#elif defined(KORE_IOS) || defined(KORE_SWITCH) || (defined(KORE_MACOS) && __arm64)
+static inline kinc_float32x4_t kinc_float32x4_load_unaligned(const float *values) {
+	return _mm_loadu_ps(values);
+}
+
+static inline void kinc_float32x4_store_unaligned(float *destination, kinc_float32x4_t value) {
+	_mm_storeu_ps(destination, value);
+}
+
+static inline void kinc_float32x4_transpose(kinc_float32x4_t *a, kinc_float32x4_t *b, kinc_float32x4_t *c, kinc_float32x4_t *d) {
+	_MM_TRANSPOSE4_PS(*a, *b, *c, *d);
+}
+
+static inline kinc_float32x4_t kinc_float32x4_min(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return _mm_min_ps(a, b);
+}
+
+static inline kinc_float32x4_t kinc_float32x4_max(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return _mm_max_ps(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmpeq(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return _mm_cmpeq_ps(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmpneq(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return _mm_cmpneq_ps(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmplt(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return _mm_cmplt_ps(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmple(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return _mm_cmple_ps(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmpgt(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return _mm_cmpgt_ps(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmpge(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return _mm_cmpge_ps(a, b);
+}
+
+// Picks the lanes of a where mask is set and the lanes of b everywhere else.
+static inline kinc_float32x4_t kinc_float32x4_sel(kinc_float32x4_t a, kinc_float32x4_t b, kinc_float32x4_mask_t mask) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Returns a bit per lane, lane 0 in the lowest bit.
+static inline int kinc_float32x4_mask_bits(kinc_float32x4_mask_t mask) {
+	return _mm_movemask_ps(mask);
+}
+
+// Returns (a[x], a[y], b[z], b[w]). The lane indices have to be compile-time constants.
+#define kinc_float32x4_shuffle(a, b, x, y, z, w) _mm_shuffle_ps((a), (b), _MM_SHUFFLE((w), (z), (y), (x)))
+
+#elif defined(KINC_NEON)
 
 #include <arm_neon.h>
 
 typedef float32x4_t kinc_float32x4_t;
+typedef uint32x4_t kinc_float32x4_mask_t;
 
-inline kinc_float32x4_t kinc_float32x4_load(float a, float b, float c, float d) {
-	return {a, b, c, d};
+static inline kinc_float32x4_t kinc_float32x4_load(float a, float b, float c, float d) {
+	float32x4_t value = {a, b, c, d};
+	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_load_all(float t) {
-	return {t, t, t, t};
+static inline kinc_float32x4_t kinc_float32x4_load_all(float t) {
+	return vdupq_n_f32(t);
 }
 
-inline float kinc_float32x4_get(kinc_float32x4_t t, int index) {
+static inline float kinc_float32x4_get(kinc_float32x4_t t, int index) {
 	return t[index];
 }
 
-inline kinc_float32x4_t kinc_float32x4_abs(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_abs(kinc_float32x4_t t) {
 	return vabsq_f32(t);
 }
 
-inline kinc_float32x4_t kinc_float32x4_add(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_add(kinc_float32x4_t a, kinc_float32x4_t b) {
 	return vaddq_f32(a, b);
 }
 
-inline kinc_float32x4_t kinc_float32x4_div(kinc_float32x4_t a, kinc_float32x4_t b) {
-#if defined(ARM64) || defined(KORE_SWITCH) || __arm64
+static inline kinc_float32x4_t kinc_float32x4_div(kinc_float32x4_t a, kinc_float32x4_t b) {
+#ifdef KINC_NEON64
 	return vdivq_f32(a, b);
 #else
 	float32x4_t inv = vrecpeq_f32(b);
@@ -108,43 +168,116 @@ inline kinc_float32x4_t kinc_float32x4_div(kinc_float32x4_t a, kinc_float32x4_t
 #endif
 }
 
-inline kinc_float32x4_t kinc_float32x4_mul(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_mul(kinc_float32x4_t a, kinc_float32x4_t b) {
 	return vmulq_f32(a, b);
 }
 
-inline kinc_float32x4_t kinc_float32x4_neg(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_neg(kinc_float32x4_t t) {
 	return vnegq_f32(t);
 }
 
-inline kinc_float32x4_t kinc_float32x4_reciprocal_approximation(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_reciprocal_approximation(kinc_float32x4_t t) {
 	return vrecpeq_f32(t);
 }
 
-inline kinc_float32x4_t kinc_float32x4_reciprocal_sqrt_approximation(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_reciprocal_sqrt_approximation(kinc_float32x4_t t) {
 	return vrsqrteq_f32(t);
 }
 
-inline kinc_float32x4_t kinc_float32x4_sub(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_sub(kinc_float32x4_t a, kinc_float32x4_t b) {
 	return vsubq_f32(a, b);
 }
 
-inline kinc_float32x4_t kinc_float32x4_sqrt(kinc_float32x4_t t) {
-#if defined(ARM64) || defined(KORE_SWITCH) || __arm64
+static inline kinc_float32x4_t kinc_float32x4_sqrt(kinc_float32x4_t t) {
+#ifdef KINC_NEON64
 	return vsqrtq_f32(t);
 #else
 	return vmulq_f32(t, vrsqrteq_f32(t));
 #endif
 }
 
+static inline kinc_float32x4_t kinc_float32x4_load_unaligned(const float *values) {
+	return vld1q_f32(values);
+}
+
+static inline void kinc_float32x4_store_unaligned(float *destination, kinc_float32x4_t value) {
+	vst1q_f32(destination, value);
+}
+
+static inline void kinc_float32x4_transpose(kinc_float32x4_t *a, kinc_float32x4_t *b, kinc_float32x4_t *c, kinc_float32x4_t *d) {
+	float32x4x2_t ab = vtrnq_f32(*a, *b);
+	float32x4x2_t cd = vtrnq_f32(*c, *d);
+	*a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+	*b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+	*c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+	*d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+
+static inline kinc_float32x4_t kinc_float32x4_min(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return vminq_f32(a, b);
+}
+
+static inline kinc_float32x4_t kinc_float32x4_max(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return vmaxq_f32(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmpeq(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return vceqq_f32(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmpneq(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return vmvnq_u32(vceqq_f32(a, b));
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmplt(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return vcltq_f32(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmple(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return vcleq_f32(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmpgt(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return vcgtq_f32(a, b);
+}
+
+static inline kinc_float32x4_mask_t kinc_float32x4_cmpge(kinc_float32x4_t a, kinc_float32x4_t b) {
+	return vcgeq_f32(a, b);
+}
+
+static inline kinc_float32x4_t kinc_float32x4_sel(kinc_float32x4_t a, kinc_float32x4_t b, kinc_float32x4_mask_t mask) {
+	return vbslq_f32(mask, a, b);
+}
+
+static inline int kinc_float32x4_mask_bits(kinc_float32x4_mask_t mask) {
+	return (vgetq_lane_u32(mask, 0) & 1) | (vgetq_lane_u32(mask, 1) & 2) | (vgetq_lane_u32(mask, 2) & 4) | (vgetq_lane_u32(mask, 3) & 8);
+}
+
+static inline kinc_float32x4_t kinc_internal_float32x4_shuffle(kinc_float32x4_t a, kinc_float32x4_t b, int x, int y, int z, int w) {
+	float values_a[4];
+	float values_b[4];
+	vst1q_f32(values_a, a);
+	vst1q_f32(values_b, b);
+	return kinc_float32x4_load(values_a[x], values_a[y], values_b[z], values_b[w]);
+}
+
+#define kinc_float32x4_shuffle(a, b, x, y, z, w) kinc_internal_float32x4_shuffle((a), (b), (x), (y), (z), (w))
+
 #else
 
 #include <kinc/math/core.h>
 
+#include <stdint.h>
+
 typedef struct kinc_float32x4 {
 	float values[4];
 } kinc_float32x4_t;
 
-inline kinc_float32x4_t kinc_float32x4_load(float a, float b, float c, float d) {
+typedef struct kinc_float32x4_mask {
+	uint32_t values[4];
+} kinc_float32x4_mask_t;
+
+static inline kinc_float32x4_t kinc_float32x4_load(float a, float b, float c, float d) {
 	kinc_float32x4_t value;
 	value.values[0] = a;
 	value.values[1] = b;
@@ -153,7 +286,7 @@ inline kinc_float32x4_t kinc_float32x4_load(float a, float b, float c, float d)
 	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_load_all(float t) {
+static inline kinc_float32x4_t kinc_float32x4_load_all(float t) {
 	kinc_float32x4_t value;
 	value.values[0] = t;
 	value.values[1] = t;
@@ -162,11 +295,11 @@ inline kinc_float32x4_t kinc_float32x4_load_all(float t) {
 	return value;
 }
 
-inline float kinc_float32x4_get(kinc_float32x4_t t, int index) {
+static inline float kinc_float32x4_get(kinc_float32x4_t t, int index) {
 	return t.values[index];
 }
 
-inline kinc_float32x4_t kinc_float32x4_abs(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_abs(kinc_float32x4_t t) {
 	kinc_float32x4_t value;
 	value.values[0] = kinc_abs(t.values[0]);
 	value.values[1] = kinc_abs(t.values[1]);
@@ -175,7 +308,7 @@ inline kinc_float32x4_t kinc_float32x4_abs(kinc_float32x4_t t) {
 	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_add(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_add(kinc_float32x4_t a, kinc_float32x4_t b) {
 	kinc_float32x4_t value;
 	value.values[0] = a.values[0] + b.values[0];
 	value.values[1] = a.values[1] + b.values[1];
@@ -184,7 +317,7 @@ inline kinc_float32x4_t kinc_float32x4_add(kinc_float32x4_t a, kinc_float32x4_t
 	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_div(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_div(kinc_float32x4_t a, kinc_float32x4_t b) {
 	kinc_float32x4_t value;
 	value.values[0] = a.values[0] / b.values[0];
 	value.values[1] = a.values[1] / b.values[1];
@@ -193,7 +326,7 @@ inline kinc_float32x4_t kinc_float32x4_div(kinc_float32x4_t a, kinc_float32x4_t
 	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_mul(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_mul(kinc_float32x4_t a, kinc_float32x4_t b) {
 	kinc_float32x4_t value;
 	value.values[0] = a.values[0] * b.values[0];
 	value.values[1] = a.values[1] * b.values[1];
@@ -202,7 +335,7 @@ inline kinc_float32x4_t kinc_float32x4_mul(kinc_float32x4_t a, kinc_float32x4_t
 	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_neg(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_neg(kinc_float32x4_t t) {
 	kinc_float32x4_t value;
 	value.values[0] = -t.values[0];
 	value.values[1] = -t.values[1];
@@ -211,25 +344,25 @@ inline kinc_float32x4_t kinc_float32x4_neg(kinc_float32x4_t t) {
 	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_reciprocal_approximation(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_reciprocal_approximation(kinc_float32x4_t t) {
 	kinc_float32x4_t value;
-	value.values[0] = 0;
-	value.values[1] = 0;
-	value.values[2] = 0;
-	value.values[3] = 0;
+	value.values[0] = 1.0f / t.values[0];
+	value.values[1] = 1.0f / t.values[1];
+	value.values[2] = 1.0f / t.values[2];
+	value.values[3] = 1.0f / t.values[3];
 	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_reciprocal_sqrt_approximation(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_reciprocal_sqrt_approximation(kinc_float32x4_t t) {
 	kinc_float32x4_t value;
-	value.values[0] = 0;
-	value.values[1] = 0;
-	value.values[2] = 0;
-	value.values[3] = 0;
+	value.values[0] = 1.0f / kinc_sqrt(t.values[0]);
+	value.values[1] = 1.0f / kinc_sqrt(t.values[1]);
+	value.values[2] = 1.0f / kinc_sqrt(t.values[2]);
+	value.values[3] = 1.0f / kinc_sqrt(t.values[3]);
 	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_sub(kinc_float32x4_t a, kinc_float32x4_t b) {
+static inline kinc_float32x4_t kinc_float32x4_sub(kinc_float32x4_t a, kinc_float32x4_t b) {
 	kinc_float32x4_t value;
 	value.values[0] = a.values[0] - b.values[0];
 	value.values[1] = a.values[1] - b.values[1];
@@ -238,7 +371,7 @@ inline kinc_float32x4_t kinc_float32x4_sub(kinc_float32x4_t a, kinc_float32x4_t
 	return value;
 }
 
-inline kinc_float32x4_t kinc_float32x4_sqrt(kinc_float32x4_t t) {
+static inline kinc_float32x4_t kinc_float32x4_sqrt(kinc_float32x4_t t) {
 	kinc_float32x4_t value;
 	value.values[0] = kinc_sqrt(t.values[0]);
 	value.values[1] = kinc_sqrt(t.values[1]);
@@ -247,6 +380,77 @@ inline kinc_float32x4_t kinc_float32x4_sqrt(kinc_float32x4_t t) {
 	return value;
 }
 
+static inline kinc_float32x4_t kinc_float32x4_load_unaligned(const float *values) {
+	return kinc_float32x4_load(values[0], values[1], values[2], values[3]);
+}
+
+static inline void kinc_float32x4_store_unaligned(float *destination, kinc_float32x4_t value) {
+	destination[0] = value.values[0];
+	destination[1] = value.values[1];
+	destination[2] = value.values[2];
+	destination[3] = value.values[3];
+}
+
+static inline void kinc_float32x4_transpose(kinc_float32x4_t *a, kinc_float32x4_t *b, kinc_float32x4_t *c, kinc_float32x4_t *d) {
+	kinc_float32x4_t rows[4] = {*a, *b, *c, *d};
+	for (int i = 0; i < 4; ++i) {
+		a->values[i] = rows[i].values[0];
+		b->values[i] = rows[i].values[1];
+		c->values[i] = rows[i].values[2];
+		d->values[i] = rows[i].values[3];
+	}
+}
+
+static inline kinc_float32x4_t kinc_float32x4_min(kinc_float32x4_t a, kinc_float32x4_t b) {
+	kinc_float32x4_t value;
+	for (int i = 0; i < 4; ++i) {
+		value.values[i] = a.values[i] < b.values[i] ? a.values[i] : b.values[i];
+	}
+	return value;
+}
+
+static inline kinc_float32x4_t kinc_float32x4_max(kinc_float32x4_t a, kinc_float32x4_t b) {
+	kinc_float32x4_t value;
+	for (int i = 0; i < 4; ++i) {
+		value.values[i] = a.values[i] > b.values[i] ? a.values[i] : b.values[i];
+	}
+	return value;
+}
+
+#define KINC_INTERNAL_FLOAT32X4_COMPARE(name, op)                                                                                                              \
+	static inline kinc_float32x4_mask_t kinc_float32x4_##name(kinc_float32x4_t a, kinc_float32x4_t b) {                                                       \
+		kinc_float32x4_mask_t mask;                                                                                                                            \
+		for (int i = 0; i < 4; ++i) {                                                                                                                          \
+			mask.values[i] = a.values[i] op b.values[i] ? 0xffffffff : 0;                                                                                      \
+		}                                                                                                                                                      \
+		return mask;                                                                                                                                           \
+	}
+
+KINC_INTERNAL_FLOAT32X4_COMPARE(cmpeq, ==)
+KINC_INTERNAL_FLOAT32X4_COMPARE(cmpneq, !=)
+KINC_INTERNAL_FLOAT32X4_COMPARE(cmplt, <)
+KINC_INTERNAL_FLOAT32X4_COMPARE(cmple, <=)
+KINC_INTERNAL_FLOAT32X4_COMPARE(cmpgt, >)
+KINC_INTERNAL_FLOAT32X4_COMPARE(cmpge, >=)
+
+static inline kinc_float32x4_t kinc_float32x4_sel(kinc_float32x4_t a, kinc_float32x4_t b, kinc_float32x4_mask_t mask) {
+	kinc_float32x4_t value;
+	for (int i = 0; i < 4; ++i) {
+		value.values[i] = mask.values[i] != 0 ? a.values[i] : b.values[i];
+	}
+	return value;
+}
+
+static inline int kinc_float32x4_mask_bits(kinc_float32x4_mask_t mask) {
+	return (mask.values[0] != 0 ? 1 : 0) | (mask.values[1] != 0 ? 2 : 0) | (mask.values[2] != 0 ? 4 : 0) | (mask.values[3] != 0 ? 8 : 0);
+}
+
+static inline kinc_float32x4_t kinc_internal_float32x4_shuffle(kinc_float32x4_t a, kinc_float32x4_t b, int x, int y, int z, int w) {
+	return kinc_float32x4_load(a.values[x], a.values[y], b.values[z], b.values[w]);
+}
+
+#define kinc_float32x4_shuffle(a, b, x, y, z, w) kinc_internal_float32x4_shuffle((a), (b), (x), (y), (z), (w))
+
 #endif
 
 #ifdef __cplusplus
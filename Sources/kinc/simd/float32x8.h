@@ -0,0 +1,185 @@
+#pragma once
+
+#include "float32x4.h"
+
+/*! \file float32x8.h
+    \brief Provides 256bit eight-element floating point SIMD operations. These map to AVX when the target is compiled with AVX enabled and are otherwise
+   emulated using two kinc_float32x4_t values.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(KINC_AVX)
+
+#include <immintrin.h>
+
+typedef __m256 kinc_float32x8_t;
+typedef __m256 kinc_float32x8_mask_t;
+
+static inline kinc_float32x8_t kinc_float32x8_load_all(float t) {
+	return _mm256_set1_ps(t);
+}
+
+static inline kinc_float32x8_t kinc_float32x8_load_unaligned(const float *values) {
+	return _mm256_loadu_ps(values);
+}
+
+static inline void kinc_float32x8_store_unaligned(float *destination, kinc_float32x8_t t) {
+	_mm256_storeu_ps(destination, t);
+}
+
+static inline float kinc_float32x8_get(kinc_float32x8_t t, int index) {
+	union {
+		__m256 value;
+		float elements[8];
+	} converter;
+	converter.value = t;
+	return converter.elements[index];
+}
+
+static inline kinc_float32x8_t kinc_float32x8_add(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_add_ps(a, b);
+}
+
+static inline kinc_float32x8_t kinc_float32x8_sub(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_sub_ps(a, b);
+}
+
+static inline kinc_float32x8_t kinc_float32x8_mul(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_mul_ps(a, b);
+}
+
+static inline kinc_float32x8_t kinc_float32x8_div(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_div_ps(a, b);
+}
+
+static inline kinc_float32x8_t kinc_float32x8_sqrt(kinc_float32x8_t t) {
+	return _mm256_sqrt_ps(t);
+}
+
+static inline kinc_float32x8_t kinc_float32x8_abs(kinc_float32x8_t t) {
+	return _mm256_andnot_ps(_mm256_set1_ps(-0.f), t);
+}
+
+static inline kinc_float32x8_t kinc_float32x8_neg(kinc_float32x8_t t) {
+	return _mm256_xor_ps(_mm256_set1_ps(-0.f), t);
+}
+
+static inline kinc_float32x8_t kinc_float32x8_min(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_min_ps(a, b);
+}
+
+static inline kinc_float32x8_t kinc_float32x8_max(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_max_ps(a, b);
+}
+
+static inline kinc_float32x8_mask_t kinc_float32x8_cmplt(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+}
+
+static inline kinc_float32x8_mask_t kinc_float32x8_cmple(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+}
+
+static inline kinc_float32x8_mask_t kinc_float32x8_cmpgt(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+}
+
+static inline kinc_float32x8_mask_t kinc_float32x8_cmpge(kinc_float32x8_t a, kinc_float32x8_t b) {
+	return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+}
+
+// Picks the lanes of a where mask is set and the lanes of b everywhere else.
+static inline kinc_float32x8_t kinc_float32x8_sel(kinc_float32x8_t a, kinc_float32x8_t b, kinc_float32x8_mask_t mask) {
+	return _mm256_blendv_ps(b, a, mask);
+}
+
+// Returns a bit per lane, lane 0 in the lowest bit.
+static inline int kinc_float32x8_mask_bits(kinc_float32x8_mask_t mask) {
+	return _mm256_movemask_ps(mask);
+}
+
+#else
+
+typedef struct kinc_float32x8 {
+	kinc_float32x4_t low;
+	kinc_float32x4_t high;
+} kinc_float32x8_t;
+
+typedef struct kinc_float32x8_mask {
+	kinc_float32x4_mask_t low;
+	kinc_float32x4_mask_t high;
+} kinc_float32x8_mask_t;
+
+static inline kinc_float32x8_t kinc_float32x8_load_all(float t) {
+	kinc_float32x8_t value;
+	value.low = kinc_float32x4_load_all(t);
+	value.high = value.low;
+	return value;
+}
+
+static inline kinc_float32x8_t kinc_float32x8_load_unaligned(const float *values) {
+	kinc_float32x8_t value;
+	value.low = kinc_float32x4_load_unaligned(values);
+	value.high = kinc_float32x4_load_unaligned(values + 4);
+	return value;
+}
+
+static inline void kinc_float32x8_store_unaligned(float *destination, kinc_float32x8_t t) {
+	kinc_float32x4_store_unaligned(destination, t.low);
+	kinc_float32x4_store_unaligned(destination + 4, t.high);
+}
+
+static inline float kinc_float32x8_get(kinc_float32x8_t t, int index) {
+	return index < 4 ? kinc_float32x4_get(t.low, index) : kinc_float32x4_get(t.high, index - 4);
+}
+
+#define KINC_INTERNAL_FLOAT32X8_UNARY(name)                                                                                                                    \
+	static inline kinc_float32x8_t kinc_float32x8_##name(kinc_float32x8_t t) {                                                                                \
+		kinc_float32x8_t value;                                                                                                                                \
+		value.low = kinc_float32x4_##name(t.low);                                                                                                              \
+		value.high = kinc_float32x4_##name(t.high);                                                                                                            \
+		return value;                                                                                                                                          \
+	}
+
+#define KINC_INTERNAL_FLOAT32X8_BINARY(name, result)                                                                                                           \
+	static inline result kinc_float32x8_##name(kinc_float32x8_t a, kinc_float32x8_t b) {                                                                      \
+		result value;                                                                                                                                          \
+		value.low = kinc_float32x4_##name(a.low, b.low);                                                                                                       \
+		value.high = kinc_float32x4_##name(a.high, b.high);                                                                                                    \
+		return value;                                                                                                                                          \
+	}
+
+KINC_INTERNAL_FLOAT32X8_UNARY(sqrt)
+KINC_INTERNAL_FLOAT32X8_UNARY(abs)
+KINC_INTERNAL_FLOAT32X8_UNARY(neg)
+
+KINC_INTERNAL_FLOAT32X8_BINARY(add, kinc_float32x8_t)
+KINC_INTERNAL_FLOAT32X8_BINARY(sub, kinc_float32x8_t)
+KINC_INTERNAL_FLOAT32X8_BINARY(mul, kinc_float32x8_t)
+KINC_INTERNAL_FLOAT32X8_BINARY(div, kinc_float32x8_t)
+KINC_INTERNAL_FLOAT32X8_BINARY(min, kinc_float32x8_t)
+KINC_INTERNAL_FLOAT32X8_BINARY(max, kinc_float32x8_t)
+KINC_INTERNAL_FLOAT32X8_BINARY(cmplt, kinc_float32x8_mask_t)
+KINC_INTERNAL_FLOAT32X8_BINARY(cmple, kinc_float32x8_mask_t)
+KINC_INTERNAL_FLOAT32X8_BINARY(cmpgt, kinc_float32x8_mask_t)
+KINC_INTERNAL_FLOAT32X8_BINARY(cmpge, kinc_float32x8_mask_t)
+
+static inline kinc_float32x8_t kinc_float32x8_sel(kinc_float32x8_t a, kinc_float32x8_t b, kinc_float32x8_mask_t mask) {
+	kinc_float32x8_t value;
+	value.low = kinc_float32x4_sel(a.low, b.low, mask.low);
+	value.high = kinc_float32x4_sel(a.high, b.high, mask.high);
+	return value;
+}
+
+static inline int kinc_float32x8_mask_bits(kinc_float32x8_mask_t mask) {
+	return kinc_float32x4_mask_bits(mask.low) | (kinc_float32x4_mask_bits(mask.high) << 4);
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,349 @@
+#pragma once
+
+#include "float32x4.h"
+
+#include <math.h>
+#include <stdint.h>
+
+/*! \file int32x4.h
+    \brief Provides 128bit four-element signed integer SIMD operations which are mapped to equivalent SSE2 or Neon operations.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(KINC_SSE2)
+
+#include <emmintrin.h>
+
+typedef __m128i kinc_int32x4_t;
+
+static inline kinc_int32x4_t kinc_int32x4_load(int32_t a, int32_t b, int32_t c, int32_t d) {
+	return _mm_set_epi32(d, c, b, a);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_load_all(int32_t t) {
+	return _mm_set1_epi32(t);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_load_unaligned(const int32_t *values) {
+	return _mm_loadu_si128((const __m128i *)values);
+}
+
+static inline void kinc_int32x4_store_unaligned(int32_t *destination, kinc_int32x4_t t) {
+	_mm_storeu_si128((__m128i *)destination, t);
+}
+
+static inline int32_t kinc_int32x4_get(kinc_int32x4_t t, int index) {
+	union {
+		__m128i value;
+		int32_t elements[4];
+	} converter;
+	converter.value = t;
+	return converter.elements[index];
+}
+
+static inline kinc_int32x4_t kinc_int32x4_add(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return _mm_add_epi32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_sub(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return _mm_sub_epi32(a, b);
+}
+
+// SSE2 has no 32bit low multiply, the even and odd lanes are multiplied separately and interleaved again.
+static inline kinc_int32x4_t kinc_int32x4_mul(kinc_int32x4_t a, kinc_int32x4_t b) {
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_and(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return _mm_and_si128(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_or(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return _mm_or_si128(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_xor(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return _mm_xor_si128(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_not(kinc_int32x4_t t) {
+	return _mm_xor_si128(t, _mm_set1_epi32(-1));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_shift_left(kinc_int32x4_t t, int bits) {
+	return _mm_sll_epi32(t, _mm_cvtsi32_si128(bits));
+}
+
+// Arithmetic shift, the sign bit is replicated.
+static inline kinc_int32x4_t kinc_int32x4_shift_right(kinc_int32x4_t t, int bits) {
+	return _mm_sra_epi32(t, _mm_cvtsi32_si128(bits));
+}
+
+// Logical shift, zeros are shifted in.
+static inline kinc_int32x4_t kinc_int32x4_shift_right_logical(kinc_int32x4_t t, int bits) {
+	return _mm_srl_epi32(t, _mm_cvtsi32_si128(bits));
+}
+
+// Comparisons return all bits set in the lanes where the comparison is true.
+static inline kinc_int32x4_t kinc_int32x4_cmpeq(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return _mm_cmpeq_epi32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_cmplt(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return _mm_cmplt_epi32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_cmpgt(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return _mm_cmpgt_epi32(a, b);
+}
+
+// Picks the lanes of a where mask is set and the lanes of b everywhere else.
+static inline kinc_int32x4_t kinc_int32x4_sel(kinc_int32x4_t a, kinc_int32x4_t b, kinc_int32x4_t mask) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_min(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return kinc_int32x4_sel(a, b, _mm_cmplt_epi32(a, b));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_max(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return kinc_int32x4_sel(a, b, _mm_cmpgt_epi32(a, b));
+}
+
+// Rounds to nearest with ties to even (the default rounding-mode) on every platform.
+static inline kinc_int32x4_t kinc_int32x4_from_float32x4(kinc_float32x4_t t) {
+	return _mm_cvtps_epi32(t);
+}
+
+static inline kinc_float32x4_t kinc_int32x4_to_float32x4(kinc_int32x4_t t) {
+	return _mm_cvtepi32_ps(t);
+}
+
+#elif defined(KINC_NEON)
+
+typedef int32x4_t kinc_int32x4_t;
+
+static inline kinc_int32x4_t kinc_int32x4_load(int32_t a, int32_t b, int32_t c, int32_t d) {
+	int32x4_t value = {a, b, c, d};
+	return value;
+}
+
+static inline kinc_int32x4_t kinc_int32x4_load_all(int32_t t) {
+	return vdupq_n_s32(t);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_load_unaligned(const int32_t *values) {
+	return vld1q_s32(values);
+}
+
+static inline void kinc_int32x4_store_unaligned(int32_t *destination, kinc_int32x4_t t) {
+	vst1q_s32(destination, t);
+}
+
+static inline int32_t kinc_int32x4_get(kinc_int32x4_t t, int index) {
+	int32_t elements[4];
+	vst1q_s32(elements, t);
+	return elements[index];
+}
+
+static inline kinc_int32x4_t kinc_int32x4_add(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vaddq_s32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_sub(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vsubq_s32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_mul(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vmulq_s32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_and(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vandq_s32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_or(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vorrq_s32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_xor(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return veorq_s32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_not(kinc_int32x4_t t) {
+	return vmvnq_s32(t);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_shift_left(kinc_int32x4_t t, int bits) {
+	return vshlq_s32(t, vdupq_n_s32(bits));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_shift_right(kinc_int32x4_t t, int bits) {
+	return vshlq_s32(t, vdupq_n_s32(-bits));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_shift_right_logical(kinc_int32x4_t t, int bits) {
+	return vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(t), vdupq_n_s32(-bits)));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_cmpeq(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vreinterpretq_s32_u32(vceqq_s32(a, b));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_cmplt(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vreinterpretq_s32_u32(vcltq_s32(a, b));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_cmpgt(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vreinterpretq_s32_u32(vcgtq_s32(a, b));
+}
+
+static inline kinc_int32x4_t kinc_int32x4_sel(kinc_int32x4_t a, kinc_int32x4_t b, kinc_int32x4_t mask) {
+	return vbslq_s32(vreinterpretq_u32_s32(mask), a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_min(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vminq_s32(a, b);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_max(kinc_int32x4_t a, kinc_int32x4_t b) {
+	return vmaxq_s32(a, b);
+}
+
+// Rounds to nearest with ties to even on every platform.
+static inline kinc_int32x4_t kinc_int32x4_from_float32x4(kinc_float32x4_t t) {
+#ifdef KINC_NEON64
+	return vcvtnq_s32_f32(t);
+#else
+	// adding and subtracting 2^23 leaves no fraction bits so the addition rounds like the FPU does, larger values are integers already
+	float32x4_t magnitude = vabsq_f32(t);
+	float32x4_t shift = vdupq_n_f32(8388608.0f);
+	float32x4_t rounded = vbslq_f32(vcltq_f32(magnitude, shift), vsubq_f32(vaddq_f32(magnitude, shift), shift), magnitude);
+	return vcvtq_s32_f32(vbslq_f32(vdupq_n_u32(0x80000000), t, rounded));
+#endif
+}
+
+static inline kinc_float32x4_t kinc_int32x4_to_float32x4(kinc_int32x4_t t) {
+	return vcvtq_f32_s32(t);
+}
+
+#else
+
+typedef struct kinc_int32x4 {
+	int32_t values[4];
+} kinc_int32x4_t;
+
+static inline kinc_int32x4_t kinc_int32x4_load(int32_t a, int32_t b, int32_t c, int32_t d) {
+	kinc_int32x4_t value;
+	value.values[0] = a;
+	value.values[1] = b;
+	value.values[2] = c;
+	value.values[3] = d;
+	return value;
+}
+
+static inline kinc_int32x4_t kinc_int32x4_load_all(int32_t t) {
+	return kinc_int32x4_load(t, t, t, t);
+}
+
+static inline kinc_int32x4_t kinc_int32x4_load_unaligned(const int32_t *values) {
+	return kinc_int32x4_load(values[0], values[1], values[2], values[3]);
+}
+
+static inline void kinc_int32x4_store_unaligned(int32_t *destination, kinc_int32x4_t t) {
+	for (int i = 0; i < 4; ++i) {
+		destination[i] = t.values[i];
+	}
+}
+
+static inline int32_t kinc_int32x4_get(kinc_int32x4_t t, int index) {
+	return t.values[index];
+}
+
+#define KINC_INTERNAL_INT32X4_BINARY(name, expression)                                                                                                         \
+	static inline kinc_int32x4_t kinc_int32x4_##name(kinc_int32x4_t a, kinc_int32x4_t b) {                                                                    \
+		kinc_int32x4_t value;                                                                                                                                  \
+		for (int i = 0; i < 4; ++i) {                                                                                                                          \
+			int32_t x = a.values[i];                                                                                                                           \
+			int32_t y = b.values[i];                                                                                                                           \
+			value.values[i] = (expression);                                                                                                                    \
+		}                                                                                                                                                      \
+		return value;                                                                                                                                          \
+	}
+
+// add, sub and mul wrap around like the SIMD versions do
+KINC_INTERNAL_INT32X4_BINARY(add, (int32_t)((uint32_t)x + (uint32_t)y))
+KINC_INTERNAL_INT32X4_BINARY(sub, (int32_t)((uint32_t)x - (uint32_t)y))
+KINC_INTERNAL_INT32X4_BINARY(mul, (int32_t)((uint32_t)x * (uint32_t)y))
+KINC_INTERNAL_INT32X4_BINARY(and, x & y)
+KINC_INTERNAL_INT32X4_BINARY(or, x | y)
+KINC_INTERNAL_INT32X4_BINARY(xor, x ^ y)
+KINC_INTERNAL_INT32X4_BINARY(cmpeq, x == y ? -1 : 0)
+KINC_INTERNAL_INT32X4_BINARY(cmplt, x < y ? -1 : 0)
+KINC_INTERNAL_INT32X4_BINARY(cmpgt, x > y ? -1 : 0)
+KINC_INTERNAL_INT32X4_BINARY(min, x < y ? x : y)
+KINC_INTERNAL_INT32X4_BINARY(max, x > y ? x : y)
+
+static inline kinc_int32x4_t kinc_int32x4_not(kinc_int32x4_t t) {
+	kinc_int32x4_t value;
+	for (int i = 0; i < 4; ++i) {
+		value.values[i] = ~t.values[i];
+	}
+	return value;
+}
+
+static inline kinc_int32x4_t kinc_int32x4_shift_left(kinc_int32x4_t t, int bits) {
+	kinc_int32x4_t value;
+	for (int i = 0; i < 4; ++i) {
+		value.values[i] = (int32_t)((uint32_t)t.values[i] << bits);
+	}
+	return value;
+}
+
+static inline kinc_int32x4_t kinc_int32x4_shift_right(kinc_int32x4_t t, int bits) {
+	kinc_int32x4_t value;
+	for (int i = 0; i < 4; ++i) {
+		value.values[i] = t.values[i] >> bits;
+	}
+	return value;
+}
+
+static inline kinc_int32x4_t kinc_int32x4_shift_right_logical(kinc_int32x4_t t, int bits) {
+	kinc_int32x4_t value;
+	for (int i = 0; i < 4; ++i) {
+		value.values[i] = (int32_t)((uint32_t)t.values[i] >> bits);
+	}
+	return value;
+}
+
+static inline kinc_int32x4_t kinc_int32x4_sel(kinc_int32x4_t a, kinc_int32x4_t b, kinc_int32x4_t mask) {
+	kinc_int32x4_t value;
+	for (int i = 0; i < 4; ++i) {
+		value.values[i] = (a.values[i] & mask.values[i]) | (b.values[i] & ~mask.values[i]);
+	}
+	return value;
+}
+
+// Rounds to nearest with ties to even (the default rounding-mode) on every platform.
+static inline kinc_int32x4_t kinc_int32x4_from_float32x4(kinc_float32x4_t t) {
+	kinc_int32x4_t value;
+	for (int i = 0; i < 4; ++i) {
+		value.values[i] = (int32_t)lrintf(kinc_float32x4_get(t, i));
+	}
+	return value;
+}
+
+static inline kinc_float32x4_t kinc_int32x4_to_float32x4(kinc_int32x4_t t) {
+	return kinc_float32x4_load((float)t.values[0], (float)t.values[1], (float)t.values[2], (float)t.values[3]);
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
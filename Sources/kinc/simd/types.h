@@ -0,0 +1,36 @@
+#pragma once
+
+#include <kinc/global.h>
+
+/*! \file types.h
+    \brief Selects the SIMD instruction set which is used by the kinc/simd types. The selection happens at compile time based on the target - KINC_SSE, KINC_SSE2,
+   KINC_AVX, KINC_NEON or KINC_NOSIMD is defined accordingly. Define KINC_NOSIMD yourself to force the portable scalar implementations.
+*/
+
+#if !defined(KINC_NOSIMD)
+
+#if defined(__SSE__) || _M_IX86_FP == 2 || _M_IX86_FP == 1 || defined(KORE_WINDOWS) || (defined(KORE_MACOS) && __x86_64)
+#define KINC_SSE
+#endif
+
+#if defined(__SSE2__) || _M_IX86_FP == 2 || defined(_M_X64) || defined(KORE_WINDOWS) || (defined(KORE_MACOS) && __x86_64)
+#define KINC_SSE2
+#endif
+
+#if defined(__AVX__)
+#define KINC_AVX
+#endif
+
+#if !defined(KINC_SSE) && (defined(KORE_IOS) || defined(KORE_SWITCH) || (defined(KORE_MACOS) && __arm64) || defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define KINC_NEON
+#endif
+
+#if defined(KINC_NEON) && (defined(ARM64) || defined(KORE_SWITCH) || __arm64 || defined(__aarch64__))
+#define KINC_NEON64
+#endif
+
+#if !defined(KINC_SSE) && !defined(KINC_NEON)
+#define KINC_NOSIMD
+#endif
+
+#endif
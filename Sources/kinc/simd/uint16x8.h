@@ -0,0 +1,313 @@
+#pragma once
+
+#include "uint8x16.h"
+
+/*! \file uint16x8.h
+    \brief Provides 128bit eight-element unsigned 16bit integer SIMD operations which are mapped to equivalent SSE2 or Neon operations.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(KINC_SSE2)
+
+typedef __m128i kinc_uint16x8_t;
+
+static inline kinc_uint16x8_t kinc_uint16x8_load_all(uint16_t t) {
+	return _mm_set1_epi16((short)t);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_load_unaligned(const uint16_t *values) {
+	return _mm_loadu_si128((const __m128i *)values);
+}
+
+static inline void kinc_uint16x8_store_unaligned(uint16_t *destination, kinc_uint16x8_t t) {
+	_mm_storeu_si128((__m128i *)destination, t);
+}
+
+static inline uint16_t kinc_uint16x8_get(kinc_uint16x8_t t, int index) {
+	union {
+		__m128i value;
+		uint16_t elements[8];
+	} converter;
+	converter.value = t;
+	return converter.elements[index];
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_add(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_add_epi16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_sub(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_sub_epi16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_add_saturated(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_adds_epu16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_sub_saturated(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_subs_epu16(a, b);
+}
+
+// Keeps the low 16 bits of each product.
+static inline kinc_uint16x8_t kinc_uint16x8_mul(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_mullo_epi16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_shift_left(kinc_uint16x8_t t, int bits) {
+	return _mm_sll_epi16(t, _mm_cvtsi32_si128(bits));
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_shift_right(kinc_uint16x8_t t, int bits) {
+	return _mm_srl_epi16(t, _mm_cvtsi32_si128(bits));
+}
+
+// SSE2 only knows signed 16bit min/max, a saturated subtraction is zero exactly when a <= b.
+static inline kinc_uint16x8_t kinc_uint16x8_min(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_sub_epi16(a, _mm_subs_epu16(a, b));
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_max(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_add_epi16(b, _mm_subs_epu16(a, b));
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_and(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_and_si128(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_or(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_or_si128(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_xor(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_xor_si128(a, b);
+}
+
+// Returns all bits set in the lanes where a and b are equal.
+static inline kinc_uint16x8_t kinc_uint16x8_cmpeq(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return _mm_cmpeq_epi16(a, b);
+}
+
+// Picks the lanes of a where mask is set and the lanes of b everywhere else.
+static inline kinc_uint16x8_t kinc_uint16x8_sel(kinc_uint16x8_t a, kinc_uint16x8_t b, kinc_uint16x8_t mask) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Zero-extends the lower eight bytes.
+static inline kinc_uint16x8_t kinc_uint16x8_widen_low(kinc_uint8x16_t t) {
+	return _mm_unpacklo_epi8(t, _mm_setzero_si128());
+}
+
+// Zero-extends the upper eight bytes.
+static inline kinc_uint16x8_t kinc_uint16x8_widen_high(kinc_uint8x16_t t) {
+	return _mm_unpackhi_epi8(t, _mm_setzero_si128());
+}
+
+// Packs a into the lower and b into the upper eight bytes, clamping every lane to 255.
+static inline kinc_uint8x16_t kinc_uint16x8_narrow_saturated(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	// _mm_packus_epi16 treats its input as signed, clamp to 255 first so that large values do not turn negative
+	__m128i limit = _mm_set1_epi16(255);
+	return _mm_packus_epi16(kinc_uint16x8_min(a, limit), kinc_uint16x8_min(b, limit));
+}
+
+#elif defined(KINC_NEON)
+
+typedef uint16x8_t kinc_uint16x8_t;
+
+static inline kinc_uint16x8_t kinc_uint16x8_load_all(uint16_t t) {
+	return vdupq_n_u16(t);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_load_unaligned(const uint16_t *values) {
+	return vld1q_u16(values);
+}
+
+static inline void kinc_uint16x8_store_unaligned(uint16_t *destination, kinc_uint16x8_t t) {
+	vst1q_u16(destination, t);
+}
+
+static inline uint16_t kinc_uint16x8_get(kinc_uint16x8_t t, int index) {
+	uint16_t elements[8];
+	vst1q_u16(elements, t);
+	return elements[index];
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_add(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vaddq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_sub(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vsubq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_add_saturated(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vqaddq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_sub_saturated(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vqsubq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_mul(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vmulq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_shift_left(kinc_uint16x8_t t, int bits) {
+	return vshlq_u16(t, vdupq_n_s16((int16_t)bits));
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_shift_right(kinc_uint16x8_t t, int bits) {
+	return vshlq_u16(t, vdupq_n_s16((int16_t)-bits));
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_min(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vminq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_max(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vmaxq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_and(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vandq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_or(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vorrq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_xor(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return veorq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_cmpeq(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vceqq_u16(a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_sel(kinc_uint16x8_t a, kinc_uint16x8_t b, kinc_uint16x8_t mask) {
+	return vbslq_u16(mask, a, b);
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_widen_low(kinc_uint8x16_t t) {
+	return vmovl_u8(vget_low_u8(t));
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_widen_high(kinc_uint8x16_t t) {
+	return vmovl_u8(vget_high_u8(t));
+}
+
+static inline kinc_uint8x16_t kinc_uint16x8_narrow_saturated(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	return vcombine_u8(vqmovn_u16(a), vqmovn_u16(b));
+}
+
+#else
+
+typedef struct kinc_uint16x8 {
+	uint16_t values[8];
+} kinc_uint16x8_t;
+
+static inline kinc_uint16x8_t kinc_uint16x8_load_all(uint16_t t) {
+	kinc_uint16x8_t value;
+	for (int i = 0; i < 8; ++i) {
+		value.values[i] = t;
+	}
+	return value;
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_load_unaligned(const uint16_t *values) {
+	kinc_uint16x8_t value;
+	for (int i = 0; i < 8; ++i) {
+		value.values[i] = values[i];
+	}
+	return value;
+}
+
+static inline void kinc_uint16x8_store_unaligned(uint16_t *destination, kinc_uint16x8_t t) {
+	for (int i = 0; i < 8; ++i) {
+		destination[i] = t.values[i];
+	}
+}
+
+static inline uint16_t kinc_uint16x8_get(kinc_uint16x8_t t, int index) {
+	return t.values[index];
+}
+
+#define KINC_INTERNAL_UINT16X8_BINARY(name, expression)                                                                                                        \
+	static inline kinc_uint16x8_t kinc_uint16x8_##name(kinc_uint16x8_t a, kinc_uint16x8_t b) {                                                                \
+		kinc_uint16x8_t value;                                                                                                                                 \
+		for (int i = 0; i < 8; ++i) {                                                                                                                          \
+			uint32_t x = a.values[i];                                                                                                                          \
+			uint32_t y = b.values[i];                                                                                                                          \
+			value.values[i] = (uint16_t)(expression);                                                                                                          \
+		}                                                                                                                                                      \
+		return value;                                                                                                                                          \
+	}
+
+KINC_INTERNAL_UINT16X8_BINARY(add, x + y)
+KINC_INTERNAL_UINT16X8_BINARY(sub, x - y)
+KINC_INTERNAL_UINT16X8_BINARY(add_saturated, x + y > 0xffff ? 0xffff : x + y)
+KINC_INTERNAL_UINT16X8_BINARY(sub_saturated, x < y ? 0 : x - y)
+KINC_INTERNAL_UINT16X8_BINARY(mul, x * y)
+KINC_INTERNAL_UINT16X8_BINARY(min, x < y ? x : y)
+KINC_INTERNAL_UINT16X8_BINARY(max, x > y ? x : y)
+KINC_INTERNAL_UINT16X8_BINARY(and, x & y)
+KINC_INTERNAL_UINT16X8_BINARY(or, x | y)
+KINC_INTERNAL_UINT16X8_BINARY(xor, x ^ y)
+KINC_INTERNAL_UINT16X8_BINARY(cmpeq, x == y ? 0xffff : 0)
+
+static inline kinc_uint16x8_t kinc_uint16x8_shift_left(kinc_uint16x8_t t, int bits) {
+	kinc_uint16x8_t value;
+	for (int i = 0; i < 8; ++i) {
+		value.values[i] = bits > 15 ? 0 : (uint16_t)(t.values[i] << bits);
+	}
+	return value;
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_shift_right(kinc_uint16x8_t t, int bits) {
+	kinc_uint16x8_t value;
+	for (int i = 0; i < 8; ++i) {
+		value.values[i] = bits > 15 ? 0 : (uint16_t)(t.values[i] >> bits);
+	}
+	return value;
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_sel(kinc_uint16x8_t a, kinc_uint16x8_t b, kinc_uint16x8_t mask) {
+	kinc_uint16x8_t value;
+	for (int i = 0; i < 8; ++i) {
+		value.values[i] = (uint16_t)((a.values[i] & mask.values[i]) | (b.values[i] & ~mask.values[i]));
+	}
+	return value;
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_widen_low(kinc_uint8x16_t t) {
+	kinc_uint16x8_t value;
+	for (int i = 0; i < 8; ++i) {
+		value.values[i] = t.values[i];
+	}
+	return value;
+}
+
+static inline kinc_uint16x8_t kinc_uint16x8_widen_high(kinc_uint8x16_t t) {
+	kinc_uint16x8_t value;
+	for (int i = 0; i < 8; ++i) {
+		value.values[i] = t.values[i + 8];
+	}
+	return value;
+}
+
+static inline kinc_uint8x16_t kinc_uint16x8_narrow_saturated(kinc_uint16x8_t a, kinc_uint16x8_t b) {
+	kinc_uint8x16_t value;
+	for (int i = 0; i < 8; ++i) {
+		value.values[i] = a.values[i] > 255 ? 255 : (uint8_t)a.values[i];
+		value.values[i + 8] = b.values[i] > 255 ? 255 : (uint8_t)b.values[i];
+	}
+	return value;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
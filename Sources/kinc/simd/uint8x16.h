@@ -0,0 +1,279 @@
+#pragma once
+
+#include "types.h"
+
+#include <stdint.h>
+
+/*! \file uint8x16.h
+    \brief Provides 128bit sixteen-element unsigned byte SIMD operations which are mapped to equivalent SSE2 or Neon operations. Useful for pixel and
+   audio-byte processing.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(KINC_SSE2)
+
+#include <emmintrin.h>
+
+typedef __m128i kinc_uint8x16_t;
+
+static inline kinc_uint8x16_t kinc_uint8x16_load_all(uint8_t t) {
+	return _mm_set1_epi8((char)t);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_load_unaligned(const uint8_t *values) {
+	return _mm_loadu_si128((const __m128i *)values);
+}
+
+static inline void kinc_uint8x16_store_unaligned(uint8_t *destination, kinc_uint8x16_t t) {
+	_mm_storeu_si128((__m128i *)destination, t);
+}
+
+static inline uint8_t kinc_uint8x16_get(kinc_uint8x16_t t, int index) {
+	union {
+		__m128i value;
+		uint8_t elements[16];
+	} converter;
+	converter.value = t;
+	return converter.elements[index];
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_add(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_add_epi8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_sub(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_sub_epi8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_add_saturated(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_adds_epu8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_sub_saturated(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_subs_epu8(a, b);
+}
+
+// Rounds up, (a + b + 1) / 2.
+static inline kinc_uint8x16_t kinc_uint8x16_average(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_avg_epu8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_min(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_min_epu8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_max(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_max_epu8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_and(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_and_si128(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_or(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_or_si128(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_xor(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_xor_si128(a, b);
+}
+
+// Returns all bits set in the lanes where a and b are equal.
+static inline kinc_uint8x16_t kinc_uint8x16_cmpeq(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_cmpeq_epi8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmpneq(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_xor_si128(_mm_cmpeq_epi8(a, b), _mm_set1_epi8((char)0xff));
+}
+
+// SSE2 only compares signed bytes, unsigned comparisons go through min and max instead.
+static inline kinc_uint8x16_t kinc_uint8x16_cmpge(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_cmpeq_epi8(_mm_max_epu8(a, b), a);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmple(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_cmpeq_epi8(_mm_min_epu8(a, b), a);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmpgt(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_xor_si128(kinc_uint8x16_cmple(a, b), _mm_set1_epi8((char)0xff));
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmplt(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return _mm_xor_si128(kinc_uint8x16_cmpge(a, b), _mm_set1_epi8((char)0xff));
+}
+
+// Picks the lanes of a where mask is set and the lanes of b everywhere else.
+static inline kinc_uint8x16_t kinc_uint8x16_sel(kinc_uint8x16_t a, kinc_uint8x16_t b, kinc_uint8x16_t mask) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+#elif defined(KINC_NEON)
+
+#include <arm_neon.h>
+
+typedef uint8x16_t kinc_uint8x16_t;
+
+static inline kinc_uint8x16_t kinc_uint8x16_load_all(uint8_t t) {
+	return vdupq_n_u8(t);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_load_unaligned(const uint8_t *values) {
+	return vld1q_u8(values);
+}
+
+static inline void kinc_uint8x16_store_unaligned(uint8_t *destination, kinc_uint8x16_t t) {
+	vst1q_u8(destination, t);
+}
+
+static inline uint8_t kinc_uint8x16_get(kinc_uint8x16_t t, int index) {
+	uint8_t elements[16];
+	vst1q_u8(elements, t);
+	return elements[index];
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_add(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vaddq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_sub(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vsubq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_add_saturated(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vqaddq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_sub_saturated(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vqsubq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_average(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vrhaddq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_min(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vminq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_max(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vmaxq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_and(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vandq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_or(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vorrq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_xor(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return veorq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmpeq(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vceqq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmpneq(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vmvnq_u8(vceqq_u8(a, b));
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmpge(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vcgeq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmple(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vcleq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmpgt(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vcgtq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_cmplt(kinc_uint8x16_t a, kinc_uint8x16_t b) {
+	return vcltq_u8(a, b);
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_sel(kinc_uint8x16_t a, kinc_uint8x16_t b, kinc_uint8x16_t mask) {
+	return vbslq_u8(mask, a, b);
+}
+
+#else
+
+typedef struct kinc_uint8x16 {
+	uint8_t values[16];
+} kinc_uint8x16_t;
+
+static inline kinc_uint8x16_t kinc_uint8x16_load_all(uint8_t t) {
+	kinc_uint8x16_t value;
+	for (int i = 0; i < 16; ++i) {
+		value.values[i] = t;
+	}
+	return value;
+}
+
+static inline kinc_uint8x16_t kinc_uint8x16_load_unaligned(const uint8_t *values) {
+	kinc_uint8x16_t value;
+	for (int i = 0; i < 16; ++i) {
+		value.values[i] = values[i];
+	}
+	return value;
+}
+
+static inline void kinc_uint8x16_store_unaligned(uint8_t *destination, kinc_uint8x16_t t) {
+	for (int i = 0; i < 16; ++i) {
+		destination[i] = t.values[i];
+	}
+}
+
+static inline uint8_t kinc_uint8x16_get(kinc_uint8x16_t t, int index) {
+	return t.values[index];
+}
+
+#define KINC_INTERNAL_UINT8X16_BINARY(name, expression)                                                                                                        \
+	static inline kinc_uint8x16_t kinc_uint8x16_##name(kinc_uint8x16_t a, kinc_uint8x16_t b) {                                                                \
+		kinc_uint8x16_t value;                                                                                                                                 \
+		for (int i = 0; i < 16; ++i) {                                                                                                                         \
+			int x = a.values[i];                                                                                                                               \
+			int y = b.values[i];                                                                                                                               \
+			value.values[i] = (uint8_t)(expression);                                                                                                           \
+		}                                                                                                                                                      \
+		return value;                                                                                                                                          \
+	}
+
+KINC_INTERNAL_UINT8X16_BINARY(add, x + y)
+KINC_INTERNAL_UINT8X16_BINARY(sub, x - y)
+KINC_INTERNAL_UINT8X16_BINARY(add_saturated, x + y > 255 ? 255 : x + y)
+KINC_INTERNAL_UINT8X16_BINARY(sub_saturated, x - y < 0 ? 0 : x - y)
+KINC_INTERNAL_UINT8X16_BINARY(average, (x + y + 1) >> 1)
+KINC_INTERNAL_UINT8X16_BINARY(min, x < y ? x : y)
+KINC_INTERNAL_UINT8X16_BINARY(max, x > y ? x : y)
+KINC_INTERNAL_UINT8X16_BINARY(and, x & y)
+KINC_INTERNAL_UINT8X16_BINARY(or, x | y)
+KINC_INTERNAL_UINT8X16_BINARY(xor, x ^ y)
+KINC_INTERNAL_UINT8X16_BINARY(cmpeq, x == y ? 0xff : 0)
+KINC_INTERNAL_UINT8X16_BINARY(cmpneq, x != y ? 0xff : 0)
+KINC_INTERNAL_UINT8X16_BINARY(cmpge, x >= y ? 0xff : 0)
+KINC_INTERNAL_UINT8X16_BINARY(cmple, x <= y ? 0xff : 0)
+KINC_INTERNAL_UINT8X16_BINARY(cmpgt, x > y ? 0xff : 0)
+KINC_INTERNAL_UINT8X16_BINARY(cmplt, x < y ? 0xff : 0)
+
+static inline kinc_uint8x16_t kinc_uint8x16_sel(kinc_uint8x16_t a, kinc_uint8x16_t b, kinc_uint8x16_t mask) {
+	kinc_uint8x16_t value;
+	for (int i = 0; i < 16; ++i) {
+		value.values[i] = (uint8_t)((a.values[i] & mask.values[i]) | (b.values[i] & ~mask.values[i]));
+	}
+	return value;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
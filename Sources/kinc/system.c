@@ -3,11 +3,24 @@
 #include "window.h"
 
 #include <kinc/io/filereader.h>
+#include <kinc/input/queue.h>
 #include <kinc/io/filewriter.h>
+#include <kinc/memory.h>
+#include <kinc/profiler.h>
+#include <kinc/threads/thread.h>
 
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef KORE_LINUX
+#include <errno.h>
+#include <time.h>
+#endif
+
+#ifdef KORE_HEADLESS
+#include <kinc/backend/headless.h>
+#endif
+
 #if !defined(KORE_HTML5) && !defined(KORE_ANDROID) && !defined(KORE_WINDOWS) && !defined(KORE_CONSOLE)
 double kinc_time() {
 	return kinc_timestamp() / kinc_frequency();
@@ -183,9 +196,147 @@ void kinc_stop() {
 #endif
 }
 
+static double target_frame_rate = 0.0;
+static kinc_ticks_t frame_deadline = 0;
+static kinc_ticks_t last_frame_start = 0;
+static float frame_times[KINC_FRAME_STATISTICS_HISTORY];
+static int frame_time_count = 0;
+static int frame_time_index = 0;
+static int missed_deadlines = 0;
+
+void kinc_set_target_frame_rate(double frames_per_second) {
+	target_frame_rate = frames_per_second > 0.0 ? frames_per_second : 0.0;
+	frame_deadline = 0;
+}
+
+double kinc_target_frame_rate(void) {
+	return target_frame_rate;
+}
+
+static void record_frame_start(void) {
+	kinc_ticks_t now = kinc_timestamp();
+	if (last_frame_start != 0) {
+		frame_times[frame_time_index] = (float)((now - last_frame_start) / kinc_frequency());
+		frame_time_index = (frame_time_index + 1) % KINC_FRAME_STATISTICS_HISTORY;
+		if (frame_time_count < KINC_FRAME_STATISTICS_HISTORY) {
+			++frame_time_count;
+		}
+	}
+	last_frame_start = now;
+}
+
+static int compare_floats(const void *a, const void *b) {
+	float fa = *(const float *)a;
+	float fb = *(const float *)b;
+	return fa < fb ? -1 : (fa > fb ? 1 : 0);
+}
+
+void kinc_frame_statistics(kinc_frame_statistics_t *statistics) {
+	memset(statistics, 0, sizeof(*statistics));
+	statistics->missed_deadlines = missed_deadlines;
+	if (frame_time_count == 0) {
+		return;
+	}
+	float sorted[KINC_FRAME_STATISTICS_HISTORY];
+	memcpy(sorted, frame_times, frame_time_count * sizeof(float));
+	qsort(sorted, frame_time_count, sizeof(float), compare_floats);
+	double sum = 0.0;
+	for (int i = 0; i < frame_time_count; ++i) {
+		sum += sorted[i];
+	}
+	statistics->frames = frame_time_count;
+	statistics->average_seconds = sum / frame_time_count;
+	statistics->min_seconds = sorted[0];
+	statistics->max_seconds = sorted[frame_time_count - 1];
+	statistics->percentile_50_seconds = sorted[(frame_time_count - 1) * 50 / 100];
+	statistics->percentile_95_seconds = sorted[(frame_time_count - 1) * 95 / 100];
+	statistics->percentile_99_seconds = sorted[(frame_time_count - 1) * 99 / 100];
+}
+
+void kinc_frame_statistics_reset(void) {
+	frame_time_count = 0;
+	frame_time_index = 0;
+	missed_deadlines = 0;
+}
+
+#if !defined(KORE_HTML5) && !defined(KORE_TIZEN)
+static void wait_until(kinc_ticks_t deadline) {
+	double frequency = kinc_frequency();
+#ifdef KORE_LINUX
+	// timestamps are CLOCK_MONOTONIC_RAW nanoseconds which clock_nanosleep does not support, so the remaining time is added to CLOCK_MONOTONIC instead
+	kinc_ticks_t spin = (kinc_ticks_t)(frequency * 0.0005);
+	kinc_ticks_t now = kinc_timestamp();
+	if (deadline > now + spin) {
+		kinc_ticks_t sleep = deadline - spin - now;
+		struct timespec wake;
+		clock_gettime(CLOCK_MONOTONIC, &wake);
+		wake.tv_sec += (time_t)(sleep / 1000000000);
+		wake.tv_nsec += (long)(sleep % 1000000000);
+		if (wake.tv_nsec >= 1000000000) {
+			wake.tv_nsec -= 1000000000;
+			wake.tv_sec += 1;
+		}
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR) {
+		}
+	}
+#else
+	kinc_ticks_t spin = (kinc_ticks_t)(frequency * 0.002);
+	while (deadline > kinc_timestamp() + spin) {
+		kinc_thread_sleep(1);
+	}
+#endif
+	while (kinc_timestamp() < deadline) {
+	}
+}
+
+static void pace_frame(void) {
+	if (target_frame_rate <= 0.0) {
+		return;
+	}
+#ifdef KORE_HEADLESS
+	// virtual time does not pass while waiting
+	if (kinc_headless_fixed_step() > 0.0) {
+		return;
+	}
+#endif
+	kinc_ticks_t period = (kinc_ticks_t)(kinc_frequency() / target_frame_rate);
+	if (frame_deadline == 0) {
+		frame_deadline = last_frame_start + period;
+	}
+	kinc_ticks_t now = kinc_timestamp();
+	if (now > frame_deadline) {
+		// start the next frame right away instead of trying to catch up
+		++missed_deadlines;
+		frame_deadline = now + period;
+		return;
+	}
+	KINC_PROFILER_BEGIN("Frame pacing");
+	wait_until(frame_deadline);
+	KINC_PROFILER_END();
+	frame_deadline += period;
+}
+
+#if defined(KORE_IOS) || defined(KORE_MACOS)
+static bool paced_frame(void) {
+	bool result = kinc_internal_frame();
+	pace_frame();
+	return result;
+}
+#endif
+#endif
+
 bool kinc_internal_frame() {
+	record_frame_start();
+	KINC_PROFILER_FRAME();
+	if (kinc_internal_input_queue_active) {
+		kinc_internal_input_queue_frame();
+	}
+	KINC_PROFILER_BEGIN("Update");
 	kinc_internal_update_callback();
+	KINC_PROFILER_END();
+	KINC_PROFILER_BEGIN("Handle messages");
 	kinc_internal_handle_messages();
+	KINC_PROFILER_END();
 	return running;
 }
 
@@ -196,10 +347,11 @@ void kinc_start() {
 	// if (Graphics::hasWindow()) Graphics::swapBuffers();
 
 #if defined(KORE_IOS) || defined(KORE_MACOS)
-	while (withAutoreleasepool(kinc_internal_frame)) {
+	while (withAutoreleasepool(paced_frame)) {
 	}
 #else
 	while (kinc_internal_frame()) {
+		pace_frame();
 	}
 #endif
 	kinc_internal_shutdown();
@@ -275,14 +427,14 @@ size_t kinc_get_save_file_size() {
 }
 
 void kinc_load_save_file(const char *filename) {
-	free(current_file);
+	kinc_memory_free(current_file);
 	current_file = NULL;
 	current_file_size = 0;
 
 	kinc_file_reader_t reader;
 	if (kinc_file_reader_open(&reader, filename, KINC_FILE_TYPE_SAVE)) {
 		current_file_size = kinc_file_reader_size(&reader);
-		current_file = (uint8_t *)malloc(current_file_size);
+		current_file = (uint8_t *)kinc_memory_allocate(current_file_size, KINC_MEMORY_TAG_IO);
 		kinc_file_reader_read(&reader, current_file, current_file_size);
 		kinc_file_reader_close(&reader);
 	}
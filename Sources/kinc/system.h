@@ -111,6 +111,47 @@ KINC_FUNC kinc_ticks_t kinc_timestamp(void);
 /// <returns>The current time in seconds</returns>
 KINC_FUNC double kinc_time(void);
 
+/// <summary>
+/// Limits the frame rate of the main-loop which is run by kinc_start. Frames which finish early sleep until shortly before their deadline and spin for
+/// the remainder to hit it precisely. Pacing is disabled by default.
+/// </summary>
+/// <param name="frames_per_second">The targeted frame rate or 0 to disable pacing</param>
+KINC_FUNC void kinc_set_target_frame_rate(double frames_per_second);
+
+/// <summary>
+/// Returns the frame rate which was set using kinc_set_target_frame_rate.
+/// </summary>
+/// <returns>The targeted frame rate or 0 if pacing is disabled</returns>
+KINC_FUNC double kinc_target_frame_rate(void);
+
+/// <summary>
+/// The number of recent frames which are considered by kinc_frame_statistics
+/// </summary>
+#define KINC_FRAME_STATISTICS_HISTORY 512
+
+typedef struct kinc_frame_statistics {
+	int frames;
+	int missed_deadlines;
+	double average_seconds;
+	double min_seconds;
+	double max_seconds;
+	double percentile_50_seconds;
+	double percentile_95_seconds;
+	double percentile_99_seconds;
+} kinc_frame_statistics_t;
+
+/// <summary>
+/// Summarizes the time between the starts of the last KINC_FRAME_STATISTICS_HISTORY frames. Missed deadlines are counted since the last reset and
+/// only while a target frame rate is set.
+/// </summary>
+/// <param name="statistics">Receives the statistics</param>
+KINC_FUNC void kinc_frame_statistics(kinc_frame_statistics_t *statistics);
+
+/// <summary>
+/// Clears the frame statistics.
+/// </summary>
+KINC_FUNC void kinc_frame_statistics_reset(void);
+
 /// <summary>
 /// Starts Kinc's main-loop. kinc_set_update_callback should be called before kinc_start so the main-loop actually has something to do.
 /// </summary>
@@ -0,0 +1,125 @@
+#include "parallel.h"
+
+#include <kinc/threads/atomic.h>
+#include <kinc/threads/semaphore.h>
+#include <kinc/threads/thread.h>
+
+#include <stdbool.h>
+
+#ifndef KORE_HTML5
+
+static kinc_thread_t threads[KINC_PARALLEL_MAX_THREADS];
+static int worker_count = 0;
+static kinc_semaphore_t start_semaphore;
+static kinc_semaphore_t done_semaphore;
+static volatile bool quit = false;
+
+static void (*job_function)(int start, int end, void *data);
+static void *job_data;
+static int job_count;
+static int job_batch_size;
+static volatile int32_t next_batch;
+
+static void run_batches(void) {
+	for (;;) {
+		int batch = KINC_ATOMIC_INCREMENT(&next_batch);
+		int start = batch * job_batch_size;
+		if (start >= job_count) {
+			break;
+		}
+		int end = start + job_batch_size < job_count ? start + job_batch_size : job_count;
+		job_function(start, end, job_data);
+	}
+}
+
+static void worker(void *param) {
+	for (;;) {
+		kinc_semaphore_acquire(&start_semaphore);
+		if (quit) {
+			break;
+		}
+		run_batches();
+		kinc_semaphore_release(&done_semaphore, 1);
+	}
+}
+
+void kinc_parallel_init(int thread_count) {
+	if (thread_count > KINC_PARALLEL_MAX_THREADS) {
+		thread_count = KINC_PARALLEL_MAX_THREADS;
+	}
+	if (worker_count > 0 || thread_count < 2) {
+		return;
+	}
+	quit = false;
+	kinc_semaphore_init(&start_semaphore, 0, KINC_PARALLEL_MAX_THREADS);
+	kinc_semaphore_init(&done_semaphore, 0, KINC_PARALLEL_MAX_THREADS);
+	worker_count = thread_count - 1;
+	for (int i = 0; i < worker_count; ++i) {
+		kinc_thread_init(&threads[i], worker, NULL);
+	}
+}
+
+void kinc_parallel_destroy(void) {
+	if (worker_count == 0) {
+		return;
+	}
+	quit = true;
+	kinc_semaphore_release(&start_semaphore, worker_count);
+	for (int i = 0; i < worker_count; ++i) {
+		kinc_thread_wait_and_destroy(&threads[i]);
+	}
+	kinc_semaphore_destroy(&start_semaphore);
+	kinc_semaphore_destroy(&done_semaphore);
+	worker_count = 0;
+}
+
+int kinc_parallel_thread_count(void) {
+	return worker_count + 1;
+}
+
+void kinc_parallel_for(int count, int batch_size, void (*function)(int start, int end, void *data), void *data) {
+	if (batch_size < 1) {
+		batch_size = 1;
+	}
+	int batches = (count + batch_size - 1) / batch_size;
+	// workers without a batch would only wake up to go back to sleep
+	int workers = batches - 1 < worker_count ? batches - 1 : worker_count;
+	if (workers <= 0) {
+		for (int start = 0; start < count; start += batch_size) {
+			function(start, start + batch_size < count ? start + batch_size : count, data);
+		}
+		return;
+	}
+
+	job_function = function;
+	job_data = data;
+	job_count = count;
+	job_batch_size = batch_size;
+	next_batch = 0;
+	kinc_semaphore_release(&start_semaphore, workers);
+	run_batches();
+	for (int i = 0; i < workers; ++i) {
+		kinc_semaphore_acquire(&done_semaphore);
+	}
+}
+
+#else
+
+void kinc_parallel_init(int thread_count) {}
+
+void kinc_parallel_destroy(void) {}
+
+int kinc_parallel_thread_count(void) {
+	return 1;
+}
+
+void kinc_parallel_for(int count, int batch_size, void (*function)(int start, int end, void *data), void *data) {
+	if (batch_size < 1) {
+		batch_size = 1;
+	}
+	for (int start = 0; start < count; start += batch_size) {
+		function(start, start + batch_size < count ? start + batch_size : count, data);
+	}
+}
+
+#endif
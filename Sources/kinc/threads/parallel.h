@@ -0,0 +1,45 @@
+#pragma once
+
+#include <kinc/global.h>
+
+/*! \file parallel.h
+    \brief Splits loops across a small pool of persistent worker-threads. The pool is optional, without kinc_parallel_init every loop simply
+   runs on the calling thread.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KINC_PARALLEL_MAX_THREADS 64
+
+/// <summary>
+/// Starts the worker-threads. kinc_threads_init has to be called before.
+/// </summary>
+/// <param name="thread_count">The number of threads which work on a loop including the calling thread, typically the number of CPU-cores</param>
+KINC_FUNC void kinc_parallel_init(int thread_count);
+
+/// <summary>
+/// Stops the worker-threads.
+/// </summary>
+KINC_FUNC void kinc_parallel_destroy(void);
+
+/// <summary>
+/// Returns the number of threads which work on a loop, including the calling thread.
+/// </summary>
+/// <returns>The number of threads</returns>
+KINC_FUNC int kinc_parallel_thread_count(void);
+
+/// <summary>
+/// Calls function for consecutive ranges of [0, count) from all threads of the pool and returns once all ranges were processed. Only one
+/// thread at a time may call kinc_parallel_for.
+/// </summary>
+/// <param name="count">The number of items</param>
+/// <param name="batch_size">The maximum number of items passed to one call of function</param>
+/// <param name="function">Processes the items from start to end - 1</param>
+/// <param name="data">Passed on to function</param>
+KINC_FUNC void kinc_parallel_for(int count, int batch_size, void (*function)(int start, int end, void *data), void *data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,166 @@
+#include <Kore/Log.h>
+
+#include <kinc/bvh/bvh.h>
+#include <kinc/system.h>
+#include <kinc/threads/parallel.h>
+#include <kinc/threads/thread.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Kore;
+
+// Measures building, refitting and tracing a kinc_bvh over a displaced sphere. Primary rays of a pinhole camera stand in for coherent rays,
+// rays between random points inside the bounds for incoherent ones. Pass the number of build-threads as the first argument, 4 by default.
+
+namespace {
+	const float pi = 3.14159265358979f;
+	const int rings = 512;
+	const int segments = 1024;
+	const int vertexCount = (rings + 1) * (segments + 1);
+	const int indexCount = rings * segments * 6;
+	const int width = 512;
+	const int height = 512;
+	const int randomRays = width * height;
+
+	float positions[vertexCount * 3];
+	int indices[indexCount];
+	kinc_bvh_ray_t cameraRays[width * height];
+	kinc_bvh_ray_t incoherentRays[randomRays];
+	kinc_bvh_hit_t hits[width * height];
+
+	float randomFloat() {
+		return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+	}
+
+	void createMesh(float time) {
+		for (int r = 0; r <= rings; ++r) {
+			float theta = pi * r / rings;
+			for (int s = 0; s <= segments; ++s) {
+				float phi = 2.0f * pi * s / segments;
+				float radius = 1.0f + 0.1f * sinf(theta * 12.0f + time) * sinf(phi * 16.0f);
+				float *p = &positions[(r * (segments + 1) + s) * 3];
+				p[0] = radius * sinf(theta) * cosf(phi);
+				p[1] = radius * cosf(theta);
+				p[2] = radius * sinf(theta) * sinf(phi);
+			}
+		}
+	}
+
+	void createIndices() {
+		int *index = indices;
+		for (int r = 0; r < rings; ++r) {
+			for (int s = 0; s < segments; ++s) {
+				int a = r * (segments + 1) + s;
+				int b = a + 1;
+				int c = a + segments + 1;
+				int d = c + 1;
+				*index++ = a;
+				*index++ = b;
+				*index++ = c;
+				*index++ = b;
+				*index++ = d;
+				*index++ = c;
+			}
+		}
+	}
+
+	void createRays() {
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				kinc_bvh_ray_t &ray = cameraRays[y * width + x];
+				ray.origin[0] = 0.0f;
+				ray.origin[1] = 0.0f;
+				ray.origin[2] = -3.0f;
+				ray.direction[0] = (x + 0.5f) / width - 0.5f;
+				ray.direction[1] = (y + 0.5f) / height - 0.5f;
+				ray.direction[2] = 1.0f;
+				ray.max_distance = 1000.0f;
+			}
+		}
+		for (int i = 0; i < randomRays; ++i) {
+			kinc_bvh_ray_t &ray = incoherentRays[i];
+			for (int axis = 0; axis < 3; ++axis) {
+				ray.origin[axis] = randomFloat() * 1.2f;
+				ray.direction[axis] = randomFloat() * 1.2f - ray.origin[axis];
+			}
+			ray.max_distance = 1.0f;
+		}
+	}
+
+	void report(const char *name, double seconds, int rays, int hitCount) {
+		log(Info, "%-32s %8.2f ms %8.2f Mrays/s, %5.1f%% hit", name, seconds * 1000.0, rays / seconds / 1e6, hitCount * 100.0 / rays);
+	}
+
+	void traceSingle(const kinc_bvh_t *bvh, const char *name, const kinc_bvh_ray_t *rays, int count) {
+		int hitCount = 0;
+		double start = kinc_time();
+		for (int i = 0; i < count; ++i) {
+			if (kinc_bvh_intersect(bvh, &rays[i], &hits[i])) ++hitCount;
+		}
+		report(name, kinc_time() - start, count, hitCount);
+	}
+
+	void traceOccluded(const kinc_bvh_t *bvh, const char *name, const kinc_bvh_ray_t *rays, int count) {
+		int hitCount = 0;
+		double start = kinc_time();
+		for (int i = 0; i < count; ++i) {
+			if (kinc_bvh_occluded(bvh, &rays[i])) ++hitCount;
+		}
+		report(name, kinc_time() - start, count, hitCount);
+	}
+
+	void tracePackets(const kinc_bvh_t *bvh, const char *name, const kinc_bvh_ray_t *rays, int count) {
+		double start = kinc_time();
+		kinc_bvh_intersect_packets(bvh, rays, hits, count);
+		double seconds = kinc_time() - start;
+		int hitCount = 0;
+		for (int i = 0; i < count; ++i) {
+			if (hits[i].triangle >= 0) ++hitCount;
+		}
+		report(name, seconds, count, hitCount);
+	}
+
+	void build(kinc_bvh_t *bvh, const char *name) {
+		double start = kinc_time();
+		kinc_bvh_init(bvh, positions, 3 * sizeof(float), vertexCount, indices, indexCount);
+		double seconds = kinc_time() - start;
+		log(Info, "%-32s %8.2f ms %8.2f Mtriangles/s, %i nodes", name, seconds * 1000.0, indexCount / 3 / seconds / 1e6, bvh->node_count);
+	}
+}
+
+int kickstart(int argc, char **argv) {
+	int threads = argc > 1 ? atoi(argv[1]) : 4;
+	createMesh(0.0f);
+	createIndices();
+	createRays();
+	log(Info, "%i triangles", indexCount / 3);
+
+	kinc_bvh_t bvh;
+	build(&bvh, "build, 1 thread");
+	kinc_bvh_destroy(&bvh);
+
+	kinc_threads_init();
+	kinc_parallel_init(threads);
+	char name[64];
+	snprintf(name, sizeof(name), "build, %i threads", kinc_parallel_thread_count());
+	build(&bvh, name);
+
+	traceSingle(&bvh, "coherent, intersect", cameraRays, width * height);
+	tracePackets(&bvh, "coherent, intersect_packets", cameraRays, width * height);
+	traceSingle(&bvh, "incoherent, intersect", incoherentRays, randomRays);
+	traceOccluded(&bvh, "incoherent, occluded", incoherentRays, randomRays);
+	tracePackets(&bvh, "incoherent, intersect_packets", incoherentRays, randomRays);
+
+	createMesh(1.0f);
+	double start = kinc_time();
+	kinc_bvh_refit(&bvh, positions, 3 * sizeof(float));
+	double seconds = kinc_time() - start;
+	log(Info, "%-32s %8.2f ms %8.2f Mtriangles/s", "refit", seconds * 1000.0, indexCount / 3 / seconds / 1e6);
+	traceSingle(&bvh, "coherent after refit, intersect", cameraRays, width * height);
+
+	kinc_bvh_destroy(&bvh);
+	kinc_parallel_destroy();
+	return 0;
+}
@@ -0,0 +1,6 @@
+let project = new Project('BVHBenchmark');
+
+project.addFile('Sources/**');
+project.setDebugDir('Deployment');
+
+resolve(project);
@@ -0,0 +1,116 @@
+#include <Kore/Audio3/Audio.h>
+#include <Kore/Log.h>
+
+#include <kinc/audio2/audio.h>
+#include <kinc/system.h>
+#include <kinc/threads/thread.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+using namespace Kore;
+
+// Plays sine-voices around the listener and reports how long the Audio3-mixer takes for equal-power panning and for HRTF-convolution.
+// Loads are given relative to the duration of the mixed audio, so 100% is the most the audio-thread can take.
+
+namespace {
+	const float pi = 3.14159265358979f;
+	const int maxVoices = 256;
+	const int directions = 72;
+	const int hrtfLength = 256;
+	const double secondsPerRun = 1.0;
+
+	struct Sine {
+		float phase;
+		float step;
+	};
+
+	Sine sines[maxVoices];
+	Audio3::Channel *channels[maxVoices];
+
+	void sine(Audio3::Channel *channel, int samples) {
+		Sine *sine = (Sine *)channel->userdata;
+		for (int i = 0; i < samples; ++i) {
+			*(float *)&channel->buffer.data[channel->buffer.writeLocation] = sinf(sine->phase) * 0.01f;
+			channel->buffer.writeLocation += 4;
+			if (channel->buffer.writeLocation >= channel->buffer.dataSize) channel->buffer.writeLocation = 0;
+			sine->phase += sine->step;
+			if (sine->phase > 2.0f * pi) sine->phase -= 2.0f * pi;
+		}
+	}
+
+	// decaying noise with an interaural delay, close enough to measured responses for timing purposes
+	void createHRTF(float *left, float *right) {
+		for (int d = 0; d < directions; ++d) {
+			float angle = 2.0f * pi * d / directions;
+			int delay = (int)(fabsf(sinf(angle)) * 30.0f);
+			for (int i = 0; i < hrtfLength; ++i) {
+				float value = (rand() / (float)RAND_MAX * 2.0f - 1.0f) * expf(-i / 32.0f);
+				bool leftFirst = sinf(angle) < 0.0f;
+				left[d * hrtfLength + i] = leftFirst || i >= delay ? value : 0.0f;
+				right[d * hrtfLength + i] = !leftFirst || i >= delay ? value : 0.0f;
+			}
+		}
+	}
+
+	void run(const char *name, int voices) {
+		for (int i = 0; i < voices; ++i) {
+			float angle = 2.0f * pi * i / voices;
+			sines[i].phase = 0.0f;
+			sines[i].step = 2.0f * pi * (220.0f + i * 3.0f) / kinc_a2_samples_per_second;
+			channels[i] = Audio3::createChannel(vec3(sinf(angle) * 5.0f, 0.0f, -cosf(angle) * 5.0f), sine, &sines[i]);
+			channels[i]->doppler = false;
+		}
+		// let the mixer pick up the new voices
+		kinc_thread_sleep(100);
+
+		double load = 0.0;
+		double maxLoad = 0.0;
+		double voicesPerMillisecond = 0.0;
+		int measurements = 0;
+		double start = kinc_time();
+		while (kinc_time() - start < secondsPerRun) {
+			Audio3::update();
+			Audio3::Statistics stats = Audio3::statistics();
+			if (stats.frames > 0 && stats.seconds > 0.0) {
+				double blockLoad = stats.seconds * kinc_a2_samples_per_second / stats.frames;
+				load += blockLoad;
+				if (blockLoad > maxLoad) maxLoad = blockLoad;
+				voicesPerMillisecond += stats.voices / (stats.seconds * 1000.0);
+				++measurements;
+			}
+			kinc_thread_sleep(1);
+		}
+		for (int i = 0; i < voices; ++i) {
+			Audio3::destroyChannel(channels[i]);
+		}
+		if (measurements == 0) {
+			log(Warning, "%s: no audio was mixed", name);
+			return;
+		}
+		log(Info, "%-12s %4i voices: load %6.2f%% (max %6.2f%%), %8.1f voices/ms", name, voices, load / measurements * 100.0, maxLoad * 100.0,
+		    voicesPerMillisecond / measurements);
+	}
+}
+
+int kickstart(int argc, char **argv) {
+	Audio3::init();
+
+	float *left = new float[directions * hrtfLength];
+	float *right = new float[directions * hrtfLength];
+	createHRTF(left, right);
+	Audio3::setHRTF(left, right, directions, hrtfLength);
+	delete[] left;
+	delete[] right;
+
+	const int voiceCounts[] = {16, 64, maxVoices};
+	for (int v = 0; v < 3; ++v) {
+		Audio3::setPanning(Audio3::PanningEqualPower);
+		run("equal-power", voiceCounts[v]);
+		Audio3::setPanning(Audio3::PanningHRTF);
+		run("HRTF", voiceCounts[v]);
+	}
+
+	Audio3::shutdown();
+	return 0;
+}
@@ -0,0 +1,6 @@
+let project = new Project('HRTFBenchmark');
+
+project.addFile('Sources/**');
+project.setDebugDir('Deployment');
+
+resolve(project);
@@ -0,0 +1,142 @@
+#include <Kore/Log.h>
+
+#include <kinc/math/matrix.h>
+#include <kinc/system.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+using namespace Kore;
+
+// Measures the 4x4 matrix functions against the element-wise implementation they replaced and checks that both agree.
+
+namespace {
+	const int count = 1024;
+	const int rounds = 1000;
+
+	kinc_matrix4x4_t a[count];
+	kinc_matrix4x4_t b[count];
+	kinc_matrix4x4_t results[count];
+	kinc_matrix4x4_t references[count];
+	kinc_vector4_t vectors[count];
+	kinc_vector4_t transformedVectors[count];
+	kinc_vector3_t points[count];
+	kinc_vector3_t transformedPoints[count];
+
+	float randomFloat() {
+		return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+	}
+
+	kinc_matrix4x4_t referenceMultiply(kinc_matrix4x4_t *a, kinc_matrix4x4_t *b) {
+		kinc_matrix4x4_t result;
+		for (int x = 0; x < 4; ++x) {
+			for (int y = 0; y < 4; ++y) {
+				float t = 0.0f;
+				for (int i = 0; i < 4; ++i) {
+					t += kinc_matrix4x4_get(a, i, y) * kinc_matrix4x4_get(b, x, i);
+				}
+				kinc_matrix4x4_set(&result, x, y, t);
+			}
+		}
+		return result;
+	}
+
+	float maxDifference(const kinc_matrix4x4_t *a, const kinc_matrix4x4_t *b, int count) {
+		float difference = 0.0f;
+		for (int i = 0; i < count; ++i) {
+			for (int j = 0; j < 16; ++j) {
+				float d = fabsf(a[i].m[j] - b[i].m[j]);
+				if (d > difference) difference = d;
+			}
+		}
+		return difference;
+	}
+
+	void report(const char *name, double seconds, int operations) {
+		log(Info, "%-40s %8.2f ns/op %10.2f Mop/s", name, seconds * 1e9 / operations, operations / seconds / 1e6);
+	}
+}
+
+int kickstart(int argc, char **argv) {
+	for (int i = 0; i < count; ++i) {
+		for (int j = 0; j < 16; ++j) {
+			a[i].m[j] = randomFloat();
+			b[i].m[j] = randomFloat();
+		}
+		vectors[i].x = randomFloat();
+		vectors[i].y = randomFloat();
+		vectors[i].z = randomFloat();
+		vectors[i].w = 1.0f;
+		points[i].x = randomFloat();
+		points[i].y = randomFloat();
+		points[i].z = randomFloat();
+	}
+	const int operations = count * rounds;
+
+	double start = kinc_time();
+	for (int r = 0; r < rounds; ++r) {
+		for (int i = 0; i < count; ++i) {
+			references[i] = referenceMultiply(&a[i], &b[i]);
+		}
+	}
+	report("reference multiply", kinc_time() - start, operations);
+
+	start = kinc_time();
+	for (int r = 0; r < rounds; ++r) {
+		for (int i = 0; i < count; ++i) {
+			results[i] = kinc_matrix4x4_multiply(&a[i], &b[i]);
+		}
+	}
+	report("kinc_matrix4x4_multiply", kinc_time() - start, operations);
+	log(Info, "max difference to the reference: %g", maxDifference(results, references, count));
+
+	start = kinc_time();
+	for (int r = 0; r < rounds; ++r) {
+		kinc_matrix4x4_multiply_matrix_pairs(a, b, results, count);
+	}
+	report("kinc_matrix4x4_multiply_matrix_pairs", kinc_time() - start, operations);
+	log(Info, "max difference to the reference: %g", maxDifference(results, references, count));
+
+	start = kinc_time();
+	for (int r = 0; r < rounds; ++r) {
+		kinc_matrix4x4_multiply_matrices(&a[r % count], b, results, count);
+	}
+	report("kinc_matrix4x4_multiply_matrices", kinc_time() - start, operations);
+
+	start = kinc_time();
+	for (int r = 0; r < rounds; ++r) {
+		for (int i = 0; i < count; ++i) {
+			kinc_matrix4x4_transpose(&results[i]);
+		}
+	}
+	report("kinc_matrix4x4_transpose", kinc_time() - start, operations);
+
+	start = kinc_time();
+	for (int r = 0; r < rounds; ++r) {
+		for (int i = 0; i < count; ++i) {
+			transformedVectors[i] = kinc_matrix4x4_multiply_vector(&a[r % count], vectors[i]);
+		}
+	}
+	report("kinc_matrix4x4_multiply_vector", kinc_time() - start, operations);
+
+	start = kinc_time();
+	for (int r = 0; r < rounds; ++r) {
+		kinc_matrix4x4_multiply_vectors(&a[r % count], vectors, transformedVectors, count);
+	}
+	report("kinc_matrix4x4_multiply_vectors", kinc_time() - start, operations);
+
+	start = kinc_time();
+	for (int r = 0; r < rounds; ++r) {
+		kinc_matrix4x4_multiply_points(&a[r % count], points, transformedPoints, count);
+	}
+	report("kinc_matrix4x4_multiply_points", kinc_time() - start, operations);
+
+	// keeps the compiler from dropping the work
+	float sum = 0.0f;
+	for (int i = 0; i < count; ++i) {
+		sum += results[i].m[0] + transformedVectors[i].x + transformedPoints[i].x;
+	}
+	log(Info, "checksum: %f", sum);
+
+	return 0;
+}
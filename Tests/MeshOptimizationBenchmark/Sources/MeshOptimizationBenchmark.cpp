@@ -0,0 +1,197 @@
+#include <Kore/Log.h>
+
+#include <kinc/mesh/optimization.h>
+#include <kinc/system.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+using namespace Kore;
+
+// Runs the kinc/mesh optimizations on a self-occluding mesh (a tube along a trefoil knot) whose triangles were shuffled and reports the
+// average cache miss ratio (ACMR) of a simulated FIFO post-transform cache and the overdraw of a small software rasterizer after every step.
+// The rasterizer renders the mesh with back-face culling and a depth test from the six axis directions; overdraw is the number of fragments
+// which passed the depth test divided by the number of covered pixels, so 1 is the optimum.
+
+namespace {
+	const float pi = 3.14159265358979f;
+	const int rings = 1024;
+	const int sides = 32;
+	const int vertexCount = rings * sides;
+	const int indexCount = rings * sides * 6;
+	const int resolution = 256;
+
+	float positions[vertexCount * 3];
+	int indices[indexCount];
+	int optimized[indexCount];
+	int remap[vertexCount];
+	float depth[resolution * resolution];
+
+	void knot(float t, float *p) {
+		p[0] = sinf(t) + 2.0f * sinf(2.0f * t);
+		p[1] = cosf(t) - 2.0f * cosf(2.0f * t);
+		p[2] = -sinf(3.0f * t);
+	}
+
+	void cross(const float *a, const float *b, float *result) {
+		result[0] = a[1] * b[2] - a[2] * b[1];
+		result[1] = a[2] * b[0] - a[0] * b[2];
+		result[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	void normalize(float *v) {
+		float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+		v[0] /= length;
+		v[1] /= length;
+		v[2] /= length;
+	}
+
+	void createMesh() {
+		for (int r = 0; r < rings; ++r) {
+			float t = 2.0f * pi * r / rings;
+			float center[3], next[3], tangent[3], normal[3], binormal[3];
+			knot(t, center);
+			knot(t + 0.001f, next);
+			for (int i = 0; i < 3; ++i) tangent[i] = next[i] - center[i];
+			normalize(tangent);
+			float up[3] = {0.0f, 0.0f, 1.0f};
+			cross(tangent, up, normal);
+			normalize(normal);
+			cross(normal, tangent, binormal);
+			for (int s = 0; s < sides; ++s) {
+				float angle = 2.0f * pi * s / sides;
+				float *p = &positions[(r * sides + s) * 3];
+				for (int i = 0; i < 3; ++i) {
+					p[i] = center[i] + (cosf(angle) * normal[i] + sinf(angle) * binormal[i]) * 0.4f;
+				}
+			}
+		}
+		int *index = indices;
+		for (int r = 0; r < rings; ++r) {
+			for (int s = 0; s < sides; ++s) {
+				int a = r * sides + s;
+				int b = r * sides + (s + 1) % sides;
+				int c = ((r + 1) % rings) * sides + s;
+				int d = ((r + 1) % rings) * sides + (s + 1) % sides;
+				*index++ = a;
+				*index++ = c;
+				*index++ = b;
+				*index++ = b;
+				*index++ = c;
+				*index++ = d;
+			}
+		}
+	}
+
+	// what an exporter which does not care about triangle-order might produce
+	void shuffleTriangles(int *triangles) {
+		srand(1);
+		for (int i = indexCount / 3 - 1; i > 0; --i) {
+			int j = (int)(((unsigned)rand() * (RAND_MAX + 1u) + (unsigned)rand()) % (unsigned)(i + 1));
+			for (int k = 0; k < 3; ++k) {
+				int swap = triangles[i * 3 + k];
+				triangles[i * 3 + k] = triangles[j * 3 + k];
+				triangles[j * 3 + k] = swap;
+			}
+		}
+	}
+
+	float edge(const float *a, const float *b, float x, float y) {
+		return (b[0] - a[0]) * (y - a[1]) - (b[1] - a[1]) * (x - a[0]);
+	}
+
+	// fragments which passed the depth test and covered pixels of one view along the axis, looking in the direction of sign
+	void rasterize(const int *triangles, int axis, float sign, int &shaded, int &covered) {
+		int u = (axis + 1) % 3;
+		int v = (axis + 2) % 3;
+		// mirrors the image for one of the directions so counter-clockwise front-faces end up with a positive area for both
+		float flip = -sign;
+		for (int i = 0; i < resolution * resolution; ++i) depth[i] = INFINITY;
+		const float extent = 3.5f;
+		for (int t = 0; t < indexCount / 3; ++t) {
+			float screen[3][3];
+			for (int k = 0; k < 3; ++k) {
+				const float *p = &positions[triangles[t * 3 + k] * 3];
+				screen[k][0] = (p[u] * flip / extent * 0.5f + 0.5f) * resolution;
+				screen[k][1] = (p[v] / extent * 0.5f + 0.5f) * resolution;
+				screen[k][2] = p[axis] * sign;
+			}
+			float area = edge(screen[0], screen[1], screen[2][0], screen[2][1]);
+			if (area <= 0.0f) {
+				// back-facing or degenerate
+				continue;
+			}
+			int minX = (int)floorf(fminf(screen[0][0], fminf(screen[1][0], screen[2][0])));
+			int maxX = (int)ceilf(fmaxf(screen[0][0], fmaxf(screen[1][0], screen[2][0])));
+			int minY = (int)floorf(fminf(screen[0][1], fminf(screen[1][1], screen[2][1])));
+			int maxY = (int)ceilf(fmaxf(screen[0][1], fmaxf(screen[1][1], screen[2][1])));
+			if (minX < 0) minX = 0;
+			if (minY < 0) minY = 0;
+			if (maxX > resolution - 1) maxX = resolution - 1;
+			if (maxY > resolution - 1) maxY = resolution - 1;
+			for (int y = minY; y <= maxY; ++y) {
+				for (int x = minX; x <= maxX; ++x) {
+					float px = x + 0.5f;
+					float py = y + 0.5f;
+					float w0 = edge(screen[1], screen[2], px, py);
+					float w1 = edge(screen[2], screen[0], px, py);
+					float w2 = edge(screen[0], screen[1], px, py);
+					if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+						continue;
+					}
+					float z = (w0 * screen[0][2] + w1 * screen[1][2] + w2 * screen[2][2]) / area;
+					float &stored = depth[y * resolution + x];
+					if (z < stored) {
+						if (stored == INFINITY) ++covered;
+						stored = z;
+						++shaded;
+					}
+				}
+			}
+		}
+	}
+
+	float overdraw(const int *triangles) {
+		int shaded = 0;
+		int covered = 0;
+		for (int axis = 0; axis < 3; ++axis) {
+			rasterize(triangles, axis, 1.0f, shaded, covered);
+			rasterize(triangles, axis, -1.0f, shaded, covered);
+		}
+		return covered > 0 ? (float)shaded / covered : 0.0f;
+	}
+
+	void report(const char *name, const int *triangles) {
+		kinc_mesh_vertex_cache_statistics_t stats = kinc_mesh_analyze_vertex_cache(triangles, indexCount, vertexCount, KINC_MESH_DEFAULT_CACHE_SIZE);
+		log(Info, "%-24s ACMR %5.3f  ATVR %5.3f  overdraw %5.3f", name, stats.acmr, stats.atvr, overdraw(triangles));
+	}
+}
+
+int kickstart(int argc, char **argv) {
+	createMesh();
+	log(Info, "%i vertices, %i triangles, cache size %i", vertexCount, indexCount / 3, KINC_MESH_DEFAULT_CACHE_SIZE);
+	report("generated order", indices);
+
+	shuffleTriangles(indices);
+	report("shuffled", indices);
+
+	double start = kinc_time();
+	kinc_mesh_optimize_vertex_cache(optimized, indices, indexCount, vertexCount, KINC_MESH_DEFAULT_CACHE_SIZE);
+	double seconds = kinc_time() - start;
+	report("vertex cache optimized", optimized);
+	log(Info, "kinc_mesh_optimize_vertex_cache: %.2f ms, %.2f Mtriangles/s", seconds * 1000.0, indexCount / 3 / seconds / 1e6);
+
+	start = kinc_time();
+	kinc_mesh_optimize_overdraw(optimized, optimized, indexCount, positions, 3 * sizeof(float), vertexCount, 1.05f);
+	seconds = kinc_time() - start;
+	report("overdraw optimized", optimized);
+	log(Info, "kinc_mesh_optimize_overdraw: %.2f ms, %.2f Mtriangles/s", seconds * 1000.0, indexCount / 3 / seconds / 1e6);
+
+	start = kinc_time();
+	kinc_mesh_optimize_vertex_fetch_remap(remap, optimized, indexCount, vertexCount);
+	kinc_mesh_remap_index_buffer(optimized, optimized, indexCount, remap);
+	seconds = kinc_time() - start;
+	log(Info, "kinc_mesh_optimize_vertex_fetch_remap: %.2f ms", seconds * 1000.0);
+
+	return 0;
+}
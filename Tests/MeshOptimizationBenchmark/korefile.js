@@ -0,0 +1,6 @@
+let project = new Project('MeshOptimizationBenchmark');
+
+project.addFile('Sources/**');
+project.setDebugDir('Deployment');
+
+resolve(project);
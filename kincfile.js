@@ -50,6 +50,9 @@ function addBackend(name) {
 
 let plugin = false;
 
+// Builds for machines without a display, GPU or sound hardware, for example KINC_HEADLESS=1 node make linux
+const headless = !!process.env.KINC_HEADLESS && process.env.KINC_HEADLESS !== '0';
+
 if (platform === Platform.Windows) {
 	project.addDefine('KORE_WINDOWS');
 	project.addDefine('KORE_MICROSOFT');
@@ -326,6 +329,17 @@ else if (platform === Platform.HTML5) {
 		throw new Error('Graphics API ' + graphics + ' is not available for HTML5.');
 	}
 }
+else if ((platform === Platform.Linux || platform === Platform.FreeBSD) && headless) {
+	g4 = true;
+	project.addDefine('KORE_LINUX');
+	project.addDefine('KORE_HEADLESS');
+	addBackend('System/Headless');
+	addBackend('System/POSIX');
+	addBackend('Graphics4/Null');
+	project.addDefine('KORE_POSIX');
+	project.addDefine('_POSIX_C_SOURCE=200112L');
+	project.addDefine('_XOPEN_SOURCE=600');
+}
 else if (platform === Platform.Linux || platform === Platform.FreeBSD) {
 	project.addDefine('KORE_LINUX');
 	addBackend('System/Linux');
@@ -416,6 +430,7 @@ if (g4) {
 else {
 	project.addExclude('Sources/Kore/Graphics4/**');
 	project.addExclude('Sources/kinc/graphics4/**');
+	project.addExclude('Sources/kinc/mesh/**');
 }
 
 if (g5) {